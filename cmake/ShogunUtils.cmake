@@ -322,7 +322,14 @@ function(ADD_SHOGUN_BENCHMARK REL_BENCHMARK_NAME)
 		set(NO_COLOR "--color_print=false")
 	endif()
 
-	add_test(${BENCHMARK_NAME} ${CMAKE_BINARY_DIR}/bin/${BENCHMARK_NAME} ${NO_COLOR})
+	# results are kept as JSON, to track regressions across releases
+	set(BENCHMARK_OUTPUT_DIR ${CMAKE_BINARY_DIR}/benchmarks)
+	file(MAKE_DIRECTORY ${BENCHMARK_OUTPUT_DIR})
+	set(JSON_OUTPUT
+		"--benchmark_out=${BENCHMARK_OUTPUT_DIR}/${BENCHMARK_NAME}.json"
+		"--benchmark_out_format=json")
+
+	add_test(${BENCHMARK_NAME} ${CMAKE_BINARY_DIR}/bin/${BENCHMARK_NAME} ${NO_COLOR} ${JSON_OUTPUT})
 	set_tests_properties(${BENCHMARK_NAME} PROPERTIES LABELS "benchmark")
 	if(ARGN)
 		set_tests_properties(${BENCHMARK_NAME} PROPERTIES ${ARGN})
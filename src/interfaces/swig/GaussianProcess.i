@@ -12,6 +12,7 @@
 %shared_ptr(shogun::Inference)
 SHARED_RANDOM_INTERFACE(shogun::Inference)
 %shared_ptr(shogun::ExactInferenceMethod)
+%shared_ptr(shogun::IterativeExactInferenceMethod)
 %shared_ptr(shogun::LaplaceInference)
 %shared_ptr(shogun::SparseInference)
 %shared_ptr(shogun::SingleSparseInference)
@@ -90,6 +91,7 @@ RANDOM_INTERFACE(Inference)
 %include <shogun/machine/gp/SingleLaplaceInferenceMethod.h>
 %include <shogun/machine/gp/MultiLaplaceInferenceMethod.h>
 %include <shogun/machine/gp/ExactInferenceMethod.h>
+%include <shogun/machine/gp/IterativeExactInferenceMethod.h>
 %include <shogun/machine/gp/SingleFITCLaplaceInferenceMethod.h>
 %include <shogun/machine/gp/FITCInferenceMethod.h>
 %include <shogun/machine/gp/VarDTCInferenceMethod.h>
@@ -30,6 +30,7 @@
  #include <shogun/machine/gp/SingleSparseInference.h>
  #include <shogun/machine/gp/MultiLaplaceInferenceMethod.h>
  #include <shogun/machine/gp/ExactInferenceMethod.h>
+ #include <shogun/machine/gp/IterativeExactInferenceMethod.h>
  #include <shogun/machine/gp/FITCInferenceMethod.h>
  #include <shogun/machine/gp/VarDTCInferenceMethod.h>
  #include <shogun/machine/gp/SingleFITCLaplaceInferenceMethod.h>
@@ -164,6 +164,38 @@ namespace shogun
 	private:
 		ObsParamsList m_list_obs_params;
 	};
+
+	/** whether a parameter is selected by the mask of clone() */
+	static bool has_properties(
+	    const AnyParameterProperties& p, ParameterProperties pprop)
+	{
+		// if the filter mask is ALL, also include parameters with no set properties (NONE)
+		return p.has_property(pprop) ||
+		       (pprop == ParameterProperties::ALL &&
+		        p.compare_mask(ParameterProperties::NONE));
+	}
+
+	/** Finds the parameter of another object that corresponds to the next
+	 * parameter of this object. Objects of the same type register their
+	 * parameters in the same order, so the parameter at the same position
+	 * in other is tried before looking up the tag.
+	 *
+	 * @param other parameters of the other object
+	 * @param other_it position in other, advanced past the result
+	 * @param tag tag of the parameter
+	 * @return the parameter or nullptr if other does not have it
+	 */
+	template <class Container, class Iterator>
+	static auto find_corresponding(
+	    Container& other, Iterator& other_it, const BaseTag& tag)
+	    -> decltype(&other_it->second)
+	{
+		if (other_it == other.end() || other_it->first != tag)
+			other_it = other.find(tag);
+		if (other_it == other.end())
+			return nullptr;
+		return &(other_it++)->second;
+	}
 } /* namespace shogun  */
 
 using namespace shogun;
@@ -323,10 +355,15 @@ std::shared_ptr<SGObject> SGObject::clone(ParameterProperties pp) const
 	          "SGObject::create_empty() overridden.\n",
 	    get_name());
 
-	for (const auto& it : self->filter(pp))
+	auto clone_it = clone->self->begin();
+	for (const auto& it : *self)
 	{
 		const BaseTag& tag = it.first;
 		const Any& own = it.second.get_value();
+		auto param = find_corresponding(*clone->self, clone_it, tag);
+
+		if (!has_properties(it.second.get_properties(), pp))
+			continue;
 
 		if (!own.cloneable())
 		{
@@ -340,7 +377,13 @@ std::shared_ptr<SGObject> SGObject::clone(ParameterProperties pp) const
 			"Cloning parameter {}::{} of type {}.", this->get_name(),
 			tag.name().c_str(), own.type().c_str());
 
-		clone->get_parameter(tag).get_value().clone_from(own);
+		if (!param)
+		{
+			error(
+			    "Parameter {}::{} does not exist.", clone->get_name(),
+			    tag.name().c_str());
+		}
+		param->get_value().clone_from(own);
 	}
 
 	SG_DEBUG("Done cloning {} at {}, new object at {}.", get_name(), fmt::ptr(this), fmt::ptr(clone.get()));
@@ -355,15 +398,16 @@ void SGObject::create_parameter(
 
 const AnyParameter& SGObject::get_parameter(const BaseTag& _tag) const
 {
-	if (!has_parameter(_tag))
+	auto [has_tag, tag_it] = self->has(_tag);
+	if (!has_tag)
 	{
 		error(
 			"Parameter {}::{} does not exist.", get_name(),
 			_tag.name().c_str());
 	}
-	
-	const auto& parameter = self->at(_tag);
-	
+
+	const auto& parameter = tag_it->second;
+
 	if (parameter.get_properties().has_property(
 	        ParameterProperties::FUNCTION))
 	{
@@ -377,14 +421,15 @@ const AnyParameter& SGObject::get_parameter(const BaseTag& _tag) const
 
 AnyParameter& SGObject::get_parameter(const BaseTag& _tag)
 {
-	if (!has_parameter(_tag))
+	auto [has_tag, tag_it] = self->has(_tag);
+	if (!has_tag)
 	{
 		error(
 			"Parameter {}::{} does not exist.", get_name(),
 			_tag.name().c_str());
 	}
 
-	auto& parameter = self->at(_tag);
+	auto& parameter = tag_it->second;
 
 	if (parameter.get_properties().has_property(
 	        ParameterProperties::FUNCTION))
@@ -572,10 +617,12 @@ bool SGObject::equals(const SGObject* other) const
 	}
 
 	/* Assumption: objects of same type have same set of tags. */
+	auto other_it = other->self->cbegin();
 	for (const auto& it : *self)
 	{
 		const BaseTag& tag = it.first;
 		const Any& own = it.second.get_value();
+		auto other_param = find_corresponding(*other->self, other_it, tag);
 
 		if (!own.comparable())
 		{
@@ -586,7 +633,13 @@ bool SGObject::equals(const SGObject* other) const
 			continue;
 		}
 
-		const Any& given = other->get_parameter(tag).get_value();
+		if (!other_param)
+		{
+			error(
+			    "Parameter {}::{} does not exist.", other->get_name(),
+			    tag.name().c_str());
+		}
+		const Any& given = other_param->get_value();
 
 		SG_DEBUG(
 		    "Comparing parameter {}::{} of type {}.", this->get_name(),
@@ -45,6 +45,10 @@ class ParameterObserver;
 
 template <class T>
 class ObservedValueTemplated;
+#ifndef SWIG
+template <typename T>
+class ParameterHandle;
+#endif
 	namespace io
 	{
 		class Deserializer;
@@ -142,7 +146,12 @@ class SGObject: public std::enable_shared_from_this<SGObject>
 	{
 		const ValueType& m_value;
 	};
-	
+
+#ifndef SWIG
+	template <typename T>
+	friend class ParameterHandle;
+#endif
+
 public:
 	/** Definition of observed subject */
 	typedef rxcpp::subjects::subject<std::shared_ptr<ObservedValue>> SGSubject;
@@ -312,16 +321,7 @@ public:
 		      typename std::enable_if_t<!is_string<T>::value>* = nullptr>
 	void put(const Tag<T>& _tag, const T& value)
 	{
-		const auto& parameter_value = get_parameter(_tag).get_value();
-
-		if (!parameter_value.cloneable())
-		{
-			error(
-				"Cannot put parameter {}::{}.", get_name(),
-				_tag.name().c_str());
-		}
-
-		update_parameter(_tag, value);
+		put_parameter(get_parameter(_tag), _tag, value);
 	}
 
 	/** Setter for a class parameter that has values of type string,
@@ -515,9 +515,6 @@ public:
 	template <typename T>
 	auto get(const Tag<T>& _tag) const
 	{
-		using ReturnType = std::conditional_t<is_sg_base<T>::value, std::shared_ptr<T>, T>;
-		ReturnType result;
-		
 		const auto& param = get_parameter(_tag);
 
 		if constexpr (is_string<T>::value)
@@ -525,42 +522,22 @@ public:
 			if (m_string_to_enum_map.count(_tag.name()))
 				return std::string(string_enum_reverse_lookup(_tag.name(), get<machine_int_t>(_tag.name())));
 		}
-		
-		const auto& value = param.get_value();
-		try
-		{
-			if (param.get_properties().has_property(ParameterProperties::CONSTFUNCTION))
-			{
-				ParameterGetterInterface<ReturnType, std::function<ReturnType()>> visitor{result};
-				value.visit_with(&visitor);
-			}
-			else if (param.get_properties().has_property(ParameterProperties::AUTO))
-			{
-				ParameterGetterInterface<ReturnType, AutoValue<ReturnType>> visitor{result};
-				value.visit_with(&visitor);
-			}
-			else
-			{
-				ParameterGetterInterface<ReturnType, ReturnType> visitor{result};
-				value.visit_with(&visitor);
-			}
-		}
-		catch (const std::bad_optional_access&)
-		{
-			const auto& heuristic = param.get_init_function();
-			error("The value of parameter {}::{} is automatically computed using \"{}\" during model training, "
-				  "and is currently not set. Either set a value or read value after training.",
-				  get_name(),_tag.name(), heuristic->display_name());
-		}
-		catch (const std::logic_error&)
-		{
-			error(
-				"Cannot get parameter {}::{} of type {}, incompatible with "
-				"requested type {}.",
-				get_name(), _tag.name().c_str(), value.type().c_str(),
-				demangled_type<T>().c_str());
-		}
-		return result;
+
+		return get_parameter_value<T>(param, _tag);
+	}
+
+	/** Resolves a parameter once and returns a typed handle to it, which
+	 * gets and puts the parameter without looking up its name again.
+	 * Enum parameters are accessed as machine_int_t.
+	 *
+	 * @param name name of the parameter
+	 * @return handle to the parameter
+	 */
+	template <typename T>
+	ParameterHandle<T> get_handle(std::string_view name)
+	{
+		BaseTag tag(name);
+		return ParameterHandle<T>(this, &get_parameter(tag), std::move(tag));
 	}
 #endif
 
@@ -1121,7 +1098,20 @@ private:
 	template <typename T>
 	void update_parameter(const BaseTag& _tag, const T& value, bool do_checks = true)
 	{
-		auto& param = get_parameter(_tag);
+		update_parameter(get_parameter(_tag), _tag, value, do_checks);
+	}
+
+	/** Updates a parameter that has already been looked up.
+	 *
+	 * @param param the parameter
+	 * @param _tag name information of parameter
+	 * @param value new value of parameter
+	 */
+	template <typename T>
+	void update_parameter(
+		AnyParameter& param, const BaseTag& _tag, const T& value,
+		bool do_checks = true)
+	{
 		auto& pprop = param.get_properties();
 		auto& parameter_value = param.get_value();
 		if (pprop.has_property(ParameterProperties::READONLY))
@@ -1165,6 +1155,76 @@ private:
 			method();
 	}
 
+	/** Puts the value of a parameter that has already been looked up, see
+	 * put(const Tag<T>&, const T&).
+	 *
+	 * @param param the parameter
+	 * @param _tag name information of parameter
+	 * @param value new value of parameter
+	 */
+	template <typename T>
+	void put_parameter(AnyParameter& param, const BaseTag& _tag, const T& value)
+	{
+		if (!param.get_value().cloneable())
+		{
+			error(
+				"Cannot put parameter {}::{}.", get_name(),
+				_tag.name().c_str());
+		}
+
+		update_parameter(param, _tag, value);
+	}
+
+	/** Gets the value of a parameter that has already been looked up, see
+	 * get(const Tag<T>&).
+	 *
+	 * @param param the parameter
+	 * @param _tag name information of parameter
+	 * @return value of the parameter
+	 */
+	template <typename T>
+	auto get_parameter_value(const AnyParameter& param, const BaseTag& _tag) const
+	{
+		using ReturnType = std::conditional_t<is_sg_base<T>::value, std::shared_ptr<T>, T>;
+		ReturnType result;
+
+		const auto& value = param.get_value();
+		try
+		{
+			if (param.get_properties().has_property(ParameterProperties::CONSTFUNCTION))
+			{
+				ParameterGetterInterface<ReturnType, std::function<ReturnType()>> visitor{result};
+				value.visit_with(&visitor);
+			}
+			else if (param.get_properties().has_property(ParameterProperties::AUTO))
+			{
+				ParameterGetterInterface<ReturnType, AutoValue<ReturnType>> visitor{result};
+				value.visit_with(&visitor);
+			}
+			else
+			{
+				ParameterGetterInterface<ReturnType, ReturnType> visitor{result};
+				value.visit_with(&visitor);
+			}
+		}
+		catch (const std::bad_optional_access&)
+		{
+			const auto& heuristic = param.get_init_function();
+			error("The value of parameter {}::{} is automatically computed using \"{}\" during model training, "
+				  "and is currently not set. Either set a value or read value after training.",
+				  get_name(),_tag.name(), heuristic->display_name());
+		}
+		catch (const std::logic_error&)
+		{
+			error(
+				"Cannot get parameter {}::{} of type {}, incompatible with "
+				"requested type {}.",
+				get_name(), _tag.name().c_str(), value.type().c_str(),
+				demangled_type<T>().c_str());
+		}
+		return result;
+	}
+
 	/** Getter for a class parameter, identified by a BaseTag.
 	 * Throws an exception if the class does not have such a parameter.
 	 *
@@ -1327,6 +1387,69 @@ protected:
 		int64_t m_next_subscription_index;
 	};
 
+#ifndef SWIG
+/** @brief Typed handle to a parameter of an SGObject, see
+ * SGObject::get_handle().
+ *
+ * Getting and putting through a handle behaves like SGObject::get() and
+ * SGObject::put(), including constraints and callbacks, but skips the lookup
+ * of the parameter by name. This pays off in loops that access the same
+ * parameters many times, e.g. in model selection.
+ *
+ * A handle must not outlive its object, and is invalidated when further
+ * parameters are registered, which only happens during construction.
+ */
+template <typename T>
+class ParameterHandle
+{
+	using ValueType =
+		std::conditional_t<std::is_enum<T>::value, machine_int_t, T>;
+
+public:
+	/** constructor
+	 *
+	 * @param obj object of the parameter
+	 * @param param the parameter
+	 * @param tag name information of the parameter
+	 */
+	ParameterHandle(SGObject* obj, AnyParameter* param, BaseTag tag)
+		: m_obj(obj), m_param(param), m_tag(std::move(tag))
+	{
+	}
+
+	/** @return value of the parameter */
+	auto get() const
+	{
+		if constexpr (std::is_enum<T>::value)
+			return static_cast<T>(
+				m_obj->get_parameter_value<ValueType>(*m_param, m_tag));
+		else
+			return m_obj->get_parameter_value<ValueType>(*m_param, m_tag);
+	}
+
+	/** @param value new value of the parameter */
+	void put(const T& value)
+	{
+		if constexpr (std::is_enum<T>::value)
+			m_obj->put_parameter(
+				*m_param, m_tag, static_cast<ValueType>(value));
+		else
+			m_obj->put_parameter(*m_param, m_tag, value);
+	}
+
+	/** @return name of the parameter */
+	std::string name() const
+	{
+		return m_tag.name();
+	}
+
+private:
+	SGObject* m_obj;
+	AnyParameter* m_param;
+	BaseTag m_tag;
+};
+#endif
+
 template <class T>
 std::shared_ptr<T> make_clone(std::shared_ptr<T> orig, ParameterProperties pp = ParameterProperties::ALL)
 {
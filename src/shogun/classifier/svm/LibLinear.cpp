@@ -24,6 +24,20 @@
 
 using namespace shogun;
 
+/** allocates a zero weight vector of length num_feat, followed by the bias */
+template <class T>
+static SGVector<T> zero_weights(int32_t num_feat, bool bias)
+{
+	SGVector<T> w;
+	if (bias)
+		w = SGVector<T>(SG_ALIGNED_MALLOC(T, index_t(num_feat + 1), alignment::container_alignment), num_feat);
+	else
+		w = SGVector<T>(num_feat);
+
+	memset(w.vector, 0, sizeof(T) * (w.vlen + (bias ? 1 : 0)));
+	return w;
+}
+
 LibLinear::LibLinear() : RandomMixin<LinearMachine>()
 {
 	init();
@@ -116,26 +130,13 @@ bool LibLinear::train_machine(std::shared_ptr<Features> data)
 			    num_vec, num_train_labels);
 		}
 	}
-	SGVector<float64_t> w;
-	if (get_bias_enabled())
-		w = SGVector<float64_t>(SG_ALIGNED_MALLOC(float64_t, index_t(num_feat + 1), alignment::container_alignment), num_feat);
-	else
-		w = SGVector<float64_t>(num_feat);
+	auto w = zero_weights<float64_t>(num_feat, get_bias_enabled());
 
 	liblinear_problem prob;
-	if (get_bias_enabled())
-	{
-		if (solver_type != L2R_LR_DUAL)
-			prob.n = w.vlen + 1;
-		else
-			prob.n = w.vlen;
-		memset(w.vector, 0, sizeof(float64_t) * (w.vlen + 1));
-	}
+	if (get_bias_enabled() && solver_type != L2R_LR_DUAL)
+		prob.n = w.vlen + 1;
 	else
-	{
 		prob.n = w.vlen;
-		memset(w.vector, 0, sizeof(float64_t) * (w.vlen + 0));
-	}
 	prob.l = num_vec;
 	prob.x = features;
 	prob.y = SG_MALLOC(double, prob.l);
@@ -193,12 +194,18 @@ bool LibLinear::train_machine(std::shared_ptr<Features> data)
 		break;
 	}
 	case L2R_L2LOSS_SVC_DUAL:
-		solve_l2r_l1l2_svc(
-		    w, &prob, get_epsilon(), Cp, Cn, L2R_L2LOSS_SVC_DUAL);
-		break;
 	case L2R_L1LOSS_SVC_DUAL:
-		solve_l2r_l1l2_svc(
-		    w, &prob, get_epsilon(), Cp, Cn, L2R_L1LOSS_SVC_DUAL);
+		if (use_float32(features))
+		{
+			auto w32 = zero_weights<float32_t>(num_feat, get_bias_enabled());
+			solve_l2r_l1l2_svc(
+			    w32, &prob, get_epsilon(), Cp, Cn, solver_type);
+			for (int32_t i = 0; i < prob.n; i++)
+				w[i] = w32[i];
+		}
+		else
+			solve_l2r_l1l2_svc(
+			    w, &prob, get_epsilon(), Cp, Cn, solver_type);
 		break;
 	case L1R_L2LOSS_SVC:
 	{
@@ -216,7 +223,15 @@ bool LibLinear::train_machine(std::shared_ptr<Features> data)
 	}
 	case L2R_LR_DUAL:
 	{
-		solve_l2r_lr_dual(w, &prob, get_epsilon(), Cp, Cn);
+		if (use_float32(features))
+		{
+			auto w32 = zero_weights<float32_t>(num_feat, get_bias_enabled());
+			solve_l2r_lr_dual(w32, &prob, get_epsilon(), Cp, Cn);
+			for (int32_t i = 0; i < prob.n + (prob.use_bias ? 1 : 0); i++)
+				w[i] = w32[i];
+		}
+		else
+			solve_l2r_lr_dual(w, &prob, get_epsilon(), Cp, Cn);
 		break;
 	}
 	default:
@@ -259,14 +274,15 @@ bool LibLinear::train_machine(std::shared_ptr<Features> data)
 // x, y, Cp, Cn
 // eps is the stopping tolerance
 //
-// solution will be put in w
+// solution will be put in w, which may be single precision
 
 #undef GETI
 #define GETI(i) (y[i] + 1)
 // To support weights for instances, use GETI(i) (i)
 
+template <class T>
 void LibLinear::solve_l2r_l1l2_svc(
-    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+    SGVector<T>& w, const liblinear_problem* prob, double eps,
     double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st)
 {
 	int l = prob->l;
@@ -395,7 +411,7 @@ void LibLinear::solve_l2r_l1l2_svc(
 				alpha[i] = Math::min(Math::max(alpha[i] - G / QD[i], 0.0), C);
 				d = (alpha[i] - alpha_old) * yi;
 
-				prob->x->add_to_dense_vec(d, i, w.vector, n);
+				prob->x->add_to_dense_vec((T)d, i, w.vector, n);
 
 				if (prob->use_bias)
 					w.vector[n] += d;
@@ -1199,7 +1215,7 @@ void LibLinear::solve_l1r_lr(
 // x, y, Cp, Cn
 // eps is the stopping tolerance
 //
-// solution will be put in w
+// solution will be put in w, which may be single precision
 //
 // See Algorithm 5 of Yu et al., MLJ 2010
 
@@ -1207,8 +1223,9 @@ void LibLinear::solve_l1r_lr(
 #define GETI(i) (y[i] + 1)
 // To support weights for instances, use GETI(i) (i)
 
+template <class T>
 void LibLinear::solve_l2r_lr_dual(
-    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+    SGVector<T>& w, const liblinear_problem* prob, double eps,
     double Cp, double Cn)
 {
 	int l = prob->l;
@@ -1251,7 +1268,8 @@ void LibLinear::solve_l2r_lr_dual(
 	for (i = 0; i < l; i++)
 	{
 		xTx[i] = prob->x->dot(i, prob->x, i);
-		prob->x->add_to_dense_vec(y[i] * alpha[2 * i], i, w.vector, w_size);
+		prob->x->add_to_dense_vec(
+		    (T)(y[i] * alpha[2 * i]), i, w.vector, w_size);
 
 		if (prob->use_bias)
 		{
@@ -1323,7 +1341,7 @@ void LibLinear::solve_l2r_lr_dual(
 				alpha[ind2] = C - z;
 
 				prob->x->add_to_dense_vec(
-				    sign * (z - alpha_old) * yi, i, w.vector, w_size);
+				    (T)(sign * (z - alpha_old) * yi), i, w.vector, w_size);
 
 				if (prob->use_bias)
 					w.vector[w_size] += sign * (z - alpha_old) * yi;
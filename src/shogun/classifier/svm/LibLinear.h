@@ -56,6 +56,11 @@ namespace shogun
 	 *
 	 * See the ::LIBLINEAR_SOLVER_TYPE enum for types of solvers.
 	 *
+	 * With set_float32_compute(true) and float32 features, the dual
+	 * coordinate descent solvers (L2R_L2LOSS_SVC_DUAL, L2R_L1LOSS_SVC_DUAL
+	 * and L2R_LR_DUAL) keep w in single precision, while the dual variables
+	 * and gradients stay in double precision.
+	 *
 	 * [1] http://www.csie.ntu.edu.tw/~cjlin/liblinear/
 	 * */
 	class LibLinear : public RandomMixin<LinearMachine>
@@ -230,8 +235,9 @@ namespace shogun
 		void train_one(
 		    const liblinear_problem* prob, const liblinear_parameter* param,
 		    double Cp, double Cn);
+		template <class T>
 		void solve_l2r_l1l2_svc(
-		    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+		    SGVector<T>& w, const liblinear_problem* prob, double eps,
 		    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st);
 
 		void solve_l1r_l2_svc(
@@ -240,8 +246,9 @@ namespace shogun
 		void solve_l1r_lr(
 		    SGVector<float64_t>& w, const liblinear_problem* prob_col,
 		    double eps, double Cp, double Cn);
+		template <class T>
 		void solve_l2r_lr_dual(
-		    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+		    SGVector<T>& w, const liblinear_problem* prob, double eps,
 		    double Cp, double Cn);
 
 	protected:
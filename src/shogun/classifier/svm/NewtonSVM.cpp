@@ -13,6 +13,7 @@
 #include <shogun/labels/Labels.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgLazy.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 #include <utility>
@@ -148,7 +149,6 @@ void NewtonSVM::line_search_linear(const SGVector<float64_t>& d)
 	SGVector<float64_t> Y = binary_labels(m_labels)->get_labels();
 	SGVector<float64_t> outz(x_n);
 	SGVector<float64_t> temp1(x_n);
-	SGVector<float64_t> temp1forout(x_n);
 	SGVector<float64_t> outzsv(x_n);
 	SGVector<float64_t> Ysv(x_n);
 	SGVector<float64_t> Xsv(x_n);
@@ -169,10 +169,10 @@ void NewtonSVM::line_search_linear(const SGVector<float64_t>& d)
 
 	while (1)
 	{
-		temp1 = linalg::element_prod(Y, Xd);
-		temp1forout = temp1.clone();
-		linalg::scale(temp1forout, temp1forout, t);
-		outz = linalg::add(out, temp1forout, 1.0, -1.0);
+		{
+			using namespace linalg::lazy;
+			eval(ref(out) - t * ref(Y) * ref(Xd), outz);
+		}
 
 		// Calculation of sv
 		sv_len=0;
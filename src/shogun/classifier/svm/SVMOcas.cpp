@@ -73,6 +73,11 @@ bool SVMOcas::train_machine(std::shared_ptr<Features> data)
 
 	current_w = SGVector<float64_t>(features->get_dim_feature_space());
 	current_w.zero();
+	if (use_float32(features))
+	{
+		current_w_float32 = SGVector<float32_t>(current_w.vlen);
+		current_w_float32.zero();
+	}
 
 	if (num_vec!=lab.vlen || num_vec<=0)
 		error("num_vec={} num_train_labels={}", num_vec, lab.vlen);
@@ -140,6 +145,7 @@ bool SVMOcas::train_machine(std::shared_ptr<Features> data)
 
 	SG_FREE(old_w);
 	old_w=NULL;
+	current_w_float32 = SGVector<float32_t>();
 
 	set_w(current_w);
 
@@ -160,11 +166,14 @@ float64_t SVMOcas::update_W( float64_t t, void* ptr )
   uint32_t nDim = (uint32_t) o->current_w.vlen;
   float64_t* W = o->current_w.vector;
   float64_t* oldW=o->old_w;
+  float32_t* W32 = o->current_w_float32.vector;
 
   for(uint32_t j=0; j <nDim; j++)
   {
 	  W[j] = oldW[j]*(1-t) + t*W[j];
 	  sq_norm_W += W[j]*W[j];
+	  if (W32)
+		  W32[j] = W[j];
   }
   o->bias=o->old_bias*(1-t) + t*o->bias;
   sq_norm_W += Math::sq(o->bias);
@@ -275,7 +284,14 @@ int SVMOcas::compute_output(float64_t *output, void* ptr)
 
 	float64_t* y = o->lab.vector;
 
-	f->dense_dot_range(output, 0, nData, y, o->current_w.vector, o->current_w.vlen, 0.0);
+	if (o->current_w_float32.vlen)
+	{
+		/* outputs are still accumulated into double precision */
+		f->dense_dot_range(output, 0, nData, y, o->current_w_float32.vector,
+			o->current_w_float32.vlen, 0.0);
+	}
+	else
+		f->dense_dot_range(output, 0, nData, y, o->current_w.vector, o->current_w.vlen, 0.0);
 
 	for (int32_t i=0; i<nData; i++)
 		output[i]+=y[i]*o->bias;
@@ -321,6 +337,9 @@ void SVMOcas::compute_W(
 		bias += c_bias[i]*alpha[i];
 	}
 
+	for (index_t j=0; j<o->current_w_float32.vlen; j++)
+		o->current_w_float32[j]=W[j];
+
 	*sq_norm_W = linalg::dot(W, W) + Math::sq(bias);
 	*dp_WoldW = linalg::dot(W, oldW) + bias*old_bias;
 	//io::print("nSel={} sq_norm_W={} dp_WoldW={}\n", nSel, *sq_norm_W, *dp_WoldW);
@@ -27,7 +27,12 @@ enum E_SVM_TYPE
 };
 #endif
 
-/** @brief class SVMOcas */
+/** @brief class SVMOcas
+ *
+ * With set_float32_compute(true) and float32 features, the outputs of all
+ * training vectors are computed against a single precision copy of w, while
+ * the cutting planes are kept in double precision.
+ */
 class SVMOcas : public LinearMachine
 {
 	public:
@@ -208,6 +213,9 @@ class SVMOcas : public LinearMachine
 
 		/** current W */
 		SGVector<float64_t> current_w;
+		/** single precision copy of current W, kept up to date by
+		 * compute_W and update_W while training with float32 compute */
+		SGVector<float32_t> current_w_float32;
 		/** old W */
 		float64_t* old_w;
 		/** old bias */
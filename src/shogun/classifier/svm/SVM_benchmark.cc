@@ -0,0 +1,97 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/classifier/svm/LibLinear.h"
+#include "shogun/classifier/svm/LibSVM.h"
+#include "shogun/classifier/svm/SVMLight.h"
+#include "shogun/kernel/GaussianKernel.h"
+#include "shogun/util/benchmark_data.h"
+
+namespace shogun
+{
+
+class SVMFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		feats = benchmark_data::dense_features(st.range(0), st.range(1));
+		labels = benchmark_data::binary_labels(st.range(0));
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		feats.reset();
+		labels.reset();
+	}
+
+	std::shared_ptr<DenseFeatures<float64_t>> feats;
+	std::shared_ptr<BinaryLabels> labels;
+};
+
+/** training vectors and their dimension */
+#define ADD_SVM_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(4)->Ranges({{256, 4096}, {16, 64}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(SVMFixture, LibSVM_train)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto kernel = std::make_shared<GaussianKernel>(feats, feats, 2.0 * st.range(1));
+		auto svm = std::make_shared<LibSVM>(1.0, kernel, labels);
+		svm->train();
+	}
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_SVM_ARGS(BENCHMARK_REGISTER_F(SVMFixture, LibSVM_train))
+
+#ifdef USE_SVMLIGHT
+BENCHMARK_DEFINE_F(SVMFixture, SVMLight_train)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto kernel = std::make_shared<GaussianKernel>(feats, feats, 2.0 * st.range(1));
+		auto svm = std::make_shared<SVMLight>(1.0, kernel, labels);
+		svm->train();
+	}
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_SVM_ARGS(BENCHMARK_REGISTER_F(SVMFixture, SVMLight_train))
+#endif //USE_SVMLIGHT
+
+static void LibLinear_train(
+    benchmark::State& st, const std::shared_ptr<DenseFeatures<float64_t>>& feats,
+    const std::shared_ptr<BinaryLabels>& labels, LIBLINEAR_SOLVER_TYPE solver)
+{
+	for (auto _ : st)
+	{
+		auto svm = std::make_shared<LibLinear>(solver);
+		svm->set_labels(labels);
+		svm->put("seed", benchmark_data::seed);
+		svm->train(feats);
+	}
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+
+BENCHMARK_DEFINE_F(SVMFixture, LibLinear_L2R_L2LOSS_SVC_DUAL_train)(benchmark::State& st)
+{
+	LibLinear_train(st, feats, labels, L2R_L2LOSS_SVC_DUAL);
+}
+ADD_SVM_ARGS(BENCHMARK_REGISTER_F(SVMFixture, LibLinear_L2R_L2LOSS_SVC_DUAL_train))
+
+BENCHMARK_DEFINE_F(SVMFixture, LibLinear_L2R_L1LOSS_SVC_DUAL_train)(benchmark::State& st)
+{
+	LibLinear_train(st, feats, labels, L2R_L1LOSS_SVC_DUAL);
+}
+ADD_SVM_ARGS(BENCHMARK_REGISTER_F(SVMFixture, LibLinear_L2R_L1LOSS_SVC_DUAL_train))
+
+BENCHMARK_DEFINE_F(SVMFixture, LibLinear_L2R_LR_train)(benchmark::State& st)
+{
+	LibLinear_train(st, feats, labels, L2R_LR);
+}
+ADD_SVM_ARGS(BENCHMARK_REGISTER_F(SVMFixture, LibLinear_L2R_LR_train))
+
+}
@@ -9,23 +9,127 @@
 #include <shogun/base/progress.h>
 #include <shogun/clustering/Hierarchical.h>
 #include <shogun/distance/Distance.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/Features.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/structure/DisjointSet.h>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <utility>
 
 using namespace shogun;
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct pair
+/** number of clusters from which on nearest neighbours are searched in
+ * parallel
+ */
+static constexpr int32_t PARALLEL_SEARCH_SIZE=1024;
+
+/** finds the j!=skip with active[j] that minimises f(j), where f is called
+ * exactly once for each such j. Ties go to the smallest j.
+ *
+ * @return j and f(j), or -1 if there is no such j
+ */
+template <class F>
+static std::pair<int32_t, float64_t> nearest_active(
+	const std::vector<char>& active, int32_t skip, F f)
+{
+	int32_t num=active.size();
+	int32_t best=-1;
+	float64_t best_dist=std::numeric_limits<float64_t>::infinity();
+
+#pragma omp parallel if (num>=PARALLEL_SEARCH_SIZE)
+	{
+		int32_t local=-1;
+		float64_t local_dist=std::numeric_limits<float64_t>::infinity();
+
+#pragma omp for nowait
+		for (int32_t j=0; j<num; j++)
+		{
+			if (!active[j] || j==skip)
+				continue;
+
+			auto d=f(j);
+			if (local==-1 || d<local_dist)
+			{
+				local=j;
+				local_dist=d;
+			}
+		}
+
+#pragma omp critical
+		{
+			if (local!=-1 && (best==-1 || local_dist<best_dist ||
+				(local_dist==best_dist && local<best)))
+			{
+				best=local;
+				best_dist=local_dist;
+			}
+		}
+	}
+
+	return std::make_pair(best, best_dist);
+}
+
+/** position of the distance between i<j in the condensed distance matrix */
+static inline int64_t condensed_index(int64_t num, int64_t i, int64_t j)
+{
+	return i*num-i*(i+1)/2+j-i-1;
+}
+
+template <class D, class M>
+std::vector<Hierarchical::Merge> Hierarchical::nn_chain(int32_t num, D dist, M merge)
 {
-	/** index 1 */
-	int32_t idx1;
-	/** index 2 */
-	int32_t idx2;
-};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
+	std::vector<Merge> result;
+	result.reserve(num-1);
+
+	std::vector<char> active(num, 1);
+	std::vector<int32_t> chain;
+	chain.reserve(num);
+	int32_t first_active=0;
+
+	auto pb=SG_PROGRESS(range(num-1));
+	while (int32_t(result.size())<num-1)
+	{
+		if (chain.empty())
+		{
+			while (!active[first_active])
+				first_active++;
+			chain.push_back(first_active);
+		}
+
+		auto a=chain.back();
+		auto prev=chain.size()>1 ? chain[chain.size()-2] : -1;
+		auto nearest=nearest_active(active, a, [&](int32_t j) { return dist(a, j); });
+
+		// prefer the previous element on ties, so the chain terminates
+		if (prev!=-1 && dist(a, prev)<=nearest.second)
+			nearest=std::make_pair(prev, dist(a, prev));
+
+		if (nearest.first!=prev)
+		{
+			chain.push_back(nearest.first);
+			continue;
+		}
+
+		chain.pop_back();
+		chain.pop_back();
+
+		// the cluster with the smaller element survives
+		auto keep=Math::min(a, prev);
+		auto drop=Math::max(a, prev);
+		result.push_back({keep, drop, nearest.second});
+		merge(keep, drop, nearest.second, active);
+		active[drop]=0;
+		pb.print_progress();
+	}
+	pb.complete();
+
+	return result;
+}
 
 Hierarchical::Hierarchical()
 : DistanceMachine()
@@ -46,6 +150,7 @@ Hierarchical::Hierarchical(int32_t merges_, std::shared_ptr<Distance> d)
 void Hierarchical::init()
 {
 	merges = 3;
+	m_linkage = LINKAGE_SINGLE;
 	dimensions = 0;
 	assignment = NULL;
 	assignment_len = 0;
@@ -64,6 +169,11 @@ void Hierarchical::register_parameters()
 	watch_param("table_size", &table_size);
 	watch_param("pairs", &pairs, &pairs_len);
 	watch_param("merge_distance", &merge_distance, &merge_distance_len);
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&m_linkage, "linkage", "Linkage between clusters",
+	    ParameterProperties::SETTING,
+	    SG_OPTIONS(
+	        LINKAGE_SINGLE, LINKAGE_COMPLETE, LINKAGE_AVERAGE, LINKAGE_WARD));
 }
 
 Hierarchical::~Hierarchical()
@@ -90,8 +200,25 @@ bool Hierarchical::train_machine(std::shared_ptr<Features> data)
 
 	int32_t num=lhs->get_num_vectors();
 	ASSERT(num>0)
+	require(merges<num, "Number of merges ({}) should be smaller than the "
+		"number of vectors ({})", merges, num);
+
+	std::vector<Merge> dendrogram;
+	if (m_linkage==LINKAGE_SINGLE)
+		dendrogram=single_linkage(num);
+	else if (m_linkage==LINKAGE_WARD &&
+		distance->get_distance_type()==D_EUCLIDEAN &&
+		!distance->as<EuclideanDistance>()->get_disable_sqrt() &&
+		lhs->get_feature_class()==C_DENSE && lhs->get_feature_type()==F_DREAL)
+	{
+		dendrogram=nn_chain_ward_centroids(
+			lhs->as<DenseFeatures<float64_t>>()->get_feature_matrix());
+	}
+	else
+		dendrogram=nn_chain_linkage(num);
 
-	const int32_t num_pairs=num*(num-1)/2;
+	std::stable_sort(dendrogram.begin(), dendrogram.end(),
+		[](const Merge& a, const Merge& b) { return a.distance<b.distance; });
 
 	SG_FREE(merge_distance);
 	merge_distance=SG_MALLOC(float64_t, num);
@@ -101,82 +228,170 @@ bool Hierarchical::train_machine(std::shared_ptr<Features> data)
 	SG_FREE(assignment);
 	assignment=SG_MALLOC(int32_t, num);
 	assignment_len = num;
-	SGVector<int32_t>::range_fill_vector(assignment, num);
 
 	SG_FREE(pairs);
 	pairs=SG_MALLOC(int32_t, 2*num);
 	SGVector<int32_t>::fill_vector(pairs, 2*num, -1);
 
-	pair* index=SG_MALLOC(pair, num_pairs);
-	float64_t* distances=SG_MALLOC(float64_t, num_pairs);
+	// replay the merges in order of distance, the cluster created by merge l
+	// is num+l
+	auto sets=std::make_shared<DisjointSet>(num);
+	sets->make_sets();
+	std::vector<int32_t> cluster(num);
+	std::iota(cluster.begin(), cluster.end(), 0);
 
-	int32_t offs=0;
-	for (auto i : SG_PROGRESS(range(0, num)))
+	int32_t num_merges=Math::min(num-merges+1, num-1);
+	for (int32_t l=0; l<num_merges; l++)
 	{
-		for (int32_t j=i+1; j<num; j++)
-		{
-			distances[offs] = distance->distance(i, j);
-			index[offs].idx1 = i;
-			index[offs].idx2 = j;
-			offs++; // offs=i*(i+1)/2+j
-		}
+		auto root1=sets->find_set(dendrogram[l].idx1);
+		auto root2=sets->find_set(dendrogram[l].idx2);
+		auto c1=cluster[root1];
+		auto c2=cluster[root2];
+
+		pairs[2*l]=Math::min(c1, c2);
+		pairs[2*l+1]=Math::max(c1, c2);
+		merge_distance[l]=dendrogram[l].distance;
+		cluster[sets->link_set(root1, root2)]=num+l;
+#ifdef DEBUG_HIERARCHICAL
+		io::print("l={:04} c1={:+04} c2={:+04d} c={:+04d} dist={:6.6f}\n", l, c1, c2, num+l, merge_distance[l]);
+#endif
 	}
 
-	Math::qsort_index<float64_t,pair>(distances, index, (num-1)*num/2);
-	//Math::display_vector(distances, (num-1)*num/2, "dists");
+	for (int32_t i=0; i<num; i++)
+		assignment[i]=cluster[sets->find_set(i)];
+
+	table_size=num-merges;
+	ASSERT(table_size>0)
 
-	auto pb = SG_PROGRESS(range(0, num_pairs - 1));
-	int32_t k=-1;
-	int32_t l=0;
-	for (; l<num && (num-l)>=merges && k<num_pairs-1; l++)
+	return true;
+}
+
+std::vector<Hierarchical::Merge> Hierarchical::single_linkage(int32_t num)
+{
+	// Prim's algorithm, where min_dist[j] is the distance of j to the tree
+	std::vector<Merge> result;
+	result.reserve(num-1);
+
+	std::vector<char> outside(num, 1);
+	std::vector<float64_t> min_dist(num, std::numeric_limits<float64_t>::infinity());
+	std::vector<int32_t> nearest(num, 0);
+
+	auto pb=SG_PROGRESS(range(num-1));
+	int32_t current=0;
+	outside[current]=0;
+	for (int32_t l=0; l<num-1; l++)
 	{
-		while (k<num_pairs-1)
-		{
-			k++;
+		auto next=nearest_active(outside, current, [&](int32_t j) {
+			auto d=distance->distance(current, j);
+			if (d<min_dist[j])
+			{
+				min_dist[j]=d;
+				nearest[j]=current;
+			}
+			return min_dist[j];
+		});
 
-			int32_t i=index[k].idx1;
-			int32_t j=index[k].idx2;
-			int32_t c1=assignment[i];
-			int32_t c2=assignment[j];
+		current=next.first;
+		result.push_back({nearest[current], current, next.second});
+		outside[current]=0;
+		pb.print_progress();
+	}
+	pb.complete();
 
-			if (c1==c2)
-				continue;
+	return result;
+}
 
-			pb.print_progress();
+std::vector<Hierarchical::Merge> Hierarchical::nn_chain_linkage(int32_t num)
+{
+	int64_t num_pairs=int64_t(num)*(num-1)/2;
+	std::vector<float64_t> distances(num_pairs);
 
-			if (c1<c2)
-			{
-				pairs[2*l]=c1;
-				pairs[2*l+1]=c2;
-			}
-			else
-			{
-				pairs[2*l]=c2;
-				pairs[2*l+1]=c1;
-			}
-			merge_distance[l]=distances[k];
+#pragma omp parallel for schedule(dynamic)
+	for (int32_t i=0; i<num; i++)
+	{
+		auto offs=condensed_index(num, i, i+1);
+		for (int32_t j=i+1; j<num; j++)
+			distances[offs++]=distance->distance(i, j);
+	}
+
+	auto dist=[&](int32_t i, int32_t j) -> float64_t& {
+		return i<j ? distances[condensed_index(num, i, j)] :
+			distances[condensed_index(num, j, i)];
+	};
+
+	std::vector<int32_t> sizes(num, 1);
+	auto linkage=m_linkage;
+	auto merge=[&](int32_t keep, int32_t drop, float64_t d_kd, const std::vector<char>& active) {
+		float64_t n_k=sizes[keep];
+		float64_t n_d=sizes[drop];
+
+		// Lance-Williams update of the distances to the merged cluster
+#pragma omp parallel for if (num>=PARALLEL_SEARCH_SIZE)
+		for (int32_t j=0; j<num; j++)
+		{
+			if (!active[j] || j==keep || j==drop)
+				continue;
 
-			int32_t c=num+l;
-			for (int32_t m=0; m<num; m++)
+			auto d_kj=dist(keep, j);
+			auto d_dj=dist(drop, j);
+			float64_t n_j=sizes[j];
+			switch (linkage)
 			{
-				if (assignment[m] == c1 || assignment[m] == c2)
-					assignment[m] = c;
+			case LINKAGE_COMPLETE:
+				dist(keep, j)=Math::max(d_kj, d_dj);
+				break;
+			case LINKAGE_AVERAGE:
+				dist(keep, j)=(n_k*d_kj+n_d*d_dj)/(n_k+n_d);
+				break;
+			default:
+				dist(keep, j)=std::sqrt(Math::max(0.0,
+					((n_k+n_j)*d_kj*d_kj+(n_d+n_j)*d_dj*d_dj-n_j*d_kd*d_kd)/
+					(n_k+n_d+n_j)));
+				break;
 			}
-#ifdef DEBUG_HIERARCHICAL
-			io::print("l={:04} i={:04d} j={:04d} c1={:+04} c2={:+04d} c={:+04d} dist={:6.6f}\n", l,i,j, c1,c2,c, merge_distance[l]);
-#endif
-			break;
 		}
-	}
-	pb.complete();
 
-	table_size=l-1;
-	ASSERT(table_size>0)
-	SG_FREE(distances);
-	SG_FREE(index);
+		sizes[keep]+=sizes[drop];
+	};
 
+	return nn_chain(num, [&](int32_t i, int32_t j) { return dist(i, j); }, merge);
+}
 
-	return true;
+std::vector<Hierarchical::Merge> Hierarchical::nn_chain_ward_centroids(
+	const SGMatrix<float64_t>& feats)
+{
+	int32_t num=feats.num_cols;
+	int32_t dim=feats.num_rows;
+	auto centroids=feats.clone();
+	std::vector<int32_t> sizes(num, 1);
+
+	// squared Ward distance, to be compared without the square root
+	auto dist_sq=[&](int32_t i, int32_t j) {
+		auto ci=centroids.get_column_vector(i);
+		auto cj=centroids.get_column_vector(j);
+		float64_t d=0;
+		for (int32_t k=0; k<dim; k++)
+			d+=(ci[k]-cj[k])*(ci[k]-cj[k]);
+
+		return 2.0*sizes[i]*sizes[j]/(sizes[i]+sizes[j])*d;
+	};
+
+	auto merge=[&](int32_t keep, int32_t drop, float64_t, const std::vector<char>&) {
+		float64_t n_k=sizes[keep];
+		float64_t n_d=sizes[drop];
+		auto ck=centroids.get_column_vector(keep);
+		auto cd=centroids.get_column_vector(drop);
+		for (int32_t k=0; k<dim; k++)
+			ck[k]=(n_k*ck[k]+n_d*cd[k])/(n_k+n_d);
+
+		sizes[keep]+=sizes[drop];
+	};
+
+	auto result=nn_chain(num, dist_sq, merge);
+	for (auto& m : result)
+		m.distance=std::sqrt(m.distance);
+
+	return result;
 }
 
 bool Hierarchical::load(FILE* srcfile)
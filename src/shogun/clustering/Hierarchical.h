@@ -15,15 +15,31 @@
 #include <shogun/distance/Distance.h>
 #include <shogun/machine/DistanceMachine.h>
 
+#include <vector>
+
 namespace shogun
 {
 class DistanceMachine;
 
-/** @brief Agglomerative hierarchical single linkage clustering.
+/** linkage that defines the distance between two clusters */
+enum HIERARCHICAL_LINKAGE
+{
+	/** minimum distance between the elements */
+	LINKAGE_SINGLE,
+	/** maximum distance between the elements */
+	LINKAGE_COMPLETE,
+	/** mean distance between the elements */
+	LINKAGE_AVERAGE,
+	/** increase of the within cluster variance (Ward's method) */
+	LINKAGE_WARD
+};
+
+/** @brief Agglomerative hierarchical clustering.
  *
  * Starting with each object being assigned to its own cluster clusters are
- * iteratively merged.  Here the clusters are merged whose elements have
- * minimum distance, i.e.  the clusters A and B that obtain
+ * iteratively merged.  Here the clusters are merged that have minimum
+ * distance under the chosen linkage, e.g. for single linkage (the default)
+ * the clusters A and B that obtain
  *
  * \f[
  * \min\{d({\bf x},{\bf x'}): {\bf x}\in {\cal A},{\bf x'}\in {\cal B}\}
@@ -31,7 +47,21 @@ class DistanceMachine;
  *
  * are merged.
  *
- * cf e.g. http://en.wikipedia.org/wiki/Data_clustering*/
+ * Single linkage is computed as a minimum spanning tree (Prim's algorithm on
+ * the implicit complete graph), whose edges sorted by length are the merges.
+ * It evaluates each distance once and needs O(n) memory. Complete, average
+ * and Ward linkage use the nearest-neighbour chain algorithm with
+ * Lance-Williams updates of the distances between clusters, which needs
+ * the n(n-1)/2 distances. Ward linkage on DenseFeatures<float64_t> with
+ * EuclideanDistance instead keeps the cluster centroids and needs O(nd)
+ * memory. Distances are computed in parallel.
+ *
+ * Ward merge distances are \f$\sqrt{2|A||B|/(|A|+|B|)}\,\|c_A-c_B\|\f$
+ * for centroids \f$c_A, c_B\f$, which is the distance for singletons.
+ *
+ * cf e.g. http://en.wikipedia.org/wiki/Data_clustering and
+ * D. Muellner, Modern hierarchical, agglomerative clustering algorithms,
+ * arXiv:1109.2378, 2011*/
 class Hierarchical : public DistanceMachine
 {
 	public:
@@ -85,6 +115,24 @@ class Hierarchical : public DistanceMachine
 		 */
 		int32_t get_merges();
 
+		/** set linkage
+		 *
+		 * @param linkage linkage between clusters
+		 */
+		void set_linkage(HIERARCHICAL_LINKAGE linkage)
+		{
+			m_linkage=linkage;
+		}
+
+		/** get linkage
+		 *
+		 * @return linkage between clusters
+		 */
+		HIERARCHICAL_LINKAGE get_linkage() const
+		{
+			return m_linkage;
+		}
+
 		/** get assignment
 		 *
 		 */
@@ -119,6 +167,42 @@ class Hierarchical : public DistanceMachine
 		 */
 		virtual bool train_machine(std::shared_ptr<Features> data=NULL);
 
+#ifndef SWIG
+		/** merge of two clusters, represented by one of their elements */
+		struct Merge
+		{
+			int32_t idx1;
+			int32_t idx2;
+			float64_t distance;
+		};
+
+		/** @return merges of single linkage, in no particular order */
+		std::vector<Merge> single_linkage(int32_t num);
+
+		/** @return merges of complete, average or Ward linkage using a
+		 * nearest-neighbour chain on all distances, in no particular order
+		 */
+		std::vector<Merge> nn_chain_linkage(int32_t num);
+
+		/** @return merges of Ward linkage using a nearest-neighbour chain on
+		 * the centroids of the features, in no particular order
+		 */
+		std::vector<Merge> nn_chain_ward_centroids(
+		    const SGMatrix<float64_t>& feats);
+
+		/** runs the nearest-neighbour chain algorithm
+		 *
+		 * @param num number of elements
+		 * @param dist distance between the clusters represented by two
+		 * elements
+		 * @param merge merges the cluster of the second element into the
+		 * cluster of the first one
+		 * @return merges in no particular order
+		 */
+		template <class D, class M>
+		std::vector<Merge> nn_chain(int32_t num, D dist, M merge);
+#endif
+
 	private:
 		/** Initialize attributes */
 		void init();
@@ -130,6 +214,9 @@ class Hierarchical : public DistanceMachine
 		/// the number of merges in hierarchical clustering
 		int32_t merges;
 
+		/// linkage between clusters
+		HIERARCHICAL_LINKAGE m_linkage;
+
 		/// number of dimensions
 		int32_t dimensions;
 
@@ -15,6 +15,7 @@
 #include <shogun/io/SGIO.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
+#include <limits>
 #include <utility>
 
 using namespace Eigen;
@@ -26,20 +27,32 @@ namespace shogun
 
 KMeans::KMeans():KMeansBase()
 {
+	init();
 }
 
 KMeans::KMeans(int32_t k_i, std::shared_ptr<Distance> d_i, bool use_kmpp_i):KMeansBase(k_i, std::move(d_i), use_kmpp_i)
 {
+	init();
 }
 
 KMeans::KMeans(int32_t k_i, std::shared_ptr<Distance> d_i, SGMatrix<float64_t> centers_i):KMeansBase(k_i, std::move(d_i), centers_i)
 {
+	init();
 }
 
 KMeans::~KMeans()
 {
 }
 
+void KMeans::init()
+{
+	m_solver=KMEANS_LLOYD;
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&m_solver, "solver", "Algorithm used for training",
+	    ParameterProperties::SETTING,
+	    SG_OPTIONS(KMEANS_LLOYD, KMEANS_ELKAN, KMEANS_HAMERLY));
+}
+
 void KMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 {
 	auto lhs =
@@ -73,116 +86,437 @@ void KMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 		auto rhs_mus = std::make_shared<DenseFeatures<float64_t>>(centers.clone());
 		distance->replace_rhs(rhs_mus);
 
-#pragma omp parallel for firstprivate(lhs_size, dim, num_centers) \
-		shared(centers, cluster_assignments, weights_set) \
-		reduction(+:changed) if (!fixed_centers)
-		/* Assigment step : Assign each point to nearest cluster */
+		/* Assigment step : Assign each point to nearest cluster. The
+		 * distances are to the centers at the start of the iteration, so
+		 * all of them are computed in tiles at once. */
+		SGVector<float64_t> min_dists;
+		auto nearest=distance->nearest_rhs(min_dists);
+
 		for (int32_t i=0; i<lhs_size; i++)
 		{
 			const int32_t cluster_assignments_i=cluster_assignments[i];
-			int32_t min_cluster, j;
-			float64_t min_dist, dist;
+			const int32_t min_cluster=nearest[i];
+			if (min_cluster==cluster_assignments_i)
+				continue;
+
+			changed++;
+			++weights_set[min_cluster];
+			--weights_set[cluster_assignments_i];
+			cluster_assignments[i]=min_cluster;
+
+			if (!fixed_centers)
+				continue;
+
+			/* with fixed centers, the reassigned point moves the centers
+			 * right away */
+			SGVector<float64_t>vec=lhs->get_feature_vector(i);
+			float64_t temp_min = 1.0 / weights_set[min_cluster];
+
+			/* mu_new = mu_old + (x - mu_old)/(w) */
+			for (int32_t j=0; j<dim; j++)
+			{
+				centers(j, min_cluster)+=
+					(vec[j]-centers(j, min_cluster))*temp_min;
+			}
 
-			min_cluster=0;
-		   	min_dist=distance->distance(i,0);
-			for (j=1; j<num_centers; j++)
+			/* mu_new = mu_old - (x - mu_old)/(w-1) */
+			/* if weights_set(j)~=0 */
+			if (weights_set[cluster_assignments_i]!=0)
 			{
-				dist=distance->distance(i,j);
-				if (dist<min_dist)
+				float64_t temp_i = 1.0 / weights_set[cluster_assignments_i];
+
+				for (int32_t j=0; j<dim; j++)
 				{
-					min_dist=dist;
-					min_cluster=j;
+					centers(j, cluster_assignments_i)-=
+						(vec[j]-centers(j, cluster_assignments_i))*temp_i;
 				}
 			}
+			else
+			{
+				centers.get_column(cluster_assignments_i).zero();
+			}
+			lhs->free_feature_vector(vec, i);
+		}
+		if(changed==0)
+			break;
+
+		/* Update Step : Calculate new means */
+		if (!fixed_centers)
+			update_centers(centers, cluster_assignments, weights_set);
+
+		observe<SGMatrix<float64_t>>(iter, "cluster_centers");
+
+		if (iter%(max_iter/10) == 0)
+			io::info("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed);
+	}
+	distance->reset_precompute();
+	distance->replace_rhs(rhs_cache);
+
+
+}
+
+void KMeans::update_centers(
+	SGMatrix<float64_t> centers, const SGVector<int32_t>& cluster_assignments,
+	const SGVector<int64_t>& weights_set)
+{
+	auto lhs=distance->get_lhs()->as<DenseFeatures<float64_t>>();
+	centers.zero();
+
+	for (int32_t i=0; i<cluster_assignments.vlen; i++)
+	{
+		int32_t cluster_i=cluster_assignments[i];
+
+		auto vec = lhs->get_feature_vector(i);
+		linalg::add_col_vec(centers, cluster_i, vec, centers);
+		lhs->free_feature_vector(vec, i);
+	}
+
+	for (int32_t i=0; i<centers.num_cols; i++)
+	{
+		if (weights_set[i]!=0)
+		{
+			auto col = centers.get_column(i);
+			linalg::scale(col, col, 1.0 / weights_set[i]);
+		}
+	}
+}
+
+namespace
+{
+	/** Euclidean distance of two dense vectors */
+	float64_t euclidean(const float64_t* a, const float64_t* b, int32_t dim)
+	{
+		float64_t sum=0;
+		for (int32_t j=0; j<dim; j++)
+			sum+=Math::sq(a[j]-b[j]);
+		return std::sqrt(sum);
+	}
+
+	/** pairwise distances of the centers and half the distance of every
+	 * center to its closest other center: points closer than that to their
+	 * own center cannot be closer to any other center
+	 */
+	void center_distances(
+		const SGMatrix<float64_t>& centers, SGMatrix<float64_t>& cc,
+		SGVector<float64_t>& half_min)
+	{
+		const int32_t num_centers=centers.num_cols;
+		const int32_t dim=centers.num_rows;
 
-			if (min_cluster!=cluster_assignments_i)
+#pragma omp parallel for schedule(static)
+		for (int32_t c=0; c<num_centers; c++)
+		{
+			half_min[c]=std::numeric_limits<float64_t>::infinity();
+			for (int32_t c2=0; c2<num_centers; c2++)
 			{
-				changed++;
-#pragma omp atomic
-				++weights_set[min_cluster];
-#pragma omp atomic
-				--weights_set[cluster_assignments_i];
+				cc(c2, c)=c2==c ? 0 : euclidean(
+					centers.get_column_vector(c), centers.get_column_vector(c2), dim);
+				if (c2!=c)
+					half_min[c]=Math::min(half_min[c], 0.5*cc(c2, c));
+			}
+		}
+	}
 
-				if(fixed_centers)
-				{
-					SGVector<float64_t>vec=lhs->get_feature_vector(i);
-					float64_t temp_min = 1.0 / weights_set[min_cluster];
+	/** distance every center moved in the update step */
+	SGVector<float64_t> center_drift(
+		const SGMatrix<float64_t>& old_centers, const SGMatrix<float64_t>& centers)
+	{
+		SGVector<float64_t> drift(centers.num_cols);
+		for (int32_t c=0; c<centers.num_cols; c++)
+		{
+			drift[c]=euclidean(
+				old_centers.get_column_vector(c), centers.get_column_vector(c),
+				centers.num_rows);
+		}
+		return drift;
+	}
 
-					/* mu_new = mu_old + (x - mu_old)/(w) */
-					for (j=0; j<dim; j++)
-					{
-						centers(j, min_cluster)+=
-							(vec[j]-centers(j, min_cluster))*temp_min;
-					}
+	/** number of points in every cluster */
+	void count_weights(
+		const SGVector<int32_t>& cluster_assignments, SGVector<int64_t>& weights_set)
+	{
+		weights_set.zero();
+		for (int32_t i=0; i<cluster_assignments.vlen; i++)
+			++weights_set[cluster_assignments[i]];
+	}
+}
+
+void KMeans::Elkan_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	auto lhs=distance->get_lhs()->as<DenseFeatures<float64_t>>();
+	const int32_t lhs_size=lhs->get_num_vectors();
+	const int32_t dim=lhs->get_num_features();
+	auto data=lhs->get_feature_matrix_block(0, lhs_size);
+
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	SGVector<int64_t> weights_set(num_centers);
+	/* upper bound on the distance of every point to its center */
+	SGVector<float64_t> upper(lhs_size);
+	/* lower bounds on the distances of every point to all centers */
+	SGMatrix<float64_t> lower(num_centers, lhs_size);
+	SGMatrix<float64_t> cc(num_centers, num_centers);
+	SGVector<float64_t> half_min(num_centers);
+
+	center_distances(centers, cc, half_min);
 
-					lhs->free_feature_vector(vec, i);
+	int32_t changed=0;
 
-					/* mu_new = mu_old - (x - mu_old)/(w-1) */
-					/* if weights_set(j)~=0 */
-					if (weights_set[cluster_assignments_i]!=0)
+	/* Initial assignment : centers far from the best one so far are skipped */
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:changed)
+	for (int32_t i=0; i<lhs_size; i++)
+	{
+		const float64_t* x=data.get_column_vector(i);
+		float64_t* l=lower.get_column_vector(i);
+
+		int32_t a=0;
+		float64_t u=euclidean(x, centers.get_column_vector(0), dim);
+		l[0]=u;
+		for (int32_t c=1; c<num_centers; c++)
+		{
+			if (cc(c, a)>2*u)
+			{
+				l[c]=cc(c, a)-u;
+				continue;
+			}
+
+			l[c]=euclidean(x, centers.get_column_vector(c), dim);
+			if (l[c]<u)
+			{
+				u=l[c];
+				a=c;
+			}
+		}
+
+		upper[i]=u;
+		cluster_assignments[i]=a;
+		if (a!=0)
+			changed++;
+	}
+
+	for (auto iter : SG_PROGRESS(range(max_iter)))
+	{
+		if (iter==max_iter-1)
+			io::warn("KMeans clustering has reached maximum number of ( {} ) iterations without having converged. \
+				   	Terminating. ", iter);
+
+		/* Assigment step : distances are only computed where the bounds fail */
+		if (iter>0)
+		{
+			changed=0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:changed)
+			for (int32_t i=0; i<lhs_size; i++)
+			{
+				const int32_t old_a=cluster_assignments[i];
+				float64_t u=upper[i];
+				if (u<half_min[old_a])
+					continue;
+
+				const float64_t* x=data.get_column_vector(i);
+				float64_t* l=lower.get_column_vector(i);
+				int32_t a=old_a;
+				bool tight=false;
+
+				for (int32_t c=0; c<num_centers; c++)
+				{
+					if (c==a || u<l[c] || u<0.5*cc(c, a))
+						continue;
+
+					if (!tight)
 					{
-						float64_t temp_i = 1.0 / weights_set[cluster_assignments_i];
-						SGVector<float64_t>vec1=lhs->get_feature_vector(i);
-
-						for (j=0; j<dim; j++)
-						{
-							centers(j, cluster_assignments_i)-=
-								(vec1[j]-centers(j, cluster_assignments_i))*temp_i;
-						}
-						lhs->free_feature_vector(vec1, i);
+						u=euclidean(x, centers.get_column_vector(a), dim);
+						l[a]=u;
+						tight=true;
+						if (u<l[c] || u<0.5*cc(c, a))
+							continue;
 					}
-					else
+
+					l[c]=euclidean(x, centers.get_column_vector(c), dim);
+					/* ties go to the smaller index as in Lloyd's algorithm */
+					if (l[c]<u || (l[c]==u && c<a))
 					{
-						centers.get_column(cluster_assignments_i).zero();
+						u=l[c];
+						a=c;
 					}
-
 				}
 
-				cluster_assignments[i] = min_cluster;
+				upper[i]=u;
+				if (a!=old_a)
+				{
+					cluster_assignments[i]=a;
+					changed++;
+				}
 			}
 		}
+
 		if(changed==0)
 			break;
 
-		/* Update Step : Calculate new means */
-		if (!fixed_centers)
+		/* Update Step : Calculate new means and loosen the bounds */
+		count_weights(cluster_assignments, weights_set);
+		auto old_centers=centers.clone();
+		update_centers(centers, cluster_assignments, weights_set);
+		auto drift=center_drift(old_centers, centers);
+
+#pragma omp parallel for schedule(static)
+		for (int32_t i=0; i<lhs_size; i++)
 		{
-			centers.zero();
+			float64_t* l=lower.get_column_vector(i);
+			for (int32_t c=0; c<num_centers; c++)
+				l[c]=Math::max(l[c]-drift[c], 0.0);
+			upper[i]+=drift[cluster_assignments[i]];
+		}
 
-			for (int32_t i=0; i<lhs_size; i++)
-			{
-				int32_t cluster_i=cluster_assignments[i];
+		center_distances(centers, cc, half_min);
 
-				auto vec = lhs->get_feature_vector(i);
-				linalg::add_col_vec(centers, cluster_i, vec, centers);
-				lhs->free_feature_vector(vec, i);
+		observe<SGMatrix<float64_t>>(iter, "cluster_centers");
+
+		if (max_iter>=10 && iter%(max_iter/10) == 0)
+			io::info("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed);
+	}
+}
+
+void KMeans::Hamerly_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	auto lhs=distance->get_lhs()->as<DenseFeatures<float64_t>>();
+	const int32_t lhs_size=lhs->get_num_vectors();
+	const int32_t dim=lhs->get_num_features();
+	auto data=lhs->get_feature_matrix_block(0, lhs_size);
+
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	SGVector<int64_t> weights_set(num_centers);
+	/* upper bound on the distance of every point to its center */
+	SGVector<float64_t> upper(lhs_size);
+	/* lower bound on the distance of every point to its second closest center */
+	SGVector<float64_t> lower(lhs_size);
+	SGMatrix<float64_t> cc(num_centers, num_centers);
+	SGVector<float64_t> half_min(num_centers);
+
+	/* closest and second closest center of a point, ties go to the smaller
+	 * index as in Lloyd's algorithm */
+	auto assign=[&](int32_t i) {
+		const float64_t* x=data.get_column_vector(i);
+		int32_t a=0;
+		float64_t d1=std::numeric_limits<float64_t>::infinity();
+		float64_t d2=d1;
+		for (int32_t c=0; c<num_centers; c++)
+		{
+			auto d=euclidean(x, centers.get_column_vector(c), dim);
+			if (d<d1)
+			{
+				d2=d1;
+				d1=d;
+				a=c;
 			}
+			else if (d<d2)
+				d2=d;
+		}
+		upper[i]=d1;
+		lower[i]=d2;
+		return a;
+	};
+
+	int32_t changed=0;
+
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:changed)
+	for (int32_t i=0; i<lhs_size; i++)
+	{
+		cluster_assignments[i]=assign(i);
+		if (cluster_assignments[i]!=0)
+			changed++;
+	}
 
-			for (int32_t i=0; i<num_centers; i++)
+	for (auto iter : SG_PROGRESS(range(max_iter)))
+	{
+		if (iter==max_iter-1)
+			io::warn("KMeans clustering has reached maximum number of ( {} ) iterations without having converged. \
+				   	Terminating. ", iter);
+
+		/* Assigment step : distances are only computed where the bounds fail */
+		if (iter>0)
+		{
+			center_distances(centers, cc, half_min);
+
+			changed=0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:changed)
+			for (int32_t i=0; i<lhs_size; i++)
 			{
-				if (weights_set[i]!=0)
+				const int32_t old_a=cluster_assignments[i];
+				const float64_t bound=Math::max(half_min[old_a], lower[i]);
+				if (upper[i]<bound)
+					continue;
+
+				upper[i]=euclidean(
+					data.get_column_vector(i), centers.get_column_vector(old_a), dim);
+				if (upper[i]<bound)
+					continue;
+
+				auto a=assign(i);
+				if (a!=old_a)
 				{
-					auto col = centers.get_column(i);
-					linalg::scale(col, col, 1.0 / weights_set[i]);
+					cluster_assignments[i]=a;
+					changed++;
 				}
 			}
 		}
 
+		if(changed==0)
+			break;
+
+		/* Update Step : Calculate new means and loosen the bounds */
+		count_weights(cluster_assignments, weights_set);
+		auto old_centers=centers.clone();
+		update_centers(centers, cluster_assignments, weights_set);
+		auto drift=center_drift(old_centers, centers);
+
+		/* largest drift, and the second largest for points of that center */
+		int32_t max_c=0;
+		float64_t max_drift=0, second_drift=0;
+		for (int32_t c=0; c<num_centers; c++)
+		{
+			if (drift[c]>max_drift)
+			{
+				second_drift=max_drift;
+				max_drift=drift[c];
+				max_c=c;
+			}
+			else if (drift[c]>second_drift)
+				second_drift=drift[c];
+		}
+
+#pragma omp parallel for schedule(static)
+		for (int32_t i=0; i<lhs_size; i++)
+		{
+			const int32_t a=cluster_assignments[i];
+			upper[i]+=drift[a];
+			lower[i]-=a==max_c ? second_drift : max_drift;
+		}
+
 		observe<SGMatrix<float64_t>>(iter, "cluster_centers");
 
-		if (iter%(max_iter/10) == 0)
+		if (max_iter>=10 && iter%(max_iter/10) == 0)
 			io::info("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed);
 	}
-	distance->reset_precompute();
-	distance->replace_rhs(rhs_cache);
-
-
 }
 
 bool KMeans::train_machine(std::shared_ptr<Features> data)
 {
 	initialize_training(data);
-	Lloyd_KMeans(cluster_centers, k);
+
+	if (m_solver==KMEANS_LLOYD || fixed_centers)
+		Lloyd_KMeans(cluster_centers, k);
+	else
+	{
+		require(distance->get_distance_type()==D_EUCLIDEAN,
+			"The {} solver relies on the triangle inequality and requires "
+			"EuclideanDistance, got {}", m_solver==KMEANS_ELKAN ? "Elkan" : "Hamerly",
+			distance->get_name());
+
+		if (m_solver==KMEANS_ELKAN)
+			Elkan_KMeans(cluster_centers, k);
+		else
+			Hamerly_KMeans(cluster_centers, k);
+	}
+
 	compute_cluster_variances();
 	auto cluster_centres =
 		std::make_shared<DenseFeatures<float64_t>>(cluster_centers);
@@ -19,6 +19,17 @@
 
 namespace shogun
 {
+	/** algorithm used for training KMeans */
+	enum KMEANS_SOLVER
+	{
+		/** Lloyd's algorithm, all point to center distances per iteration */
+		KMEANS_LLOYD,
+		/** Elkan's algorithm, one lower bound per point and center */
+		KMEANS_ELKAN,
+		/** Hamerly's algorithm, a single lower bound per point */
+		KMEANS_HAMERLY
+	};
+
 class KMeansBase;
 
 /** @brief KMeans clustering,  partitions the data into k (a-priori specified) clusters.
@@ -35,6 +46,19 @@ class KMeansBase;
  *
  * To use mini-batch based training was see KMeansMiniBatch 
  *
+ * Besides Lloyd's algorithm, the solvers KMEANS_ELKAN and KMEANS_HAMERLY
+ * are available. They keep upper and lower bounds on the distances of
+ * every point to the centers and use the triangle inequality together with
+ * the drift of the centers to skip most distance evaluations once the
+ * clusters stabilise. Both lead to the same clustering as Lloyd's
+ * algorithm (up to rounding and ties), but require a EuclideanDistance.
+ * Elkan's algorithm stores k bounds per point and prunes best for many
+ * clusters, Hamerly's algorithm stores a single bound per point. With
+ * fixed_centers, Lloyd's algorithm is always used.
+ *
+ * cf. Elkan, C. (2003). Using the Triangle Inequality to Accelerate
+ * k-Means. ICML.
+ * cf. Hamerly, G. (2010). Making k-means even faster. SDM.
  * cf. http://en.wikipedia.org/wiki/K-means_algorithm
  * cf. http://en.wikipedia.org/wiki/Lloyd's_algorithm
  *
@@ -67,8 +91,26 @@ class KMeans : public KMeansBase
 		/** @return object name */
 		virtual const char* get_name() const { return "KMeans"; }		
 
+		/** @return the algorithm used for training */
+		KMEANS_SOLVER get_solver_type() const
+		{
+			return m_solver;
+		}
+
+		/** set the algorithm used for training
+		 *
+		 * @param solver algorithm
+		 */
+		void set_solver_type(KMEANS_SOLVER solver)
+		{
+			m_solver=solver;
+		}
+
 	private:
 
+		/** register parameters */
+		void init();
+
 		/** train k-means
 		 *
 		 * @param data training data (parameter can be avoided if distance or
@@ -82,6 +124,30 @@ class KMeans : public KMeansBase
 		/** Lloyd's KMeans training method
 		 */
 		void Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Elkan's KMeans training method
+		 */
+		void Elkan_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Hamerly's KMeans training method
+		 */
+		void Hamerly_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Update step : set centers to the means of their points. Centers
+		 * of empty clusters are set to zero.
+		 *
+		 * @param centers cluster centers (output)
+		 * @param cluster_assignments cluster of every point
+		 * @param weights_set number of points in every cluster
+		 */
+		void update_centers(
+			SGMatrix<float64_t> centers,
+			const SGVector<int32_t>& cluster_assignments,
+			const SGVector<int64_t>& weights_set);
+
+	private:
+		/** training algorithm */
+		KMEANS_SOLVER m_solver;
 };
 }
 #endif
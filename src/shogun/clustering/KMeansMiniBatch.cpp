@@ -63,17 +63,25 @@ void KMeansMiniBatch::minibatch_KMeans()
 	SGVector<float64_t> v=SGVector<float64_t>(k);
 	v.zero();
 
+	SGMatrix<float64_t> batch(dims, batch_size);
+	auto batch_feats=std::make_shared<DenseFeatures<float64_t>>(batch);
+
 	for (auto i : SG_PROGRESS(range(max_iter)))
 	{
 		SGVector<int32_t> M=mbchoose_rand(batch_size,XSize);
-		SGVector<int32_t> ncent=SGVector<int32_t>(batch_size);
 		for (int32_t j=0; j<batch_size; j++)
 		{
-			SGVector<float64_t> dists=SGVector<float64_t>(k);
-			for (int32_t p=0; p<k; p++)
-				dists[p]=distance->distance(M[j],p);
-			ncent[j] = Math::arg_min(dists.vector, 1, dists.vlen);
+			SGVector<float64_t> x=lhs->get_feature_vector(M[j]);
+			sg_memcpy(batch.get_column_vector(j), x.vector, dims*sizeof(float64_t));
+			lhs->free_feature_vector(x, M[j]);
 		}
+
+		/* batch-to-center distances in tiles, centers moved since last time */
+		distance->replace_lhs(batch_feats);
+		distance->precompute_rhs();
+		SGVector<float64_t> min_dists;
+		SGVector<int32_t> ncent=distance->nearest_rhs(min_dists);
+
 		for (int32_t j=0; j<batch_size; j++)
 		{
 			int32_t near=ncent[j];
@@ -87,6 +95,7 @@ void KMeansMiniBatch::minibatch_KMeans()
 		observe<SGMatrix<float64_t>>(i, "cluster_centers");
 	}
 
+	distance->replace_lhs(lhs);
 	distance->replace_rhs(rhs_cache);
 }
 
@@ -0,0 +1,41 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/clustering/KMeans.h"
+#include "shogun/distance/EuclideanDistance.h"
+#include "shogun/util/benchmark_data.h"
+
+namespace shogun
+{
+
+/** clusters range(0) vectors of dimension 32 from range(1) blobs into
+ * range(1) clusters
+ */
+static void BM_KMeans_train(benchmark::State& state, KMEANS_SOLVER solver)
+{
+	auto num_clusters = state.range(1);
+	auto feats = benchmark_data::dense_features(state.range(0), 32, num_clusters);
+
+	for (auto _ : state)
+	{
+		auto distance = std::make_shared<EuclideanDistance>(feats, feats);
+		auto kmeans = std::make_shared<KMeans>(num_clusters, distance);
+		kmeans->set_solver_type(solver);
+		kmeans->put("max_iter", 50);
+		kmeans->put("seed", benchmark_data::seed);
+		kmeans->train();
+	}
+	state.SetItemsProcessed(state.iterations() * feats->get_num_vectors());
+}
+
+#define ADD_KMEANS_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(4)->Ranges({{1024, 16384}, {4, 64}})->Unit(benchmark::kMillisecond);
+
+ADD_KMEANS_ARGS(BENCHMARK_CAPTURE(BM_KMeans_train, Lloyd, KMEANS_LLOYD))
+ADD_KMEANS_ARGS(BENCHMARK_CAPTURE(BM_KMeans_train, Elkan, KMEANS_ELKAN))
+ADD_KMEANS_ARGS(BENCHMARK_CAPTURE(BM_KMeans_train, Hamerly, KMEANS_HAMERLY))
+
+}
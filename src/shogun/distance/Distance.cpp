@@ -21,7 +21,11 @@
 #include <shogun/distance/Distance.h>
 #include <shogun/features/Features.h>
 
+#include <algorithm>
+#include <limits>
 #include <string.h>
+#include <utility>
+#include <vector>
 #ifndef _WIN32
 #include <unistd.h>
 #endif
@@ -35,6 +39,12 @@
 
 using namespace shogun;
 
+namespace
+{
+	/** number of vectors per side of a distance tile */
+	constexpr index_t DISTANCE_BLOCK_SIZE=256;
+}
+
 Distance::Distance() : SGObject()
 {
 	init();
@@ -345,5 +355,199 @@ SGMatrix<T> Distance::get_distance_matrix()
 	return SGMatrix<T>(result,m,n,true);
 }
 
+void Distance::compute_distance_block(
+	index_t lhs_begin, index_t lhs_end, index_t rhs_begin, index_t rhs_end,
+	SGMatrix<float64_t>& block)
+{
+	for (index_t j=rhs_begin; j<rhs_end; ++j)
+	{
+		for (index_t i=lhs_begin; i<lhs_end; ++i)
+			block(i-lhs_begin, j-rhs_begin)=this->distance(i, j);
+	}
+}
+
+SGVector<index_t> Distance::nearest_rhs(SGVector<float64_t>& min_dists)
+{
+	require(has_features(), "no features assigned to distance");
+
+	const index_t m=get_num_vec_lhs();
+	const index_t n=get_num_vec_rhs();
+	require(n>0, "No vectors on right hand side");
+
+	SGVector<index_t> nearest(m);
+	min_dists=SGVector<float64_t>(m);
+	const index_t num_blocks=(m+DISTANCE_BLOCK_SIZE-1)/DISTANCE_BLOCK_SIZE;
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_blocks; ++b)
+	{
+		const index_t lhs_begin=b*DISTANCE_BLOCK_SIZE;
+		const index_t n_lhs=std::min(DISTANCE_BLOCK_SIZE, m-lhs_begin);
+		SGMatrix<float64_t> buffer(n_lhs, std::min(DISTANCE_BLOCK_SIZE, n));
+
+		float64_t* best=min_dists.vector+lhs_begin;
+		index_t* best_idx=nearest.vector+lhs_begin;
+		std::fill_n(best, n_lhs, std::numeric_limits<float64_t>::infinity());
+		std::fill_n(best_idx, n_lhs, 0);
+
+		for (index_t rhs_begin=0; rhs_begin<n; rhs_begin+=DISTANCE_BLOCK_SIZE)
+		{
+			const index_t n_rhs=std::min(DISTANCE_BLOCK_SIZE, n-rhs_begin);
+			SGMatrix<float64_t> tile(buffer.matrix, n_lhs, n_rhs, false);
+			compute_distance_block(
+				lhs_begin, lhs_begin+n_lhs, rhs_begin, rhs_begin+n_rhs, tile);
+
+			// running minimum over the columns, branch free so that it
+			// vectorizes along the contiguous lhs dimension
+			for (index_t j=0; j<n_rhs; ++j)
+			{
+				const float64_t* col=tile.get_column_vector(j);
+				const index_t idx=rhs_begin+j;
+#pragma omp simd
+				for (index_t i=0; i<n_lhs; ++i)
+				{
+					const bool closer=col[i]<best[i];
+					best[i]=closer ? col[i] : best[i];
+					best_idx[i]=closer ? idx : best_idx[i];
+				}
+			}
+		}
+	}
+
+	return nearest;
+}
+
+SGVector<index_t> Distance::nearest_lhs(
+	SGVector<float64_t>& min_dists, index_t rhs_begin, index_t rhs_end)
+{
+	require(has_features(), "no features assigned to distance");
+
+	const index_t m=get_num_vec_lhs();
+	if (rhs_end<0)
+		rhs_end=get_num_vec_rhs();
+	require(m>0, "No vectors on left hand side");
+	require(rhs_begin>=0 && rhs_begin<=rhs_end && rhs_end<=get_num_vec_rhs(),
+		"Invalid range [{}, {}) of {} right hand side vectors!", rhs_begin,
+		rhs_end, get_num_vec_rhs());
+
+	const index_t n=rhs_end-rhs_begin;
+	SGVector<index_t> nearest(n);
+	min_dists=SGVector<float64_t>(n);
+	const index_t num_blocks=(n+DISTANCE_BLOCK_SIZE-1)/DISTANCE_BLOCK_SIZE;
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_blocks; ++b)
+	{
+		const index_t block_begin=b*DISTANCE_BLOCK_SIZE;
+		const index_t n_rhs=std::min(DISTANCE_BLOCK_SIZE, n-block_begin);
+		const index_t rhs_offset=rhs_begin+block_begin;
+		SGMatrix<float64_t> buffer(std::min(DISTANCE_BLOCK_SIZE, m), n_rhs);
+
+		float64_t* best=min_dists.vector+block_begin;
+		index_t* best_idx=nearest.vector+block_begin;
+		std::fill_n(best, n_rhs, std::numeric_limits<float64_t>::infinity());
+		std::fill_n(best_idx, n_rhs, 0);
+
+		for (index_t lhs_begin=0; lhs_begin<m; lhs_begin+=DISTANCE_BLOCK_SIZE)
+		{
+			const index_t n_lhs=std::min(DISTANCE_BLOCK_SIZE, m-lhs_begin);
+			SGMatrix<float64_t> tile(buffer.matrix, n_lhs, n_rhs, false);
+			compute_distance_block(
+				lhs_begin, lhs_begin+n_lhs, rhs_offset, rhs_offset+n_rhs, tile);
+
+			// minimum of every column as a vectorized reduction, its
+			// position is only searched if it improves the running minimum
+			for (index_t j=0; j<n_rhs; ++j)
+			{
+				const float64_t* col=tile.get_column_vector(j);
+				float64_t col_min=std::numeric_limits<float64_t>::infinity();
+#pragma omp simd reduction(min:col_min)
+				for (index_t i=0; i<n_lhs; ++i)
+					col_min=col[i]<col_min ? col[i] : col_min;
+
+				if (col_min<best[j])
+				{
+					best[j]=col_min;
+					best_idx[j]=lhs_begin+(std::find(col, col+n_lhs, col_min)-col);
+				}
+			}
+		}
+	}
+
+	return nearest;
+}
+
+SGMatrix<index_t> Distance::k_nearest_lhs(
+	int32_t k, index_t rhs_begin, index_t rhs_end)
+{
+	require(has_features(), "no features assigned to distance");
+
+	const index_t m=get_num_vec_lhs();
+	if (rhs_end<0)
+		rhs_end=get_num_vec_rhs();
+	require(k>0 && k<=m,
+		"K ({}) must be positive and not larger than the number of left hand "
+		"side vectors ({}).", k, m);
+	require(rhs_begin>=0 && rhs_begin<=rhs_end && rhs_end<=get_num_vec_rhs(),
+		"Invalid range [{}, {}) of {} right hand side vectors!", rhs_begin,
+		rhs_end, get_num_vec_rhs());
+
+	const index_t n=rhs_end-rhs_begin;
+
+	SGMatrix<index_t> NN(k, n);
+	const index_t num_blocks=(n+DISTANCE_BLOCK_SIZE-1)/DISTANCE_BLOCK_SIZE;
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_blocks; ++b)
+	{
+		const index_t block_begin=b*DISTANCE_BLOCK_SIZE;
+		const index_t n_rhs=std::min(DISTANCE_BLOCK_SIZE, n-block_begin);
+		const index_t rhs_offset=rhs_begin+block_begin;
+		SGMatrix<float64_t> buffer(std::min(DISTANCE_BLOCK_SIZE, m), n_rhs);
+
+		// bounded max-heaps of (distance, index) pairs, one per rhs vector
+		std::vector<std::vector<std::pair<float64_t, index_t>>> heaps(n_rhs);
+		for (auto& heap : heaps)
+			heap.reserve(k);
+
+		for (index_t lhs_begin=0; lhs_begin<m; lhs_begin+=DISTANCE_BLOCK_SIZE)
+		{
+			const index_t n_lhs=std::min(DISTANCE_BLOCK_SIZE, m-lhs_begin);
+			SGMatrix<float64_t> tile(buffer.matrix, n_lhs, n_rhs, false);
+			compute_distance_block(
+				lhs_begin, lhs_begin+n_lhs, rhs_offset, rhs_offset+n_rhs, tile);
+
+			for (index_t j=0; j<n_rhs; ++j)
+			{
+				auto& heap=heaps[j];
+				for (index_t i=0; i<n_lhs; ++i)
+				{
+					std::pair<float64_t, index_t> candidate(tile(i, j), lhs_begin+i);
+					if (index_t(heap.size())<k)
+					{
+						heap.push_back(candidate);
+						std::push_heap(heap.begin(), heap.end());
+					}
+					else if (candidate<heap.front())
+					{
+						std::pop_heap(heap.begin(), heap.end());
+						heap.back()=candidate;
+						std::push_heap(heap.begin(), heap.end());
+					}
+				}
+			}
+		}
+
+		for (index_t j=0; j<n_rhs; ++j)
+		{
+			std::sort_heap(heaps[j].begin(), heaps[j].end());
+			for (index_t l=0; l<k; ++l)
+				NN(l, block_begin+j)=heaps[j][l].second;
+		}
+	}
+
+	return NN;
+}
+
 template SGMatrix<float64_t> Distance::get_distance_matrix<float64_t>();
 template SGMatrix<float32_t> Distance::get_distance_matrix<float32_t>();
@@ -19,6 +19,7 @@
 #include <shogun/features/FeatureTypes.h>
 #include <shogun/features/Features.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
 
 namespace shogun
 {
@@ -162,6 +163,59 @@ class Distance : public SGObject
 		 */
 		template <class T> SGMatrix<T> get_distance_matrix();
 
+		/** compute the distances between the lhs vectors
+		 * [lhs_begin, lhs_end) and the rhs vectors [rhs_begin, rhs_end) in
+		 * one go. The default evaluates distance() for every pair, derived
+		 * classes may override it to compute whole tiles at once, e.g.
+		 * through a matrix product of dense feature blocks.
+		 *
+		 * @param lhs_begin index of first lhs vector
+		 * @param lhs_end index one past the last lhs vector
+		 * @param rhs_begin index of first rhs vector
+		 * @param rhs_end index one past the last rhs vector
+		 * @param block preallocated result of size
+		 * (lhs_end-lhs_begin)x(rhs_end-rhs_begin)
+		 */
+		virtual void compute_distance_block(
+			index_t lhs_begin, index_t lhs_end, index_t rhs_begin,
+			index_t rhs_end, SGMatrix<float64_t>& block);
+
+		/** find the nearest rhs vector of every lhs vector. Distances are
+		 * computed tile by tile through compute_distance_block() and in
+		 * parallel over lhs tiles. Ties go to the smallest index.
+		 *
+		 * @param min_dists distance to the nearest rhs vector (output)
+		 * @return index of the nearest rhs vector of every lhs vector
+		 */
+		SGVector<index_t> nearest_rhs(SGVector<float64_t>& min_dists);
+
+		/** find the nearest lhs vector of every rhs vector in the range
+		 * [rhs_begin, rhs_end). Distances are computed tile by tile
+		 * through compute_distance_block() and in parallel over rhs tiles.
+		 * Ties go to the smallest index.
+		 *
+		 * @param min_dists distance to the nearest lhs vector (output)
+		 * @param rhs_begin index of first rhs vector
+		 * @param rhs_end index one past the last rhs vector, -1 for all
+		 * @return index of the nearest lhs vector of every rhs vector in the
+		 * range
+		 */
+		SGVector<index_t> nearest_lhs(
+			SGVector<float64_t>& min_dists, index_t rhs_begin=0,
+			index_t rhs_end=-1);
+
+		/** find the k nearest lhs vectors of every rhs vector in the range
+		 * [rhs_begin, rhs_end), see nearest_lhs()
+		 *
+		 * @param k number of neighbors
+		 * @param rhs_begin index of first rhs vector
+		 * @param rhs_end index one past the last rhs vector, -1 for all
+		 * @return k x (rhs_end-rhs_begin) matrix of lhs indices, sorted by
+		 * increasing distance in every column
+		 */
+		SGMatrix<index_t> k_nearest_lhs(
+			int32_t k, index_t rhs_begin=0, index_t rhs_end=-1);
+
 		/** compute row start offset for parallel kernel matrix computation
 		 *
 		 * @param offs offset
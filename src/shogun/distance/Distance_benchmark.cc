@@ -0,0 +1,63 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/distance/ChiSquareDistance.h"
+#include "shogun/distance/CosineDistance.h"
+#include "shogun/distance/EuclideanDistance.h"
+#include "shogun/distance/ManhattanMetric.h"
+#include "shogun/util/benchmark_data.h"
+
+#include <functional>
+
+namespace shogun
+{
+
+/** non-negative data, as required by some of the distances */
+static std::shared_ptr<DenseFeatures<float64_t>>
+createDistanceData(index_t num_vecs, index_t num_dim)
+{
+	auto data = benchmark_data::gaussians(num_vecs, num_dim);
+	for (index_t i = 0; i < data.num_rows * data.num_cols; ++i)
+		data[i] = Math::abs(data[i]);
+	return std::make_shared<DenseFeatures<float64_t>>(data);
+}
+
+/** computes the distances between a batch of range(0) query vectors and
+ * 1024 reference vectors of dimension range(1)
+ */
+static void BM_Distance_Batch(
+    benchmark::State& state, std::function<std::shared_ptr<Distance>()> create)
+{
+	auto queries = createDistanceData(state.range(0), state.range(1));
+	auto reference = createDistanceData(1024, state.range(1));
+	auto distance = create();
+	distance->init(queries, reference);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(distance->get_distance_matrix());
+
+	state.SetItemsProcessed(
+	    state.iterations() * int64_t(queries->get_num_vectors()) *
+	    reference->get_num_vectors());
+}
+
+#define ADD_DISTANCE_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(4)->Ranges({{64, 4096}, {16, 256}})->Unit(benchmark::kMillisecond);
+
+ADD_DISTANCE_ARGS(BENCHMARK_CAPTURE(BM_Distance_Batch, EuclideanDistance, []() {
+	return std::make_shared<EuclideanDistance>();
+}))
+ADD_DISTANCE_ARGS(BENCHMARK_CAPTURE(BM_Distance_Batch, ManhattanMetric, []() {
+	return std::make_shared<ManhattanMetric>();
+}))
+ADD_DISTANCE_ARGS(BENCHMARK_CAPTURE(BM_Distance_Batch, ChiSquareDistance, []() {
+	return std::make_shared<ChiSquareDistance>();
+}))
+ADD_DISTANCE_ARGS(BENCHMARK_CAPTURE(BM_Distance_Batch, CosineDistance, []() {
+	return std::make_shared<CosineDistance>();
+}))
+
+}
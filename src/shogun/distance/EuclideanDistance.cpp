@@ -11,6 +11,7 @@
 #include <shogun/features/DotFeatures.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 using namespace shogun;
 
@@ -173,3 +174,28 @@ float64_t EuclideanDistance::distance_upper_bounded(int32_t idx_a, int32_t idx_b
 
 	return result;
 }
+
+void EuclideanDistance::compute_distance_block(
+	index_t lhs_begin, index_t lhs_end, index_t rhs_begin, index_t rhs_end,
+	SGMatrix<float64_t>& block)
+{
+	if (precompute_matrix ||
+		lhs->get_feature_class()!=C_DENSE || rhs->get_feature_class()!=C_DENSE ||
+		lhs->get_feature_type()!=F_DREAL || rhs->get_feature_type()!=F_DREAL)
+	{
+		Distance::compute_distance_block(lhs_begin, lhs_end, rhs_begin, rhs_end, block);
+		return;
+	}
+
+	auto lhs_block=lhs->as<DenseFeatures<float64_t>>()
+		->get_feature_matrix_block(lhs_begin, lhs_end);
+	auto rhs_block=rhs->as<DenseFeatures<float64_t>>()
+		->get_feature_matrix_block(rhs_begin, rhs_end);
+
+	/* the squared norms are taken from the blocks rather than the
+	 * precomputed ones, which are only updated by init() and replace_*(),
+	 * not when subsets or the data of the features change */
+	linalg::squared_distances(lhs_block, rhs_block, block);
+	if (!disable_sqrt)
+		linalg::sqrt(block, block);
+}
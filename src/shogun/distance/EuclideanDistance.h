@@ -130,6 +130,21 @@ public:
 	 */
 	virtual float64_t distance_upper_bounded(int32_t idx_a, int32_t idx_b, float64_t upper_bound);
 
+	/** compute a tile of distances. For dense real valued features this
+	 * is a single matrix product of the feature blocks, expanded with the
+	 * squared norms as \f$\|a\|^2+\|b\|^2-2a^\top b\f$
+	 *
+	 * @param lhs_begin index of first lhs vector
+	 * @param lhs_end index one past the last lhs vector
+	 * @param rhs_begin index of first rhs vector
+	 * @param rhs_end index one past the last rhs vector
+	 * @param block preallocated result of size
+	 * (lhs_end-lhs_begin)x(rhs_end-rhs_begin)
+	 */
+	virtual void compute_distance_block(
+		index_t lhs_begin, index_t lhs_end, index_t rhs_begin,
+		index_t rhs_end, SGMatrix<float64_t>& block);
+
 	/**
 	 * Precomputation of squared norms for features of right hand side
 	 * WARNING : Make sure to reset computations using reset_precompute()
@@ -12,9 +12,11 @@
 #include <shogun/lib/config.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/base/Parallel.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/features/StringFeatures.h>
 #include <shogun/features/Alphabet.h>
 #include <shogun/mathematics/UniformRealDistribution.h>
+#include <shogun/mathematics/eigen3.h>
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -22,13 +24,91 @@
 #include <ctype.h>
 #include <thread>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #define VAL_MACRO log((default_value == 0) ? (uniform_real_dist(m_prng)) : default_value)
 #define ARRAY_SIZE 65336
 
 using namespace shogun;
 
+/** log(sum(exp(x))) of every column of x, which is overwritten. The
+ * exponentials are evaluated by Eigen and thus vectorized. Columns without
+ * finite entries give -inf.
+ */
+static void colwise_log_sum_exp(
+	Eigen::Ref<Eigen::MatrixXd> x, Eigen::Ref<Eigen::VectorXd> result)
+{
+	result=x.colwise().maxCoeff().transpose();
+	result=(result.array()==-Math::INFTY).select(0.0, result.array());
+	x.rowwise()-=result.transpose();
+	result.array()+=x.array().exp().colwise().sum().log().transpose();
+}
+
+/** log(sum(exp(x))) of a vector */
+static float64_t log_sum_exp(const Eigen::Ref<const Eigen::VectorXd>& x)
+{
+	float64_t max=x.maxCoeff();
+	if (max==-Math::INFTY)
+		return max;
+
+	return max+std::log((x.array()-max).exp().sum());
+}
+
+/** sum of the per-sequence log-probabilities in sequence order, so that the
+ * result does not depend on the number of threads
+ */
+static float64_t sum_in_order(const SGVector<float64_t>& dim_prob)
+{
+	float64_t sum=0;
+	for (index_t i=0; i<dim_prob.vlen; i++)
+		sum+=dim_prob[i];
+
+	return sum;
+}
+
+/** number of chunks the sequences are split into when the vectorized engine
+ * counts parameter uses. It does not depend on the number of threads, so
+ * summing the chunks in order gives the same model on every run.
+ */
+static const int32_t ENGINE_NUM_CHUNKS=64;
+
+/** uses of p, q, a and b counted over one chunk of sequences */
+struct EngineCounts
+{
+	EngineCounts(int32_t N, int32_t M)
+		: p(Eigen::VectorXd::Zero(N)), q(Eigen::VectorXd::Zero(N)),
+		  a(Eigen::MatrixXd::Zero(N, N)), b(Eigen::MatrixXd::Zero(N, M))
+	{
+	}
+
+	EngineCounts& operator+=(const EngineCounts& other)
+	{
+		p+=other.p;
+		q+=other.q;
+		a+=other.a;
+		b+=other.b;
+		return *this;
+	}
+
+	Eigen::VectorXd p;
+	Eigen::VectorXd q;
+	Eigen::MatrixXd a;
+	Eigen::MatrixXd b;
+};
+
+/** sum of the counts of all chunks in chunk order */
+static EngineCounts sum_in_order(
+	const std::vector<EngineCounts>& chunk_counts, int32_t N, int32_t M)
+{
+	EngineCounts sum(N, M);
+	for (const auto& counts : chunk_counts)
+		sum+=counts;
+
+	return sum;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -194,6 +274,7 @@ HMM::HMM(const std::shared_ptr<HMM>& h)
 	this->M=h->get_M();
 	status=initialize_hmm(NULL, h->get_pseudo());
 	this->copy_model(h);
+	m_engine=h->m_engine;
 	set_observations(h->p_observations);
 }
 
@@ -1164,8 +1245,13 @@ float64_t HMM::best_path(int32_t dimension)
 		{
 			io::info("computing full viterbi likelihood");
 			float64_t sum = 0 ;
-			for (int32_t i=0; i<p_observations->get_num_vectors(); i++)
-				sum+=best_path(i) ;
+			if (m_engine==HMM_ENGINE_VECTORIZED)
+				sum=best_path_vectorized(-1);
+			else
+			{
+				for (int32_t i=0; i<p_observations->get_num_vectors(); i++)
+					sum+=best_path(i) ;
+			}
 			sum /= p_observations->get_num_vectors() ;
 			all_pat_prob=sum ;
 			all_path_prob_updated=true ;
@@ -1182,6 +1268,13 @@ float64_t HMM::best_path(int32_t dimension)
 
 	if (PATH_PROB_UPDATED(dimension) && dimension==PATH_PROB_DIMENSION(dimension))
 		return pat_prob;
+	else if (m_engine==HMM_ENGINE_VECTORIZED)
+	{
+		pat_prob=best_path_vectorized(dimension);
+		PATH_PROB_UPDATED(dimension)=true;
+		PATH_PROB_DIMENSION(dimension)=dimension;
+		return pat_prob;
+	}
 	else
 	{
 		float64_t* delta= ARRAYN2(dimension);
@@ -1280,9 +1373,346 @@ float64_t HMM::best_path(int32_t dimension)
 	}
 }
 
+void HMM::update_engine_tables()
+{
+	if (m_engine_tables_updated && m_engine_a_from.num_rows==N &&
+		m_engine_b_obs.num_cols==M)
+		return;
+
+	if (m_engine_a_from.num_rows!=N)
+		m_engine_a_from=SGMatrix<float64_t>(N, N);
+	if (m_engine_b_obs.num_rows!=N || m_engine_b_obs.num_cols!=M)
+		m_engine_b_obs=SGMatrix<float64_t>(N, M);
+
+	typename SGMatrix<float64_t>::EigenMatrixXtMap a_from=m_engine_a_from;
+	typename SGMatrix<float64_t>::EigenMatrixXtMap b_obs=m_engine_b_obs;
+	a_from=Eigen::Map<const Eigen::MatrixXd>(transition_matrix_a, N, N).transpose();
+	b_obs=Eigen::Map<const Eigen::MatrixXd>(observation_matrix_b, M, N).transpose();
+	m_engine_tables_updated=true;
+}
+
+float64_t HMM::engine_forward(
+	const uint16_t* obs, int32_t len, SGMatrix<float64_t>& alpha,
+	SGMatrix<float64_t>& work) const
+{
+	typename SGMatrix<float64_t>::EigenMatrixXtMap alpha_eig=alpha;
+	typename SGMatrix<float64_t>::EigenMatrixXtMap work_eig=work;
+	Eigen::Map<const Eigen::MatrixXd> a_to(transition_matrix_a, N, N);
+	Eigen::Map<const Eigen::MatrixXd> b_obs(m_engine_b_obs.matrix, N, M);
+	Eigen::Map<const Eigen::VectorXd> p(initial_state_distribution_p, N);
+	Eigen::Map<const Eigen::VectorXd> q(end_state_distribution_q, N);
+
+	alpha_eig.col(0)=p+b_obs.col(obs[0]);
+	for (int32_t t=1; t<len; t++)
+	{
+		// column j holds alpha_t-1(i)+a(i,j) for all i
+		work_eig=a_to.colwise()+alpha_eig.col(t-1);
+		colwise_log_sum_exp(work_eig, alpha_eig.col(t));
+		alpha_eig.col(t)+=b_obs.col(obs[t]);
+	}
+
+	work_eig.col(0)=alpha_eig.col(len-1)+q;
+	return log_sum_exp(work_eig.col(0));
+}
+
+void HMM::engine_backward(
+	const uint16_t* obs, int32_t len, SGMatrix<float64_t>& beta,
+	SGMatrix<float64_t>& work) const
+{
+	typename SGMatrix<float64_t>::EigenMatrixXtMap beta_eig=beta;
+	typename SGMatrix<float64_t>::EigenMatrixXtMap work_eig=work;
+	Eigen::Map<const Eigen::MatrixXd> a_from(m_engine_a_from.matrix, N, N);
+	Eigen::Map<const Eigen::MatrixXd> b_obs(m_engine_b_obs.matrix, N, M);
+	Eigen::Map<const Eigen::VectorXd> q(end_state_distribution_q, N);
+
+	beta_eig.col(len-1)=q;
+	for (int32_t t=len-2; t>=0; t--)
+	{
+		// column i holds a(i,j)+b(j,O_t+1)+beta_t+1(j) for all j
+		beta_eig.col(t)=b_obs.col(obs[t+1])+beta_eig.col(t+1);
+		work_eig=a_from.colwise()+beta_eig.col(t);
+		colwise_log_sum_exp(work_eig, beta_eig.col(t));
+	}
+}
+
+float64_t HMM::engine_viterbi(
+	const uint16_t* obs, int32_t len, SGMatrix<float64_t>& delta,
+	SGMatrix<float64_t>& work, T_STATES* psi, T_STATES* best_path) const
+{
+	typename SGMatrix<float64_t>::EigenMatrixXtMap delta_eig=delta;
+	typename SGMatrix<float64_t>::EigenMatrixXtMap work_eig=work;
+	Eigen::Map<const Eigen::MatrixXd> a_to(transition_matrix_a, N, N);
+	Eigen::Map<const Eigen::MatrixXd> b_obs(m_engine_b_obs.matrix, N, M);
+	Eigen::Map<const Eigen::VectorXd> p(initial_state_distribution_p, N);
+	Eigen::Map<const Eigen::VectorXd> q(end_state_distribution_q, N);
+
+	delta_eig.col(0)=p+b_obs.col(obs[0]);
+	for (int32_t t=1; t<len; t++)
+	{
+		auto prev=delta_eig.col((t-1)%2);
+		auto cur=delta_eig.col(t%2);
+		work_eig=a_to.colwise()+prev;
+		for (int32_t j=0; j<N; j++)
+		{
+			Eigen::Index argmax;
+			cur[j]=work_eig.col(j).maxCoeff(&argmax)+b_obs(j, obs[t]);
+#ifdef FIX_POS
+			if (model && model->get_fix_pos_state(t,j,N)==Model::FIX_DISALLOWED)
+				cur[j]+=Model::DISALLOWED_PENALTY;
+#endif
+			psi[int64_t(t)*N+j]=argmax;
+		}
+	}
+
+	Eigen::Index argmax;
+	float64_t prob=(delta_eig.col((len-1)%2)+q).maxCoeff(&argmax);
+	best_path[len-1]=argmax;
+	for (int32_t t=len-1; t>0; t--)
+		best_path[t-1]=psi[int64_t(t)*N+best_path[t]];
+
+	return prob;
+}
+
+float64_t HMM::model_probability_vectorized()
+{
+	update_engine_tables();
+
+	int32_t num_vectors=p_observations->get_num_vectors();
+	int32_t max_len=p_observations->get_max_vector_length();
+	SGVector<float64_t> dim_prob(num_vectors);
+
+#pragma omp parallel num_threads(env()->get_num_threads())
+	{
+		SGMatrix<float64_t> alpha(N, max_len);
+		SGMatrix<float64_t> work(N, N);
+
+#pragma omp for schedule(dynamic)
+		for (int32_t dim=0; dim<num_vectors; dim++)
+		{
+			int32_t len;
+			bool free_vec;
+			uint16_t* obs=p_observations->get_feature_vector(dim, len, free_vec);
+			dim_prob[dim]=engine_forward(obs, len, alpha, work);
+			p_observations->free_feature_vector(obs, dim, free_vec);
+		}
+	}
+
+	mod_prob=sum_in_order(dim_prob);
+	mod_prob_updated=true;
+	return mod_prob;
+}
+
+float64_t HMM::best_path_vectorized(int32_t dimension)
+{
+	update_engine_tables();
+
+	if (dimension==-1)
+	{
+		int32_t num_vectors=p_observations->get_num_vectors();
+		int32_t max_len=p_observations->get_max_vector_length();
+		SGVector<float64_t> dim_prob(num_vectors);
+
+#pragma omp parallel num_threads(env()->get_num_threads())
+		{
+			SGMatrix<float64_t> delta(N, 2);
+			SGMatrix<float64_t> work(N, N);
+			std::vector<T_STATES> psi(int64_t(max_len)*N);
+			std::vector<T_STATES> best(max_len);
+
+#pragma omp for schedule(dynamic)
+			for (int32_t dim=0; dim<num_vectors; dim++)
+			{
+				int32_t len;
+				bool free_vec;
+				uint16_t* obs=p_observations->get_feature_vector(dim, len, free_vec);
+				dim_prob[dim]=engine_viterbi(
+					obs, len, delta, work, psi.data(), best.data());
+				p_observations->free_feature_vector(obs, dim, free_vec);
+			}
+		}
+
+		return sum_in_order(dim_prob);
+	}
+
+	int32_t len;
+	bool free_vec;
+	uint16_t* obs=p_observations->get_feature_vector(dimension, len, free_vec);
+	SGMatrix<float64_t> delta(N, 2);
+	SGMatrix<float64_t> work(N, N);
+	std::vector<T_STATES> psi(int64_t(len)*N);
+	float64_t prob=engine_viterbi(
+		obs, len, delta, work, psi.data(), PATH(dimension));
+	p_observations->free_feature_vector(obs, dimension, free_vec);
+
+	return prob;
+}
+
+void HMM::estimate_model_baum_welch_vectorized(const std::shared_ptr<HMM>& estimate)
+{
+	estimate->update_engine_tables();
+
+	int32_t num_vectors=p_observations->get_num_vectors();
+	int32_t max_len=p_observations->get_max_vector_length();
+	Eigen::Map<const Eigen::MatrixXd> a_from(estimate->m_engine_a_from.matrix, N, N);
+	Eigen::Map<const Eigen::MatrixXd> b_obs(estimate->m_engine_b_obs.matrix, N, M);
+
+	// expected number of uses of p, q, a and b, in the layouts of the
+	// engine's tables
+	int32_t num_chunks=std::min(num_vectors, ENGINE_NUM_CHUNKS);
+	std::vector<EngineCounts> chunk_counts(num_chunks, EngineCounts(N, M));
+	SGVector<float64_t> dim_prob(num_vectors);
+
+#pragma omp parallel num_threads(env()->get_num_threads())
+	{
+		SGMatrix<float64_t> alpha(N, max_len);
+		SGMatrix<float64_t> beta(N, max_len);
+		SGMatrix<float64_t> work(N, N);
+		typename SGMatrix<float64_t>::EigenMatrixXtMap alpha_eig=alpha;
+		typename SGMatrix<float64_t>::EigenMatrixXtMap beta_eig=beta;
+		typename SGMatrix<float64_t>::EigenMatrixXtMap work_eig=work;
+
+#pragma omp for schedule(dynamic)
+		for (int32_t chunk=0; chunk<num_chunks; chunk++)
+		{
+			EngineCounts& counts=chunk_counts[chunk];
+			int32_t end=int64_t(num_vectors)*(chunk+1)/num_chunks;
+			for (int32_t dim=int64_t(num_vectors)*chunk/num_chunks; dim<end; dim++)
+			{
+				int32_t len;
+				bool free_vec;
+				uint16_t* obs=p_observations->get_feature_vector(dim, len, free_vec);
+				float64_t dimmodprob=estimate->engine_forward(obs, len, alpha, work);
+				estimate->engine_backward(obs, len, beta, work);
+				dim_prob[dim]=dimmodprob;
+
+				counts.p.array()+=((alpha_eig.col(0)+beta_eig.col(0)).array()-
+					dimmodprob).exp();
+				counts.q.array()+=((alpha_eig.col(len-1)+beta_eig.col(len-1)).array()-
+					dimmodprob).exp();
+
+				for (int32_t t=0; t<len; t++)
+				{
+					counts.b.col(obs[t]).array()+=
+						((alpha_eig.col(t)+beta_eig.col(t)).array()-dimmodprob).exp();
+				}
+
+				for (int32_t t=0; t<len-1; t++)
+				{
+					// column i holds the posterior of the transitions from i
+					work_eig=a_from.colwise()+(b_obs.col(obs[t+1])+beta_eig.col(t+1));
+					work_eig.rowwise()+=(alpha_eig.col(t).array()-dimmodprob).matrix().transpose();
+					counts.a.array()+=work_eig.array().exp();
+				}
+
+				p_observations->free_feature_vector(obs, dim, free_vec);
+			}
+		}
+	}
+
+	EngineCounts counts=sum_in_order(chunk_counts, N, M);
+
+	// counts start from PSEUDO for the allowed parameters, the others
+	// keep their value
+	for (int32_t i=0; i<N; i++)
+	{
+		if (estimate->get_p(i)>Math::ALMOST_NEG_INFTY)
+			set_p(i, log(PSEUDO+counts.p[i]));
+		else
+			set_p(i, estimate->get_p(i));
+		if (estimate->get_q(i)>Math::ALMOST_NEG_INFTY)
+			set_q(i, log(PSEUDO+counts.q[i]));
+		else
+			set_q(i, estimate->get_q(i));
+
+		for (int32_t j=0; j<N; j++)
+		{
+			if (estimate->get_a(i,j)>Math::ALMOST_NEG_INFTY)
+				set_a(i,j, log(PSEUDO+counts.a(j,i)));
+			else
+				set_a(i,j, estimate->get_a(i,j));
+		}
+		for (int32_t j=0; j<M; j++)
+		{
+			if (estimate->get_b(i,j)>Math::ALMOST_NEG_INFTY)
+				set_b(i,j, log(PSEUDO+counts.b(i,j)));
+			else
+				set_b(i,j, estimate->get_b(i,j));
+		}
+	}
+
+	//cache estimate model probability
+	estimate->mod_prob=sum_in_order(dim_prob);
+	estimate->mod_prob_updated=true ;
+
+	//new model probability is unknown
+	normalize();
+	invalidate_model();
+}
+
+float64_t HMM::count_best_paths_vectorized(
+	const std::shared_ptr<HMM>& estimate, float64_t* P, float64_t* Q)
+{
+	estimate->update_engine_tables();
+
+	int32_t num_vectors=p_observations->get_num_vectors();
+	int32_t max_len=p_observations->get_max_vector_length();
+	int32_t num_chunks=std::min(num_vectors, ENGINE_NUM_CHUNKS);
+	std::vector<EngineCounts> chunk_counts(num_chunks, EngineCounts(N, M));
+	SGVector<float64_t> dim_prob(num_vectors);
+
+#pragma omp parallel num_threads(env()->get_num_threads())
+	{
+		SGMatrix<float64_t> delta(N, 2);
+		SGMatrix<float64_t> work(N, N);
+		std::vector<T_STATES> psi(int64_t(max_len)*N);
+		std::vector<T_STATES> best(max_len);
+
+#pragma omp for schedule(dynamic)
+		for (int32_t chunk=0; chunk<num_chunks; chunk++)
+		{
+			EngineCounts& counts=chunk_counts[chunk];
+			int32_t end=int64_t(num_vectors)*(chunk+1)/num_chunks;
+			for (int32_t dim=int64_t(num_vectors)*chunk/num_chunks; dim<end; dim++)
+			{
+				int32_t len;
+				bool free_vec;
+				uint16_t* obs=p_observations->get_feature_vector(dim, len, free_vec);
+				dim_prob[dim]=estimate->engine_viterbi(
+					obs, len, delta, work, psi.data(), best.data());
+
+				for (int32_t t=0; t<len-1; t++)
+					counts.a(best[t], best[t+1])++;
+				for (int32_t t=0; t<len; t++)
+					counts.b(best[t], obs[t])++;
+				counts.p[best[0]]++;
+				counts.q[best[len-1]]++;
+
+				p_observations->free_feature_vector(obs, dim, free_vec);
+			}
+		}
+	}
+
+	EngineCounts counts=sum_in_order(chunk_counts, N, M);
+
+	for (int32_t i=0; i<N; i++)
+	{
+		for (int32_t j=0; j<N; j++)
+			set_A(i,j, get_A(i,j)+counts.a(i,j));
+		for (int32_t j=0; j<M; j++)
+			set_B(i,j, get_B(i,j)+counts.b(i,j));
+		P[i]+=counts.p[i];
+		Q[i]+=counts.q[i];
+	}
+
+	return sum_in_order(dim_prob);
+}
+
 #ifndef USE_HMMPARALLEL
 float64_t HMM::model_probability_comp()
 {
+	if (m_engine==HMM_ENGINE_VECTORIZED)
+		return model_probability_vectorized();
+
 	//for faster calculation cache model probability
 	mod_prob=0 ;
 	for (int32_t dim=0; dim<p_observations->get_num_vectors(); dim++) //sum in log space
@@ -1296,6 +1726,9 @@ float64_t HMM::model_probability_comp()
 
 float64_t HMM::model_probability_comp()
 {
+	if (m_engine==HMM_ENGINE_VECTORIZED)
+		return model_probability_vectorized();
+
 	std::vector<S_BW_THREAD_PARAM> params(env()->get_num_threads());
 
 	io::info("computing full model probablity");
@@ -1422,6 +1855,12 @@ void HMM::ab_buf_comp(
 //estimates new model lambda out of lambda_train using baum welch algorithm
 void HMM::estimate_model_baum_welch(const std::shared_ptr<HMM>&	hmm)
 {
+	if (m_engine==HMM_ENGINE_VECTORIZED)
+	{
+		estimate_model_baum_welch_vectorized(hmm);
+		return;
+	}
+
 	int32_t i,j,cpu;
 	float64_t fullmodprob=0;	//for all dims
 
@@ -1526,6 +1965,12 @@ void HMM::estimate_model_baum_welch(const std::shared_ptr<HMM>&	hmm)
 //estimates new model lambda out of lambda_estimate using baum welch algorithm
 void HMM::estimate_model_baum_welch(const std::shared_ptr<HMM>& estimate)
 {
+	if (m_engine==HMM_ENGINE_VECTORIZED)
+	{
+		estimate_model_baum_welch_vectorized(estimate);
+		return;
+	}
+
 	int32_t i,j,t,dim;
 	float64_t a_sum, b_sum;	//numerator
 	float64_t dimmodprob=0;	//model probability for dim
@@ -1961,56 +2406,61 @@ void HMM::estimate_model_viterbi(const std::shared_ptr<HMM>& estimate)
 
 	float64_t allpatprob=0 ;
 
+	if (m_engine==HMM_ENGINE_VECTORIZED)
+		allpatprob=count_best_paths_vectorized(estimate, P, Q);
+	else
+	{
 #ifdef USE_HMMPARALLEL
-	int32_t num_threads = env()->get_num_threads();
-	std::vector<std::thread> threads;
-	threads.reserve(num_threads);
-	std::vector<S_DIM_THREAD_PARAM> params(num_threads);
+		int32_t num_threads = env()->get_num_threads();
+		std::vector<std::thread> threads;
+		threads.reserve(num_threads);
+		std::vector<S_DIM_THREAD_PARAM> params(num_threads);
 
-	if (p_observations->get_num_vectors()<num_threads)
-		num_threads=p_observations->get_num_vectors();
+		if (p_observations->get_num_vectors()<num_threads)
+			num_threads=p_observations->get_num_vectors();
 #endif
 
-	for (int32_t dim=0; dim<p_observations->get_num_vectors(); dim++)
-	{
+		for (int32_t dim=0; dim<p_observations->get_num_vectors(); dim++)
+		{
 
 #ifdef USE_HMMPARALLEL
-		if (dim%num_threads==0)
-		{
-			for (i=0; i<num_threads; i++)
+			if (dim%num_threads==0)
 			{
-				if (dim+i<p_observations->get_num_vectors())
+				for (i=0; i<num_threads; i++)
 				{
-					params[i].hmm=estimate ;
-					params[i].dim=dim+i ;
-					threads.emplace_back([this, &p=params[i]](){vit_dim_prefetch(&p);});
+					if (dim+i<p_observations->get_num_vectors())
+					{
+						params[i].hmm=estimate ;
+						params[i].dim=dim+i ;
+						threads.emplace_back([this, &p=params[i]](){vit_dim_prefetch(&p);});
+					}
 				}
-			}
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
+				for (i=0; i<num_threads; i++)
 				{
-					threads[i].join();
-					allpatprob += params[i].prob_sum;
+					if (dim+i<p_observations->get_num_vectors())
+					{
+						threads[i].join();
+						allpatprob += params[i].prob_sum;
+					}
 				}
 			}
-		}
 #else
-		//using viterbi to find best path
-		allpatprob += estimate->best_path(dim);
+			//using viterbi to find best path
+			allpatprob += estimate->best_path(dim);
 #endif // USE_HMMPARALLEL
 
-		//counting occurences for A and B
-		for (t=0; t<p_observations->get_vector_length(dim)-1; t++)
-		{
-			set_A(estimate->PATH(dim)[t], estimate->PATH(dim)[t+1], get_A(estimate->PATH(dim)[t], estimate->PATH(dim)[t+1])+1);
-			set_B(estimate->PATH(dim)[t], p_observations->get_feature(dim,t),  get_B(estimate->PATH(dim)[t], p_observations->get_feature(dim,t))+1);
-		}
+			//counting occurences for A and B
+			for (t=0; t<p_observations->get_vector_length(dim)-1; t++)
+			{
+				set_A(estimate->PATH(dim)[t], estimate->PATH(dim)[t+1], get_A(estimate->PATH(dim)[t], estimate->PATH(dim)[t+1])+1);
+				set_B(estimate->PATH(dim)[t], p_observations->get_feature(dim,t),  get_B(estimate->PATH(dim)[t], p_observations->get_feature(dim,t))+1);
+			}
 
-		set_B(estimate->PATH(dim)[p_observations->get_vector_length(dim)-1], p_observations->get_feature(dim,p_observations->get_vector_length(dim)-1),  get_B(estimate->PATH(dim)[p_observations->get_vector_length(dim)-1], p_observations->get_feature(dim,p_observations->get_vector_length(dim)-1)) + 1 );
+			set_B(estimate->PATH(dim)[p_observations->get_vector_length(dim)-1], p_observations->get_feature(dim,p_observations->get_vector_length(dim)-1),  get_B(estimate->PATH(dim)[p_observations->get_vector_length(dim)-1], p_observations->get_feature(dim,p_observations->get_vector_length(dim)-1)) + 1 );
 
-		P[estimate->PATH(dim)[0]]++;
-		Q[estimate->PATH(dim)[p_observations->get_vector_length(dim)-1]]++;
+			P[estimate->PATH(dim)[0]]++;
+			Q[estimate->PATH(dim)[p_observations->get_vector_length(dim)-1]]++;
+		}
 	}
 
 	allpatprob/=p_observations->get_num_vectors() ;
@@ -2706,6 +3156,7 @@ void HMM::invalidate_model()
 	//initialize pat/mod_prob/alpha/beta cache as not calculated
 	this->mod_prob=0.0;
 	this->mod_prob_updated=false;
+	this->m_engine_tables_updated=false;
 
 	if (mem_initialized)
 	{
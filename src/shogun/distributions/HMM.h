@@ -10,6 +10,7 @@
 
 #include <shogun/mathematics/Math.h>
 #include <shogun/lib/common.h>
+#include <shogun/lib/SGMatrix.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/config.h>
 #include <shogun/features/Features.h>
@@ -77,6 +78,18 @@ enum BaumWelchViterbiType
 	VIT_DEFINED
 };
 
+/** Algorithms computing the model probability, the best paths and the
+ * Baum-Welch and Viterbi estimates of all observations
+ */
+enum EHMMEngine
+{
+	/// recursion over single cells using the alpha/beta caches
+	HMM_ENGINE_RECURSIVE,
+	/// log-space recursion over whole state vectors, in parallel over the
+	/// observation sequences
+	HMM_ENGINE_VECTORIZED
+};
+
 
 /** @brief class Model */
 class Model
@@ -630,6 +643,17 @@ class HMM : public RandomMixin<Distribution>
 		inline bool set_epsilon (float64_t eps) { epsilon=eps; return true; }
 		inline float64_t get_epsilon() { return epsilon; }
 
+		/** set the algorithms used for the model probability, the best
+		 * paths and training. The vectorized engine needs O(T*N) memory
+		 * per thread, where T is the length of the longest observation.
+		 *
+		 * @param engine engine to use
+		 */
+		inline void set_engine(EHMMEngine engine) { m_engine=engine; }
+
+		/** @return the engine in use */
+		inline EHMMEngine get_engine() const { return m_engine; }
+
 		/** interface for e.g. GUIHMM to run BaumWelch or Viterbi training
 		 * @param type type of BaumWelch/Viterbi training
 		 */
@@ -1263,6 +1287,19 @@ class HMM : public RandomMixin<Distribution>
 
 		// true->stolen from other HMMs, false->got own
 		bool reused_caches;
+
+		/// engine computing model probability, best paths and estimates
+		EHMMEngine m_engine=HMM_ENGINE_RECURSIVE;
+
+		/// transposed transition matrix, column i holds a(i, :)
+		SGMatrix<float64_t> m_engine_a_from;
+
+		/// observation matrix, column o holds b(:, o)
+		SGMatrix<float64_t> m_engine_b_obs;
+
+		/// whether the engine tables hold the current a and b, reset by
+		/// invalidate_model()
+		bool m_engine_tables_updated=false;
 		//@}
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
@@ -1327,6 +1364,72 @@ class HMM : public RandomMixin<Distribution>
 #endif //USE_HMMPARALLEL_STRUCTURES
 		//@}
 
+		/** copies a and b into the layouts used by the vectorized engine,
+		 * unless they were copied since the last invalidate_model()
+		 */
+		void update_engine_tables();
+
+		/** log-space forward algorithm of the vectorized engine
+		 *
+		 * @param obs observation sequence
+		 * @param len length of the sequence
+		 * @param alpha N x len (or more columns) matrix that gets
+		 * log Pr[O_0, ..., O_t, q_t=S_i | lambda] in column t
+		 * @param work N x N matrix for temporary calculations
+		 * @return log Pr[O | lambda]
+		 */
+		float64_t engine_forward(
+			const uint16_t* obs, int32_t len, SGMatrix<float64_t>& alpha,
+			SGMatrix<float64_t>& work) const;
+
+		/** log-space backward algorithm of the vectorized engine
+		 *
+		 * @param obs observation sequence
+		 * @param len length of the sequence
+		 * @param beta N x len (or more columns) matrix that gets
+		 * log Pr[O_t+1, ..., O_T-1 | q_t=S_i, lambda] in column t
+		 * @param work N x N matrix for temporary calculations
+		 */
+		void engine_backward(
+			const uint16_t* obs, int32_t len, SGMatrix<float64_t>& beta,
+			SGMatrix<float64_t>& work) const;
+
+		/** Viterbi algorithm of the vectorized engine
+		 *
+		 * @param obs observation sequence
+		 * @param len length of the sequence
+		 * @param delta N x 2 matrix for temporary calculations
+		 * @param work N x N matrix for temporary calculations
+		 * @param psi backtracking table of len*N states
+		 * @param best_path len states that get the best path
+		 * @return probability of the best path
+		 */
+		float64_t engine_viterbi(
+			const uint16_t* obs, int32_t len, SGMatrix<float64_t>& delta,
+			SGMatrix<float64_t>& work, T_STATES* psi,
+			T_STATES* best_path) const;
+
+		/** model_probability_comp() of the vectorized engine */
+		float64_t model_probability_vectorized();
+
+		/** best_path() of the vectorized engine */
+		float64_t best_path_vectorized(int32_t dimension);
+
+		/** estimate_model_baum_welch() of the vectorized engine */
+		void estimate_model_baum_welch_vectorized(
+			const std::shared_ptr<HMM>& estimate);
+
+		/** adds the counts of the best paths of all observations to
+		 * A, B, P and Q, see estimate_model_viterbi()
+		 *
+		 * @param estimate model computing the best paths
+		 * @param P counts of the start states
+		 * @param Q counts of the end states
+		 * @return sum of the probabilities of the best paths
+		 */
+		float64_t count_best_paths_vectorized(
+			const std::shared_ptr<HMM>& estimate, float64_t* P, float64_t* Q);
+
 		/** GOTN */
 		static const int32_t GOTN;
 		/** GOTM */
@@ -10,6 +10,7 @@
 
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
+#include <shogun/io/MappedFeatureFile.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
@@ -42,6 +43,7 @@ template<class ST> DenseFeatures<ST>::DenseFeatures(const DenseFeatures & orig)
 {
 	init();
 	set_feature_matrix(orig.feature_matrix);
+	m_mapped_file=orig.m_mapped_file;
 	initialize_cache();
 
 	if (orig.m_subset_stack != NULL)
@@ -72,6 +74,15 @@ template<class ST> DenseFeatures<ST>::DenseFeatures(const std::shared_ptr<File>&
 	load(loader);
 }
 
+template<class ST> DenseFeatures<ST>::DenseFeatures(std::shared_ptr<MappedFeatureFile<ST>> file) :
+		DotFeatures()
+{
+	init();
+	require(file, "No mapped file given");
+	set_feature_matrix(file->get_dense_view());
+	m_mapped_file=file;
+}
+
 template<class ST> DenseFeatures<ST>::DenseFeatures(const std::shared_ptr<DotFeatures>& features) :
 		DotFeatures()
 {
@@ -114,6 +125,7 @@ template<class ST> void DenseFeatures<ST>::free_feature_matrix()
 {
 	m_subset_stack->remove_all_subsets();
 	feature_matrix=SGMatrix<ST>();
+	m_mapped_file=NULL;
 	num_vectors = 0;
 	num_features = 0;
 }
@@ -277,6 +289,36 @@ SGMatrix<ST> DenseFeatures<ST>::get_feature_matrix() const
 	return target;
 }
 
+template <class ST>
+SGMatrix<ST> DenseFeatures<ST>::get_feature_matrix_block(index_t begin, index_t end) const
+{
+	require(begin>=0 && begin<=end && end<=get_num_vectors(),
+		"Invalid block [{}, {}) for {} vectors!", begin, end, get_num_vectors());
+
+	if (feature_matrix.matrix && !m_subset_stack->has_subsets() &&
+		!get_num_preprocessors())
+	{
+		return SGMatrix<ST>(
+			feature_matrix.matrix+int64_t(num_features)*begin,
+			num_features, end-begin, false);
+	}
+
+	SGMatrix<ST> target;
+	for (index_t i=begin; i<end; ++i)
+	{
+		int32_t vlen;
+		bool do_free;
+		ST* vec=get_feature_vector(i, vlen, do_free);
+
+		if (i==begin)
+			target=SGMatrix<ST>(vlen, end-begin);
+
+		sg_memcpy(target.get_column_vector(i-begin), vec, vlen*sizeof(ST));
+		free_feature_vector(vec, i, do_free);
+	}
+	return target;
+}
+
 template <class ST>
 void DenseFeatures<ST>::copy_feature_matrix(SGMatrix<ST>& target, index_t column_offset) const
 {
@@ -475,6 +517,33 @@ void DenseFeatures<float64_t>::add_to_dense_vec(float64_t alpha, int32_t vec_idx
 	free_feature_vector(vec1, vec_idx1, vfree);
 }
 
+template <class ST>
+void DenseFeatures<ST>::add_to_dense_vec(
+	float32_t alpha, int32_t vec_idx1, float32_t* vec2, int32_t vec2_len,
+	bool abs_val) const
+{
+	ASSERT(vec2_len == num_features)
+
+	int32_t vlen;
+	bool vfree;
+	ST* vec1 = get_feature_vector(vec_idx1, vlen, vfree);
+
+	ASSERT(vlen == num_features)
+
+	if (abs_val)
+	{
+		for (int32_t i = 0; i < num_features; i++)
+			vec2[i] += alpha * (float32_t)Math::abs(vec1[i]);
+	}
+	else
+	{
+		for (int32_t i = 0; i < num_features; i++)
+			vec2[i] += alpha * (float32_t)vec1[i];
+	}
+
+	free_feature_vector(vec1, vec_idx1, vfree);
+}
+
 template<class ST> int32_t DenseFeatures<ST>::get_nnz_features_for_vector(int32_t num) const
 {
 	return num_features;
@@ -568,7 +637,9 @@ std::shared_ptr<Features> DenseFeatures<ST>::shallow_subset_copy()
 
 	SG_DEBUG("Using underlying feature matrix with {} dimensions and {} feature vectors!", num_features, num_vectors);
 	SGMatrix<ST> shallow_copy_matrix(feature_matrix);
-	shallow_copy_features=std::make_shared<DenseFeatures>(shallow_copy_matrix);
+	auto shallow_copy=std::make_shared<DenseFeatures>(shallow_copy_matrix);
+	shallow_copy->m_mapped_file=m_mapped_file;
+	shallow_copy_features=shallow_copy;
 
 	if (m_subset_stack->has_subsets())
 		shallow_copy_features->add_subset(m_subset_stack->get_last_subset()->get_subset_idx());
@@ -632,6 +703,27 @@ DenseFeatures<ST>::dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) const
 	return result;
 }
 
+template <typename ST>
+float32_t
+DenseFeatures<ST>::dot(int32_t vec_idx1, const SGVector<float32_t>& vec2) const
+{
+	SGVector<ST> vec1 = get_feature_vector(vec_idx1);
+	float32_t result = 0;
+	if constexpr (std::is_same<ST, float32_t>::value)
+		result = linalg::dot(vec2, vec1);
+	else
+	{
+		require(
+		    vec1.vlen == vec2.vlen,
+		    "Length of vector a ({}) doesn't match vector b ({}).", vec2.vlen,
+		    vec1.vlen);
+		for (int32_t i = 0; i < vec1.vlen; i++)
+			result += vec2[i] * (float32_t)vec1[i];
+	}
+	free_feature_vector(vec1, vec_idx1);
+	return result;
+}
+
 template<class ST> bool DenseFeatures<ST>::is_equal(std::shared_ptr<DenseFeatures> rhs)
 {
 	if ( num_features != rhs->num_features || num_vectors != rhs->num_vectors )
@@ -24,6 +24,7 @@ namespace shogun {
 template<class ST> class StringFeatures;
 template<class ST> class DenseFeatures;
 template<class ST> class SGMatrix;
+template<class ST> class MappedFeatureFile;
 class DotFeatures;
 
 /** @brief The class DenseFeatures implements dense feature matrices.
@@ -99,6 +100,20 @@ public:
 	 */
 	DenseFeatures(const std::shared_ptr<File>& loader);
 
+#ifndef SWIG // SWIG should skip this part
+	/** constructor serving the features directly from a mapped file
+	 *
+	 * The feature matrix is a view on the mapping, which is kept alive as
+	 * long as the features or copies of them exist. Nothing is parsed or
+	 * copied. The mapping is copy-on-write, so in place modifications are
+	 * visible to all features on the same file but never written to the
+	 * file.
+	 *
+	 * @param file mapped file with a dense layout
+	 */
+	DenseFeatures(std::shared_ptr<MappedFeatureFile<ST>> file);
+#endif
+
 	/** duplicate feature object
 	 *
 	 * @return feature object
@@ -193,6 +208,17 @@ public:
 	 */
 	SGMatrix<ST> get_feature_matrix() const;
 
+	/** Getter for a contiguous block of feature vectors
+	 *
+	 * in-place without subset and preprocessors
+	 * a copy otherwise
+	 *
+	 * @param begin index of the first vector in the block
+	 * @param end index one past the last vector in the block
+	 * @return matrix with feature vectors begin,...,end-1 as columns
+	 */
+	SGMatrix<ST> get_feature_matrix_block(index_t begin, index_t end) const;
+
 	/** get the pointer to the feature matrix
 	 * num_feat,num_vectors are returned by reference
 	 *
@@ -360,6 +386,36 @@ public:
 	virtual void add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
 			float64_t* vec2, int32_t vec2_len, bool abs_val = false) const;
 
+	/** compute dot product between vector1 and a dense single precision
+	 * vector in single precision
+	 *
+	 * possible with subset
+	 *
+	 * @param vec_idx1 index of first vector
+	 * @param vec2 dense vector
+	 */
+	virtual float32_t
+	dot(int32_t vec_idx1, const SGVector<float32_t>& vec2) const;
+
+	/** add vector 1 multiplied with alpha to dense single precision vector2
+	 *
+	 * possible with subset
+	 *
+	 * @param alpha scalar alpha
+	 * @param vec_idx1 index of first vector
+	 * @param vec2 pointer to single precision vector
+	 * @param vec2_len length of single precision vector
+	 * @param abs_val if true add the absolute value
+	 */
+	virtual void add_to_dense_vec(float32_t alpha, int32_t vec_idx1,
+			float32_t* vec2, int32_t vec2_len, bool abs_val = false) const;
+
+	/** @return true for float32 features */
+	virtual bool has_native_float32() const
+	{
+		return std::is_same<ST, float32_t>::value;
+	}
+
 	/** get number of non-zero features in vector
 	 *
 	 * @param num which vector
@@ -557,6 +613,9 @@ protected:
 
 	/** feature cache */
 	std::shared_ptr<Cache<ST>> feature_cache;
+
+	/** mapped file the feature matrix points into, if any */
+	std::shared_ptr<MappedFeatureFile<ST>> m_mapped_file;
 };
 }
 #endif // _DENSEFEATURES__H__
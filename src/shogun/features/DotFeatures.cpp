@@ -45,6 +45,68 @@ DotFeatures::DotFeatures(std::shared_ptr<File> loader)
 }
 
 void DotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const
+{
+	dense_dot_range_impl(output, start, stop, alphas, vec, dim, b);
+}
+
+void DotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float32_t* vec, int32_t dim, float64_t b) const
+{
+	dense_dot_range_impl(output, start, stop, alphas, vec, dim, b);
+}
+
+float32_t DotFeatures::dot(int32_t vec_idx1, const SGVector<float32_t>& vec2) const
+{
+	/* iterating does not change the features, but the interface is not const */
+	auto self=const_cast<DotFeatures*>(this);
+	void* it=self->get_feature_iterator(vec_idx1);
+	if (it)
+	{
+		float32_t result=0;
+		int32_t idx;
+		float64_t val;
+		while (self->get_next_feature(idx, val, it))
+		{
+			ASSERT(idx>=0 && idx<vec2.vlen)
+			result+=val*vec2[idx];
+		}
+		self->free_feature_iterator(it);
+		return result;
+	}
+
+	SGVector<float64_t> vec(vec2.vlen);
+	for (index_t i=0; i<vec2.vlen; i++)
+		vec[i]=vec2[i];
+
+	return dot(vec_idx1, vec);
+}
+
+void DotFeatures::add_to_dense_vec(float32_t alpha, int32_t vec_idx1, float32_t* vec2, int32_t vec2_len, bool abs_val) const
+{
+	auto self=const_cast<DotFeatures*>(this);
+	void* it=self->get_feature_iterator(vec_idx1);
+	if (it)
+	{
+		int32_t idx;
+		float64_t val;
+		while (self->get_next_feature(idx, val, it))
+		{
+			ASSERT(idx>=0 && idx<vec2_len)
+			vec2[idx]+=alpha*(abs_val ? Math::abs(val) : val);
+		}
+		self->free_feature_iterator(it);
+		return;
+	}
+
+	SGVector<float64_t> vec(vec2_len);
+	vec.zero();
+	add_to_dense_vec(alpha, vec_idx1, vec.vector, vec2_len, abs_val);
+
+	for (index_t i=0; i<vec2_len; i++)
+		vec2[i]+=vec[i];
+}
+
+template <class T>
+void DotFeatures::dense_dot_range_impl(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, T* vec, int32_t dim, float64_t b) const
 {
 	ASSERT(output)
 	ASSERT(start>=0)
@@ -53,7 +115,7 @@ void DotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t stop
 
 	int32_t num_vectors=stop-start;
 	ASSERT(num_vectors>0)
-	SGVector<float64_t> sgvec(vec, dim, false);
+	SGVector<T> sgvec(vec, dim, false);
 
 	int32_t num_threads;
 	int32_t step;
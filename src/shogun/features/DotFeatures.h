@@ -37,6 +37,11 @@ namespace shogun
  *
  * - iteration over all (potentially) non-zero features of \f${\bf x}\f$
  *
+ * The dense vector \f${\bf z}\f$ may also be single precision. Features
+ * that store float32 values and compute these operations without converting
+ * to double precision report so in has_native_float32(); for all others the
+ * single precision operations iterate over the non-zero features, and fall
+ * back to the double precision ones only where no feature iterator exists.
  */
 class DotFeatures : public Features
 {
@@ -95,6 +100,31 @@ class DotFeatures : public Features
 		 */
 		virtual void add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t* vec2, int32_t vec2_len, bool abs_val=false) const = 0;
 
+		/** compute dot product between vector1 and a dense single precision vector
+		 *
+		 * @param vec_idx1 index of first vector
+		 * @param vec2 dense vector
+		 */
+		virtual float32_t
+		dot(int32_t vec_idx1, const SGVector<float32_t>& vec2) const;
+
+		/** add vector 1 multiplied with alpha to dense single precision vector2
+		 *
+		 * @param alpha scalar alpha
+		 * @param vec_idx1 index of first vector
+		 * @param vec2 pointer to single precision vector
+		 * @param vec2_len length of single precision vector
+		 * @param abs_val if true add the absolute value
+		 */
+		virtual void add_to_dense_vec(float32_t alpha, int32_t vec_idx1, float32_t* vec2, int32_t vec2_len, bool abs_val=false) const;
+
+		/** whether the single precision dot() and add_to_dense_vec() work on
+		 * the stored values directly, i.e. without converting to double
+		 *
+		 * @return false
+		 */
+		virtual bool has_native_float32() const { return false; }
+
 		/** Compute the dot product for a range of vectors. This function makes use of dense_dot
 		 * alphas[i] * sparse[i]^T * w + b
 		 *
@@ -110,6 +140,20 @@ class DotFeatures : public Features
 		 */
 		virtual void dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const;
 
+		/** Compute the dot product for a range of vectors with a single precision
+		 * dense vector
+		 * alphas[i] * sparse[i]^T * w + b
+		 *
+		 * @param output result for the given vector range
+		 * @param start start vector range from this idx
+		 * @param stop stop vector range at this idx
+		 * @param alphas scalars to multiply with, may be NULL
+		 * @param vec single precision dense vector to compute dot product with
+		 * @param dim length of the dense vector
+		 * @param b bias
+		 */
+		virtual void dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float32_t* vec, int32_t dim, float64_t b) const;
+
 		/** Compute the dot product for a subset of vectors. This function makes use of dense_dot
 		 * alphas[i] * sparse[i]^T * w + b
 		 *
@@ -221,6 +265,10 @@ class DotFeatures : public Features
 
 	private:
 		void init();
+
+		/** dense_dot_range() for dense vectors of type T */
+		template <class T>
+		void dense_dot_range_impl(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, T* vec, int32_t dim, float64_t b) const;
 };
 }
 #endif // _DOTFEATURES_H___
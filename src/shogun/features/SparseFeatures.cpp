@@ -3,6 +3,7 @@
 #include <shogun/features/SparseFeatures.h>
 #include <shogun/preprocessor/SparsePreprocessor.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/io/MappedFeatureFile.h>
 #include <shogun/io/SGIO.h>
 
 #include <string.h>
@@ -33,7 +34,7 @@ template<class ST> SparseFeatures<ST>::SparseFeatures(SGMatrix<ST> dense)
 
 template<class ST> SparseFeatures<ST>::SparseFeatures(const SparseFeatures & orig)
 : DotFeatures(orig), sparse_feature_matrix(orig.sparse_feature_matrix),
-	feature_cache(orig.feature_cache)
+	feature_cache(orig.feature_cache), m_mapped_file(orig.m_mapped_file)
 {
 	init();
 
@@ -63,6 +64,17 @@ template<class ST> SparseFeatures<ST>::SparseFeatures(const std::shared_ptr<File
 	load(loader);
 }
 
+template<class ST>
+SparseFeatures<ST>::SparseFeatures(std::shared_ptr<MappedFeatureFile<ST>> file)
+: SparseFeatures(0)
+{
+	require(file, "No mapped file given");
+	// feature indices are only checked if the file was opened with
+	// check_indices
+	sparse_feature_matrix=file->get_sparse_view();
+	m_mapped_file=file;
+}
+
 template<class ST> SparseFeatures<ST>::~SparseFeatures()
 {
 
@@ -212,6 +224,46 @@ void SparseFeatures<complex128_t>::add_to_dense_vec(float64_t alpha,
 	not_implemented(SOURCE_LOCATION);;
 }
 
+template<class ST> void SparseFeatures<ST>::add_to_dense_vec(float32_t alpha, int32_t num, float32_t* vec, int32_t dim, bool abs_val) const
+{
+	require(vec, "add_to_dense_vec(num={},dim={}): vec must not be NULL",
+		num, dim);
+	require(dim>=get_num_features(),
+		"add_to_dense_vec(num={},dim={}): dim should contain number of features {}",
+		num, dim, get_num_features());
+
+	SGSparseVector<ST> sv=get_sparse_feature_vector(num);
+
+	if (sv.features)
+	{
+		if (abs_val)
+		{
+			for (int32_t i=0; i<sv.num_feat_entries; i++)
+			{
+				vec[sv.features[i].feat_index]+=alpha
+					*(float32_t)Math::abs(sv.features[i].entry);
+			}
+		}
+		else
+		{
+			for (int32_t i=0; i<sv.num_feat_entries; i++)
+			{
+				vec[sv.features[i].feat_index]+=alpha
+						*(float32_t)sv.features[i].entry;
+			}
+		}
+	}
+
+	free_sparse_feature_vector(num);
+}
+
+template<>
+void SparseFeatures<complex128_t>::add_to_dense_vec(float32_t alpha,
+	int32_t num, float32_t* vec, int32_t dim, bool abs_val) const
+{
+	not_implemented(SOURCE_LOCATION);;
+}
+
 template<class ST> void SparseFeatures<ST>::free_sparse_feature_vector(int32_t num) const
 {
 	if (feature_cache)
@@ -242,6 +294,7 @@ template<class ST> void SparseFeatures<ST>::set_sparse_feature_matrix(SGSparseMa
 		error("Not allowed with subset");
 
 	sparse_feature_matrix=sm;
+	m_mapped_file=NULL;
 
 	// TODO: check should be implemented in sparse matrix class
 	for (int32_t j=0; j<get_num_vectors(); j++) {
@@ -286,6 +339,7 @@ template<class ST> void SparseFeatures<ST>::free_sparse_features()
 template<class ST> void SparseFeatures<ST>::free_sparse_feature_matrix()
 {
 	sparse_feature_matrix=SGSparseMatrix<ST>();
+	m_mapped_file=NULL;
 }
 
 template<class ST> void SparseFeatures<ST>::set_full_feature_matrix(SGMatrix<ST> full)
@@ -493,6 +547,42 @@ float64_t SparseFeatures<complex128_t>::dot(
 	return 0.0;
 }
 
+template <class ST>
+float32_t
+SparseFeatures<ST>::dot(int32_t vec_idx1, const SGVector<float32_t>& vec2) const
+{
+	require(
+		vec2.size() >= get_num_features(),
+		"dot(vec_idx1={},vec2_len={}): vec2_len should contain number of "
+		"features {}",
+		vec_idx1, vec2.size(), get_num_features());
+
+	float32_t result=0;
+	SGSparseVector<ST> sv=get_sparse_feature_vector(vec_idx1);
+
+	if (sv.features)
+	{
+		require(get_num_features() >= sv.get_num_dimensions(),
+			"sparse_matrix[{}] check failed (matrix features {} >= vector dimension {})",
+			vec_idx1, get_num_features(), sv.get_num_dimensions());
+
+		for (int32_t i=0; i<sv.num_feat_entries; i++)
+			result+=vec2[sv.features[i].feat_index]*(float32_t)sv.features[i].entry;
+	}
+
+	free_sparse_feature_vector(vec_idx1);
+
+	return result;
+}
+
+template <>
+float32_t SparseFeatures<complex128_t>::dot(
+	int32_t vec_idx1, const SGVector<float32_t>& vec2) const
+{
+	not_implemented(SOURCE_LOCATION);;
+	return 0.0;
+}
+
 template<class ST> void* SparseFeatures<ST>::get_feature_iterator(int32_t vector_index)
 {
 	if (vector_index>=get_num_vectors())
@@ -573,7 +663,14 @@ template<class ST> SGSparseVectorEntry<ST>* SparseFeatures<ST>::compute_sparse_f
 
 template<class ST> void SparseFeatures<ST>::sort_features()
 {
-	sparse_feature_matrix.sort_features();
+	// mapped vectors are sorted in place, as they cannot be reallocated
+	if (m_mapped_file)
+	{
+		for (index_t i=0; i<sparse_feature_matrix.num_vectors; i++)
+			sparse_feature_matrix[i].sort_features(true);
+	}
+	else
+		sparse_feature_matrix.sort_features();
 }
 
 template<class ST> void SparseFeatures<ST>::init()
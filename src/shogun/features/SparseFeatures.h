@@ -27,6 +27,7 @@ class LibSVMFile;
 class Features;
 template <class ST> class DenseFeatures;
 template <class T> class Cache;
+template <class T> class MappedFeatureFile;
 
 /** @brief Template class SparseFeatures implements sparse matrices.
  *
@@ -81,6 +82,22 @@ template <class ST> class SparseFeatures : public DotFeatures
 		 */
 		SparseFeatures(const std::shared_ptr<File>& loader);
 
+#ifndef SWIG // SWIG should skip this part
+		/** constructor serving the features directly from a mapped file
+		 *
+		 * All sparse vectors are views on the mapping, which is kept alive
+		 * as long as the features or copies of them exist. Nothing is
+		 * parsed or copied. The mapping is copy-on-write, so in place
+		 * modifications (e.g. by sort_features()) are visible to all
+		 * features on the same file but never written to the file. The
+		 * feature indices are only checked if the file was opened with
+		 * check_indices.
+		 *
+		 * @param file mapped file with a sparse layout
+		 */
+		SparseFeatures(std::shared_ptr<MappedFeatureFile<ST>> file);
+#endif
+
 		/** default destructor */
 		virtual ~SparseFeatures();
 
@@ -393,6 +410,37 @@ template <class ST> class SparseFeatures : public DotFeatures
 		virtual float64_t
 		dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) const;
 
+		/** compute dot product between vector1 and a dense single precision
+		 * vector in single precision
+		 *
+		 * possible with subset
+		 *
+		 * @param vec_idx1 index of first vector
+		 * @param vec2 dense vector
+		 */
+		virtual float32_t
+		dot(int32_t vec_idx1, const SGVector<float32_t>& vec2) const;
+
+		/** add a sparse feature vector onto a dense single precision one
+		 * dense+=alpha*sparse
+		 *
+		 * possible with subset
+		 *
+		 * @param alpha scalar to multiply with
+		 * @param num index of feature vector
+		 * @param vec dense vector
+		 * @param dim length of the dense vector
+		 * @param abs_val if true, do dense+=alpha*abs(sparse)
+		 */
+		virtual void add_to_dense_vec(float32_t alpha, int32_t num,
+				float32_t* vec, int32_t dim, bool abs_val=false) const;
+
+		/** @return true for float32 features */
+		virtual bool has_native_float32() const
+		{
+			return std::is_same<ST, float32_t>::value;
+		}
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 		/** iterator for sparse features */
 		struct sparse_feature_iterator
@@ -482,6 +530,9 @@ template <class ST> class SparseFeatures : public DotFeatures
 
 		/** feature cache */
 		std::shared_ptr<Cache< SGSparseVectorEntry<ST> >> feature_cache;
+
+		/** mapped file the sparse vectors point into, if any */
+		std::shared_ptr<MappedFeatureFile<ST>> m_mapped_file;
 };
 }
 #endif /* _SPARSEFEATURES__H__ */
@@ -73,6 +73,12 @@ template<class T> void StreamingDenseFeatures<T>::reset_stream()
 	}
 }
 
+template<class T>
+void StreamingDenseFeatures<T>::set_num_parse_threads(int32_t num_threads)
+{
+	parser.set_num_parse_threads(num_threads);
+}
+
 template<class T> float32_t StreamingDenseFeatures<T>::dense_dot(
 		const float32_t* vec2, int32_t vec2_len)
 {
@@ -300,17 +306,22 @@ std::shared_ptr<Features> StreamingDenseFeatures<T>::get_streamed_features(
 
 	/* init matrix empty, as we dont know the dimension yet */
 	SGMatrix<T> matrix;
+	index_t num_read=0;
 
-	for (index_t i=0; i<num_elements; ++i)
+	while (num_read<num_elements)
 	{
+		/* take as many parsed examples as possible at once */
+		Example<T>* examples;
+		int32_t num=parser.get_next_batch(examples, num_elements-num_read);
+
 		/* check if we run out of data */
-		if (!get_next_example())
+		if (num==0)
 		{
 			io::warn("Ran out of streaming data, reallocating matrix and "
 					"returning!");
 
 			/* allocating space for data so far, not this mighe be 0 bytes */
-			SGMatrix<T> so_far(matrix.num_rows, i);
+			SGMatrix<T> so_far(matrix.num_rows, num_read);
 
 			/* copy */
 			sg_memcpy(so_far.matrix, matrix.matrix,
@@ -319,33 +330,31 @@ std::shared_ptr<Features> StreamingDenseFeatures<T>::get_streamed_features(
 			matrix=so_far;
 			break;
 		}
-		else
+
+		for (int32_t i=0; i<num; i++)
 		{
 			/* allocate matrix memory in first iteration */
 			if (!matrix.matrix)
 			{
 				SG_DEBUG("Allocating {}x{} matrix",
-						current_vector.vlen, num_elements);
-				matrix=SGMatrix<T>(current_vector.vlen, num_elements);
+						examples[i].length, num_elements);
+				matrix=SGMatrix<T>(examples[i].length, num_elements);
 			}
 
-			/* get an example from stream and copy to feature matrix */
-			SGVector<T> vec=get_vector();
-
 			/* check for inconsistent dimensions */
-			require(vec.vlen==matrix.num_rows,
+			require(examples[i].length==matrix.num_rows,
 					"Dimension of streamed vector ({}) does not match "
 					"dimensions of previous vectors ({})",
-					vec.vlen, matrix.num_rows);
+					examples[i].length, matrix.num_rows);
 
 			/* copy vector into matrix */
-			sg_memcpy(&matrix.matrix[current_vector.vlen*i], vec.vector,
-					vec.vlen*sizeof(T));
-
-			/* clean up */
-			release_example();
+			sg_memcpy(&matrix.matrix[int64_t(matrix.num_rows)*num_read],
+					examples[i].fv, examples[i].length*sizeof(T));
+			num_read++;
 		}
 
+		/* clean up */
+		parser.finalize_batch(num);
 	}
 
 	/* create new feature object from collected data */
@@ -107,6 +107,13 @@ public:
 	 */
 	virtual void reset_stream();
 
+	/**
+	 * Set the number of threads that parse the input.
+	 *
+	 * @param num_threads number of parse threads
+	 */
+	virtual void set_num_parse_threads(int32_t num_threads);
+
 	/**
 	 * Instructs the parser to return the next example.
 	 *
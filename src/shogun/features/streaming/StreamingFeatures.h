@@ -176,6 +176,19 @@ public:
 	 */
 	virtual void reset_stream();
 
+	/**
+	 * Set the number of threads that parse the input. More than one
+	 * thread is used for inputs that support chunked parsing, see
+	 * InputParser::set_num_parse_threads(). Must be called before
+	 * start_parser().
+	 *
+	 * @param num_threads number of parse threads
+	 */
+	virtual void set_num_parse_threads(int32_t num_threads)
+	{
+		error("{}::set_num_parse_threads() is not supported!", get_name());
+	}
+
 	/** Returns a new Features instance which contains num_elements elements from
 	 * the underlying stream. Not SG_REF'ed
 	 *
@@ -6,6 +6,7 @@
  */
 
 #include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/mathematics/Math.h>
 
 namespace shogun
@@ -337,6 +338,54 @@ void StreamingSparseFeatures<T>::release_example()
 	parser.finalize_example();
 }
 
+template <class T>
+void StreamingSparseFeatures<T>::set_num_parse_threads(int32_t num_threads)
+{
+	parser.set_num_parse_threads(num_threads);
+}
+
+template <class T>
+std::shared_ptr<Features> StreamingSparseFeatures<T>::get_streamed_features(
+		index_t num_elements)
+{
+	require(num_elements>0, "Requested number of feature vectors ({}) must be "
+			"positive", num_elements);
+
+	std::vector<SGSparseVector<T>> vectors;
+	vectors.reserve(num_elements);
+
+	while (index_t(vectors.size())<num_elements)
+	{
+		Example<SGSparseVectorEntry<T>>* examples;
+		int32_t num=parser.get_next_batch(examples,
+				num_elements-vectors.size());
+		if (num==0)
+		{
+			io::warn("Ran out of streaming data, returning {} vectors!",
+					vectors.size());
+			break;
+		}
+
+		for (int32_t i=0; i<num; i++)
+		{
+			// the parser still owns the memory
+			SGSparseVector<T> vec(examples[i].fv, examples[i].length, false);
+			vectors.push_back(vec.clone());
+
+			current_num_features=Math::max(current_num_features,
+					vectors.back().get_num_dimensions());
+		}
+		current_vec_index+=num;
+		parser.finalize_batch(num);
+	}
+
+	SGSparseMatrix<T> matrix(current_num_features, vectors.size());
+	for (index_t i=0; i<matrix.num_vectors; i++)
+		matrix[i]=vectors[i];
+
+	return std::make_shared<SparseFeatures<T>>(matrix);
+}
+
 template <class T>
 int32_t StreamingSparseFeatures<T>::get_dim_feature_space() const
 {
@@ -157,6 +157,13 @@ public:
 	 */
 	virtual void reset_stream();
 
+	/**
+	 * Set the number of threads that parse the input.
+	 *
+	 * @param num_threads number of parse threads
+	 */
+	virtual void set_num_parse_threads(int32_t num_threads);
+
 	/** set number of features
 	 *
 	 * Sometimes when loading sparse features not all possible dimensions
@@ -319,6 +326,16 @@ public:
 	 */
 	virtual int32_t get_num_vectors() const;
 
+	/** Returns a new SparseFeatures instance which contains num_elements
+	 * elements from the underlying stream, fetched in whole batches from
+	 * the parser.
+	 *
+	 * @param num_elements num elements to save from stream
+	 * @return Features object of underlying type, might contain less data if
+	 * the stream did end (warning is written)
+	 */
+	virtual std::shared_ptr<Features> get_streamed_features(index_t num_elements);
+
 private:
 	/**
 	 * Initializes members to null values.
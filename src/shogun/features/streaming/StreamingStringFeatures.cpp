@@ -1,4 +1,5 @@
 #include <shogun/features/streaming/StreamingStringFeatures.h>
+#include <shogun/features/StringFeatures.h>
 
 namespace shogun
 {
@@ -178,38 +179,81 @@ bool StreamingStringFeatures<T>::get_next_example()
 	if (!ret_value)
 		return false;
 
+	process_string(current_string);
+
+	return ret_value;
+}
+
+template <class T>
+void StreamingStringFeatures<T>::process_string(SGVector<T>& str)
+{
 	int32_t i;
 	if (remap_to_bin)
 	{
-		alpha_ascii->add_string_to_histogram(current_string.vector, current_string.vlen);
+		alpha_ascii->add_string_to_histogram(str.vector, str.vlen);
 
-		for (i=0; i<current_string.size(); i++)
-			current_string[i]=alpha_ascii->remap_to_bin(current_string[i]);
-		alpha_bin->add_string_to_histogram(current_string.vector, current_string.vlen);
+		for (i=0; i<str.size(); i++)
+			str[i]=alpha_ascii->remap_to_bin(str[i]);
+		alpha_bin->add_string_to_histogram(str.vector, str.vlen);
 	}
 	else
 	{
-		alpha_ascii->add_string_to_histogram(current_string.vector, current_string.vlen);
+		alpha_ascii->add_string_to_histogram(str.vector, str.vlen);
 	}
 
 	/* Check the input using src alphabet, alpha_ascii */
 	if ( !(alpha_ascii->check_alphabet_size() && alpha_ascii->check_alphabet()) )
-	{
 		error("StreamingStringFeatures: The given input was found to be incompatible with the alphabet!");
-		return 0;
-	}
-
-	//SG_UNREF(alphabet);
 
 	if (remap_to_bin)
 		alphabet=alpha_bin;
 	else
 		alphabet=alpha_ascii;
 
-	//SG_REF(alphabet);
 	num_symbols=alphabet->get_num_symbols();
+}
 
-	return ret_value;
+template <class T>
+std::shared_ptr<Features> StreamingStringFeatures<T>::get_streamed_features(
+		index_t num_elements)
+{
+	require(num_elements>0, "Requested number of strings ({}) must be "
+			"positive", num_elements);
+
+	std::vector<SGVector<T>> strings;
+	strings.reserve(num_elements);
+
+	while (index_t(strings.size())<num_elements)
+	{
+		Example<T>* examples;
+		int32_t num=parser.get_next_batch(examples,
+				num_elements-strings.size());
+		if (num==0)
+		{
+			io::warn("Ran out of streaming data, returning {} strings!",
+					strings.size());
+			break;
+		}
+
+		for (int32_t i=0; i<num; i++)
+		{
+			/* strings point into parser memory and are copied first */
+			SGVector<T> str=SGVector<T>(examples[i].fv,
+					examples[i].length, false).clone();
+			process_string(str);
+			strings.push_back(str);
+		}
+		parser.finalize_batch(num);
+	}
+
+	return std::make_shared<StringFeatures<T>>(strings,
+			std::make_shared<Alphabet>(alphabet));
+}
+
+template <class T>
+void StreamingStringFeatures<T>::set_num_parse_threads(int32_t num_threads)
+{
+	parser.set_num_parse_threads(num_threads);
 }
 
 template <class T>
@@ -173,6 +173,13 @@ public:
 	 */
 	virtual void release_example();
 
+	/**
+	 * Set the number of threads that parse the input.
+	 *
+	 * @param num_threads number of parse threads
+	 */
+	virtual void set_num_parse_threads(int32_t num_threads);
+
 	/**
 	 * Return the length of the current vector.
 	 *
@@ -215,7 +222,24 @@ public:
 	 */
 	virtual int32_t get_num_features();
 
+	/** Returns a new StringFeatures instance which contains num_elements
+	 * strings from the underlying stream, fetched in whole batches from
+	 * the parser.
+	 *
+	 * @param num_elements num elements to save from stream
+	 * @return Features object of underlying type, might contain less data if
+	 * the stream did end (warning is written)
+	 */
+	virtual std::shared_ptr<Features> get_streamed_features(index_t num_elements);
+
 private:
+	/**
+	 * Updates the alphabet histograms with a string, remapping it to the
+	 * binary alphabet if requested, and checks it against the alphabet.
+	 *
+	 * @param str string to process
+	 */
+	void process_string(SGVector<T>& str);
 
 	/**
 	 * Initializes members to null values.
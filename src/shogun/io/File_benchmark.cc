@@ -0,0 +1,195 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/features/streaming/StreamingDenseFeatures.h"
+#include "shogun/io/CSVFile.h"
+#include "shogun/io/LibSVMFile.h"
+#include "shogun/io/serialization/BitseryDeserializer.h"
+#include "shogun/io/serialization/BitserySerializer.h"
+#include "shogun/io/serialization/JsonDeserializer.h"
+#include "shogun/io/serialization/JsonSerializer.h"
+#include "shogun/io/stream/ByteArrayInputStream.h"
+#include "shogun/io/stream/ByteArrayOutputStream.h"
+#include "shogun/io/streaming/StreamingAsciiFile.h"
+#include "shogun/util/benchmark_data.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace shogun
+{
+
+/** range(0) vectors of dimension range(1) */
+class FileFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		feats = benchmark_data::dense_features(st.range(0), st.range(1));
+		fname = temp_filename();
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		feats.reset();
+		std::remove(fname.c_str());
+	}
+
+	/** @return name of a new, unique file in the temporary directory */
+	static std::string temp_filename()
+	{
+		const char* dir = std::getenv("TMPDIR");
+		if (!dir)
+			dir = std::getenv("TEMP");
+		std::string name =
+		    std::string(dir ? dir : "/tmp") + "/File_benchmark.XXXXXX";
+#ifdef _WIN32
+		_mktemp_s(&name[0], name.size() + 1);
+#else
+		int fd = mkstemp(&name[0]);
+		if (fd != -1)
+			close(fd);
+#endif
+		return name;
+	}
+
+	/** writes the features as CSV to fname */
+	void write_csv()
+	{
+		auto file = std::make_shared<CSVFile>(fname.c_str(), 'w');
+		feats->save(file);
+		file->close();
+	}
+
+	void set_bytes_processed(benchmark::State& st)
+	{
+		st.SetBytesProcessed(
+		    st.iterations() * int64_t(feats->get_num_vectors()) *
+		    feats->get_num_features() * sizeof(float64_t));
+	}
+
+	std::string fname;
+	std::shared_ptr<DenseFeatures<float64_t>> feats;
+};
+
+#define ADD_FILE_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(8)->Ranges({{1024, 65536}, {8, 64}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(FileFixture, CSVFile_write)(benchmark::State& st)
+{
+	for (auto _ : st)
+		write_csv();
+
+	set_bytes_processed(st);
+}
+ADD_FILE_ARGS(BENCHMARK_REGISTER_F(FileFixture, CSVFile_write))
+
+BENCHMARK_DEFINE_F(FileFixture, CSVFile_read)(benchmark::State& st)
+{
+	write_csv();
+	for (auto _ : st)
+	{
+		auto file = std::make_shared<CSVFile>(fname.c_str(), 'r');
+		benchmark::DoNotOptimize(std::make_shared<DenseFeatures<float64_t>>(file));
+	}
+
+	set_bytes_processed(st);
+}
+ADD_FILE_ARGS(BENCHMARK_REGISTER_F(FileFixture, CSVFile_read))
+
+BENCHMARK_DEFINE_F(FileFixture, LibSVMFile_write)(benchmark::State& st)
+{
+	auto sparse = std::make_shared<SparseFeatures<float64_t>>(feats->get_feature_matrix());
+	auto labels = benchmark_data::binary_labels(feats->get_num_vectors())->get_labels();
+	for (auto _ : st)
+		sparse->save_with_labels(std::make_shared<LibSVMFile>(fname.c_str(), 'w'), labels);
+
+	set_bytes_processed(st);
+}
+ADD_FILE_ARGS(BENCHMARK_REGISTER_F(FileFixture, LibSVMFile_write))
+
+BENCHMARK_DEFINE_F(FileFixture, LibSVMFile_read)(benchmark::State& st)
+{
+	auto sparse = std::make_shared<SparseFeatures<float64_t>>(feats->get_feature_matrix());
+	auto labels = benchmark_data::binary_labels(feats->get_num_vectors())->get_labels();
+	sparse->save_with_labels(std::make_shared<LibSVMFile>(fname.c_str(), 'w'), labels);
+	for (auto _ : st)
+	{
+		auto loaded = std::make_shared<SparseFeatures<float64_t>>();
+		benchmark::DoNotOptimize(
+		    loaded->load_with_labels(std::make_shared<LibSVMFile>(fname.c_str(), 'r')));
+	}
+
+	set_bytes_processed(st);
+}
+ADD_FILE_ARGS(BENCHMARK_REGISTER_F(FileFixture, LibSVMFile_read))
+
+template <class S, class D>
+static void serialization_roundtrip(
+    benchmark::State& st, const std::shared_ptr<SGObject>& obj)
+{
+	for (auto _ : st)
+	{
+		auto ostream = std::make_shared<io::ByteArrayOutputStream>();
+		auto serializer = std::make_shared<S>();
+		serializer->attach(ostream);
+		serializer->write(obj);
+
+		auto istream = std::make_shared<io::ByteArrayInputStream>(ostream->as_string());
+		auto deserializer = std::make_shared<D>();
+		deserializer->attach(istream);
+		benchmark::DoNotOptimize(deserializer->read_object());
+	}
+}
+
+BENCHMARK_DEFINE_F(FileFixture, JsonSerializer_roundtrip)(benchmark::State& st)
+{
+	serialization_roundtrip<io::JsonSerializer, io::JsonDeserializer>(st, feats);
+	set_bytes_processed(st);
+}
+ADD_FILE_ARGS(BENCHMARK_REGISTER_F(FileFixture, JsonSerializer_roundtrip))
+
+BENCHMARK_DEFINE_F(FileFixture, BitserySerializer_roundtrip)(benchmark::State& st)
+{
+	serialization_roundtrip<io::BitserySerializer, io::BitseryDeserializer>(st, feats);
+	set_bytes_processed(st);
+}
+ADD_FILE_ARGS(BENCHMARK_REGISTER_F(FileFixture, BitserySerializer_roundtrip))
+
+/** streams range(0) vectors of dimension range(1) from a CSV file, parsed by
+ * range(2) threads
+ */
+BENCHMARK_DEFINE_F(FileFixture, StreamingDenseFeatures_throughput)(benchmark::State& st)
+{
+	write_csv();
+	for (auto _ : st)
+	{
+		auto input = std::make_shared<StreamingAsciiFile>(fname.c_str());
+		input->set_delimiter(',');
+		auto streaming = std::make_shared<StreamingDenseFeatures<float64_t>>(input, false, 1024);
+		streaming->set_num_parse_threads(st.range(2));
+		streaming->start_parser();
+		while (streaming->get_next_example())
+		{
+			benchmark::DoNotOptimize(streaming->get_vector());
+			streaming->release_example();
+		}
+		streaming->end_parser();
+	}
+
+	set_bytes_processed(st);
+}
+BENCHMARK_REGISTER_F(FileFixture, StreamingDenseFeatures_throughput)
+	->RangeMultiplier(8)->Ranges({{1024, 65536}, {8, 64}, {1, 4}})->Unit(benchmark::kMillisecond);
+
+}
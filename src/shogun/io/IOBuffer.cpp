@@ -8,6 +8,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <algorithm>
 #ifdef _WIN32
 #include <io.h>
 #else
@@ -80,6 +81,27 @@ void IOBuffer::set(char *p)
 	space.end = p;
 }
 
+void IOBuffer::reset_content()
+{
+	space.end = space.begin;
+	endloaded = space.begin;
+}
+
+void IOBuffer::append_content(const char* data, size_t nbytes)
+{
+	size_t loaded = endloaded - space.begin;
+	size_t capacity = space.end_array - space.begin;
+	if (loaded + nbytes > capacity)
+	{
+		size_t offset = space.end - space.begin;
+		space.reserve(std::max(2 * capacity, loaded + nbytes));
+		space.end = space.begin+offset;
+		endloaded = space.begin+loaded;
+	}
+	memcpy(endloaded, data, nbytes);
+	endloaded += nbytes;
+}
+
 ssize_t IOBuffer::read_file(void* buf, size_t nbytes)
 {
 	return read(working_file, buf, nbytes);
@@ -86,6 +86,22 @@ namespace shogun
 	 */
 	void set(char *p);
 
+	/**
+	 * Discard all loaded content, so that the buffer can be filled
+	 * with append_content() from memory instead of a file.
+	 */
+	void reset_content();
+
+	/**
+	 * Append bytes to the loaded content, growing the buffer space
+	 * if needed. Pointers obtained by earlier reads are invalidated
+	 * when the buffer grows.
+	 *
+	 * @param data bytes to append
+	 * @param nbytes number of bytes
+	 */
+	void append_content(const char* data, size_t nbytes);
+
 	/**
 	 * Read some bytes from the file into memory.
 	 *
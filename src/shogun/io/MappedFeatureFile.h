@@ -0,0 +1,412 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __MAPPEDFEATUREFILE_H__
+#define __MAPPEDFEATUREFILE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/io/MemoryMappedFile.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGSparseVector.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+namespace shogun
+{
+/** version of the on-disk layout written by MappedFeatureFile */
+#define MAPPED_FEATURES_VERSION 1
+/** alignment of the blocks of a mapped feature file in bytes */
+#define MAPPED_FEATURES_ALIGNMENT 4096
+
+/** layout of the feature data of a mapped feature file */
+enum EMappedFeatureLayout
+{
+	MFL_DENSE = 1,
+	MFL_SPARSE = 2
+};
+
+/** @brief header at the start of every mapped feature file.
+ *
+ * All offsets are in bytes from the start of the file and are multiples
+ * of MAPPED_FEATURES_ALIGNMENT.
+ */
+struct MappedFeatureHeader
+{
+	/// always "SGFEATMM"
+	char magic[8];
+	/// layout version, see MAPPED_FEATURES_VERSION
+	uint32_t version;
+	/// EMappedFeatureLayout
+	uint32_t layout;
+	/// EPrimitiveType of the stored values
+	uint32_t ptype;
+	/// size of one stored value or sparse entry in bytes
+	uint32_t entry_size;
+	/// MAPPED_FEATURES_BYTE_ORDER as written by the creating machine
+	uint32_t byte_order;
+	/// unused, zero
+	uint32_t reserved;
+	/// number of features (rows)
+	int64_t num_features;
+	/// number of vectors (columns)
+	int64_t num_vectors;
+	/// number of stored values or sparse entries
+	int64_t num_entries;
+	/// offset of the row offsets of a sparse file, 0 for dense files
+	uint64_t offsets_offset;
+	/// offset of the values or sparse entries
+	uint64_t data_offset;
+};
+
+/** @brief Memory mapped feature matrix stored in a binary columnar file.
+ *
+ * The file starts with a MappedFeatureHeader. Dense matrices follow as one
+ * aligned column-major block, i.e. every feature vector is contiguous.
+ * Sparse matrices are stored CSR-style by vector: an aligned block of
+ * num_vectors+1 int64 offsets, followed by an aligned block of all
+ * SGSparseVectorEntry<T> of all vectors, where the entries of vector i are
+ * [offsets[i], offsets[i+1]).
+ *
+ * Files are written with write() and opened with the constructor, which
+ * maps them copy-on-write and validates them. The views returned by
+ * get_dense_view() and get_sparse_view() point directly into the mapping,
+ * so nothing is parsed or copied; they are valid as long as this object
+ * lives. Writing to them only changes the pages written to in memory, the
+ * file itself is never modified. Files are tied to the byte order and type
+ * sizes of the machine that wrote them.
+ *
+ * Opening a sparse file checks its offsets, which takes time linear in the
+ * number of vectors. Checking the feature indices of all entries needs a
+ * pass over the whole file, so it is only done on request. Files from an
+ * untrusted source should be opened with check_indices, as out of range
+ * indices in the views are not detected later.
+ */
+template <class T> class MappedFeatureFile : public SGObject
+{
+public:
+	/** default constructor */
+	MappedFeatureFile() : SGObject()
+	{
+		init();
+	}
+
+	/** constructor, maps a file and validates its header
+	 *
+	 * @param fname name of the file
+	 * @param check_indices whether to check the feature indices of all
+	 * sparse entries
+	 */
+	MappedFeatureFile(const char* fname, bool check_indices=false)
+		: SGObject()
+	{
+		init();
+
+		m_file=std::make_shared<MemoryMappedFile<char>>(fname, 'c');
+		require(m_file->get_size()>=sizeof(MappedFeatureHeader),
+			"File {} is too small to be a mapped feature file", fname);
+
+		memcpy(&m_header, m_file->get_map(), sizeof(MappedFeatureHeader));
+		validate(fname);
+		if (check_indices && get_layout()==MFL_SPARSE)
+			validate_indices(fname);
+	}
+
+	/** destructor */
+	virtual ~MappedFeatureFile()
+	{
+	}
+
+	/** write a dense feature matrix
+	 *
+	 * @param fname name of the file
+	 * @param matrix matrix with one feature vector per column
+	 */
+	static void write(const char* fname, SGMatrix<T> matrix)
+	{
+		MappedFeatureHeader header=create_header(MFL_DENSE, sizeof(T));
+		header.num_features=matrix.num_rows;
+		header.num_vectors=matrix.num_cols;
+		header.num_entries=int64_t(matrix.num_rows)*matrix.num_cols;
+		header.data_offset=align(sizeof(MappedFeatureHeader));
+
+		FILE* f=open_for_writing(fname);
+		write_block(f, &header, sizeof(header), 0, fname);
+		write_block(f, matrix.matrix, header.num_entries*sizeof(T),
+			header.data_offset, fname);
+		fclose(f);
+	}
+
+	/** write a sparse feature matrix
+	 *
+	 * @param fname name of the file
+	 * @param matrix sparse matrix with one feature vector per column
+	 */
+	static void write(const char* fname, SGSparseMatrix<T> matrix)
+	{
+		std::vector<int64_t> offsets(matrix.num_vectors+1, 0);
+		for (index_t i=0; i<matrix.num_vectors; i++)
+		{
+			for (index_t j=0; j<matrix[i].num_feat_entries; j++)
+			{
+				auto idx=matrix[i].features[j].feat_index;
+				require(idx>=0 && idx<matrix.num_features,
+					"Feature index {} of vector {} exceeds [0;{}]", idx, i,
+					matrix.num_features-1);
+			}
+			offsets[i+1]=offsets[i]+matrix[i].num_feat_entries;
+		}
+
+		MappedFeatureHeader header=
+			create_header(MFL_SPARSE, sizeof(SGSparseVectorEntry<T>));
+		header.num_features=matrix.num_features;
+		header.num_vectors=matrix.num_vectors;
+		header.num_entries=offsets.back();
+		header.offsets_offset=align(sizeof(MappedFeatureHeader));
+		header.data_offset=align(
+			header.offsets_offset+offsets.size()*sizeof(int64_t));
+
+		FILE* f=open_for_writing(fname);
+		write_block(f, &header, sizeof(header), 0, fname);
+		write_block(f, offsets.data(), offsets.size()*sizeof(int64_t),
+			header.offsets_offset, fname);
+		uint64_t pos=header.data_offset;
+		for (index_t i=0; i<matrix.num_vectors; i++)
+		{
+			auto bytes=matrix[i].num_feat_entries*sizeof(SGSparseVectorEntry<T>);
+			write_block(f, matrix[i].features, bytes, pos, fname);
+			pos+=bytes;
+		}
+		fclose(f);
+	}
+
+	/** @return layout of the mapped file */
+	EMappedFeatureLayout get_layout() const
+	{
+		return (EMappedFeatureLayout) m_header.layout;
+	}
+
+	/** @return number of features */
+	int32_t get_num_features() const { return m_header.num_features; }
+
+	/** @return number of vectors */
+	int32_t get_num_vectors() const { return m_header.num_vectors; }
+
+	/** @return number of stored values or sparse entries */
+	int64_t get_num_entries() const { return m_header.num_entries; }
+
+	/** @return view on the mapped dense matrix */
+	SGMatrix<T> get_dense_view() const
+	{
+		require(m_file, "No file mapped");
+		require(get_layout()==MFL_DENSE, "Mapped file is not dense");
+
+		return SGMatrix<T>((T*) (m_file->get_map()+m_header.data_offset),
+			m_header.num_features, m_header.num_vectors, false);
+	}
+
+	/** @return sparse matrix whose vectors are views on the mapped entries */
+	SGSparseMatrix<T> get_sparse_view() const
+	{
+		require(m_file, "No file mapped");
+		require(get_layout()==MFL_SPARSE, "Mapped file is not sparse");
+
+		auto offsets=(const int64_t*) (m_file->get_map()+m_header.offsets_offset);
+		auto entries=(SGSparseVectorEntry<T>*) (
+			m_file->get_map()+m_header.data_offset);
+
+		SGSparseMatrix<T> matrix(m_header.num_features, m_header.num_vectors);
+		for (index_t i=0; i<matrix.num_vectors; i++)
+		{
+			matrix[i]=SGSparseVector<T>(entries+offsets[i],
+				offsets[i+1]-offsets[i], false);
+		}
+		return matrix;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const { return "MappedFeatureFile"; }
+
+private:
+	void init()
+	{
+		memset(&m_header, 0, sizeof(MappedFeatureHeader));
+		set_generic<T>();
+	}
+
+	static uint64_t align(uint64_t offset)
+	{
+		return (offset+MAPPED_FEATURES_ALIGNMENT-1)/
+			MAPPED_FEATURES_ALIGNMENT*MAPPED_FEATURES_ALIGNMENT;
+	}
+
+	/** @return primitive type of the stored values, as in set_generic() */
+	static EPrimitiveType primitive_type()
+	{
+		if constexpr (std::is_same_v<T, bool>)
+			return PT_BOOL;
+		else if constexpr (std::is_same_v<T, char>)
+			return PT_CHAR;
+		else if constexpr (std::is_same_v<T, int8_t>)
+			return PT_INT8;
+		else if constexpr (std::is_same_v<T, uint8_t>)
+			return PT_UINT8;
+		else if constexpr (std::is_same_v<T, int16_t>)
+			return PT_INT16;
+		else if constexpr (std::is_same_v<T, uint16_t>)
+			return PT_UINT16;
+		else if constexpr (std::is_same_v<T, int32_t>)
+			return PT_INT32;
+		else if constexpr (std::is_same_v<T, uint32_t>)
+			return PT_UINT32;
+		else if constexpr (std::is_same_v<T, int64_t>)
+			return PT_INT64;
+		else if constexpr (std::is_same_v<T, uint64_t>)
+			return PT_UINT64;
+		else if constexpr (std::is_same_v<T, float32_t>)
+			return PT_FLOAT32;
+		else if constexpr (std::is_same_v<T, float64_t>)
+			return PT_FLOAT64;
+		else if constexpr (std::is_same_v<T, floatmax_t>)
+			return PT_FLOATMAX;
+		else if constexpr (std::is_same_v<T, complex128_t>)
+			return PT_COMPLEX128;
+		else
+			return PT_UNDEFINED;
+	}
+
+	static MappedFeatureHeader create_header(
+		EMappedFeatureLayout layout, uint32_t entry_size)
+	{
+		MappedFeatureHeader header;
+		memset(&header, 0, sizeof(MappedFeatureHeader));
+		memcpy(header.magic, MAPPED_FEATURES_MAGIC, sizeof(header.magic));
+		header.version=MAPPED_FEATURES_VERSION;
+		header.layout=layout;
+		header.ptype=primitive_type();
+		header.entry_size=entry_size;
+		header.byte_order=MAPPED_FEATURES_BYTE_ORDER;
+		return header;
+	}
+
+	static FILE* open_for_writing(const char* fname)
+	{
+		FILE* f=fopen(fname, "wb");
+		require(f, "Could not open {} for writing", fname);
+		return f;
+	}
+
+	/** writes a block at offset pos, zero padding the gap before it */
+	static void write_block(FILE* f, const void* data, uint64_t bytes,
+		uint64_t pos, const char* fname)
+	{
+		static const char zeros[MAPPED_FEATURES_ALIGNMENT]={0};
+
+		auto cur=(uint64_t) ftell(f);
+		while (cur<pos)
+		{
+			auto n=std::min<uint64_t>(pos-cur, MAPPED_FEATURES_ALIGNMENT);
+			if (fwrite(zeros, 1, n, f)!=n)
+				break;
+			cur+=n;
+		}
+
+		if (cur!=pos || (bytes && fwrite(data, 1, bytes, f)!=bytes))
+		{
+			fclose(f);
+			error("Error writing mapped feature file {}", fname);
+		}
+	}
+
+	void validate(const char* fname)
+	{
+		require(!memcmp(m_header.magic, MAPPED_FEATURES_MAGIC,
+			sizeof(m_header.magic)), "{} is not a mapped feature file", fname);
+		require(m_header.byte_order==MAPPED_FEATURES_BYTE_ORDER,
+			"{} was written on a machine with different byte order", fname);
+		require(m_header.version==MAPPED_FEATURES_VERSION,
+			"{} has layout version {}, only version {} is supported", fname,
+			m_header.version, MAPPED_FEATURES_VERSION);
+		require(m_header.ptype==(uint32_t) primitive_type(),
+			"{} stores values of another type than {}", fname,
+			demangled_type<T>());
+
+		uint64_t entry_size=sizeof(T);
+		if (m_header.layout==MFL_SPARSE)
+			entry_size=sizeof(SGSparseVectorEntry<T>);
+		else
+			require(m_header.layout==MFL_DENSE, "{} has unknown layout {}",
+				fname, m_header.layout);
+		require(m_header.entry_size==entry_size,
+			"{} has entries of {} bytes, expected {}", fname,
+			m_header.entry_size, entry_size);
+
+		const int64_t max_index=std::numeric_limits<index_t>::max();
+		require(m_header.num_features>=0 && m_header.num_features<=max_index &&
+			m_header.num_vectors>=0 && m_header.num_vectors<=max_index &&
+			m_header.num_entries>=0, "{} has invalid dimensions", fname);
+		if (m_header.layout==MFL_DENSE)
+			require(m_header.num_entries==
+				m_header.num_features*m_header.num_vectors,
+				"{} has invalid number of entries", fname);
+
+		uint64_t size=m_file->get_size();
+		require(m_header.data_offset%MAPPED_FEATURES_ALIGNMENT==0 &&
+			m_header.data_offset<=size &&
+			uint64_t(m_header.num_entries)<=(size-m_header.data_offset)/entry_size,
+			"{} is truncated", fname);
+		if (m_header.layout==MFL_SPARSE)
+		{
+			uint64_t offsets_bytes=(m_header.num_vectors+1)*sizeof(int64_t);
+			require(m_header.offsets_offset%MAPPED_FEATURES_ALIGNMENT==0 &&
+				m_header.offsets_offset+offsets_bytes<=m_header.data_offset,
+				"{} has invalid offsets block", fname);
+
+			auto offsets=(const int64_t*) (
+				m_file->get_map()+m_header.offsets_offset);
+			require(offsets[0]==0 &&
+				offsets[m_header.num_vectors]==m_header.num_entries,
+				"{} has offsets not covering its {} entries", fname,
+				m_header.num_entries);
+			for (int64_t i=0; i<m_header.num_vectors; i++)
+				require(offsets[i]<=offsets[i+1],
+					"{} has corrupt offsets of vector {}", fname, i);
+		}
+	}
+
+	void validate_indices(const char* fname)
+	{
+		auto entries=(const SGSparseVectorEntry<T>*) (
+			m_file->get_map()+m_header.data_offset);
+		for (int64_t i=0; i<m_header.num_entries; i++)
+		{
+			require(entries[i].feat_index>=0 &&
+				entries[i].feat_index<m_header.num_features,
+				"{} has feature index {} of entry {} outside [0;{}]",
+				fname, entries[i].feat_index, i, m_header.num_features-1);
+		}
+	}
+
+	/** file magic */
+	static constexpr const char* MAPPED_FEATURES_MAGIC="SGFEATMM";
+	/** written as is to detect foreign byte order */
+	static constexpr uint32_t MAPPED_FEATURES_BYTE_ORDER=0x01020304;
+
+	/** header of the mapped file */
+	MappedFeatureHeader m_header;
+
+	/** the mapping */
+	std::shared_ptr<MemoryMappedFile<char>> m_file;
+};
+}
+#endif // __MAPPEDFEATUREFILE_H__
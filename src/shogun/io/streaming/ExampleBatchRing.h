@@ -0,0 +1,212 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __EXAMPLEBATCHRING_H__
+#define __EXAMPLEBATCHRING_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+#include <shogun/io/streaming/ParseBuffer.h>
+#include <shogun/io/streaming/StreamingFile.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace shogun
+{
+/** @brief A batch of consecutive examples of a stream, together with the
+ * chunk parser that holds the text they were parsed from.
+ *
+ * Examples and their feature vectors are allocated once and reused for
+ * every chunk that passes through the batch.
+ */
+template <class T> struct ExampleBatch
+{
+	/// Examples, only the first num_examples are valid
+	std::vector<Example<T>> examples;
+	/// Allocated length of the feature vector of each example
+	std::vector<index_t> capacity;
+	/// Number of valid examples
+	int32_t num_examples;
+	/// Whether the stream ends with this batch
+	bool last;
+	/// Parser holding the text of the batch, which examples may point into
+	std::shared_ptr<StreamingFile> source;
+	/// 2*seq if free for sequence number seq, 2*seq+1 if filled with it
+	alignas(CPU_CACHE_LINE_SIZE) std::atomic<int64_t> ticket;
+};
+
+/** @brief Bounded ring of example batches, filled in parallel by any
+ * number of parse threads and read in order by a single consumer.
+ *
+ * The chunks of a stream are numbered consecutively and chunk seq is
+ * always parsed into batch seq % num_batches. Every batch carries a ticket
+ * that tells whether it is free for or filled with a given sequence
+ * number, so producers and the consumer hand over batches without locks:
+ * a producer waits until its batch has been released by the consumer and
+ * the consumer waits until the next batch in sequence has been published.
+ */
+template <class T> class ExampleBatchRing
+{
+public:
+	/** constructor
+	 *
+	 * @param num_batches number of batches in the ring
+	 * @param batch_size maximum number of examples of a batch
+	 * @param source input file, whose chunk parsers are used for the batches
+	 */
+	ExampleBatchRing(int32_t num_batches, int32_t batch_size,
+		std::shared_ptr<StreamingFile> source)
+		: m_num_batches(num_batches), m_batch_size(batch_size),
+		  m_free_vectors_on_destruct(true), m_filling(true)
+	{
+		require(num_batches>0, "Number of batches ({}) must be positive!",
+			num_batches);
+		require(batch_size>0, "Batch size ({}) must be positive!", batch_size);
+
+		m_batches=std::make_unique<ExampleBatch<T>[]>(num_batches);
+		for (int32_t b=0; b<num_batches; b++)
+		{
+			auto& batch=m_batches[b];
+			batch.examples.resize(batch_size);
+			for (auto& ex : batch.examples)
+			{
+				ex.label=FLT_MAX;
+				ex.fv=NULL;
+				ex.length=0;
+			}
+			batch.capacity.assign(batch_size, 0);
+			batch.num_examples=0;
+			batch.last=false;
+			batch.source=source->create_chunk_parser();
+			batch.ticket.store(2*int64_t(b), std::memory_order_relaxed);
+		}
+	}
+
+	~ExampleBatchRing()
+	{
+		if (!m_free_vectors_on_destruct)
+			return;
+
+		for (int32_t b=0; b<m_num_batches; b++)
+		{
+			for (auto& ex : m_batches[b].examples)
+				SG_FREE(ex.fv);
+		}
+	}
+
+	ExampleBatchRing(const ExampleBatchRing&)=delete;
+	ExampleBatchRing& operator=(const ExampleBatchRing&)=delete;
+
+	/** @return number of batches */
+	int32_t get_num_batches() const { return m_num_batches; }
+
+	/** @return maximum number of examples of a batch */
+	int32_t get_batch_size() const { return m_batch_size; }
+
+	/** Sets whether feature vectors are freed on destruction
+	 *
+	 * @param destroy free all vectors on destruction
+	 */
+	void set_free_vectors_on_destruct(bool destroy)
+	{
+		m_free_vectors_on_destruct=destroy;
+	}
+
+	/** @param seq sequence number
+	 * @return batch that holds chunk seq
+	 */
+	ExampleBatch<T>* get_batch(int64_t seq)
+	{
+		return &m_batches[seq % m_num_batches];
+	}
+
+	/** Waits until the batch of chunk seq can be filled
+	 *
+	 * @param seq sequence number
+	 * @param keep_running waiting stops once this turns false
+	 * @return batch or NULL if waiting or filling was stopped
+	 */
+	ExampleBatch<T>* acquire_free(
+		int64_t seq, const std::atomic_bool& keep_running)
+	{
+		return wait_for(seq, 2*seq, keep_running, true);
+	}
+
+	/** Stops producers that wait for a free batch, used once a batch ends
+	 * the stream as the batches behind it are never consumed
+	 */
+	void stop_filling()
+	{
+		m_filling.store(false, std::memory_order_release);
+	}
+
+	/** Makes a filled batch available to the consumer
+	 *
+	 * @param seq sequence number the batch was acquired for
+	 */
+	void publish(int64_t seq)
+	{
+		get_batch(seq)->ticket.store(2*seq+1, std::memory_order_release);
+	}
+
+	/** Waits until chunk seq has been parsed
+	 *
+	 * @param seq sequence number
+	 * @param keep_running waiting stops once this turns false
+	 * @return batch or NULL if waiting was stopped
+	 */
+	ExampleBatch<T>* acquire_filled(
+		int64_t seq, const std::atomic_bool& keep_running)
+	{
+		return wait_for(seq, 2*seq+1, keep_running, false);
+	}
+
+	/** Hands a consumed batch back for chunk seq + num_batches
+	 *
+	 * @param seq sequence number the batch was filled with
+	 */
+	void release(int64_t seq)
+	{
+		get_batch(seq)->ticket.store(
+			2*(seq+m_num_batches), std::memory_order_release);
+	}
+
+private:
+	ExampleBatch<T>* wait_for(int64_t seq, int64_t ticket,
+		const std::atomic_bool& keep_running, bool producer)
+	{
+		auto batch=get_batch(seq);
+		int32_t spins=0;
+		while (batch->ticket.load(std::memory_order_acquire)!=ticket)
+		{
+			if (!keep_running.load(std::memory_order_acquire))
+				return NULL;
+			if (producer && !m_filling.load(std::memory_order_acquire))
+				return NULL;
+
+			// back off once the wait is not short anymore
+			if (spins<1024)
+			{
+				spins++;
+				std::this_thread::yield();
+			}
+			else
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+		return batch;
+	}
+
+	int32_t m_num_batches;
+	int32_t m_batch_size;
+	bool m_free_vectors_on_destruct;
+	std::atomic_bool m_filling;
+	std::unique_ptr<ExampleBatch<T>[]> m_batches;
+};
+}
+#endif // __EXAMPLEBATCHRING_H__
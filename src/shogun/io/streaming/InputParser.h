@@ -14,10 +14,13 @@
 #include <shogun/io/SGIO.h>
 #include <shogun/io/streaming/StreamingFile.h>
 #include <shogun/io/streaming/ParseBuffer.h>
+#include <shogun/io/streaming/ExampleBatchRing.h>
+#include <algorithm>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #define PARSER_DEFAULT_BUFFSIZE 100
 
@@ -71,6 +74,16 @@ namespace shogun
  * The parsing thread should be joined with a call to end_parser().
  * exit_parser() may be used to cancel the parse thread if needed.
  *
+ * If more than one parse thread is requested through
+ * set_num_parse_threads() and the input supports chunked parsing (see
+ * StreamingFile::supports_chunked_parsing()), the parser runs as a
+ * pipeline instead: the parse threads take turns reading chunks of lines
+ * from the input and parse them concurrently into the batches of an
+ * ExampleBatchRing, which hands them to the learner in input order
+ * without locks. Batches and the feature vectors of their examples are
+ * allocated once and reused. get_next_batch() returns many examples at
+ * once, which saves the per-example synchronisation of get_next_example().
+ *
  * Options are provided for automatic SG_FREEing of example objects
  * after each finalize_example() and also on InputParser destruction.
  * They are set through the set_free_vector* functions.
@@ -193,9 +206,26 @@ public:
     void set_free_vectors_on_destruct(bool destroy);
 
     /**
-     * Starts the parser, creating a new thread.
+     * Sets the number of parse threads. Takes effect on the next call of
+     * start_parser(); inputs that do not support chunked parsing always
+     * use a single thread.
+     *
+     * @param num_threads number of parse threads
+     */
+    void set_num_parse_threads(int32_t num_threads);
+
+    /**
+     * Returns the number of parse threads
+     *
+     * @return number of parse threads
+     */
+    int32_t get_num_parse_threads() { return num_parse_threads; }
+
+    /**
+     * Starts the parser, creating new threads.
      *
-     * main_parse_loop is the parsing method.
+     * main_parse_loop is the parsing method of a single parse thread,
+     * parse_chunks() the one of each thread of a pipelined parser.
      */
     void start_parser();
 
@@ -252,6 +282,18 @@ public:
     int32_t get_next_example(T* &feature_vector,
                  int32_t &length);
 
+    /**
+     * Gets up to max_examples next examples at once. A pipelined parser
+     * returns the unread examples of its current batch, otherwise a
+     * single example is returned.
+     *
+     * @param examples set to the first example, the others follow it
+     * @param max_examples maximum number of examples to return
+     *
+     * @return number of examples, 0 if no more examples are left
+     */
+    int32_t get_next_batch(Example<T>* &examples, int32_t max_examples);
+
     /**
      * Finalize the current example, indicating that the buffer
      * position it occupies may be overwritten by the parser.
@@ -261,6 +303,14 @@ public:
      */
     void finalize_example();
 
+    /**
+     * Finalize a number of examples in the order they were fetched,
+     * e.g. all examples returned by get_next_batch()
+     *
+     * @param num_examples number of examples
+     */
+    void finalize_batch(int32_t num_examples);
+
     /**
      * End the parser, waiting for the parse thread to complete.
      *
@@ -288,6 +338,29 @@ private:
      */
     static void* parse_loop_entry_point(void* params);
 
+    /**
+     * Waits for the next example of the single-threaded parser.
+     *
+     * @return example or NULL if no more examples are left
+     */
+    Example<T>* wait_for_example();
+
+    /**
+     * Parsing loop of each thread of a pipelined parser. Reads chunks
+     * of the input and parses them into the batch ring.
+     */
+    void parse_chunks();
+
+    /**
+     * Parses the lines of a chunk into the examples of a batch.
+     *
+     * @param batch batch whose source holds the chunk
+     * @param num_lines number of lines of the chunk
+     *
+     * @return false if a line ended the input, true otherwise
+     */
+    bool parse_batch(ExampleBatch<T>* batch, int32_t num_lines);
+
 public:
     bool parsing_done;	/**< true if all input is parsed */
     bool reading_done;	/**< true if all examples are fetched */
@@ -356,6 +429,48 @@ protected:
 	/// Flag that indicate that the parsing thread should continue reading
 	alignas(CPU_CACHE_LINE_SIZE) std::atomic_bool keep_running;
 
+    /// Whether examples are freed on destruction
+    bool free_vectors_on_destruct;
+
+    /// Number of parse threads
+    int32_t num_parse_threads;
+
+    /// Threads of a pipelined parser
+    std::vector<std::thread> chunk_threads;
+
+    /// Ring of batches of a pipelined parser, NULL otherwise
+    std::unique_ptr<ExampleBatchRing<T>> batch_ring;
+
+    /// Lock serializing reads of chunks from the input
+    std::mutex chunk_lock;
+
+    /// Sequence number of the next chunk to read
+    int64_t next_chunk;
+
+    /// Whether the input has ended
+    bool chunks_done;
+
+    /// Number of parse threads that are still running
+    int32_t num_active_parsers;
+
+    /// Sequence number of the batch examples are read from
+    int64_t read_seq;
+
+    /// Position of the next example in the batch being read
+    int32_t read_pos;
+
+    /// Number of examples of the batch being read, -1 if none acquired
+    int32_t read_count;
+
+    /// Whether the batch being read is the last one
+    bool read_last;
+
+    /// Sequence number of the batch examples are finalized in
+    int64_t release_seq;
+
+    /// Number of finalized examples of that batch
+    int32_t num_finalized;
+
 };
 
 template <class T>
@@ -379,11 +494,20 @@ template <class T>
 	parsing_done=true;
 	reading_done=true;
 	keep_running.store(false, std::memory_order_release);
+	free_vectors_on_destruct=true;
+	num_parse_threads=1;
 }
 
 template <class T>
     InputParser<T>::~InputParser()
 {
+	// threads of a pipelined parser never block, so they can be stopped
+	if (!chunk_threads.empty())
+	{
+		keep_running.store(false, std::memory_order_release);
+		for (auto& thread : chunk_threads)
+			thread.join();
+	}
 }
 
 template <class T>
@@ -404,6 +528,8 @@ template <class T>
 
     free_after_release=true;
     ring_size=size;
+
+    batch_ring=nullptr;
 }
 
 template <class T>
@@ -415,7 +541,18 @@ template <class T>
 template <class T>
     void InputParser<T>::set_free_vectors_on_destruct(bool destroy)
 {
+	free_vectors_on_destruct=destroy;
 	examples_ring->set_free_vectors_on_destruct(destroy);
+	if (batch_ring)
+		batch_ring->set_free_vectors_on_destruct(destroy);
+}
+
+template <class T>
+    void InputParser<T>::set_num_parse_threads(int32_t num_threads)
+{
+	require(num_threads>0, "Number of parse threads ({}) must be positive!",
+		num_threads);
+	num_parse_threads=num_threads;
 }
 
 template <class T>
@@ -424,9 +561,34 @@ template <class T>
 	SG_TRACE("entering InputParser::start_parser()");
     if (is_running())
     {
-        error("Parser thread is already running! Multiple parse threads not supported.");
+        error("Parser is already running!");
     }
 
+	if (num_parse_threads>1 && input_source->supports_chunked_parsing())
+	{
+		SG_TRACE("creating {} parse threads", num_parse_threads);
+		batch_ring=std::make_unique<ExampleBatchRing<T>>(
+			2*num_parse_threads, ring_size, input_source);
+		batch_ring->set_free_vectors_on_destruct(free_vectors_on_destruct);
+
+		next_chunk=0;
+		chunks_done=false;
+		num_active_parsers=num_parse_threads;
+		read_seq=0;
+		read_pos=0;
+		read_count=-1;
+		read_last=false;
+		release_seq=0;
+		num_finalized=0;
+
+		keep_running.store(true, std::memory_order_release);
+		for (int32_t t=0; t<num_parse_threads; t++)
+			chunk_threads.emplace_back(&InputParser::parse_chunks, this);
+
+		SG_TRACE("leaving InputParser::start_parser()");
+		return;
+	}
+
     SG_TRACE("creating parse thread");
     if (examples_ring)
 		examples_ring->init_vector();
@@ -547,6 +709,83 @@ template <class T> void* InputParser<T>::main_parse_loop(void* params)
     return NULL;
 }
 
+template <class T> void InputParser<T>::parse_chunks()
+{
+	while (keep_running.load(std::memory_order_acquire))
+	{
+		// chunks are read in turns, which keeps them in input order
+		std::unique_lock<std::mutex> lock(chunk_lock);
+		if (chunks_done)
+			break;
+
+		int64_t seq=next_chunk++;
+		auto batch=batch_ring->acquire_free(seq, keep_running);
+		if (!batch)
+			break;
+
+		bool end_of_input;
+		auto num_lines=input_source->read_chunk(
+			batch->source.get(), batch_ring->get_batch_size(), end_of_input);
+		chunks_done=end_of_input;
+		lock.unlock();
+
+		batch->last=!parse_batch(batch, num_lines) || end_of_input;
+		{
+			std::lock_guard<std::mutex> state_lock(examples_state_lock);
+			number_of_vectors_parsed+=batch->num_examples;
+		}
+		if (batch->last && !end_of_input)
+		{
+			// a line ended the input, chunks behind it are dropped
+			batch_ring->stop_filling();
+			lock.lock();
+			chunks_done=true;
+			lock.unlock();
+		}
+		batch_ring->publish(seq);
+	}
+
+	std::lock_guard<std::mutex> lock(examples_state_lock);
+	if (--num_active_parsers==0)
+	{
+		parsing_done=true;
+		examples_state_changed.notify_one();
+	}
+}
+
+template <class T>
+    bool InputParser<T>::parse_batch(ExampleBatch<T>* batch, int32_t num_lines)
+{
+	auto source=batch->source.get();
+	batch->num_examples=0;
+
+	for (int32_t i=0; i<num_lines; i++)
+	{
+		auto& ex=batch->examples[i];
+		T* storage=ex.fv;
+		int32_t len=batch->capacity[i];
+		float64_t label=ex.label;
+
+		if (example_type == E_LABELLED)
+			(source->*read_vector_and_label)(ex.fv, len, label);
+		else
+			(source->*read_vector)(ex.fv, len);
+
+		if (len < 0)
+		{
+			// keep the vector for the next chunk
+			ex.fv=storage;
+			return false;
+		}
+
+		ex.length=len;
+		ex.label=label;
+		batch->capacity[i]=std::max(batch->capacity[i], len);
+		batch->num_examples++;
+	}
+	return true;
+}
+
 template <class T> Example<T>* InputParser<T>::retrieve_example()
 {
     /* This function should be guarded by mutexes while calling  */
@@ -580,17 +819,29 @@ template <class T> Example<T>* InputParser<T>::retrieve_example()
 template <class T> int32_t InputParser<T>::get_next_example(T* &fv,
         int32_t &length, float64_t &label)
 {
-    /* if reading is done, no more examples can be fetched. return 0
-       else, if example can be read, get the example and return 1.
-       otherwise, wait for further parsing, get the example and
-       return 1 */
+    Example<T>* ex;
+    if (get_next_batch(ex, 1) == 0)
+        return 0;
+
+    fv = ex->fv;
+    length = ex->length;
+    label = ex->label;
+
+    return 1;
+}
+
+template <class T> Example<T>* InputParser<T>::wait_for_example()
+{
+    /* if reading is done, no more examples can be fetched. return NULL
+       else, if example can be read, return the example.
+       otherwise, wait for further parsing and return the example */
 
-    Example<T> *ex;
+    Example<T> *ex = NULL;
 
     while (keep_running.load(std::memory_order_acquire))
     {
         if (reading_done)
-            return 0;
+            return NULL;
 
 		std::unique_lock<std::mutex> lock(examples_state_lock);
         ex = retrieve_example();
@@ -600,7 +851,7 @@ template <class T> int32_t InputParser<T>::get_next_example(T* &fv,
             if (reading_done)
             {
                 /* No more examples left, return */
-                return 0;
+                return NULL;
             }
             else
             {
@@ -616,11 +867,57 @@ template <class T> int32_t InputParser<T>::get_next_example(T* &fv,
         }
     }
 
-    fv = ex->fv;
-    length = ex->length;
-    label = ex->label;
+    return ex;
+}
 
-    return 1;
+template <class T>
+    int32_t InputParser<T>::get_next_batch(Example<T>* &examples,
+        int32_t max_examples)
+{
+    if (!batch_ring)
+    {
+        examples = wait_for_example();
+        return examples ? 1 : 0;
+    }
+
+    if (reading_done)
+        return 0;
+
+    while (read_pos == read_count)
+    {
+        if (read_last)
+        {
+            std::lock_guard<std::mutex> lock(examples_state_lock);
+            reading_done = true;
+            return 0;
+        }
+        read_seq++;
+        read_count = -1;
+    }
+
+    if (read_count < 0)
+    {
+        auto batch = batch_ring->acquire_filled(read_seq, keep_running);
+        if (!batch)
+            return 0;
+
+        // the batch may be refilled as soon as all its examples are
+        // finalized, so its state is copied here
+        read_pos = 0;
+        read_count = batch->num_examples;
+        read_last = batch->last;
+        if (read_count == 0)
+            return get_next_batch(examples, max_examples);
+    }
+
+    int32_t num = std::min(max_examples, read_count - read_pos);
+    examples = &batch_ring->get_batch(read_seq)->examples[read_pos];
+    read_pos += num;
+
+    std::lock_guard<std::mutex> lock(examples_state_lock);
+    number_of_vectors_read += num;
+
+    return num;
 }
 
 template <class T>
@@ -634,7 +931,33 @@ template <class T>
 template <class T>
     void InputParser<T>::finalize_example()
 {
-    examples_ring->finalize_example(free_after_release);
+    if (!batch_ring)
+    {
+        examples_ring->finalize_example(free_after_release);
+        return;
+    }
+
+    auto batch = batch_ring->get_batch(release_seq);
+    if (free_after_release)
+    {
+        SG_FREE(batch->examples[num_finalized].fv);
+        batch->examples[num_finalized].fv = NULL;
+        batch->capacity[num_finalized] = 0;
+    }
+
+    if (++num_finalized == batch->num_examples)
+    {
+        batch_ring->release(release_seq);
+        release_seq++;
+        num_finalized = 0;
+    }
+}
+
+template <class T>
+    void InputParser<T>::finalize_batch(int32_t num_examples)
+{
+    for (int32_t i=0; i<num_examples; i++)
+        finalize_example();
 }
 
 template <class T> void InputParser<T>::end_parser()
@@ -643,6 +966,9 @@ template <class T> void InputParser<T>::end_parser()
 	SG_TRACE("joining parse thread");
 	if (parse_thread.joinable())
 		parse_thread.join();
+	for (auto& thread : chunk_threads)
+		thread.join();
+	chunk_threads.clear();
     SG_TRACE("leaving InputParser::end_parser");
 }
 
@@ -653,6 +979,9 @@ template <class T> void InputParser<T>::exit_parser()
 	examples_state_changed.notify_one();
 	if (parse_thread.joinable())
 		parse_thread.join();
+	for (auto& thread : chunk_threads)
+		thread.join();
+	chunk_threads.clear();
 }
 }
 
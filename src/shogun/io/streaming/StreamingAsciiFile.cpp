@@ -26,10 +26,24 @@ StreamingAsciiFile::StreamingAsciiFile(const char* fname, char rw)
 	m_delimiter = ' ';
 }
 
+StreamingAsciiFile::StreamingAsciiFile(
+	std::shared_ptr<IOBuffer> buffer, char delimiter)
+		: StreamingFile()
+{
+	buf = buffer;
+	m_delimiter = delimiter;
+}
+
 StreamingAsciiFile::~StreamingAsciiFile()
 {
 }
 
+std::shared_ptr<StreamingFile> StreamingAsciiFile::create_chunk_parser()
+{
+	return std::shared_ptr<StreamingAsciiFile>(
+		new StreamingAsciiFile(std::make_shared<IOBuffer>(), m_delimiter));
+}
+
 /* Methods for reading dense vectors from an ascii file */
 
 #define GET_VECTOR(fname, conv, sg_type)									\
@@ -98,6 +98,12 @@ public:
 	GET_VECTOR_DECL(floatmax_t)
 #undef GET_VECTOR_DECL
 
+	/** @return true, lines of an ascii file can be parsed independently */
+	virtual bool supports_chunked_parsing() { return true; }
+
+	/** @return ascii file with the same delimiter that parses chunks */
+	virtual std::shared_ptr<StreamingFile> create_chunk_parser();
+
 #endif // #ifndef SWIG // SWIG should skip this
 
 	/** @return object name */
@@ -107,6 +113,14 @@ public:
 
 	}
 
+protected:
+	/** constructor for chunk parsers
+	 *
+	 * @param buffer buffer holding the text to parse
+	 * @param delimiter delimiter of dense vector entries
+	 */
+	StreamingAsciiFile(std::shared_ptr<IOBuffer> buffer, char delimiter);
+
 private:
 	/** helper function to read vectors / matrices
 	 *
@@ -223,3 +223,33 @@ StreamingFile::~StreamingFile()
 {
 	SG_FREE(filename);
 }
+
+std::shared_ptr<StreamingFile> StreamingFile::create_chunk_parser()
+{
+	not_implemented(SOURCE_LOCATION);
+	return nullptr;
+}
+
+int32_t StreamingFile::read_chunk(
+	StreamingFile* chunk_parser, int32_t max_lines, bool& end_of_input)
+{
+	auto chunk=chunk_parser->buf;
+	chunk->reset_content();
+	end_of_input=false;
+
+	int32_t num_lines=0;
+	char* line=NULL;
+	while (num_lines<max_lines)
+	{
+		ssize_t len=buf->read_line(line);
+		if (len<=0)
+		{
+			end_of_input=true;
+			break;
+		}
+		chunk->append_content(line, len);
+		chunk->append_content("\n", 1);
+		num_lines++;
+	}
+	return num_lines;
+}
@@ -65,6 +65,37 @@ template <class ST> struct SGSparseVectorEntry;
 		 */
 		virtual void reset_stream() { error("Unable to reset the input stream!"); }
 
+		/**
+		 * Whether the input consists of independent lines which can be
+		 * parsed concurrently, see read_chunk() and create_chunk_parser()
+		 *
+		 * @return false by default, unless overloaded
+		 */
+		virtual bool supports_chunked_parsing() { return false; }
+
+		/**
+		 * Create a file of the same format which parses chunks of lines
+		 * held in memory instead of reading from a file
+		 *
+		 * @return chunk parser
+		 */
+		virtual std::shared_ptr<StreamingFile> create_chunk_parser();
+
+		/**
+		 * Move up to max_lines complete lines from the input into the
+		 * buffer of a chunk parser, replacing its previous content.
+		 * Like the get_vector* functions, an empty line or the end of the
+		 * file ends the input.
+		 *
+		 * @param chunk_parser parser obtained from create_chunk_parser()
+		 * @param max_lines maximum number of lines to read
+		 * @param end_of_input set to true if the input has ended
+		 *
+		 * @return number of lines read
+		 */
+		int32_t read_chunk(
+			StreamingFile* chunk_parser, int32_t max_lines, bool& end_of_input);
+
 		/** @name Dense Vector Access Functions
 		 *
 		 * Functions to access dense vectors of one of several
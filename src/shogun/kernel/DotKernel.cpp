@@ -0,0 +1,22 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/kernel/DotKernel.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+
+using namespace shogun;
+
+bool DotKernel::supports_dot_block() const
+{
+	return lhs && rhs && lhs->get_feature_class()==C_DENSE &&
+		rhs->get_feature_class()==C_DENSE &&
+		lhs->get_feature_type()==F_DREAL && rhs->get_feature_type()==F_DREAL;
+}
+
+void DotKernel::compute_dot_block(
+	const SGMatrix<float64_t>& lhs_block, const SGMatrix<float64_t>& rhs_block,
+	SGMatrix<float64_t>& block) const
+{
+	linalg::matrix_prod(lhs_block, rhs_block, block, true, false);
+}
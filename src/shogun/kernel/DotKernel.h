@@ -133,6 +133,24 @@ class DotKernel : public Kernel
 		{
 			return (std::static_pointer_cast<DotFeatures>(lhs))->dot(idx_a, (std::static_pointer_cast<DotFeatures>(rhs)), idx_b);
 		}
+
+		/** @return whether both lhs and rhs are DenseFeatures<float64_t>,
+		 * i.e. whether compute_dot_block() can be used
+		 */
+		bool supports_dot_block() const;
+
+		/** compute all dot products between the columns of two blocks of
+		 * dense feature vectors with a single matrix product
+		 *
+		 * @param lhs_block lhs feature vectors, one per column
+		 * @param rhs_block rhs feature vectors, one per column
+		 * @param block preallocated result of size
+		 * lhs_block.num_cols x rhs_block.num_cols
+		 */
+		void compute_dot_block(
+			const SGMatrix<float64_t>& lhs_block,
+			const SGMatrix<float64_t>& rhs_block,
+			SGMatrix<float64_t>& block) const;
 };
 }
 #endif /* _DOTKERNEL_H__ */
@@ -5,11 +5,32 @@
  *          Soumyajit De, Viktor Gal, Bjoern Esser, Soeren Sonnenburg
  */
 
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/kernel/GaussianARDKernel.h>
+#include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
+#include <vector>
+
 using namespace shogun;
+using namespace Eigen;
+
+// number of rhs vectors per tile of the fused gradient, such that the tile
+// of kernel values stays in cache
+static constexpr index_t GRADIENT_BLOCK_SIZE=256;
+
+/** kernel values exp(-||z_j-z'_k||^2/2) between the columns of two blocks
+ * of transformed feature vectors
+ */
+static MatrixXd ard_kernel_block(const MatrixXd& Zl, const MatrixXd& Zr)
+{
+	MatrixXd block=-2*Zl.transpose()*Zr;
+	block.colwise()+=Zl.colwise().squaredNorm().transpose();
+	block.rowwise()+=Zr.colwise().squaredNorm();
+	return (-0.5*block.array().max(0.0)).exp().matrix();
+}
 
 GaussianARDKernel::GaussianARDKernel() : ExponentialARDKernel()
 {
@@ -296,3 +317,180 @@ SGMatrix<float64_t> GaussianARDKernel::get_parameter_gradient(
 		return SGMatrix<float64_t>();
 	}
 }
+
+SGMatrix<float64_t> GaussianARDKernel::get_weight_matrix(index_t dim) const
+{
+	SGMatrix<float64_t> weights(dim,
+		m_ARD_type==KT_FULL ? index_t(m_weights_cols) : dim);
+	weights.zero();
+
+	if (m_ARD_type==KT_SCALAR)
+	{
+		for (index_t i=0; i<dim; i++)
+			weights(i,i)=std::exp(m_log_weights[0]);
+	}
+	else if (m_ARD_type==KT_DIAG)
+	{
+		require(m_log_weights.vlen==dim, "Dimension mismatch between features ({}) and weights ({})",
+			dim, m_log_weights.vlen);
+		for (index_t i=0; i<dim; i++)
+			weights(i,i)=std::exp(m_log_weights[i]);
+	}
+	else if (m_ARD_type==KT_FULL)
+	{
+		require(m_weights_rows==dim, "Dimension mismatch between features ({}) and weights ({})",
+			dim, m_weights_rows);
+		// the lower triangle is stored column by column, diagonal in log domain
+		index_t offset=0;
+		for (index_t i=0; i<weights.num_cols && i<weights.num_rows; i++)
+		{
+			for (index_t k=i; k<weights.num_rows; k++)
+				weights(k,i)=m_log_weights[offset+k-i];
+			weights(i,i)=std::exp(weights(i,i));
+			offset+=weights.num_rows-i;
+		}
+	}
+	else
+		error("Unsupported ARD type");
+
+	return weights;
+}
+
+bool GaussianARDKernel::supports_block_computation()
+{
+	// subclasses override compute() with different kernel functions
+	return get_kernel_type()==K_GAUSSIANARD && supports_dot_block();
+}
+
+void GaussianARDKernel::compute_block_from_features(
+	const SGMatrix<float64_t>& lhs_block, const SGMatrix<float64_t>& rhs_block,
+	SGMatrix<float64_t>& block)
+{
+	SGMatrix<float64_t> weight_matrix=get_weight_matrix(lhs_block.num_rows);
+	Map<MatrixXd> L(weight_matrix.matrix, weight_matrix.num_rows,
+		weight_matrix.num_cols);
+	Map<MatrixXd> Xl(lhs_block.matrix, lhs_block.num_rows, lhs_block.num_cols);
+	Map<MatrixXd> Xr(rhs_block.matrix, rhs_block.num_rows, rhs_block.num_cols);
+	Map<MatrixXd> eigen_block(block.matrix, block.num_rows, block.num_cols);
+
+	eigen_block=ard_kernel_block(L.transpose()*Xl, L.transpose()*Xr);
+}
+
+SGVector<float64_t> GaussianARDKernel::get_parameter_gradient_sum(
+	Parameters::const_reference param, SGMatrix<float64_t> weights)
+{
+	if (param.first!="log_weights" || !supports_dot_block() ||
+		!std::dynamic_pointer_cast<IdentityKernelNormalizer>(normalizer))
+		return ExponentialARDKernel::get_parameter_gradient_sum(param, weights);
+
+	require(weights.num_rows==num_lhs && weights.num_cols==num_rhs,
+		"Weights ({}x{}) must be of the size of the kernel matrix ({}x{})!",
+		weights.num_rows, weights.num_cols, num_lhs, num_rhs);
+
+	auto lhs_features=std::static_pointer_cast<DenseFeatures<float64_t>>(lhs);
+	auto rhs_features=std::static_pointer_cast<DenseFeatures<float64_t>>(rhs);
+	const index_t dim=lhs_features->get_num_features();
+
+	SGMatrix<float64_t> weight_matrix=get_weight_matrix(dim);
+	Map<MatrixXd> L(weight_matrix.matrix, weight_matrix.num_rows,
+		weight_matrix.num_cols);
+	Map<MatrixXd> W(weights.matrix, weights.num_rows, weights.num_cols);
+	const bool full=m_ARD_type==KT_FULL;
+
+	SGMatrix<float64_t> rhs_matrix=rhs_features->get_feature_matrix_block(0, num_rhs);
+	Map<MatrixXd> Xr_all(rhs_matrix.matrix, rhs_matrix.num_rows,
+		rhs_matrix.num_cols);
+	const MatrixXd Zr_all=L.transpose()*Xr_all;
+
+	// with G=W.*K, the derivatives wrt L are given by the matrix
+	// sum_jk G_jk (z_j-z'_k)(x_j-y_k)^T, which expands into products of the
+	// feature blocks with G, its row sums r and its column sums c. Every
+	// row block keeps its own partial, which are summed in block order so
+	// that the gradient does not depend on the number of threads
+	const index_t num_row_blocks=
+		(num_lhs+GRADIENT_BLOCK_SIZE-1)/GRADIENT_BLOCK_SIZE;
+	std::vector<MatrixXd> block_M(num_row_blocks);
+	std::vector<VectorXd> block_diagonal(num_row_blocks);
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_row_blocks; ++b)
+	{
+		MatrixXd& local_M=block_M[b];
+		VectorXd& local_diagonal=block_diagonal[b];
+		local_M=MatrixXd::Zero(full ? L.cols() : 0, full ? dim : 0);
+		local_diagonal=VectorXd::Zero(full ? 0 : dim);
+
+		const index_t row_begin=b*GRADIENT_BLOCK_SIZE;
+		const index_t row_end=Math::min(row_begin+GRADIENT_BLOCK_SIZE, num_lhs);
+		SGMatrix<float64_t> lhs_block=
+			lhs_features->get_feature_matrix_block(row_begin, row_end);
+		Map<MatrixXd> Xl(lhs_block.matrix, lhs_block.num_rows,
+			lhs_block.num_cols);
+		const MatrixXd Zl=L.transpose()*Xl;
+
+		for (index_t col_begin=0; col_begin<num_rhs;
+			col_begin+=GRADIENT_BLOCK_SIZE)
+		{
+			const index_t num_cols=
+				Math::min(GRADIENT_BLOCK_SIZE, num_rhs-col_begin);
+			auto Xr=Xr_all.middleCols(col_begin, num_cols);
+			auto Zr=Zr_all.middleCols(col_begin, num_cols);
+
+			const MatrixXd G=ard_kernel_block(Zl, Zr).cwiseProduct(
+				W.block(row_begin, col_begin, row_end-row_begin, num_cols));
+			const VectorXd r=G.rowwise().sum();
+			const VectorXd c=G.colwise().sum().transpose();
+
+			if (full)
+			{
+				local_M.noalias()+=Zl*r.asDiagonal()*Xl.transpose();
+				local_M.noalias()+=Zr*c.asDiagonal()*Xr.transpose();
+				local_M.noalias()-=(Zl*G)*Xr.transpose();
+				local_M.noalias()-=(Zr*G.transpose())*Xl.transpose();
+			}
+			else
+			{
+				local_diagonal+=Zl.cwiseProduct(Xl)*r;
+				local_diagonal+=Zr.cwiseProduct(Xr)*c;
+				local_diagonal-=Zl.cwiseProduct(Xr*G.transpose())
+					.rowwise().sum();
+				local_diagonal-=Xl.cwiseProduct(Zr*G.transpose())
+					.rowwise().sum();
+			}
+		}
+	}
+
+	MatrixXd M=MatrixXd::Zero(full ? L.cols() : 0, full ? dim : 0);
+	VectorXd diagonal=VectorXd::Zero(full ? 0 : dim);
+	for (index_t b=0; b<num_row_blocks; ++b)
+	{
+		M+=block_M[b];
+		diagonal+=block_diagonal[b];
+	}
+
+	SGVector<float64_t> result(m_log_weights.vlen);
+	if (m_ARD_type==KT_SCALAR)
+		result[0]=-std::exp(m_log_weights[0])*diagonal.sum();
+	else if (m_ARD_type==KT_DIAG)
+	{
+		for (index_t i=0; i<result.vlen; i++)
+			result[i]=-std::exp(m_log_weights[i])*diagonal[i];
+	}
+	else
+	{
+		// derivative wrt L(p,q) is -M(q,p), chain rule for the log diagonal
+		index_t offset=0;
+		for (index_t q=0; q<L.cols() && q<L.rows(); q++)
+		{
+			for (index_t p=q; p<L.rows(); p++)
+			{
+				result[offset+p-q]=-M(q,p);
+				if (p==q)
+					result[offset]*=L(q,q);
+			}
+			offset+=L.rows()-q;
+		}
+	}
+
+	return result;
+}
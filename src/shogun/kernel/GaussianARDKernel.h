@@ -142,7 +142,37 @@ public:
 	virtual SGVector<float64_t> get_parameter_gradient_diagonal(
 		Parameters::const_reference param, index_t index=-1);
 
+	/** return the derivatives of the weighted sum of all kernel values wrt
+	 * all weights at once
+	 *
+	 * With \f$z=L^{T}x\f$ for the weight matrix \f$L\f$, the derivatives
+	 * wrt all elements of \f$L\f$ follow from the matrix
+	 * \f$\sum_{j,k} W_{jk}k(x_j, y_k)(z_j-z'_k)(x_j-y_k)^{T}\f$, which is
+	 * accumulated from tiles of kernel values by matrix products. Neither
+	 * the derivative matrices nor the pairwise differences are formed.
+	 *
+	 * @param param the parameter
+	 * @param weights matrix W of size num_lhs x num_rhs
+	 *
+	 * @return vector with one derivative per weight
+	 */
+	virtual SGVector<float64_t> get_parameter_gradient_sum(
+		Parameters::const_reference param, SGMatrix<float64_t> weights);
+
 protected:
+	virtual bool supports_block_computation();
+
+	virtual void compute_block_from_features(
+		const SGMatrix<float64_t>& lhs_block,
+		const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block);
+
+	/** @return the weights as the matrix \f$L\f$ with dim rows, such that
+	 * the distance is \f$\frac{1}{2}\|L^{T}(a-b)\|^2\f$
+	 *
+	 * @param dim number of features
+	 */
+	SGMatrix<float64_t> get_weight_matrix(index_t dim) const;
+
 	/** helper function to compute quadratic terms in
 	 * (a-b)^2 (== a^2+b^2-2ab)
 	 */
@@ -117,6 +117,23 @@ void GaussianKernel::load_serializable_post() noexcept(false)
 		m_distance->init(lhs, rhs);
 }
 
+bool GaussianKernel::supports_block_computation()
+{
+	// subclasses override compute() with different kernel functions
+	return get_kernel_type()==K_GAUSSIAN && supports_distance_block();
+}
+
+void GaussianKernel::compute_block_from_features(
+	const SGMatrix<float64_t>& lhs_block, const SGMatrix<float64_t>& rhs_block,
+	SGMatrix<float64_t>& block)
+{
+	compute_distance_block(lhs_block, rhs_block, block);
+
+	const auto width=get_width();
+	for (auto& v : block)
+		v=std::exp(-v/width);
+}
+
 float64_t GaussianKernel::distance(int32_t idx_a, int32_t idx_b) const
 {
 	return ShiftInvariantKernel::distance(idx_a, idx_b)/get_width();
@@ -189,6 +189,12 @@ protected:
 	 */
 	virtual float64_t distance(int32_t idx_a, int32_t idx_b) const;
 
+	virtual bool supports_block_computation();
+
+	virtual void compute_block_from_features(
+		const SGMatrix<float64_t>& lhs_block,
+		const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block);
+
 protected:
 	/** width */
 	AutoValue<float64_t> m_log_width = AutoValueEmpty{};
@@ -19,7 +19,9 @@
 #include <shogun/base/Parallel.h>
 
 #include <shogun/kernel/Kernel.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
+#include <shogun/machine/visitors/ShapeVisitor.h>
 #include <shogun/features/Features.h>
 
 #include <shogun/classifier/svm/SVM.h>
@@ -31,9 +33,14 @@
 #include <shogun/mathematics/Math.h>
 
 #include <utility>
+#include <vector>
 
 using namespace shogun;
 
+/** number of vectors per side of the tiles of block computations, which
+ * keeps both feature blocks and the result in cache */
+static constexpr index_t KERNEL_BLOCK_SIZE=256;
+
 Kernel::Kernel() : SGObject()
 {
 	init();
@@ -170,77 +177,44 @@ void Kernel::kernel_cache_init(int32_t buffsize, bool regression_hack)
 		error("kernel has zero rows: num_lhs={} num_rhs={}",
 				get_num_vec_lhs(), get_num_vec_rhs());
 	}
-	uint64_t buffer_size=0;
-	int32_t i;
 
 	//in regression the additional constraints are made by doubling the training data
 	if (regression_hack)
 		totdoc*=2;
 
-	buffer_size=((uint64_t) buffsize)*1024*1024/sizeof(KERNELCACHE_ELEM);
-	if (buffer_size>((uint64_t) totdoc)*totdoc)
-		buffer_size=((uint64_t) totdoc)*totdoc;
-
-	io::info("using a kernel cache of size {} MB ({} bytes) for {} Kernel", buffer_size*sizeof(KERNELCACHE_ELEM)/1024/1024, buffer_size*sizeof(KERNELCACHE_ELEM), get_name());
-
-	//make sure it fits in the *signed* KERNELCACHE_IDX type
-	ASSERT(buffer_size < (((uint64_t) 1) << (sizeof(KERNELCACHE_IDX)*8-1)))
-
-	kernel_cache.index = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.occu = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.lru = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.invindex = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.active2totdoc = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.totdoc2active = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.buffer = SG_MALLOC(KERNELCACHE_ELEM, buffer_size);
-	kernel_cache.buffsize=buffer_size;
-	kernel_cache.max_elems=(int32_t) (kernel_cache.buffsize/totdoc);
-
-	if(kernel_cache.max_elems>totdoc) {
-		kernel_cache.max_elems=totdoc;
-	}
-
-	kernel_cache.elems=0;   // initialize cache
-	for(i=0;i<totdoc;i++) {
-		kernel_cache.index[i]=-1;
-		kernel_cache.lru[i]=0;
-	}
-	for(i=0;i<totdoc;i++) {
-		kernel_cache.occu[i]=0;
-		kernel_cache.invindex[i]=-1;
-	}
-
-	kernel_cache.activenum=totdoc;;
-	for(i=0;i<totdoc;i++) {
-		kernel_cache.active2totdoc[i]=i;
-		kernel_cache.totdoc2active[i]=i;
-	}
+	kernel_cache=std::make_unique<KernelRowCache>(
+		totdoc, buffsize, cache_float32, env()->get_num_threads(),
+		cache_eviction);
 
-	kernel_cache.time=0;
+	io::info("using a kernel cache of size {} MB ({} bytes, {} shards{}) for {} Kernel",
+		kernel_cache->get_buffer_bytes()/1024/1024,
+		kernel_cache->get_buffer_bytes(), kernel_cache->get_num_shards(),
+		cache_float32 ? ", float32" : "", get_name());
 }
 
 void Kernel::get_kernel_row(
 	int32_t docnum, int32_t *active2dnum, float64_t *buffer, bool full_line)
 {
 	int32_t i,j;
-	KERNELCACHE_IDX start;
 
 	int32_t num_vectors = get_num_vec_lhs();
 	if (docnum>=num_vectors)
 		docnum=2*num_vectors-1-docnum;
 
+	/* the row must not be evicted while it is read */
+	auto lock=kernel_cache->lock_shared(docnum);
+	int32_t slot=kernel_cache->lookup(docnum);
+
 	/* is cached? */
-	if(kernel_cache.index[docnum] != -1)
+	if(slot != -1)
 	{
-		kernel_cache.lru[kernel_cache.index[docnum]]=kernel_cache.time; /* lru */
-		start=((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[docnum];
-
 		if (full_line)
 		{
 			for(j=0;j<get_num_vec_lhs();j++)
 			{
-				if(kernel_cache.totdoc2active[j] >= 0)
-					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
+				int32_t a=kernel_cache->totdoc2active(j);
+				if(a >= 0)
+					buffer[j]=kernel_cache->get(slot, a);
 				else
 					buffer[j]=(float64_t) kernel(docnum, j);
 			}
@@ -249,8 +223,9 @@ void Kernel::get_kernel_row(
 		{
 			for(i=0;(j=active2dnum[i])>=0;i++)
 			{
-				if(kernel_cache.totdoc2active[j] >= 0)
-					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
+				int32_t a=kernel_cache->totdoc2active(j);
+				if(a >= 0)
+					buffer[j]=kernel_cache->get(slot, a);
 				else
 				{
 					int32_t k=j;
@@ -281,174 +256,91 @@ void Kernel::get_kernel_row(
 	}
 }
 
-
-// Fills cache for the row m
-void Kernel::cache_kernel_row(int32_t m)
+void Kernel::fill_kernel_cache_row(int32_t m, int32_t slot)
 {
-	int32_t j,k,l;
-	KERNELCACHE_ELEM *cache;
-
 	int32_t num_vectors = get_num_vec_lhs();
+	int32_t l=kernel_cache->totdoc2active(m);
 
-	if (m>=num_vectors)
-		m=2*num_vectors-1-m;
-
-	if(!kernel_cache_check(m))   // not cached yet
+	for(int32_t j=0;j<kernel_cache->get_activenum();j++)  // fill cache
 	{
-		cache = kernel_cache_clean_and_malloc(m);
-		if(cache) {
-			l=kernel_cache.totdoc2active[m];
+		int32_t k=kernel_cache->active2totdoc(j);
 
-			for(j=0;j<kernel_cache.activenum;j++)  // fill cache
+		// k(m,k)=k(k,m) might already be cached in row k, which must not
+		// be evicted while it is read
+		if (l != -1)
+		{
+			auto lock=kernel_cache->lock_shared(k);
+			int32_t k_slot=kernel_cache->get_slot(k);
+			if (k_slot != -1)
 			{
-				k=kernel_cache.active2totdoc[j];
-
-				if((kernel_cache.index[k] != -1) && (l != -1) && (k != m)) {
-					cache[j]=kernel_cache.buffer[((KERNELCACHE_IDX) kernel_cache.activenum)
-						*kernel_cache.index[k]+l];
-				}
-				else
-				{
-					if (k>=num_vectors)
-						k=2*num_vectors-1-k;
-
-					cache[j]=kernel(m, k);
-				}
+				kernel_cache->set(slot, j, kernel_cache->get(k_slot, l));
+				continue;
 			}
 		}
-		else
-			perror("Error: Kernel cache full! => increase cache size");
+
+		if (k>=num_vectors)
+			k=2*num_vectors-1-k;
+
+		kernel_cache->set(slot, j, kernel(m, k));
 	}
 }
 
-
-void* Kernel::cache_multiple_kernel_row_helper(void* p)
+// Fills cache for the row m
+void Kernel::cache_kernel_row(int32_t m)
 {
-	int32_t j,k,l;
-	S_KTHREAD_PARAM* params = (S_KTHREAD_PARAM*) p;
+	int32_t num_vectors = get_num_vec_lhs();
 
-	for (int32_t i=params->start; i<params->end; i++)
-	{
-		KERNELCACHE_ELEM* cache=params->cache[i];
-		int32_t m = params->uncached_rows[i];
-		l=params->kernel_cache->totdoc2active[m];
+	if (m>=num_vectors)
+		m=2*num_vectors-1-m;
 
-		for(j=0;j<params->kernel_cache->activenum;j++)  // fill cache
+	if(!kernel_cache_check(m))   // not cached yet
+	{
+		int32_t slot=kernel_cache->reserve(m);
+		if(slot != -1)
 		{
-			k=params->kernel_cache->active2totdoc[j];
-
-			if((params->kernel_cache->index[k] != -1) && (l != -1) && (!params->needs_computation[k])) {
-				cache[j]=params->kernel_cache->buffer[((KERNELCACHE_IDX) params->kernel_cache->activenum)
-					*params->kernel_cache->index[k]+l];
-			}
-			else
-				{
-					if (k>=params->num_vectors)
-						k=2*params->num_vectors-1-k;
-
-					cache[j]=params->kernel->kernel(m, k);
-				}
+			fill_kernel_cache_row(m, slot);
+			kernel_cache->commit(m, slot);
 		}
-
-		//now line m is cached
-		params->needs_computation[m]=0;
+		else
+			perror("Error: Kernel cache full! => increase cache size");
 	}
-	return NULL;
 }
 
 // Fills cache for the rows in key
 void Kernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 {
-	int32_t nthreads=env()->get_num_threads();
-
-	if (nthreads<2)
-	{
-		for(int32_t i=0;i<num_rows;i++)
-			cache_kernel_row(rows[i]);
-	}
-	else
+	int32_t num_vec=get_num_vec_lhs();
+	ASSERT(num_vec>0)
+
+	// reserve all cachelines first, so that no row is evicted while
+	// others are filled from it. Reserved rows are not visible until they
+	// are committed and hence always computed from scratch.
+	std::vector<std::pair<int32_t, int32_t>> uncached;
+	std::vector<bool> reserved(num_vec, false);
+	uncached.reserve(num_rows);
+	for (int32_t i=0; i<num_rows; i++)
 	{
-		// fill up kernel cache
-		int32_t* uncached_rows = SG_MALLOC(int32_t, num_rows);
-		KERNELCACHE_ELEM** cache = SG_MALLOC(KERNELCACHE_ELEM*, num_rows);
-		S_KTHREAD_PARAM params;
-		int32_t num_threads=nthreads-1;
-		int32_t num_vec=get_num_vec_lhs();
-		ASSERT(num_vec>0)
-		uint8_t* needs_computation=SG_CALLOC(uint8_t, num_vec);
-
-		int32_t step=0;
-		int32_t num=0;
-		int32_t end=0;
-
-		// allocate cachelines if necessary
-		for (int32_t i=0; i<num_rows; i++)
-		{
-			int32_t idx=rows[i];
-			if (idx>=num_vec)
-				idx=2*num_vec-1-idx;
+		int32_t idx=rows[i];
+		if (idx>=num_vec)
+			idx=2*num_vec-1-idx;
 
-			if (kernel_cache_check(idx))
-				continue;
-
-			needs_computation[idx]=1;
-			uncached_rows[num]=idx;
-			cache[num]= kernel_cache_clean_and_malloc(idx);
-
-			if (!cache[num])
-				error("Kernel cache full! => increase cache size");
-
-			num++;
-		}
-
-		if (num>0)
-		{
-			step = num/nthreads;
-
-			if (step<1)
-			{
-				num_threads=num-1;
-				step=1;
-			}
-
-			#pragma omp parallel for private(params)
-			for (int32_t t=0; t<num_threads; t++)
-			{
-				params.kernel = this;
-				params.kernel_cache = &kernel_cache;
-				params.cache = cache;
-				params.uncached_rows = uncached_rows;
-				params.needs_computation = needs_computation;
-				params.num_uncached = num;
-				params.start = t*step;
-				params.end = (t+1)*step;
-				params.num_vectors = get_num_vec_lhs();
-				end=params.end;
-
-				cache_multiple_kernel_row_helper(&params);
-			}
-		}
-		else
-			num_threads=-1;
+		if (reserved[idx] || kernel_cache_check(idx))
+			continue;
+		reserved[idx]=true;
 
+		int32_t slot=kernel_cache->reserve(idx);
+		if (slot==-1)
+			error("Kernel cache full! => increase cache size");
 
-		S_KTHREAD_PARAM last_param;
-		last_param.kernel = this;
-		last_param.kernel_cache = &kernel_cache;
-		last_param.cache = cache;
-		last_param.uncached_rows = uncached_rows;
-		last_param.needs_computation = needs_computation;
-		last_param.start = end;
-		last_param.num_uncached = num;
-		last_param.end = num;
-		last_param.num_vectors = get_num_vec_lhs();
+		uncached.emplace_back(idx, slot);
+	}
 
-		cache_multiple_kernel_row_helper(&last_param);
+	#pragma omp parallel for schedule(dynamic)
+	for (int64_t i=0; i<(int64_t) uncached.size(); i++)
+		fill_kernel_cache_row(uncached[i].first, uncached[i].second);
 
-		SG_FREE(needs_computation);
-		SG_FREE(cache);
-		SG_FREE(uncached_rows);
-	}
+	for (const auto& r : uncached)
+		kernel_cache->commit(r.first, r.second);
 }
 
 // remove numshrink columns in the cache
@@ -456,151 +348,23 @@ void Kernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 void Kernel::kernel_cache_shrink(
 	int32_t totdoc, int32_t numshrink, int32_t *after)
 {
-	ASSERT(totdoc > 0);
-	int32_t i,j,jj,scount;     // 0 in after.
-	KERNELCACHE_IDX from=0,to=0;
-	int32_t *keep;
-
-	keep=SG_MALLOC(int32_t, totdoc);
-	for(j=0;j<totdoc;j++) {
-		keep[j]=1;
-	}
-	scount=0;
-	for(jj=0;(jj<kernel_cache.activenum) && (scount<numshrink);jj++) {
-		j=kernel_cache.active2totdoc[jj];
-		if(!after[j]) {
-			scount++;
-			keep[j]=0;
-		}
-	}
-
-	for(i=0;i<kernel_cache.max_elems;i++) {
-		for(jj=0;jj<kernel_cache.activenum;jj++) {
-			j=kernel_cache.active2totdoc[jj];
-			if(!keep[j]) {
-				from++;
-			}
-			else {
-				kernel_cache.buffer[to]=kernel_cache.buffer[from];
-				to++;
-				from++;
-			}
-		}
-	}
-
-	kernel_cache.activenum=0;
-	for(j=0;j<totdoc;j++) {
-		if((keep[j]) && (kernel_cache.totdoc2active[j] != -1)) {
-			kernel_cache.active2totdoc[kernel_cache.activenum]=j;
-			kernel_cache.totdoc2active[j]=kernel_cache.activenum;
-			kernel_cache.activenum++;
-		}
-		else {
-			kernel_cache.totdoc2active[j]=-1;
-		}
-	}
-
-	kernel_cache.max_elems= (int32_t) kernel_cache.buffsize;
-
-	if (kernel_cache.activenum>0)
-		kernel_cache.buffsize/=kernel_cache.activenum;
-
-	if(kernel_cache.max_elems>totdoc)
-		kernel_cache.max_elems=totdoc;
-
-	SG_FREE(keep);
-
+	kernel_cache->shrink(totdoc, numshrink, after);
 }
 
 void Kernel::kernel_cache_reset_lru()
 {
-	int32_t maxlru=0,k;
-
-	for(k=0;k<kernel_cache.max_elems;k++) {
-		if(maxlru < kernel_cache.lru[k])
-			maxlru=kernel_cache.lru[k];
-	}
-	for(k=0;k<kernel_cache.max_elems;k++) {
-		kernel_cache.lru[k]-=maxlru;
-	}
+	kernel_cache->reset_lru();
 }
 
 void Kernel::kernel_cache_cleanup()
 {
-	SG_FREE(kernel_cache.index);
-	SG_FREE(kernel_cache.occu);
-	SG_FREE(kernel_cache.lru);
-	SG_FREE(kernel_cache.invindex);
-	SG_FREE(kernel_cache.active2totdoc);
-	SG_FREE(kernel_cache.totdoc2active);
-	SG_FREE(kernel_cache.buffer);
-	memset(&kernel_cache, 0x0, sizeof(KERNEL_CACHE));
-}
-
-int32_t Kernel::kernel_cache_malloc()
-{
-  int32_t i;
-
-  if(kernel_cache_space_available()) {
-    for(i=0;i<kernel_cache.max_elems;i++) {
-      if(!kernel_cache.occu[i]) {
-	kernel_cache.occu[i]=1;
-	kernel_cache.elems++;
-	return(i);
-      }
-    }
-  }
-  return(-1);
-}
-
-void Kernel::kernel_cache_free(int32_t cacheidx)
-{
-	kernel_cache.occu[cacheidx]=0;
-	kernel_cache.elems--;
-}
-
-// remove least recently used cache
-// element
-int32_t Kernel::kernel_cache_free_lru()
-{
-  int32_t k,least_elem=-1,least_time;
-
-  least_time=kernel_cache.time+1;
-  for(k=0;k<kernel_cache.max_elems;k++) {
-    if(kernel_cache.invindex[k] != -1) {
-      if(kernel_cache.lru[k]<least_time) {
-	least_time=kernel_cache.lru[k];
-	least_elem=k;
-      }
-    }
-  }
-
-  if(least_elem != -1) {
-    kernel_cache_free(least_elem);
-    kernel_cache.index[kernel_cache.invindex[least_elem]]=-1;
-    kernel_cache.invindex[least_elem]=-1;
-    return(1);
-  }
-  return(0);
-}
-
-// Get a free cache entry. In case cache is full, the lru
-// element is removed.
-KERNELCACHE_ELEM* Kernel::kernel_cache_clean_and_malloc(int32_t cacheidx)
-{
-	int32_t result;
-	if((result = kernel_cache_malloc()) == -1) {
-		if(kernel_cache_free_lru()) {
-			result = kernel_cache_malloc();
-		}
-	}
-	kernel_cache.index[cacheidx]=result;
-	if(result == -1) {
-		return(0);
+	if (kernel_cache)
+	{
+		SG_DEBUG("kernel cache: {} hits, {} misses, {} evictions",
+			kernel_cache->get_hits(), kernel_cache->get_misses(),
+			kernel_cache->get_evictions());
 	}
-	kernel_cache.invindex[result]=cacheidx;
-	kernel_cache.lru[kernel_cache.index[cacheidx]]=kernel_cache.time; // lru
-	return &kernel_cache.buffer[((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[cacheidx]];
+	kernel_cache.reset();
 }
 #endif //USE_SVMLIGHT
 
@@ -911,6 +675,9 @@ void Kernel::save_serializable_post() noexcept(false)
 void Kernel::register_params()
 {
 	SG_ADD(&cache_size, "cache_size", "Cache size in MB.");
+	SG_ADD(
+	    &cache_float32, "cache_float32",
+	    "If kernel rows are cached in single precision.");
 	SG_ADD(
 		&lhs, "lhs", "Feature vectors to occur on left hand side.",
 		ParameterProperties::READONLY);
@@ -933,6 +700,10 @@ void Kernel::register_params()
 	    &normalizer, "normalizer", "Normalize the kernel.",
 	    ParameterProperties::HYPER);
 
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&cache_eviction, "cache_eviction",
+	    "Eviction policy of the kernel cache.", ParameterProperties::NONE,
+	    SG_OPTIONS(KCE_LRU, KCE_SECOND_CHANCE));
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&opt_type, "opt_type", "Optimization type.",
 	    ParameterProperties::NONE,
@@ -955,9 +726,11 @@ void Kernel::init()
 	properties=KP_NONE;
 	normalizer=NULL;
 
-#ifdef USE_SVMLIGHT
-	memset(&kernel_cache, 0x0, sizeof(KERNEL_CACHE));
-#endif //USE_SVMLIGHT
+	cache_float32=false;
+#ifdef USE_SHORTREAL_KERNELCACHE
+	cache_float32=true;
+#endif //USE_SHORTREAL_KERNELCACHE
+	cache_eviction=KCE_LRU;
 
 	set_normalizer(std::make_shared<IdentityKernelNormalizer>());
 }
@@ -1320,6 +1093,9 @@ SGMatrix<T> Kernel::get_kernel_matrix()
 
 	SG_DEBUG("returning kernel matrix of size {}x{}", m, n)
 
+	if (supports_block_computation())
+		return get_kernel_matrix_blocked<T>(m, n, symmetric);
+
 	result=SG_MALLOC(T, total_num);
 
 	int32_t num_threads=env()->get_num_threads();
@@ -1363,6 +1139,221 @@ SGMatrix<T> Kernel::get_kernel_matrix()
 	return SGMatrix<T>(result,m,n,true);
 }
 
+template <class T>
+SGMatrix<T> Kernel::get_kernel_matrix_blocked(int32_t m, int32_t n, bool symmetric)
+{
+	const index_t num_row_blocks=(m+KERNEL_BLOCK_SIZE-1)/KERNEL_BLOCK_SIZE;
+	const index_t num_col_blocks=(n+KERNEL_BLOCK_SIZE-1)/KERNEL_BLOCK_SIZE;
+	const bool normalize=
+		!std::dynamic_pointer_cast<IdentityKernelNormalizer>(normalizer);
+
+	SGMatrix<T> result(m, n);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int64_t b=0; b<int64_t(num_row_blocks)*num_col_blocks; ++b)
+	{
+		const index_t bi=b%num_row_blocks;
+		const index_t bj=b/num_row_blocks;
+		if (symmetric && bj<bi)
+			continue;
+
+		const index_t row_begin=bi*KERNEL_BLOCK_SIZE;
+		const index_t row_end=Math::min(row_begin+KERNEL_BLOCK_SIZE, m);
+		const index_t col_begin=bj*KERNEL_BLOCK_SIZE;
+		const index_t col_end=Math::min(col_begin+KERNEL_BLOCK_SIZE, n);
+
+		SGMatrix<float64_t> block(row_end-row_begin, col_end-col_begin);
+		compute_block(row_begin, row_end, col_begin, col_end, block);
+
+		for (index_t j=col_begin; j<col_end; ++j)
+		{
+			for (index_t i=row_begin; i<row_end; ++i)
+			{
+				if (symmetric && i>j)
+					continue;
+
+				float64_t v=block(i-row_begin, j-col_begin);
+				if (normalize)
+					v=normalizer->normalize(v, i, j);
+
+				result(i, j)=v;
+				if (symmetric)
+					result(j, i)=v;
+			}
+		}
+	}
+
+	return result;
+}
+
+void Kernel::compute_block(
+	index_t row_begin, index_t row_end, index_t col_begin, index_t col_end,
+	SGMatrix<float64_t>& block)
+{
+	auto lhs_block=lhs->as<DenseFeatures<float64_t>>()
+		->get_feature_matrix_block(row_begin, row_end);
+	auto rhs_block=rhs->as<DenseFeatures<float64_t>>()
+		->get_feature_matrix_block(col_begin, col_end);
+
+	compute_block_from_features(lhs_block, rhs_block, block);
+}
+
+SGMatrix<float64_t> Kernel::get_kernel_block(index_t row_begin, index_t row_end)
+{
+	require(lhs && rhs, "{}::get_kernel_block(): Kernel not initialized!",
+		get_name());
+	require(0<=row_begin && row_begin<=row_end && row_end<=num_lhs,
+		"{}::get_kernel_block(): Rows [{}, {}) out of range [0, {})!",
+		get_name(), row_begin, row_end, num_lhs);
+
+	const index_t m=row_end-row_begin;
+	const index_t n=num_rhs;
+	SGMatrix<float64_t> result(m, n);
+
+	if (!has_block_computation())
+	{
+#pragma omp parallel for schedule(dynamic)
+		for (index_t j=0; j<n; ++j)
+		{
+			for (index_t i=0; i<m; ++i)
+				result(i, j)=kernel(row_begin+i, j);
+		}
+		return result;
+	}
+
+	const index_t num_col_blocks=(n+KERNEL_BLOCK_SIZE-1)/KERNEL_BLOCK_SIZE;
+	const bool normalize=
+		!std::dynamic_pointer_cast<IdentityKernelNormalizer>(normalizer);
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t bj=0; bj<num_col_blocks; ++bj)
+	{
+		const index_t col_begin=bj*KERNEL_BLOCK_SIZE;
+		const index_t col_end=Math::min(col_begin+KERNEL_BLOCK_SIZE, n);
+
+		SGMatrix<float64_t> block(m, col_end-col_begin);
+		compute_block(row_begin, row_end, col_begin, col_end, block);
+
+		for (index_t j=col_begin; j<col_end; ++j)
+		{
+			for (index_t i=0; i<m; ++i)
+			{
+				float64_t v=block(i, j-col_begin);
+				if (normalize)
+					v=normalizer->normalize(v, row_begin+i, j);
+
+				result(i, j)=v;
+			}
+		}
+	}
+
+	return result;
+}
+
+SGVector<float64_t> Kernel::get_parameter_gradient_sum(
+	Parameters::const_reference param, SGMatrix<float64_t> weights)
+{
+	require(weights.num_rows==num_lhs && weights.num_cols==num_rhs,
+		"Weights ({}x{}) must be of the size of the kernel matrix ({}x{})!",
+		weights.num_rows, weights.num_cols, num_lhs, num_rhs);
+
+	auto visitor=std::make_unique<ShapeVisitor>();
+	param.second->get_value().visit(visitor.get());
+	SGVector<float64_t> result(visitor->get_size());
+
+	for (index_t i=0; i<result.vlen; ++i)
+	{
+		SGMatrix<float64_t> dK;
+		if (result.vlen==1)
+			dK=get_parameter_gradient(param);
+		else
+			dK=get_parameter_gradient(param, i);
+
+		float64_t sum=0;
+		for (int64_t j=0; j<int64_t(dK.num_rows)*dK.num_cols; ++j)
+			sum+=weights.matrix[j]*dK.matrix[j];
+		result[i]=sum;
+	}
+
+	return result;
+}
+
+SGVector<float64_t> Kernel::compute_batch_blocked(
+	SGVector<int32_t> idx, SGVector<float64_t> weights)
+{
+	require(idx.vlen==weights.vlen,
+		"Number of indices ({}) and weights ({}) differ!", idx.vlen,
+		weights.vlen);
+	require(has_block_computation(),
+		"{}::compute_batch_blocked(): Block computation is not supported "
+		"for the current features!", get_name());
+
+	const index_t n=get_num_vec_rhs();
+	const index_t num_col_blocks=(n+KERNEL_BLOCK_SIZE-1)/KERNEL_BLOCK_SIZE;
+	const bool normalize=
+		!std::dynamic_pointer_cast<IdentityKernelNormalizer>(normalizer);
+
+	// the lhs vectors are scattered, so they are gathered into one block
+	auto lhs_features=lhs->as<DenseFeatures<float64_t>>();
+	auto rhs_features=rhs->as<DenseFeatures<float64_t>>();
+	SGMatrix<float64_t> lhs_vectors(
+		lhs_features->get_num_features(), idx.vlen);
+	for (index_t i=0; i<idx.vlen; ++i)
+	{
+		auto vec=lhs_features->get_feature_vector(idx[i]);
+		ASSERT(vec.vlen==lhs_vectors.num_rows)
+		sg_memcpy(
+			lhs_vectors.get_column_vector(i), vec.vector,
+			vec.vlen*sizeof(float64_t));
+	}
+
+	SGVector<float64_t> result(n);
+	result.zero();
+
+	auto pb=SG_PROGRESS(range(num_col_blocks));
+#pragma omp parallel
+	{
+		// every thread computes its tiles into one buffer of the full size
+		SGMatrix<float64_t> buffer(KERNEL_BLOCK_SIZE, KERNEL_BLOCK_SIZE);
+
+#pragma omp for schedule(dynamic)
+		for (index_t bj=0; bj<num_col_blocks; ++bj)
+		{
+			const index_t col_begin=bj*KERNEL_BLOCK_SIZE;
+			const index_t col_end=Math::min(col_begin+KERNEL_BLOCK_SIZE, n);
+			auto rhs_block=rhs_features->get_feature_matrix_block(col_begin, col_end);
+
+			for (index_t row_begin=0; row_begin<idx.vlen; row_begin+=KERNEL_BLOCK_SIZE)
+			{
+				const index_t row_end=Math::min(row_begin+KERNEL_BLOCK_SIZE, idx.vlen);
+				SGMatrix<float64_t> lhs_block(
+					lhs_vectors.get_column_vector(row_begin), lhs_vectors.num_rows,
+					row_end-row_begin, false);
+				SGMatrix<float64_t> block(
+					buffer.matrix, row_end-row_begin, col_end-col_begin, false);
+				compute_block_from_features(lhs_block, rhs_block, block);
+
+				for (index_t j=col_begin; j<col_end; ++j)
+				{
+					float64_t sum=result[j];
+					for (index_t i=row_begin; i<row_end; ++i)
+					{
+						float64_t v=block(i-row_begin, j-col_begin);
+						if (normalize)
+							v=normalizer->normalize(v, idx[i], j);
+
+						sum+=weights[i]*v;
+					}
+					result[j]=sum;
+				}
+			}
+			pb.print_progress();
+		}
+	}
+	pb.complete();
+
+	return result;
+}
 
 template SGMatrix<float64_t> Kernel::get_kernel_matrix<float64_t>();
 template SGMatrix<float32_t> Kernel::get_kernel_matrix<float32_t>();
@@ -21,6 +21,7 @@
 #include <shogun/base/SGObject.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/Features.h>
+#include <shogun/kernel/KernelRowCache.h>
 #include <shogun/kernel/normalizer/KernelNormalizer.h>
 
 namespace shogun
@@ -592,6 +593,37 @@ class Kernel : public SGObject
 		 */
 		inline int32_t get_cache_size() { return cache_size; }
 
+		/** set whether kernel rows are cached in single precision, which
+		 * doubles the number of rows fitting into the cache
+		 *
+		 * @param use_float32 if rows shall be stored as float32
+		 */
+		inline void set_cache_float32(bool use_float32)
+		{
+			cache_float32 = use_float32;
+#ifdef USE_SVMLIGHT
+			cache_reset();
+#endif //USE_SVMLIGHT
+		}
+
+		/** @return whether kernel rows are cached in single precision */
+		inline bool get_cache_float32() { return cache_float32; }
+
+		/** set which cached kernel row is evicted to make room for another
+		 *
+		 * @param eviction eviction policy
+		 */
+		inline void set_cache_eviction(EKernelCacheEviction eviction)
+		{
+			cache_eviction = eviction;
+#ifdef USE_SVMLIGHT
+			cache_reset();
+#endif //USE_SVMLIGHT
+		}
+
+		/** @return eviction policy of the kernel cache */
+		inline EKernelCacheEviction get_cache_eviction() { return cache_eviction; }
+
 #ifdef USE_SVMLIGHT
 		/** cache reset */
 		inline void cache_reset() { resize_kernel_cache(cache_size); }
@@ -600,13 +632,37 @@ class Kernel : public SGObject
 		 *
 		 * @return maximum elements in cache
 		 */
-		inline int32_t get_max_elems_cache() { return kernel_cache.max_elems; }
+		inline int32_t get_max_elems_cache()
+		{
+			return kernel_cache ? kernel_cache->get_max_elems() : 0;
+		}
 
 		/** get activenum cache
 		 *
 		 * @return activecnum cache
 		 */
-		inline int32_t get_activenum_cache() { return kernel_cache.activenum; }
+		inline int32_t get_activenum_cache()
+		{
+			return kernel_cache ? kernel_cache->get_activenum() : 0;
+		}
+
+		/** @return number of kernel row lookups served from the cache */
+		inline int64_t get_cache_hits()
+		{
+			return kernel_cache ? kernel_cache->get_hits() : 0;
+		}
+
+		/** @return number of kernel row lookups not served from the cache */
+		inline int64_t get_cache_misses()
+		{
+			return kernel_cache ? kernel_cache->get_misses() : 0;
+		}
+
+		/** @return number of kernel rows evicted from the cache */
+		inline int64_t get_cache_evictions()
+		{
+			return kernel_cache ? kernel_cache->get_evictions() : 0;
+		}
 
 		/** get kernel row
 		 *
@@ -658,7 +714,8 @@ class Kernel : public SGObject
 		 */
 		inline void set_time(int32_t t)
 		{
-			kernel_cache.time=t;
+			if (kernel_cache)
+				kernel_cache->set_time(t);
 		}
 
 		/** update lru time of item at given index to avoid removal from cache
@@ -668,12 +725,7 @@ class Kernel : public SGObject
 		 */
 		inline int32_t kernel_cache_touch(int32_t cacheidx)
 		{
-			if(kernel_cache.index[cacheidx] != -1)
-			{
-				kernel_cache.lru[kernel_cache.index[cacheidx]]=kernel_cache.time;
-				return(1);
-			}
-			return(0);
+			return kernel_cache ? kernel_cache->touch(cacheidx) : false;
 		}
 
 		/** check if row at given index is cached
@@ -683,7 +735,7 @@ class Kernel : public SGObject
 		 */
 		inline int32_t kernel_cache_check(int32_t cacheidx)
 		{
-			return(kernel_cache.index[cacheidx] >= 0);
+			return kernel_cache ? kernel_cache->get_slot(cacheidx) >= 0 : false;
 		}
 
 		/** check if there is room for one more row in kernel cache
@@ -692,7 +744,7 @@ class Kernel : public SGObject
 		 */
 		inline int32_t kernel_cache_space_available()
 		{
-			return(kernel_cache.elems < kernel_cache.max_elems);
+			return kernel_cache ? kernel_cache->space_available() : false;
 		}
 
 		/** initialize kernel cache
@@ -793,6 +845,45 @@ class Kernel : public SGObject
 			int32_t num_suppvec, int32_t* IDX, float64_t* alphas,
 			float64_t factor=1.0);
 
+		/** @return whether compute_batch_blocked() can be used, i.e.
+		 * whether the kernel computes blocks of kernel values from blocks of
+		 * dense feature vectors
+		 */
+		bool has_block_computation()
+		{
+			return supports_block_computation();
+		}
+
+		/** computes the weighted sums of kernel values
+		 * \f$r_j=\sum_i w_i k({\bf x}_{idx_i}, {\bf y}_j)\f$
+		 * for all rhs vectors \f${\bf y}_j\f$, e.g. the outputs of a kernel
+		 * machine with support vectors idx and coefficients weights.
+		 *
+		 * The lhs vectors idx are gathered into one dense block, against
+		 * which tiles of rhs vectors are computed through
+		 * compute_block_from_features(). Every tile is computed by one
+		 * thread and summed in the order of idx, so the result does not
+		 * depend on the number of threads. Only possible if
+		 * has_block_computation().
+		 *
+		 * @param idx indices of lhs vectors
+		 * @param weights weights of the lhs vectors
+		 * @return weighted sums for all rhs vectors
+		 */
+		SGVector<float64_t> compute_batch_blocked(
+			SGVector<int32_t> idx, SGVector<float64_t> weights);
+
+		/** computes the rows [row_begin, row_end) of the kernel matrix
+		 * without re-initializing the kernel, through compute_block() if
+		 * has_block_computation() and one kernel() call per entry otherwise
+		 *
+		 * @param row_begin index of first lhs vector
+		 * @param row_end index one past the last lhs vector
+		 * @return (row_end-row_begin)x(number of rhs vectors) block of the
+		 * kernel matrix
+		 */
+		SGMatrix<float64_t> get_kernel_block(index_t row_begin, index_t row_end);
+
 		/** get combined kernel weight
 		 *
 		 * @return combined kernel weight
@@ -866,6 +957,23 @@ class Kernel : public SGObject
 		{
 			return get_parameter_gradient(param,index).get_diagonal_vector();
 		}
+
+		/** return the derivatives of the weighted sum of all kernel values
+		 * \f$\sum_{j,k} W_{jk}\frac{\partial k(x_j, y_k)}{\partial\theta_i}\f$
+		 * wrt all elements \f$\theta_i\f$ of a parameter, which is how
+		 * marginal likelihood gradients use the kernel derivative.
+		 *
+		 * The default calls get_parameter_gradient() once per element.
+		 * Kernels with many elements in a parameter may instead compute all
+		 * sums in one pass without any derivative matrix.
+		 *
+		 * @param param the parameter
+		 * @param weights matrix W of size num_lhs x num_rhs
+		 *
+		 * @return vector with one derivative per element of the parameter
+		 */
+		virtual SGVector<float64_t> get_parameter_gradient_sum(
+				Parameters::const_reference param, SGMatrix<float64_t> weights);
 #endif
 
 		/** Obtains a kernel from a generic SGObject with error checking. Note
@@ -911,6 +1019,49 @@ class Kernel : public SGObject
 		 */
 		virtual float64_t compute(int32_t x, int32_t y)=0;
 
+		/** whether the kernel can compute whole blocks of the (unnormalized)
+		 * kernel matrix at once via compute_block(), e.g. through a
+		 * matrix product of dense feature blocks
+		 *
+		 * @return true if compute_block() may be used
+		 */
+		virtual bool supports_block_computation()
+		{
+			return false;
+		}
+
+		/** compute the unnormalized kernel values of a block of lhs
+		 * vectors [row_begin, row_end) and rhs vectors [col_begin, col_end)
+		 * in one go through compute_block_from_features(). Only called if
+		 * supports_block_computation() is true.
+		 *
+		 * @param row_begin index of first lhs vector
+		 * @param row_end index one past the last lhs vector
+		 * @param col_begin index of first rhs vector
+		 * @param col_end index one past the last rhs vector
+		 * @param block preallocated result of size
+		 * (row_end-row_begin)x(col_end-col_begin)
+		 */
+		void compute_block(
+			index_t row_begin, index_t row_end, index_t col_begin,
+			index_t col_end, SGMatrix<float64_t>& block);
+
+		/** compute the unnormalized kernel values between the columns of
+		 * two blocks of dense feature vectors. Only called if
+		 * supports_block_computation() is true.
+		 *
+		 * @param lhs_block lhs feature vectors, one per column
+		 * @param rhs_block rhs feature vectors, one per column
+		 * @param block preallocated result of size
+		 * lhs_block.num_cols x rhs_block.num_cols
+		 */
+		virtual void compute_block_from_features(
+			const SGMatrix<float64_t>& lhs_block,
+			const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block)
+		{
+			not_implemented(SOURCE_LOCATION);
+		}
+
 		/** compute row start offset for parallel kernel matrix computation
 		 *
 		 * @param offs offset
@@ -936,6 +1087,16 @@ class Kernel : public SGObject
 		 */
 		template <class T> static void* get_kernel_matrix_helper(void* p);
 
+		/** computes the kernel matrix tile by tile through compute_block()
+		 *
+		 * @param m number of lhs vectors
+		 * @param n number of rhs vectors
+		 * @param symmetric whether only the upper triangle has to be computed
+		 * @return the kernel matrix
+		 */
+		template <class T>
+		SGMatrix<T> get_kernel_matrix_blocked(int32_t m, int32_t n, bool symmetric);
+
 		/** Can (optionally) be overridden to post-initialize some member
 		 *  variables which are not PARAMETER::ADD'ed.  Make sure that at
 		 *  first the overridden method BASE_CLASS::LOAD_SERIALIZABLE_POST
@@ -979,78 +1140,28 @@ class Kernel : public SGObject
 
 
 #ifdef USE_SVMLIGHT
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-		/**@ cache kernel evalutations to improve speed */
-		struct KERNEL_CACHE {
-			/** index */
-			int32_t   *index;
-			/** inverse index */
-			int32_t   *invindex;
-			/** active2totdoc */
-			int32_t   *active2totdoc;
-			/** totdoc2active */
-			int32_t   *totdoc2active;
-			/** least recently used */
-			int32_t   *lru;
-			/** occu */
-			int32_t   *occu;
-			/** elements */
-			int32_t   elems;
-			/** max elements */
-			int32_t   max_elems;
-			/** time */
-			int32_t   time;
-			/** active num */
-			int32_t   activenum;
-
-			/** buffer */
-			KERNELCACHE_ELEM  *buffer;
-			/** buffer size */
-			KERNELCACHE_IDX   buffsize;
-		};
-
-		/** kernel thread parameters */
-		struct S_KTHREAD_PARAM
-		{
-			/** kernel */
-			Kernel* kernel;
-			/** kernel cache */
-			KERNEL_CACHE* kernel_cache;
-			/** cache */
-			KERNELCACHE_ELEM** cache;
-			/** uncached rows */
-			int32_t* uncached_rows;
-			/** number of uncached rows */
-			int32_t num_uncached;
-			/** needs computation */
-			uint8_t* needs_computation;
-			/** start */
-			int32_t start;
-			/** end */
-			int32_t end;
-			/** of vectors */
-			int32_t num_vectors;
-		};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
-		//@{
-		static void* cache_multiple_kernel_row_helper(void* p);
-
-		/// init kernel cache of size megabytes
-		void   kernel_cache_free(int32_t cacheidx);
-		int32_t   kernel_cache_malloc();
-		int32_t   kernel_cache_free_lru();
-		KERNELCACHE_ELEM *kernel_cache_clean_and_malloc(int32_t cacheidx);
+		/** fill a row reserved in the kernel cache, reusing cached
+		 * entries of other rows where possible
+		 *
+		 * @param m example index of the row
+		 * @param slot slot reserved for the row
+		 */
+		void fill_kernel_cache_row(int32_t m, int32_t slot);
 #endif //USE_SVMLIGHT
-		//@}
 
 	protected:
 		/// cache_size in MB
 		int32_t cache_size;
 
+		/// whether the kernel cache stores rows as float32
+		bool cache_float32;
+
+		/// eviction policy of the kernel cache
+		EKernelCacheEviction cache_eviction;
+
 #ifdef USE_SVMLIGHT
 		/// kernel cache
-		KERNEL_CACHE kernel_cache;
+		std::unique_ptr<KernelRowCache> kernel_cache;
 #endif //USE_SVMLIGHT
 
 		/// this *COULD* store the whole kernel matrix
@@ -0,0 +1,304 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/io/SGIO.h>
+#include <shogun/kernel/KernelRowCache.h>
+#include <shogun/mathematics/Math.h>
+
+#include <numeric>
+
+using namespace shogun;
+
+KernelRowCache::KernelRowCache(
+	int32_t totdoc, int64_t size_mb, bool use_float32, int32_t num_shards,
+	EKernelCacheEviction eviction)
+	: m_totdoc(totdoc), m_lru_head(-1), m_lru_tail(-1), m_eviction(eviction),
+	  m_elems(0), m_activenum(totdoc), m_time(0),
+	  m_use_float32(use_float32), m_buffer32(nullptr), m_buffer64(nullptr),
+	  m_hits(0), m_misses(0), m_evictions(0)
+{
+	require(totdoc>0, "Kernel cache needs at least one row (got {})!", totdoc);
+
+	const int64_t elem_size=use_float32 ? sizeof(float32_t) : sizeof(float64_t);
+	m_buffsize=Math::min(size_mb*1024*1024/elem_size, int64_t(totdoc)*totdoc);
+
+	if (use_float32)
+		m_buffer32=SG_MALLOC(float32_t, m_buffsize);
+	else
+		m_buffer64=SG_MALLOC(float64_t, m_buffsize);
+
+	m_max_elems=(int32_t) Math::min(m_buffsize/totdoc, int64_t(totdoc));
+	m_num_shards=Math::clamp(num_shards, 1, totdoc);
+	m_shards=std::make_unique<Shard[]>(m_num_shards);
+
+	m_index.assign(totdoc, -1);
+	m_invindex.assign(totdoc, -1);
+	m_active2totdoc.resize(totdoc);
+	m_totdoc2active.resize(totdoc);
+	std::iota(m_active2totdoc.begin(), m_active2totdoc.end(), 0);
+	std::iota(m_totdoc2active.begin(), m_totdoc2active.end(), 0);
+
+	m_last_used=std::make_unique<std::atomic<int32_t>[]>(totdoc);
+	for (int32_t i=0; i<totdoc; i++)
+		m_last_used[i]=0;
+	m_queued_at.assign(totdoc, 0);
+	m_lru_prev.assign(totdoc, -1);
+	m_lru_next.assign(totdoc, -1);
+	m_queued.assign(totdoc, false);
+
+	add_free_slots(0, m_max_elems);
+}
+
+KernelRowCache::~KernelRowCache()
+{
+	SG_FREE(m_buffer32);
+	SG_FREE(m_buffer64);
+}
+
+int64_t KernelRowCache::get_buffer_bytes() const
+{
+	return m_buffsize*(m_use_float32 ? sizeof(float32_t) : sizeof(float64_t));
+}
+
+void KernelRowCache::add_free_slots(int32_t begin, int32_t end)
+{
+	// pushed in reverse so that low slots are handed out first
+	for (int32_t slot=end-1; slot>=begin; slot--)
+		m_free_slots.push_back(slot);
+}
+
+void KernelRowCache::lru_unlink(int32_t slot)
+{
+	auto prev=m_lru_prev[slot];
+	auto next=m_lru_next[slot];
+
+	if (prev!=-1)
+		m_lru_next[prev]=next;
+	else
+		m_lru_head=next;
+
+	if (next!=-1)
+		m_lru_prev[next]=prev;
+	else
+		m_lru_tail=prev;
+
+	m_lru_prev[slot]=-1;
+	m_lru_next[slot]=-1;
+	m_queued[slot]=false;
+}
+
+void KernelRowCache::lru_append(int32_t slot)
+{
+	m_lru_prev[slot]=m_lru_tail;
+	m_lru_next[slot]=-1;
+
+	if (m_lru_tail!=-1)
+		m_lru_next[m_lru_tail]=slot;
+	else
+		m_lru_head=slot;
+
+	m_lru_tail=slot;
+	m_queued[slot]=true;
+}
+
+void KernelRowCache::mark_used(int32_t slot)
+{
+	m_last_used[slot].store(m_time, std::memory_order_relaxed);
+	if (m_eviction!=KCE_LRU)
+		return;
+
+	// the row may just be evicted, then it is no longer queued
+	std::lock_guard<std::mutex> lock(m_lru_lock);
+	if (m_queued[slot])
+	{
+		lru_unlink(slot);
+		lru_append(slot);
+	}
+}
+
+bool KernelRowCache::evict()
+{
+	int32_t slot=-1;
+	{
+		std::lock_guard<std::mutex> lock(m_lru_lock);
+
+		// with KCE_LRU the head is the least recently used row. Otherwise
+		// rows that were read since they were queued get a second chance
+		// at the tail; a row only moves again once it is read at a later
+		// time.
+		while (slot==-1 && m_lru_head!=-1)
+		{
+			auto head=m_lru_head;
+			auto last_used=m_last_used[head].load(std::memory_order_relaxed);
+
+			lru_unlink(head);
+			if (m_eviction==KCE_SECOND_CHANCE && last_used>m_queued_at[head])
+			{
+				m_queued_at[head]=last_used;
+				lru_append(head);
+			}
+			else
+				slot=head;
+		}
+	}
+
+	if (slot==-1)
+		return false;
+
+	// wait for readers of the victim row
+	auto docnum=m_invindex[slot];
+	std::unique_lock<std::shared_mutex> lock(
+		m_shards[docnum%m_num_shards].lock);
+	m_index[docnum]=-1;
+	m_invindex[slot]=-1;
+	m_free_slots.push_back(slot);
+	m_elems--;
+	m_evictions++;
+	return true;
+}
+
+int32_t KernelRowCache::lookup(int32_t docnum)
+{
+	auto slot=m_index[docnum];
+	if (slot!=-1)
+	{
+		mark_used(slot);
+		m_hits++;
+	}
+	else
+		m_misses++;
+
+	return slot;
+}
+
+bool KernelRowCache::touch(int32_t docnum)
+{
+	auto lock=lock_shared(docnum);
+	auto slot=m_index[docnum];
+	if (slot==-1)
+		return false;
+
+	mark_used(slot);
+	return true;
+}
+
+int32_t KernelRowCache::reserve(int32_t docnum)
+{
+	std::lock_guard<std::mutex> lock(m_slot_lock);
+
+	if (m_free_slots.empty() && !evict())
+		return -1;
+
+	auto slot=m_free_slots.back();
+	m_free_slots.pop_back();
+	m_elems++;
+	return slot;
+}
+
+void KernelRowCache::commit(int32_t docnum, int32_t slot)
+{
+	std::lock_guard<std::mutex> slot_lock(m_slot_lock);
+	std::unique_lock<std::shared_mutex> lock(
+		m_shards[docnum%m_num_shards].lock);
+
+	// another thread was faster in caching the same row
+	if (m_index[docnum]!=-1)
+	{
+		m_free_slots.push_back(slot);
+		m_elems--;
+		return;
+	}
+
+	int32_t now=m_time;
+	m_index[docnum]=slot;
+	m_invindex[slot]=docnum;
+	m_last_used[slot].store(now, std::memory_order_relaxed);
+	m_queued_at[slot]=now;
+
+	std::lock_guard<std::mutex> lru_lock(m_lru_lock);
+	lru_append(slot);
+}
+
+void KernelRowCache::reset_lru()
+{
+	std::lock_guard<std::mutex> slot_lock(m_slot_lock);
+	std::vector<std::unique_lock<std::shared_mutex>> locks;
+	for (int32_t s=0; s<m_num_shards; s++)
+		locks.emplace_back(m_shards[s].lock);
+
+	int32_t maxlru=0;
+	for (int32_t k=0; k<m_max_elems; k++)
+		maxlru=Math::max(maxlru, m_last_used[k].load(std::memory_order_relaxed));
+
+	for (int32_t k=0; k<m_max_elems; k++)
+	{
+		m_last_used[k]-=maxlru;
+		m_queued_at[k]-=maxlru;
+	}
+}
+
+template <class T>
+void KernelRowCache::shrink_buffer(T* buffer, const std::vector<bool>& keep)
+{
+	int64_t from=0, to=0;
+	for (int32_t i=0; i<m_max_elems; i++)
+	{
+		for (int32_t jj=0; jj<m_activenum; jj++)
+		{
+			if (keep[m_active2totdoc[jj]])
+				buffer[to++]=buffer[from];
+			from++;
+		}
+	}
+}
+
+void KernelRowCache::shrink(int32_t totdoc, int32_t num_shrink, const int32_t* after)
+{
+	ASSERT(totdoc > 0);
+
+	std::lock_guard<std::mutex> slot_lock(m_slot_lock);
+	std::vector<std::unique_lock<std::shared_mutex>> locks;
+	for (int32_t s=0; s<m_num_shards; s++)
+		locks.emplace_back(m_shards[s].lock);
+
+	std::vector<bool> keep(totdoc, true);
+	int32_t scount=0;
+	for (int32_t jj=0; (jj<m_activenum) && (scount<num_shrink); jj++)
+	{
+		auto j=m_active2totdoc[jj];
+		if (!after[j])
+		{
+			scount++;
+			keep[j]=false;
+		}
+	}
+
+	if (m_use_float32)
+		shrink_buffer(m_buffer32, keep);
+	else
+		shrink_buffer(m_buffer64, keep);
+
+	m_activenum=0;
+	for (int32_t j=0; j<totdoc; j++)
+	{
+		if (keep[j] && m_totdoc2active[j]!=-1)
+		{
+			m_active2totdoc[m_activenum]=j;
+			m_totdoc2active[j]=m_activenum;
+			m_activenum++;
+		}
+		else
+			m_totdoc2active[j]=-1;
+	}
+
+	// shorter rows make room for more of them
+	auto old_max_elems=m_max_elems;
+	if (m_activenum>0)
+		m_max_elems=(int32_t) Math::min(m_buffsize/m_activenum, int64_t(m_totdoc));
+
+	if (m_max_elems>old_max_elems)
+		add_free_slots(old_max_elems, m_max_elems);
+	else
+		m_max_elems=old_max_elems;
+}
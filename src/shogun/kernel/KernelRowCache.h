@@ -0,0 +1,271 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _KERNELROWCACHE_H___
+#define _KERNELROWCACHE_H___
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace shogun
+{
+/** which cached row is evicted to make room for another one */
+enum EKernelCacheEviction
+{
+	/** the least recently used row. Every read moves its row to the end
+	 * of the LRU list, which briefly takes a lock shared by all shards */
+	KCE_LRU,
+	/** an approximation of LRU: a row read since it was queued is queued
+	 * again instead of being evicted (second chance). Reads only update
+	 * the access time of their row and take no shared lock */
+	KCE_SECOND_CHANCE
+};
+
+/** @brief Row cache for kernel evaluations of SVMLight-style solvers.
+ *
+ * A cached row of example i holds the kernel values k(i,j) of all currently
+ * active examples j, addressed by their active index. Shrinking the active
+ * set compacts all rows and makes room for more rows.
+ *
+ * Examples are split into shards for locking only, example i belongs to
+ * shard i % num_shards. Every shard has its own reader/writer lock, so any
+ * number of threads can read cached rows while rows of other shards are
+ * inserted or evicted. Free slots and the LRU list are shared by all
+ * shards, such that a row can take any free slot and the victim is chosen
+ * whatever its shard. The eviction policy, see EKernelCacheEviction,
+ * either evicts the least recently used row, or approximates this with
+ * cheaper reads by giving rows read since they were queued a second
+ * chance. Eviction is O(1) with KCE_LRU and O(1) amortized with
+ * KCE_SECOND_CHANCE.
+ *
+ * Rows can optionally be stored in single precision, which doubles the
+ * number of rows that fit into the same amount of memory.
+ *
+ * Filling a row is a two-step process: reserve() hands out a slot that is
+ * not visible to readers yet, commit() publishes it once it is filled.
+ */
+class KernelRowCache
+{
+public:
+	/** constructor
+	 *
+	 * @param totdoc number of rows (examples) that can be cached
+	 * @param size_mb size of the row buffer in megabytes
+	 * @param use_float32 whether rows are stored in single precision
+	 * @param num_shards number of shards, clamped to [1, totdoc]
+	 * @param eviction eviction policy
+	 */
+	KernelRowCache(
+		int32_t totdoc, int64_t size_mb, bool use_float32, int32_t num_shards,
+		EKernelCacheEviction eviction=KCE_LRU);
+
+	~KernelRowCache();
+
+	KernelRowCache(const KernelRowCache&)=delete;
+	KernelRowCache& operator=(const KernelRowCache&)=delete;
+
+	/** @return number of rows that can be cached at most */
+	int32_t get_max_elems() const { return m_max_elems; }
+
+	/** @return number of rows currently cached or reserved */
+	int32_t get_num_elems() const { return m_elems; }
+
+	/** @return number of active examples, i.e. the length of a row */
+	int32_t get_activenum() const { return m_activenum; }
+
+	/** @return number of shards */
+	int32_t get_num_shards() const { return m_num_shards; }
+
+	/** @return whether rows are stored in single precision */
+	bool get_use_float32() const { return m_use_float32; }
+
+	/** @return eviction policy */
+	EKernelCacheEviction get_eviction() const { return m_eviction; }
+
+	/** @return size of the row buffer in bytes */
+	int64_t get_buffer_bytes() const;
+
+	/** @return whether there is room for one more row */
+	bool space_available() const { return m_elems<m_max_elems; }
+
+	/** set the current time used for the LRU strategy
+	 *
+	 * @param t time
+	 */
+	void set_time(int32_t t) { m_time=t; }
+
+	/** subtract the most recent access time from all access times */
+	void reset_lru();
+
+	/** lock the shard of a row for reading. Must be held while reading a
+	 * row obtained from lookup()
+	 *
+	 * @param docnum example index
+	 * @return shared lock of the shard
+	 */
+	std::shared_lock<std::shared_mutex> lock_shared(int32_t docnum) const
+	{
+		return std::shared_lock<std::shared_mutex>(
+			m_shards[docnum%m_num_shards].lock);
+	}
+
+	/** find the slot of a row, count a hit or miss and mark it as used.
+	 * The caller has to hold lock_shared(docnum).
+	 *
+	 * @param docnum example index
+	 * @return slot of the row or -1 if not cached
+	 */
+	int32_t lookup(int32_t docnum);
+
+	/** @param docnum example index
+	 * @return slot of the row or -1 if not cached, without updating stats
+	 */
+	int32_t get_slot(int32_t docnum) const { return m_index[docnum]; }
+
+	/** mark a row as used to avoid its eviction
+	 *
+	 * @param docnum example index
+	 * @return whether the row is cached
+	 */
+	bool touch(int32_t docnum);
+
+	/** reserve a slot for a row, evicting a row according to the eviction
+	 * policy if necessary. The slot is invisible until commit().
+	 *
+	 * @param docnum example index
+	 * @return slot or -1 if all slots are reserved
+	 */
+	int32_t reserve(int32_t docnum);
+
+	/** publish a filled slot obtained from reserve()
+	 *
+	 * @param docnum example index
+	 * @param slot reserved slot
+	 */
+	void commit(int32_t docnum, int32_t slot);
+
+	/** @param a active index
+	 * @return example index of active index a
+	 */
+	int32_t active2totdoc(int32_t a) const { return m_active2totdoc[a]; }
+
+	/** @param docnum example index
+	 * @return active index of the example or -1 if it is inactive
+	 */
+	int32_t totdoc2active(int32_t docnum) const { return m_totdoc2active[docnum]; }
+
+	/** @param slot slot of a row
+	 * @param a active index
+	 * @return cached kernel value
+	 */
+	float64_t get(int32_t slot, int32_t a) const
+	{
+		auto pos=int64_t(m_activenum)*slot+a;
+		return m_use_float32 ? m_buffer32[pos] : m_buffer64[pos];
+	}
+
+	/** @param slot slot of a row
+	 * @param a active index
+	 * @param value kernel value to store
+	 */
+	void set(int32_t slot, int32_t a, float64_t value)
+	{
+		auto pos=int64_t(m_activenum)*slot+a;
+		if (m_use_float32)
+			m_buffer32[pos]=value;
+		else
+			m_buffer64[pos]=value;
+	}
+
+	/** remove up to num_shrink examples from the active set and compact
+	 * all rows accordingly
+	 *
+	 * @param totdoc number of examples
+	 * @param num_shrink maximum number of examples to remove
+	 * @param after examples with after[j]==0 are removed
+	 */
+	void shrink(int32_t totdoc, int32_t num_shrink, const int32_t* after);
+
+	/** @return number of lookups that found a cached row */
+	int64_t get_hits() const { return m_hits; }
+
+	/** @return number of lookups that did not find a cached row */
+	int64_t get_misses() const { return m_misses; }
+
+	/** @return number of rows evicted to make room for others */
+	int64_t get_evictions() const { return m_evictions; }
+
+private:
+	/** lock of the rows of one shard */
+	struct Shard
+	{
+		/** reader/writer lock */
+		mutable std::shared_mutex lock;
+	};
+
+	void add_free_slots(int32_t begin, int32_t end);
+	void lru_unlink(int32_t slot);
+	void lru_append(int32_t slot);
+	void mark_used(int32_t slot);
+	bool evict();
+
+	template <class T>
+	void shrink_buffer(T* buffer, const std::vector<bool>& keep);
+
+	int32_t m_totdoc;
+	int32_t m_num_shards;
+	std::unique_ptr<Shard[]> m_shards;
+
+	/** protects free slots, taken before any shard lock */
+	std::mutex m_slot_lock;
+	/** protects the LRU list, no other lock is taken while holding it */
+	std::mutex m_lru_lock;
+	/** unused slots */
+	std::vector<int32_t> m_free_slots;
+	/** least recently queued slot */
+	int32_t m_lru_head;
+	/** most recently queued slot */
+	int32_t m_lru_tail;
+
+	/** example -> slot */
+	std::vector<int32_t> m_index;
+	/** slot -> example */
+	std::vector<int32_t> m_invindex;
+	std::vector<int32_t> m_active2totdoc;
+	std::vector<int32_t> m_totdoc2active;
+
+	/** last access time of slot */
+	std::unique_ptr<std::atomic<int32_t>[]> m_last_used;
+	/** access time of slot when it was put at its LRU list position */
+	std::vector<int32_t> m_queued_at;
+	std::vector<int32_t> m_lru_prev;
+	std::vector<int32_t> m_lru_next;
+	/** whether a slot is in the LRU list */
+	std::vector<bool> m_queued;
+	EKernelCacheEviction m_eviction;
+
+	int32_t m_max_elems;
+	std::atomic<int32_t> m_elems;
+	int32_t m_activenum;
+	std::atomic<int32_t> m_time;
+
+	bool m_use_float32;
+	float32_t* m_buffer32;
+	float64_t* m_buffer64;
+	/** number of elements in buffer */
+	int64_t m_buffsize;
+
+	std::atomic<int64_t> m_hits;
+	std::atomic<int64_t> m_misses;
+	std::atomic<int64_t> m_evictions;
+};
+}
+#endif /* _KERNELROWCACHE_H___ */
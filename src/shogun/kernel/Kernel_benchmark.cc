@@ -0,0 +1,49 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/kernel/GaussianKernel.h"
+#include "shogun/kernel/LinearKernel.h"
+#include "shogun/kernel/PolyKernel.h"
+#include "shogun/kernel/SigmoidKernel.h"
+#include "shogun/util/benchmark_data.h"
+
+#include <functional>
+
+namespace shogun
+{
+
+/** computes the full Gram matrix of range(0) vectors of dimension range(1) */
+static void BM_Kernel_GramMatrix(
+    benchmark::State& state, std::function<std::shared_ptr<Kernel>()> create)
+{
+	auto feats = benchmark_data::dense_features(state.range(0), state.range(1));
+	auto kernel = create();
+	kernel->init(feats, feats);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(kernel->get_kernel_matrix());
+
+	int64_t num_vecs = feats->get_num_vectors();
+	state.SetItemsProcessed(state.iterations() * num_vecs * num_vecs);
+}
+
+#define ADD_GRAM_MATRIX_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(4)->Ranges({{256, 4096}, {16, 256}})->Unit(benchmark::kMillisecond);
+
+ADD_GRAM_MATRIX_ARGS(BENCHMARK_CAPTURE(BM_Kernel_GramMatrix, GaussianKernel, []() {
+	return std::make_shared<GaussianKernel>(2.0);
+}))
+ADD_GRAM_MATRIX_ARGS(BENCHMARK_CAPTURE(BM_Kernel_GramMatrix, LinearKernel, []() {
+	return std::make_shared<LinearKernel>();
+}))
+ADD_GRAM_MATRIX_ARGS(BENCHMARK_CAPTURE(BM_Kernel_GramMatrix, PolyKernel, []() {
+	return std::make_shared<PolyKernel>(10, 3, 1.0, 1.0);
+}))
+ADD_GRAM_MATRIX_ARGS(BENCHMARK_CAPTURE(BM_Kernel_GramMatrix, SigmoidKernel, []() {
+	return std::make_shared<SigmoidKernel>(10, 0.01, 0.0);
+}))
+
+}
@@ -130,6 +130,18 @@ class LinearKernel: public DotKernel
 		}
 
 	protected:
+		virtual bool supports_block_computation()
+		{
+			return supports_dot_block();
+		}
+
+		virtual void compute_block_from_features(
+			const SGMatrix<float64_t>& lhs_block,
+			const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block)
+		{
+			compute_dot_block(lhs_block, rhs_block, block);
+		}
+
 		/** normal vector (used in case of optimized kernel) */
 		SGVector<float64_t> normal;
 };
@@ -66,6 +66,17 @@ float64_t PolyKernel::compute(int32_t idx_a, int32_t idx_b)
 	return Math::pow(result, degree);
 }
 
+void PolyKernel::compute_block_from_features(
+	const SGMatrix<float64_t>& lhs_block, const SGMatrix<float64_t>& rhs_block,
+	SGMatrix<float64_t>& block)
+{
+	compute_dot_block(lhs_block, rhs_block, block);
+
+	const auto gamma=std::get<float64_t>(m_gamma);
+	for (auto& v : block)
+		v=Math::pow(gamma*v+m_c, degree);
+}
+
 void PolyKernel::init()
 {
 	degree = 0;
@@ -100,6 +100,15 @@ class PolyKernel: public DotKernel
 		 */
 		virtual float64_t compute(int32_t idx_a, int32_t idx_b);
 
+		virtual bool supports_block_computation()
+		{
+			return supports_dot_block();
+		}
+
+		virtual void compute_block_from_features(
+			const SGMatrix<float64_t>& lhs_block,
+			const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block);
+
 	private:
 		void init();
 
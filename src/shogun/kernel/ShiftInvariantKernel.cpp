@@ -31,6 +31,8 @@
 #include <shogun/lib/common.h>
 #include <shogun/kernel/ShiftInvariantKernel.h>
 #include <shogun/distance/CustomDistance.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 using namespace shogun;
 
@@ -101,6 +103,23 @@ float64_t ShiftInvariantKernel::distance(int32_t a, int32_t b) const
 		return m_distance->distance(a, b);
 }
 
+bool ShiftInvariantKernel::supports_distance_block() const
+{
+	return m_distance && !m_precomputed_distance && lhs && rhs &&
+		m_distance->get_distance_type()==D_EUCLIDEAN &&
+		lhs->get_feature_class()==C_DENSE && rhs->get_feature_class()==C_DENSE &&
+		lhs->get_feature_type()==F_DREAL && rhs->get_feature_type()==F_DREAL;
+}
+
+void ShiftInvariantKernel::compute_distance_block(
+	const SGMatrix<float64_t>& lhs_block, const SGMatrix<float64_t>& rhs_block,
+	SGMatrix<float64_t>& block) const
+{
+	linalg::squared_distances(lhs_block, rhs_block, block);
+	if (!m_distance->as<EuclideanDistance>()->get_disable_sqrt())
+		linalg::sqrt(block, block);
+}
+
 void ShiftInvariantKernel::register_params()
 {
 	SG_ADD((std::shared_ptr<SGObject>*) &m_distance, "m_distance", "Distance to be used.");
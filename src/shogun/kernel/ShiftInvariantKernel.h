@@ -131,6 +131,27 @@ protected:
 	 */
 	virtual float64_t distance(int32_t idx_a, int32_t idx_b) const;
 
+	/** @return whether compute_distance_block() can be used, i.e. whether
+	 * the distance is a EuclideanDistance on DenseFeatures<float64_t> and
+	 * no precomputed distance is set
+	 */
+	bool supports_distance_block() const;
+
+	/**
+	 * Computes the Euclidean distances between the columns of two blocks
+	 * of dense feature vectors as
+	 * \f$||{\bf x}||^2+||{\bf y}||^2-2{\bf x}^\top{\bf y}\f$ with a single
+	 * matrix product for all dot products.
+	 *
+	 * @param lhs_block lhs feature vectors, one per column
+	 * @param rhs_block rhs feature vectors, one per column
+	 * @param block preallocated result of size
+	 * lhs_block.num_cols x rhs_block.num_cols
+	 */
+	void compute_distance_block(
+		const SGMatrix<float64_t>& lhs_block,
+		const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block) const;
+
 	/** Distance instance for the kernel. MUST be initialized by the subclasses */
 	std::shared_ptr<Distance> m_distance;
 
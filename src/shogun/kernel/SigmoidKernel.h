@@ -93,6 +93,22 @@ class SigmoidKernel: public DotKernel
 			return tanh(std::get<float64_t>(m_gamma)*DotKernel::compute(idx_a,idx_b)+coef0);
 		}
 
+		virtual bool supports_block_computation()
+		{
+			return supports_dot_block();
+		}
+
+		virtual void compute_block_from_features(
+			const SGMatrix<float64_t>& lhs_block,
+			const SGMatrix<float64_t>& rhs_block, SGMatrix<float64_t>& block)
+		{
+			compute_dot_block(lhs_block, rhs_block, block);
+
+			const auto gamma=std::get<float64_t>(m_gamma);
+			for (auto& v : block)
+				v=tanh(gamma*v+coef0);
+		}
+
 	protected:
 		/** gamma */
 		AutoValue<float64_t> m_gamma = AutoValueEmpty{};
@@ -21,34 +21,10 @@
 
 #include <vector>
 
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-
-#endif
-
 using namespace shogun;
 
 #define TRIES(X) ((use_poim_tries) ? (poim_tries.X) : (tries.X))
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-template <class Trie> struct S_THREAD_PARAM_WDS
-{
-	int32_t* vec;
-	float64_t* result;
-	float64_t* weights;
-	WeightedDegreePositionStringKernel* kernel;
-	CTrie<Trie>* tries;
-	float64_t factor;
-	int32_t j;
-	int32_t start;
-	int32_t end;
-	int32_t length;
-	int32_t max_shift;
-	int32_t* shift;
-	int32_t* vec_idx;
-};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
 WeightedDegreePositionStringKernel::WeightedDegreePositionStringKernel(
 	void)
 : StringKernel<char>()
@@ -265,6 +241,26 @@ bool WeightedDegreePositionStringKernel::init_optimization(
 	if (tree_num<0)
 		SG_DEBUG("initializing CWeightedDegreePositionStringKernel optimization")
 
+	// the trees are built at once by sharding them over the threads
+	if (tree_num<0 && use_poim_tries)
+	{
+		if (poim_tries.get_num_used_nodes()==seq_length)
+		{
+			add_examples_to_trees(poim_tries, p_count, IDX, alphas, 0, seq_length);
+			set_is_initialized(true);
+			return true;
+		}
+	}
+	else if (tries.get_num_used_nodes()==seq_length)
+	{
+		if (tree_num<0)
+			add_examples_to_trees(tries, p_count, IDX, alphas, 0, seq_length);
+		else
+			add_examples_to_trees(tries, p_count, IDX, alphas, tree_num, upto_tree+1);
+		set_is_initialized(true);
+		return true;
+	}
+
 	for (auto i : SG_PROGRESS(range(p_count)))
 	{
 		if (tree_num<0)
@@ -738,6 +734,66 @@ void WeightedDegreePositionStringKernel::add_example_to_single_tree(
 	tree_initialized=true ;
 }
 
+template <class Trie>
+void WeightedDegreePositionStringKernel::add_examples_to_trees(
+	CTrie<Trie>& trie, int32_t count, int32_t* IDX, float64_t* alphas,
+	int32_t begin, int32_t end)
+{
+	ASSERT(position_weights_lhs==NULL)
+	ASSERT(position_weights_rhs==NULL)
+	ASSERT(alphabet)
+	ASSERT(alphabet->get_alphabet()==DNA || alphabet->get_alphabet()==RNA)
+	ASSERT(max_mismatch==0)
+	if (opt_type!=SLOWBUTMEMEFFICIENT && opt_type!=FASTBUTMEMHUNGRY)
+		error("unknown optimization type");
+	if (opt_type==FASTBUTMEMHUNGRY)
+		ASSERT(!trie.get_use_compact_terminal_nodes())
+
+	// the trees [begin, end) only read the shifted k-mers starting there
+	auto sf=std::static_pointer_cast<StringFeatures<char>>(lhs);
+	const int32_t from=Math::max(0, begin-max_shift);
+	const int32_t to=Math::min(seq_length, end+degree+max_shift);
+	trie.add_examples_by_tree(begin, end, count, seq_length,
+		[&](int32_t e, int32_t* vec)
+		{
+			int32_t len=0;
+			bool free_vec;
+			char* char_vec=sf->get_feature_vector(IDX[e], len, free_vec);
+			for (int32_t i=from; i<Math::min(len, to); i++)
+				vec[i]=alphabet->remap_to_bin(char_vec[i]);
+			sf->free_feature_vector(char_vec, IDX[e], free_vec);
+			// no stale symbols of a longer example behind a shorter one
+			for (int32_t i=Math::max(from, len); i<to; i++)
+				vec[i]=0;
+			return len;
+		},
+		// the same shifted examples as add_example_to_tree() adds to the tree
+		[&](CTrie<Trie>& shard, int32_t tree, int32_t* vec, int32_t len, int32_t e)
+		{
+			float64_t alpha=alphas[e];
+			int32_t max_s=(opt_type==FASTBUTMEMHUNGRY) ? shift[tree] : 0;
+			for (int32_t s=max_s; s>=0; s--)
+			{
+				float64_t alpha_pw = normalizer->normalize_lhs((s==0) ? (alpha) : (alpha/(2.0*s)), IDX[e]);
+				shard.add_to_trie(tree, s, vec, alpha_pw, weights, (length!=0)) ;
+			}
+
+			if (opt_type==FASTBUTMEMHUNGRY)
+			{
+				for (int32_t i=Math::max(0,tree-max_shift); i<Math::min(len,tree+max_shift+1); i++)
+				{
+					int32_t s=tree-i;
+					if ((i+s<len) && (s>=1) && (s<=shift[i]))
+					{
+						float64_t alpha_pw = normalizer->normalize_lhs(alpha/(2.0*s), IDX[e]);
+						shard.add_to_trie(tree, -s, vec, alpha_pw, weights, (length!=0)) ;
+					}
+				}
+			}
+		});
+	tree_initialized=true ;
+}
+
 float64_t WeightedDegreePositionStringKernel::compute_by_tree(int32_t idx)
 {
 	ASSERT(position_weights_lhs==NULL)
@@ -1154,64 +1210,6 @@ bool WeightedDegreePositionStringKernel::init_block_weights()
 
 
 
-void* WeightedDegreePositionStringKernel::compute_batch_helper(void* p)
-{
-	S_THREAD_PARAM_WDS<DNATrie>* params = (S_THREAD_PARAM_WDS<DNATrie>*) p;
-	int32_t j=params->j;
-	WeightedDegreePositionStringKernel* wd=params->kernel;
-	CTrie<DNATrie>* tries=params->tries;
-	float64_t* weights=params->weights;
-	int32_t length=params->length;
-	int32_t max_shift=params->max_shift;
-	int32_t* vec=params->vec;
-	float64_t* result=params->result;
-	float64_t factor=params->factor;
-	int32_t* shift=params->shift;
-	int32_t* vec_idx=params->vec_idx;
-
-	for (int32_t i=params->start; i<params->end; i++)
-	{
-		int32_t len=0;
-		auto rhs_feat=(StringFeatures<char>*)(wd->get_rhs().get());
-		auto alpha=wd->alphabet;
-
-		bool free_vec;
-		char* char_vec=rhs_feat->get_feature_vector(vec_idx[i], len, free_vec);
-		for (int32_t k=Math::max(0,j-max_shift); k<Math::min(len,j+wd->get_degree()+max_shift); k++)
-			vec[k]=alpha->remap_to_bin(char_vec[k]);
-		rhs_feat->free_feature_vector(char_vec, vec_idx[i], free_vec);
-
-
-
-		result[i] += factor*wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec, len, j, j, j, weights, (length!=0)), vec_idx[i]);
-
-		if (wd->get_optimization_type()==SLOWBUTMEMEFFICIENT)
-		{
-			for (int32_t q=Math::max(0,j-max_shift); q<Math::min(len,j+max_shift+1); q++)
-			{
-				int32_t s=j-q ;
-				if ((s>=1) && (s<=shift[q]) && (q+s<len))
-				{
-					result[i] +=
-						wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec,
-								len, q, q+s, q, weights, (length!=0)),
-								vec_idx[i])/(2.0*s);
-				}
-			}
-
-			for (int32_t s=1; (s<=shift[j]) && (j+s<len); s++)
-			{
-				result[i] +=
-					wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec,
-								len, j+s, j, j+s, weights, (length!=0)),
-								vec_idx[i])/(2.0*s);
-			}
-		}
-	}
-
-	return NULL;
-}
-
 void WeightedDegreePositionStringKernel::compute_batch(
 	int32_t num_vec, int32_t* vec_idx, float64_t* result, int32_t num_suppvec,
 	int32_t* IDX, float64_t* alphas, float64_t factor)
@@ -1227,97 +1225,73 @@ void WeightedDegreePositionStringKernel::compute_batch(
 	ASSERT(result)
 	create_empty_tries();
 
-	int32_t num_feat=std::static_pointer_cast<StringFeatures<char>>(rhs)->get_max_vector_length();
+	auto rhs_feat=std::static_pointer_cast<StringFeatures<char>>(rhs);
+	int32_t num_feat=rhs_feat->get_max_vector_length();
 	ASSERT(num_feat>0)
-	// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
+
+	// the trees of a block of positions are built at once, one per
+	// thread, instead of all of them to bound the memory
 	int32_t num_threads=env()->get_num_threads();
-#else
-	int32_t num_threads=1;
-#endif
-	ASSERT(num_threads>0)
-	int32_t* vec=SG_MALLOC(int32_t, num_threads*num_feat);
+	auto pb = SG_PROGRESS(range(num_feat));
 
-	if (num_threads < 2)
+	// TODO: replace with the new signal
+	// for (int32_t j=0; j<num_feat && !Signal::cancel_computations(); j++)
+	for (int32_t block=0; block<num_feat; block+=num_threads)
 	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !Signal::cancel_computations(); j++)
-		for (auto j : SG_PROGRESS(range(num_feat)))
-		{
-			init_optimization(num_suppvec, IDX, alphas, j);
-			S_THREAD_PARAM_WDS<DNATrie> params;
-			params.vec = vec;
-			params.result = result;
-			params.weights = weights;
-			params.kernel = this;
-			params.tries = &tries;
-			params.factor = factor;
-			params.j = j;
-			params.start = 0;
-			params.end = num_vec;
-			params.length = length;
-			params.max_shift = max_shift;
-			params.shift = shift;
-			params.vec_idx = vec_idx;
-			compute_batch_helper((void*)&params);
-		    }
-	}
-#ifdef HAVE_PTHREAD
-	else
-	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !Signal::cancel_computations(); j++)
-		for (auto j : SG_PROGRESS(range(num_feat)))
+		int32_t block_end=Math::min(block+num_threads, num_feat);
+		init_optimization(num_suppvec, IDX, alphas, block, block_end-1);
+
+#pragma omp parallel num_threads(num_threads)
 		{
-			init_optimization(num_suppvec, IDX, alphas, j);
-			pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-			S_THREAD_PARAM_WDS<DNATrie>* params = SG_MALLOC(S_THREAD_PARAM_WDS<DNATrie>, num_threads);
-			int32_t step= num_vec/num_threads;
-			int32_t t;
+			std::vector<int32_t> vec(num_feat);
 
-			for (t=0; t<num_threads-1; t++)
+#pragma omp for
+			for (int32_t i=0; i<num_vec; i++)
 			{
-				params[t].vec=&vec[num_feat*t];
-				params[t].result=result;
-				params[t].weights=weights;
-				params[t].kernel=this;
-				params[t].tries=&tries;
-				params[t].factor=factor;
-				params[t].j=j;
-				params[t].start = t*step;
-				params[t].end = (t+1)*step;
-				params[t].length=length;
-				params[t].max_shift=max_shift;
-				params[t].shift=shift;
-				params[t].vec_idx=vec_idx;
-				pthread_create(&threads[t], NULL, WeightedDegreePositionStringKernel::compute_batch_helper, (void*)&params[t]);
-			}
+				int32_t len=0;
+				bool free_vec;
+				char* char_vec=rhs_feat->get_feature_vector(vec_idx[i], len, free_vec);
+				for (int32_t k=Math::max(0,block-max_shift); k<Math::min(len,block_end+degree+max_shift-1); k++)
+					vec[k]=alphabet->remap_to_bin(char_vec[k]);
+				rhs_feat->free_feature_vector(char_vec, vec_idx[i], free_vec);
+
+				for (int32_t j=block; j<Math::min(len, block_end); j++)
+				{
+					if (j+1<Math::min(len, block_end))
+						tries.prefetch_path(vec.data(), j+1, j+1);
+
+					result[i] += factor*normalizer->normalize_rhs(tries.compute_by_tree_helper(vec.data(), len, j, j, j, weights, (length!=0)), vec_idx[i]);
+
+					if (opt_type==SLOWBUTMEMEFFICIENT)
+					{
+						for (int32_t q=Math::max(0,j-max_shift); q<Math::min(len,j+max_shift+1); q++)
+						{
+							int32_t s=j-q ;
+							if ((s>=1) && (s<=shift[q]) && (q+s<len))
+							{
+								result[i] +=
+									normalizer->normalize_rhs(tries.compute_by_tree_helper(vec.data(),
+											len, q, q+s, q, weights, (length!=0)),
+											vec_idx[i])/(2.0*s);
+							}
+						}
 
-			params[t].vec=&vec[num_feat*t];
-			params[t].result=result;
-			params[t].weights=weights;
-			params[t].kernel=this;
-			params[t].tries=&tries;
-			params[t].factor=factor;
-			params[t].j=j;
-			params[t].start=t*step;
-			params[t].end=num_vec;
-			params[t].length=length;
-			params[t].max_shift=max_shift;
-			params[t].shift=shift;
-			params[t].vec_idx=vec_idx;
-			compute_batch_helper((void*) &params[t]);
-
-			for (t=0; t<num_threads-1; t++)
-				pthread_join(threads[t], NULL);
-
-			SG_FREE(params);
-			SG_FREE(threads);
+						for (int32_t s=1; (s<=shift[j]) && (j+s<len); s++)
+						{
+							result[i] +=
+								normalizer->normalize_rhs(tries.compute_by_tree_helper(vec.data(),
+											len, j+s, j, j+s, weights, (length!=0)),
+											vec_idx[i])/(2.0*s);
+						}
+					}
+				}
+			}
 		}
-	}
-#endif
 
-	SG_FREE(vec);
+		for (int32_t j=block; j<block_end; j++)
+			pb.print_progress();
+	}
+	pb.complete();
 
 	//really also free memory as this can be huge on testing especially when
 	//using the combined kernel
@@ -155,12 +155,6 @@ class WeightedDegreePositionStringKernel: public StringKernel<char>
 			return compute_by_tree(idx);
 		}
 
-		/** helper for compute batch
-		 *
-		 * @param p thread parameter
-		 */
-		static void* compute_batch_helper(void* p);
-
 		/** compute batch
 		 *
 		 * @param num_vec number of vectors
@@ -627,6 +621,21 @@ class WeightedDegreePositionStringKernel: public StringKernel<char>
 		void add_example_to_single_tree(
 			int32_t idx, float64_t weight, int32_t tree_num);
 
+		/** add examples to the empty trees [begin, end) of a trie in
+		 * parallel, see CTrie::add_examples_by_tree()
+		 *
+		 * @param trie trie
+		 * @param count number of examples
+		 * @param IDX indices of the examples
+		 * @param alphas weights of the examples
+		 * @param begin first tree
+		 * @param end tree after the last one
+		 */
+		template <class Trie>
+		void add_examples_to_trees(
+			CTrie<Trie>& trie, int32_t count, int32_t* IDX, float64_t* alphas,
+			int32_t begin, int32_t end);
+
 		/** compute kernel function for features a and b
 		 * idx_{a,b} denote the index of the feature vectors
 		 * in the corresponding feature object
@@ -17,31 +17,10 @@
 #include <shogun/features/Features.h>
 #include <shogun/features/StringFeatures.h>
 
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-
-#endif
+#include <vector>
 
 using namespace shogun;
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct S_THREAD_PARAM_WD
-{
-
-	int32_t* vec;
-	float64_t* result;
-	float64_t* weights;
-	WeightedDegreeStringKernel* kernel;
-	CTrie<DNATrie>* tries;
-	float64_t factor;
-	int32_t j;
-	int32_t start;
-	int32_t end;
-	int32_t length;
-	int32_t* vec_idx;
-};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
 WeightedDegreeStringKernel::WeightedDegreeStringKernel ()
 : StringKernel<char>()
 {
@@ -210,6 +189,14 @@ bool WeightedDegreeStringKernel::init_optimization(int32_t count, int32_t* IDX,
 	if (tree_num<0)
 		SG_DEBUG("initializing CWeightedDegreeStringKernel optimization")
 
+	// all trees are built at once by sharding them over the threads
+	if (tree_num<0 && max_mismatch==0 && tries->get_num_used_nodes()==seq_length)
+	{
+		add_examples_to_trees(count, IDX, alphas, 0, seq_length);
+		set_is_initialized(true);
+		return true;
+	}
+
 	for (auto i : SG_PROGRESS(range(count)))
 	{
 		if (tree_num<0)
@@ -449,6 +436,39 @@ void WeightedDegreeStringKernel::add_example_to_single_tree(
 	tree_initialized=true ;
 }
 
+void WeightedDegreeStringKernel::add_examples_to_trees(
+	int32_t count, int32_t* IDX, float64_t* alphas, int32_t begin, int32_t end)
+{
+	ASSERT(tries)
+	ASSERT(alphabet)
+	ASSERT(alphabet->get_alphabet()==DNA || alphabet->get_alphabet()==RNA)
+	ASSERT(max_mismatch==0)
+
+	// the trees [begin, end) only read the k-mers starting there
+	auto sf=lhs->as<StringFeatures<char>>();
+	const int32_t to=Math::min(seq_length, end+degree);
+	tries->add_examples_by_tree(begin, end, count, seq_length,
+		[&](int32_t e, int32_t* vec)
+		{
+			int32_t len=0;
+			bool free_vec;
+			char* char_vec=sf->get_feature_vector(IDX[e], len, free_vec);
+			for (int32_t i=begin; i<Math::min(len, to); i++)
+				vec[i]=alphabet->remap_to_bin(char_vec[i]);
+			sf->free_feature_vector(char_vec, IDX[e], free_vec);
+			// no stale symbols of a longer example behind a shorter one
+			for (int32_t i=Math::max(begin, len); i<to; i++)
+				vec[i]=0;
+			return len;
+		},
+		[&](CTrie<DNATrie>& trie, int32_t tree, int32_t* vec, int32_t len, int32_t e)
+		{
+			if (alphas[e]!=0.0)
+				trie.add_to_trie(tree, 0, vec, normalizer->normalize_lhs(alphas[e], IDX[e]), weights, (length!=0));
+		});
+	tree_initialized=true;
+}
+
 void WeightedDegreeStringKernel::add_example_to_tree_mismatch(int32_t idx, float64_t alpha)
 {
 	ASSERT(tries)
@@ -816,42 +836,6 @@ bool WeightedDegreeStringKernel::init_block_weights()
 }
 
 
-void* WeightedDegreeStringKernel::compute_batch_helper(void* p)
-{
-	S_THREAD_PARAM_WD* params = (S_THREAD_PARAM_WD*) p;
-	int32_t j=params->j;
-	WeightedDegreeStringKernel* wd=params->kernel;
-	CTrie<DNATrie>* tries=params->tries;
-	float64_t* weights=params->weights;
-	int32_t length=params->length;
-	int32_t* vec=params->vec;
-	float64_t* result=params->result;
-	float64_t factor=params->factor;
-	int32_t* vec_idx=params->vec_idx;
-
-	StringFeatures<char>* rhs_feat=(StringFeatures<char>*)(wd->get_rhs().get());
-	auto alpha=wd->alphabet;
-
-	for (int32_t i=params->start; i<params->end; i++)
-	{
-		int32_t len=0;
-		bool free_vec;
-		char* char_vec=rhs_feat->get_feature_vector(vec_idx[i], len, free_vec);
-		for (int32_t k=j; k<Math::min(len,j+wd->get_degree()); k++)
-			vec[k]=alpha->remap_to_bin(char_vec[k]);
-		rhs_feat->free_feature_vector(char_vec, vec_idx[i], free_vec);
-
-		ASSERT(tries)
-
-		result[i]+=factor*
-			wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec, len, j, j, j, weights, (length!=0)), vec_idx[i]);
-	}
-
-
-
-	return NULL;
-}
-
 void WeightedDegreeStringKernel::compute_batch(
 	int32_t num_vec, int32_t* vec_idx, float64_t* result, int32_t num_suppvec,
 	int32_t* IDX, float64_t* alphas, float64_t factor)
@@ -866,96 +850,59 @@ void WeightedDegreeStringKernel::compute_batch(
 	ASSERT(result)
 	create_empty_tries();
 
-	int32_t num_feat=rhs->as<StringFeatures<char>>()->get_max_vector_length();
+	auto rhs_feat=rhs->as<StringFeatures<char>>();
+	int32_t num_feat=rhs_feat->get_max_vector_length();
 	ASSERT(num_feat>0)
-	// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
+
+	// the trees of a block of positions are built at once, one per
+	// thread, instead of all of them to bound the memory
 	int32_t num_threads=env()->get_num_threads();
-#else
-	int32_t num_threads=1;
-#endif
-	ASSERT(num_threads>0)
-	int32_t* vec=SG_MALLOC(int32_t, num_threads*num_feat);
+	int32_t block_size=(max_mismatch==0) ? num_threads : 1;
 	auto pb = SG_PROGRESS(range(num_feat));
 
-	if (num_threads < 2)
+	// TODO: replace with the new signal
+	// for (int32_t j=0; j<num_feat && !Signal::cancel_computations(); j++)
+	for (int32_t block=0; block<num_feat; block+=block_size)
 	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !Signal::cancel_computations(); j++)
-		for (int32_t j = 0; j < num_feat; j++)
+		int32_t block_end=Math::min(block+block_size, num_feat);
+		if (max_mismatch==0)
 		{
-			init_optimization(num_suppvec, IDX, alphas, j);
-			S_THREAD_PARAM_WD params;
-			params.vec=vec;
-			params.result=result;
-			params.weights=weights;
-			params.kernel=this;
-			params.tries=tries.get();
-			params.factor=factor;
-			params.j=j;
-			params.start=0;
-			params.end=num_vec;
-			params.length=length;
-			params.vec_idx=vec_idx;
-			compute_batch_helper((void*) &params);
-
-			pb.print_progress();
+			delete_optimization();
+			add_examples_to_trees(num_suppvec, IDX, alphas, block, block_end);
+			set_is_initialized(true);
 		}
-		pb.complete();
-	}
-#ifdef HAVE_PTHREAD
-	else
-	{
-		// TODO: replace with the new signal
-		// for (int32_t j=0; j<num_feat && !Signal::cancel_computations(); j++)
-		for (int32_t j = 0; j < num_feat; j++)
+		else
+			init_optimization(num_suppvec, IDX, alphas, block);
+
+#pragma omp parallel num_threads(num_threads)
 		{
-			init_optimization(num_suppvec, IDX, alphas, j);
-			pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-			S_THREAD_PARAM_WD* params = SG_MALLOC(S_THREAD_PARAM_WD, num_threads);
-			int32_t step= num_vec/num_threads;
-			int32_t t;
+			std::vector<int32_t> vec(num_feat);
 
-			for (t=0; t<num_threads-1; t++)
+#pragma omp for
+			for (int32_t i=0; i<num_vec; i++)
 			{
-				params[t].vec=&vec[num_feat*t];
-				params[t].result=result;
-				params[t].weights=weights;
-				params[t].kernel=this;
-				params[t].tries=tries.get();
-				params[t].factor=factor;
-				params[t].j=j;
-				params[t].start = t*step;
-				params[t].end = (t+1)*step;
-				params[t].length=length;
-				params[t].vec_idx=vec_idx;
-				pthread_create(&threads[t], NULL, WeightedDegreeStringKernel::compute_batch_helper, (void*)&params[t]);
-			}
-			params[t].vec=&vec[num_feat*t];
-			params[t].result=result;
-			params[t].weights=weights;
-			params[t].kernel=this;
-			params[t].tries=tries.get();
-			params[t].factor=factor;
-			params[t].j=j;
-			params[t].start=t*step;
-			params[t].end=num_vec;
-			params[t].length=length;
-			params[t].vec_idx=vec_idx;
-			compute_batch_helper((void*) &params[t]);
-
-			for (t=0; t<num_threads-1; t++)
-				pthread_join(threads[t], NULL);
-			pb.print_progress();
+				int32_t len=0;
+				bool free_vec;
+				char* char_vec=rhs_feat->get_feature_vector(vec_idx[i], len, free_vec);
+				for (int32_t k=block; k<Math::min(len, block_end+degree-1); k++)
+					vec[k]=alphabet->remap_to_bin(char_vec[k]);
+				rhs_feat->free_feature_vector(char_vec, vec_idx[i], free_vec);
+
+				for (int32_t j=block; j<Math::min(len, block_end); j++)
+				{
+					if (j+1<Math::min(len, block_end))
+						tries->prefetch_path(vec.data(), j+1, j+1);
 
-			SG_FREE(params);
-			SG_FREE(threads);
+					result[i]+=factor*
+						normalizer->normalize_rhs(tries->compute_by_tree_helper(vec.data(), len, j, j, j, weights, (length!=0)), vec_idx[i]);
+				}
+			}
 		}
-		pb.complete();
-	}
-#endif
 
-	SG_FREE(vec);
+		for (int32_t j=block; j<block_end; j++)
+			pb.print_progress();
+	}
+	pb.complete();
 
 	//really also free memory as this can be huge on testing especially when
 	//using the combined kernel
@@ -164,12 +164,6 @@ class WeightedDegreeStringKernel: public StringKernel<char>
 			return 0;
 		}
 
-		/** helper for compute batch
-		 *
-		 * @param p thread parameter
-		 */
-		static void* compute_batch_helper(void* p);
-
 		/** compute batch
 		 *
 		 * @param num_vec number of vectors
@@ -619,6 +613,19 @@ class WeightedDegreeStringKernel: public StringKernel<char>
 		void add_example_to_single_tree(
 			int32_t idx, float64_t weight, int32_t tree_num);
 
+		/** add examples to the empty trees [begin, end) in parallel, see
+		 * CTrie::add_examples_by_tree()
+		 *
+		 * @param count number of examples
+		 * @param IDX indices of the examples
+		 * @param alphas weights of the examples
+		 * @param begin first tree
+		 * @param end tree after the last one
+		 */
+		void add_examples_to_trees(
+			int32_t count, int32_t* IDX, float64_t* alphas, int32_t begin,
+			int32_t end);
+
 		/** add example to tree mismatch
 		 *
 		 * @param idx index
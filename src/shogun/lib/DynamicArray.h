@@ -408,7 +408,7 @@ template <class T> class DynamicArray :public SGObject
 			dim3_size=ndim3;
 			try
 			{
-				m_array.reserve(ndim1*ndim2*ndim3);
+				m_array.resize(int64_t(ndim1)*ndim2*ndim3);
 				return true;
 			}
 			catch (std::exception& e)
@@ -420,7 +420,7 @@ template <class T> class DynamicArray :public SGObject
 		/** set array with a constant */
 		void set_const(const T& const_element)
 		{
-			m_array.assign(m_array.capacity(), const_element);
+			m_array.assign(m_array.size(), const_element);
 		}
 
 		/** get the array
@@ -485,8 +485,7 @@ template <class T> class DynamicArray :public SGObject
 			dim2_size=dim2;
 			dim3_size=1;
 
-			m_array.reserve(dim1+dim2);
-			std::copy(p_array, p_array+dim1+dim2, m_array.begin());
+			m_array.assign(p_array, p_array+int64_t(dim1)*dim2);
 		}
 
 		/** set the 3d array pointer and free previously allocated memory
@@ -507,9 +506,7 @@ template <class T> class DynamicArray :public SGObject
 			dim2_size=dim2;
 			dim3_size=dim3;
 
-			m_array.clear();
-			m_array.reserve(dim1+dim2+dim3);
-			std::copy(p_array, p_array+dim1+dim2+dim3, m_array.begin());
+			m_array.assign(p_array, p_array+int64_t(dim1)*dim2*dim3);
 		}
 
 		/** set the array pointer and free previously allocated memory
@@ -14,6 +14,11 @@
 #include <shogun/io/SGIO.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/base/SGObject.h>
+#include <shogun/base/ShogunEnv.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace shogun
 {
@@ -36,6 +41,9 @@ namespace shogun
 
 #define TRIE_TERMINAL_CHARACTER  7
 
+// number of examples add_examples_by_tree() holds in memory at a time
+#define TRIE_EXAMPLE_CHUNK 1024
+
 /** consensus entry */
 struct ConsensusEntry
 {
@@ -248,6 +256,54 @@ IGNORE_IN_CLASSLIST template <class Trie> class CTrie : public SGObject
 			int32_t i, int32_t seq_offset, int32_t* vec, float32_t alpha,
 			float64_t *weights, bool degree_times_position_weights);
 
+		/** add many examples to the trees in parallel
+		 *
+		 * The trees [begin, end) are split into one contiguous shard per
+		 * thread. Every thread adds the examples to the trees of its shard
+		 * in a node pool of its own, so that no locking is needed, and the
+		 * pools are appended to the tree memory afterwards. The trees have
+		 * to be empty (see create() and delete_trees()), the trees outside
+		 * [begin, end) are left empty.
+		 *
+		 * @param begin first tree
+		 * @param end tree after the last one
+		 * @param num_examples number of examples
+		 * @param vec_len length of the examples
+		 * @param get_example callable (int32_t e, int32_t* vec) writing
+		 * example e to vec and returning its length; only the part of vec
+		 * read by the trees [begin, end) has to be written; called
+		 * concurrently
+		 * @param add_to_tree callable (CTrie& trie, int32_t tree,
+		 * int32_t* vec, int32_t len, int32_t e) adding example e of length
+		 * len to a tree of trie with add_to_trie(); only called for trees
+		 * before len, concurrently for different trees
+		 */
+		template <class GetExample, class AddToTree>
+		void add_examples_by_tree(
+			int32_t begin, int32_t end, int32_t num_examples,
+			int32_t vec_len, GetExample get_example, AddToTree add_to_tree);
+
+		/** prefetch the first node of the path of a sequence in a tree
+		 *
+		 * Meant to be called a little before compute_by_tree_helper() for
+		 * the same arguments, to hide the latency of the first access.
+		 *
+		 * @param vec vector
+		 * @param seq_pos sequence position
+		 * @param tree_pos tree position
+		 */
+		inline void prefetch_path(
+			const int32_t* vec, int32_t seq_pos, int32_t tree_pos) const
+		{
+#ifdef __GNUC__
+			if (degree<2)
+				return;
+			int32_t child=TreeMem[trees[tree_pos]].children[vec[seq_pos]];
+			if (child!=NO_CHILD)
+				__builtin_prefetch(&TreeMem[Math::abs(child)]);
+#endif
+		}
+
 		/** compute absolute weights tree
 		 *
 		 * @param tree tree to compute for
@@ -620,6 +676,14 @@ IGNORE_IN_CLASSLIST template <class Trie> class CTrie : public SGObject
 			const float64_t valS, const float64_t valL, const float64_t valR,
 			const int32_t debug);
 
+		/** add an offset to all node indices below a node
+		 *
+		 * @param node node
+		 * @param depth depth of node
+		 * @param offset offset
+		 */
+		void relocate_tree(int32_t node, int32_t depth, int32_t offset);
+
 		/** @return object name */
 		virtual const char* get_name() const { return "Trie"; }
 
@@ -1713,6 +1777,141 @@ void CTrie<Trie>::add_to_trie(
 	}
 }
 
+	template <class Trie>
+	template <class GetExample, class AddToTree>
+void CTrie<Trie>::add_examples_by_tree(
+	int32_t begin, int32_t end, int32_t num_examples, int32_t vec_len,
+	GetExample get_example, AddToTree add_to_tree)
+{
+	require(begin>=0 && begin<=end && end<=length,
+		"Trees [{}, {}) out of range [0, {})", begin, end, length);
+	require(TreeMemPtr==length, "Examples can only be added to empty trees");
+
+	const int32_t num_shards=Math::min(env()->get_num_threads(), end-begin);
+	if (num_shards<2)
+	{
+		std::vector<int32_t> vec(vec_len);
+		for (int32_t e=0; e<num_examples; e++)
+		{
+			const int32_t len=get_example(e, vec.data());
+			for (int32_t t=begin; t<Math::min(end, len); t++)
+				add_to_tree(*this, t, vec.data(), len, e);
+		}
+		return;
+	}
+
+	// every shard has a node pool of its own
+	std::vector<std::shared_ptr<CTrie<Trie>>> shards(num_shards);
+	std::vector<int32_t> shard_begin(num_shards+1);
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		shard_begin[s]=begin+int64_t(end-begin)*s/num_shards;
+		auto shard=std::make_shared<CTrie<Trie>>(degree, use_compact_terminal_nodes);
+		shard->weights_in_tree=weights_in_tree;
+		shard->position_weights=position_weights;
+		shard->length=length;
+		shard->trees=SG_MALLOC(int32_t, length);
+		for (int32_t t=0; t<length; t++)
+			shard->trees[t]=NO_CHILD;
+		shards[s]=shard;
+	}
+	shard_begin[num_shards]=end;
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		for (int32_t t=shard_begin[s]; t<shard_begin[s+1]; t++)
+			shards[s]->trees[t]=shards[s]->get_node(degree==1);
+	}
+
+	std::vector<int32_t> vecs(int64_t(TRIE_EXAMPLE_CHUNK)*vec_len);
+	std::vector<int32_t> lens(TRIE_EXAMPLE_CHUNK);
+	for (int32_t chunk=0; chunk<num_examples; chunk+=TRIE_EXAMPLE_CHUNK)
+	{
+		const int32_t num=Math::min(TRIE_EXAMPLE_CHUNK, num_examples-chunk);
+
+#pragma omp parallel num_threads(num_shards)
+		{
+#pragma omp for
+			for (int32_t e=0; e<num; e++)
+				lens[e]=get_example(chunk+e, &vecs[int64_t(e)*vec_len]);
+
+			// a tree stays in cache while all examples of the chunk are added
+#pragma omp for schedule(static, 1)
+			for (int32_t s=0; s<num_shards; s++)
+			{
+				for (int32_t t=shard_begin[s]; t<shard_begin[s+1]; t++)
+				{
+					for (int32_t e=0; e<num; e++)
+					{
+						if (t<lens[e])
+							add_to_tree(*shards[s], t, &vecs[int64_t(e)*vec_len], lens[e], chunk+e);
+					}
+				}
+			}
+		}
+	}
+
+	// append the pools of the shards, followed by the empty trees
+	std::vector<int32_t> offsets(num_shards+1, 0);
+	int64_t num_nodes=length-(end-begin);
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		num_nodes+=shards[s]->TreeMemPtr;
+		offsets[s+1]=offsets[s]+shards[s]->TreeMemPtr;
+	}
+	require(num_nodes+num_nodes/5+10<std::numeric_limits<int32_t>::max(),
+		"Too many trie nodes ({})", num_nodes);
+	if (num_nodes+10>=TreeMemPtrMax)
+	{
+		int32_t old_sz=TreeMemPtrMax;
+		TreeMemPtrMax=num_nodes+num_nodes/5+10;
+		SG_DEBUG("Extending TreeMem from {} to {} elements", old_sz, TreeMemPtrMax);
+		TreeMem=SG_REALLOC(Trie, TreeMem, old_sz, TreeMemPtrMax);
+	}
+
+#pragma omp parallel for num_threads(num_shards) schedule(static, 1)
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		sg_memcpy(&TreeMem[offsets[s]], shards[s]->TreeMem,
+				sizeof(Trie)*shards[s]->TreeMemPtr);
+		for (int32_t t=shard_begin[s]; t<shard_begin[s+1]; t++)
+		{
+			trees[t]=shards[s]->trees[t]+offsets[s];
+			relocate_tree(trees[t], 0, offsets[s]);
+		}
+	}
+
+	TreeMemPtr=offsets[num_shards];
+	for (int32_t t=0; t<length; t++)
+	{
+		if (t<begin || t>=end)
+			trees[t]=get_node(degree==1);
+	}
+}
+
+	template <class Trie>
+void CTrie<Trie>::relocate_tree(int32_t node, int32_t depth, int32_t offset)
+{
+	// the nodes one level above the leaves hold child weights
+	if (depth>=degree-1)
+		return;
+
+	for (int32_t q=0; q<4; q++)
+	{
+		int32_t child=TreeMem[node].children[q];
+		if (child==NO_CHILD)
+			continue;
+
+		if (child<0)
+			// compact terminal node
+			TreeMem[node].children[q]=child-offset;
+		else
+		{
+			TreeMem[node].children[q]=child+offset;
+			relocate_tree(child+offset, depth+1, offset);
+		}
+	}
+}
+
 	template <class Trie>
 float64_t CTrie<Trie>::compute_by_tree_helper(
 	int32_t* vec, int32_t len, int32_t seq_pos, int32_t tree_pos,
@@ -52,7 +52,7 @@ namespace shogun
          * @param _name name of tag
          */
         explicit Tag(std::string_view _name) : 
-            BaseTag(_name.data())
+            BaseTag(_name)
         {
         }
 
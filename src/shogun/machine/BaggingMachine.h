@@ -149,9 +149,9 @@ namespace shogun
 		 * computes the output probabilities without combination rules
 		 *
 		 * @param data the data to compute the output for
-		 * @return predictions
+		 * @return predictions, one column per bag
 		 */
-		SGMatrix<float64_t>
+		virtual SGMatrix<float64_t>
 			apply_outputs_without_combination(std::shared_ptr<Features> data);
 
 		/** Register paramaters */
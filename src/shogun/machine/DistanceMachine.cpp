@@ -105,10 +105,14 @@ std::shared_ptr<MulticlassLabels> DistanceMachine::apply_multiclass(std::shared_
 		auto lhs=distance->get_lhs();
 		distance->init(lhs, data);
 
+		/* nearest lhs vector of every element, distances computed in tiles */
+		SGVector<float64_t> min_dists;
+		auto nearest=distance->nearest_lhs(min_dists);
+
 		/* build result labels and classify all elements of procedure */
 		auto result=std::make_shared<MulticlassLabels>(data->get_num_vectors());
 		for (index_t i=0; i<data->get_num_vectors(); ++i)
-			result->set_label(i, apply_one(i));
+			result->set_label(i, nearest[i]);
 		return result;
 	}
 	else
@@ -11,10 +11,19 @@
 #include <shogun/io/SGIO.h>
 #include <shogun/kernel/CustomKernel.h>
 #include <shogun/kernel/Kernel.h>
+#include <shogun/kernel/normalizer/DiceKernelNormalizer.h>
+#include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
+#include <shogun/kernel/normalizer/SqrtDiagKernelNormalizer.h>
+#include <shogun/kernel/normalizer/TanimotoKernelNormalizer.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/machine/KernelMachine.h>
+#include <shogun/mathematics/eigen3.h>
+
+#include <algorithm>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #ifdef HAVE_OPENMP
 #include <omp.h>
@@ -327,6 +336,17 @@ SGVector<float64_t> KernelMachine::apply_get_outputs(const std::shared_ptr<Featu
 				output[i] = get_bias() + output[i];
 
 		}
+		else if (
+		    kernel->has_block_computation() &&
+		    get_batch_computation_enabled() &&
+		    !(kernel->has_property(KP_LINADD) &&
+		      kernel->get_is_initialized()))
+		{
+			SG_DEBUG("Block evaluation enabled")
+			output = kernel->compute_batch_blocked(m_svs, m_alpha);
+			for (int32_t i = 0; i < num_vectors; i++)
+				output[i] += get_bias();
+		}
 		else
 		{
 			auto pb = SG_PROGRESS(range(num_vectors));
@@ -427,6 +447,165 @@ float64_t KernelMachine::apply_one(int32_t num)
 	}
 }
 
+float64_t KernelMachine::reduce_support_vectors(int32_t budget, float64_t tolerance)
+{
+	require(kernel, "{}::reduce_support_vectors(): No kernel assigned!",
+			get_name());
+	require(budget>=0, "Budget ({}) must not be negative!", budget);
+	require(tolerance>=0, "Tolerance ({}) must not be negative!", tolerance);
+
+	auto lhs=kernel->get_lhs();
+	require(lhs, "{}::reduce_support_vectors(): No left hand side specified",
+			get_name());
+
+	/* the kernel values between support vectors are computed on a subset
+	 * of the data, which is only the same kernel if normalizing a value
+	 * depends on its two vectors alone */
+	auto normalizer=kernel->get_normalizer();
+	if (normalizer)
+	{
+		require(std::dynamic_pointer_cast<IdentityKernelNormalizer>(normalizer) ||
+				std::dynamic_pointer_cast<SqrtDiagKernelNormalizer>(normalizer) ||
+				std::dynamic_pointer_cast<TanimotoKernelNormalizer>(normalizer) ||
+				std::dynamic_pointer_cast<DiceKernelNormalizer>(normalizer),
+				"{}::reduce_support_vectors(): Normalizer {} depends on the "
+				"data and is not supported", get_name(), normalizer->get_name());
+	}
+
+	const index_t num_sv=get_num_support_vectors();
+	if (budget==0 || budget>num_sv)
+		budget=num_sv;
+
+	/* only the kernel values between support vectors are needed, so a
+	 * clone of the kernel is initialized on copies of them. The clone only
+	 * takes the hyperparameters, not the features of the kernel. The
+	 * kernel of the machine may be shared and is left untouched. */
+	auto sv_features=lhs->copy_subset(m_svs);
+	auto sv_kernel=kernel->clone(ParameterProperties::HYPER)->as<Kernel>();
+	sv_kernel->init(sv_features, sv_features);
+
+	/* outputs f_i=<w, phi(x_i)> at the support vectors, which give the
+	 * squared norm ||w||^2=sum_i alpha_i f_i */
+	SGVector<float64_t> f(num_sv);
+	if (sv_kernel->has_block_computation())
+	{
+		SGVector<int32_t> idx(num_sv);
+		idx.range_fill();
+		f=sv_kernel->compute_batch_blocked(idx, m_alpha);
+	}
+	else
+	{
+#pragma omp parallel for
+		for (index_t i=0; i<num_sv; i++)
+		{
+			float64_t sum=0;
+			for (index_t j=0; j<num_sv; j++)
+				sum+=m_alpha[j]*sv_kernel->kernel(j, i);
+			f[i]=sum;
+		}
+	}
+
+	float64_t norm_sq=0;
+	SGVector<float64_t> diag(num_sv);
+	for (index_t i=0; i<num_sv; i++)
+	{
+		norm_sq+=m_alpha[i]*f[i];
+		diag[i]=sv_kernel->kernel(i, i);
+	}
+
+	std::vector<index_t> order(num_sv);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](index_t a, index_t b) {
+		return std::abs(m_alpha[a])*std::sqrt(diag[a]) >
+			std::abs(m_alpha[b])*std::sqrt(diag[b]);
+	});
+
+	/* Cholesky factor L of the kernel matrix of the selected support
+	 * vectors is grown by one row per selected vector, together with
+	 * z=L^-1 f_S. The squared error of the projection of w is then
+	 * ||w||^2-||z||^2. The storage of L is doubled when full, it is
+	 * only as large as the budget if that many vectors are selected. */
+	index_t capacity=Math::min(budget, 64);
+	SGMatrix<float64_t> chol(capacity, capacity);
+	SGVector<float64_t> z(budget);
+	SGVector<float64_t> row(budget);
+	typename SGVector<float64_t>::EigenVectorXtMap z_eig=z;
+	typename SGVector<float64_t>::EigenVectorXtMap row_eig=row;
+
+	std::vector<index_t> selected;
+	float64_t error_sq=norm_sq;
+	for (auto c : order)
+	{
+		if (index_t(selected.size())==budget ||
+			error_sq<=tolerance*tolerance*norm_sq)
+			break;
+
+		const index_t k=selected.size();
+		if (k==capacity)
+		{
+			capacity=Math::min(2*capacity, budget);
+			SGMatrix<float64_t> grown(capacity, capacity);
+			typename SGMatrix<float64_t>::EigenMatrixXtMap grown_eig=grown;
+			typename SGMatrix<float64_t>::EigenMatrixXtMap chol_eig=chol;
+			grown_eig.topLeftCorner(k, k)=chol_eig.topLeftCorner(k, k);
+			chol=grown;
+		}
+		typename SGMatrix<float64_t>::EigenMatrixXtMap chol_eig=chol;
+
+#pragma omp parallel for if (k>=1024)
+		for (index_t j=0; j<k; j++)
+			row[j]=sv_kernel->kernel(selected[j], c);
+
+		chol_eig.topLeftCorner(k, k).triangularView<Eigen::Lower>()
+			.solveInPlace(row_eig.head(k));
+		const float64_t residual=diag[c]-row_eig.head(k).squaredNorm();
+
+		/* nearly a linear combination of the selected vectors */
+		if (residual<=diag[c]*1e-10)
+			continue;
+
+		chol_eig.row(k).head(k)=row_eig.head(k).transpose();
+		chol(k, k)=std::sqrt(residual);
+		z[k]=(f[c]-row_eig.head(k).dot(z_eig.head(k)))/chol(k, k);
+		error_sq-=z[k]*z[k];
+		selected.push_back(c);
+	}
+
+	/* coefficients of the projection solve L^T beta=z */
+	const index_t num_selected=selected.size();
+	SGVector<float64_t> beta(num_selected);
+	typename SGVector<float64_t>::EigenVectorXtMap beta_eig=beta;
+	typename SGMatrix<float64_t>::EigenMatrixXtMap chol_eig=chol;
+	beta_eig=z_eig.head(num_selected);
+	chol_eig.topLeftCorner(num_selected, num_selected)
+		.triangularView<Eigen::Lower>().transpose().solveInPlace(beta_eig);
+
+	SGVector<int32_t> svs(num_selected);
+	for (index_t i=0; i<num_selected; i++)
+		svs[i]=m_svs[selected[i]];
+
+	/* a linadd optimization of the kernel holds the unreduced machine,
+	 * which may share the kernel. This machine continues with its own
+	 * kernel on the same features, without an optimization. */
+	if (kernel->get_is_initialized())
+	{
+		auto rhs=kernel->get_rhs();
+		auto own_kernel=kernel->clone(ParameterProperties::HYPER)->as<Kernel>();
+		own_kernel->init(lhs, rhs ? rhs : lhs);
+		set_kernel(own_kernel);
+	}
+
+	set_support_vectors(svs);
+	set_alphas(beta);
+
+	const float64_t error=
+		norm_sq>0 ? std::sqrt(Math::max(error_sq, 0.0)/norm_sq) : 0;
+	io::info("Reduced {} to {} support vectors, relative error {}", num_sv,
+			num_selected, error);
+
+	return error;
+}
+
 void KernelMachine::init()
 {
 	m_bias=0.0;
@@ -198,6 +198,40 @@ class KernelMachine : public Machine
 		 */
 		bool init_kernel_optimization();
 
+		/** Reduces the number of support vectors by approximating the
+		 * machine with a subset of them (reduced set selection).
+		 *
+		 * Support vectors are taken in the order of their contribution
+		 * \f$|\alpha_i|\sqrt{k({\bf x}_i, {\bf x}_i)}\f$, skipping those
+		 * which are (nearly) linear combinations of the ones already taken
+		 * in feature space. The coefficients of the kept support vectors
+		 * are those of the orthogonal projection of
+		 * \f${\bf w}=\sum_i\alpha_i\phi({\bf x}_i)\f$ onto them, which
+		 * minimizes the approximation error \f$||{\bf w}-{\bf w}'||\f$.
+		 * The outputs of the machine then change by at most
+		 * \f$||{\bf w}-{\bf w}'||\sqrt{k({\bf x}, {\bf x})}\f$.
+		 *
+		 * The machine is changed in place, a smaller copy is obtained by
+		 * reducing a KernelMachine constructed from this one. The kernel
+		 * values are computed by a clone of the kernel's hyperparameters
+		 * initialized with copies of the support vectors, see
+		 * Features::copy_subset(), so the kernel, which such a copy
+		 * shares, is not changed. As the clone is initialized on the
+		 * support vectors only, normalizers that depend on the data, such
+		 * as AvgDiagKernelNormalizer, are not supported. If the kernel has
+		 * a linadd optimization, which describes the unreduced machine,
+		 * this machine gets its own kernel on the same features instead.
+		 * Its optimization has to be initialized with
+		 * init_kernel_optimization() if wanted.
+		 *
+		 * @param budget maximum number of support vectors, 0 for no limit
+		 * @param tolerance stop adding support vectors once the relative
+		 * approximation error is at most this
+		 * @return relative approximation error
+		 * \f$||{\bf w}-{\bf w}'||/||{\bf w}||\f$
+		 */
+		float64_t reduce_support_vectors(int32_t budget, float64_t tolerance=0.0);
+
 		/** apply kernel machine to data
 		 * for regression task
 		 *
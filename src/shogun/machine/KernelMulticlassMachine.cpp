@@ -7,9 +7,11 @@
 
 #include <shogun/machine/KernelMulticlassMachine.h>
 #include <shogun/features/Features.h>
+#include <shogun/kernel/CustomKernel.h>
 #include <shogun/kernel/Kernel.h>
 #include <shogun/machine/KernelMachine.h>
 
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
 
@@ -73,6 +75,24 @@ void KernelMulticlassMachine::store_model_features()
 	}
 }
 
+float64_t KernelMulticlassMachine::reduce_support_vectors(
+	int32_t budget, float64_t tolerance)
+{
+	require(m_kernel, "{}::reduce_support_vectors(): No kernel assigned!",
+			get_name());
+
+	float64_t max_error=0;
+	for (auto m: m_machines)
+	{
+		auto machine=m->as<KernelMachine>();
+		machine->set_kernel(m_kernel);
+		max_error=std::max(
+			max_error, machine->reduce_support_vectors(budget, tolerance));
+	}
+
+	return max_error;
+}
+
 KernelMulticlassMachine::KernelMulticlassMachine() : MulticlassMachine(), m_kernel(NULL)
 {
 	SG_ADD(&m_kernel,"kernel", "The kernel to be used", ParameterProperties::HYPER);
@@ -173,4 +193,56 @@ void KernelMulticlassMachine::remove_machine_subset()
 	not_implemented(SOURCE_LOCATION);
 }
 
+std::shared_ptr<Machine> KernelMulticlassMachine::init_submachines_for_train()
+{
+	/* the kernel matrix is computed once, the custom kernels of the
+	 * submachines only reference it */
+	m_train_kernel=std::make_shared<CustomKernel>(m_kernel);
+
+	auto machine=m_machine->as<KernelMachine>();
+	auto labels=machine->get_labels();
+	machine->set_kernel(NULL);
+	machine->set_labels(NULL);
+	auto prototype=make_clone(m_machine);
+	machine->set_kernel(m_kernel);
+	machine->set_labels(labels);
+
+	return prototype;
+}
 
+std::shared_ptr<Machine> KernelMulticlassMachine::train_submachine(
+	std::shared_ptr<Machine> machine, std::shared_ptr<BinaryLabels> labels,
+	SGVector<index_t> subset) const
+{
+	auto kernel=std::make_shared<CustomKernel>(m_train_kernel);
+	if (subset.vlen)
+	{
+		kernel->add_row_subset(subset);
+		kernel->add_col_subset(subset);
+	}
+
+	auto kernel_machine=machine->as<KernelMachine>();
+	kernel_machine->set_kernel(kernel);
+	kernel_machine->set_labels(labels);
+	kernel_machine->train();
+
+	/* support vectors index into the training vectors of the problem */
+	if (subset.vlen)
+	{
+		for (index_t i=0; i<kernel_machine->get_num_support_vectors(); i++)
+		{
+			kernel_machine->set_support_vector(
+				i, subset[kernel_machine->get_support_vector(i)]);
+		}
+	}
+
+	auto trained=get_machine_from_trained(machine);
+	trained->as<KernelMachine>()->set_kernel(m_kernel);
+
+	return trained;
+}
+
+void KernelMulticlassMachine::cleanup_submachines_for_train()
+{
+	m_train_kernel=NULL;
+}
@@ -16,6 +16,7 @@
 namespace shogun
 {
 
+class CustomKernel;
 class Features;
 class Kernel;
 
@@ -63,6 +64,17 @@ class KernelMulticlassMachine : public MulticlassMachine
 		 */
 		virtual void store_model_features();
 
+		/** Reduces the number of support vectors of every sub-machine, see
+		 * KernelMachine::reduce_support_vectors()
+		 *
+		 * @param budget maximum number of support vectors per sub-machine,
+		 * 0 for no limit
+		 * @param tolerance relative approximation error per sub-machine at
+		 * which no more support vectors are added
+		 * @return largest relative approximation error of the sub-machines
+		 */
+		float64_t reduce_support_vectors(int32_t budget, float64_t tolerance=0.0);
+
 	protected:
 
 		/** init machine for training with kernel init */
@@ -77,6 +89,22 @@ class KernelMulticlassMachine : public MulticlassMachine
 		/** construct kernel machine from given kernel machine */
 		virtual std::shared_ptr<Machine> get_machine_from_trained(std::shared_ptr<Machine> machine) const;
 
+		/** precompute the kernel matrix shared by all submachines and copy
+		 * the machine without kernel and labels
+		 */
+		virtual std::shared_ptr<Machine> init_submachines_for_train();
+
+		/** train a submachine on a custom kernel over the shared kernel
+		 * matrix, restricted to the training vectors of the problem
+		 */
+		virtual std::shared_ptr<Machine> train_submachine(
+			std::shared_ptr<Machine> machine,
+			std::shared_ptr<BinaryLabels> labels,
+			SGVector<index_t> subset) const;
+
+		/** release the shared kernel matrix */
+		virtual void cleanup_submachines_for_train();
+
 		/** return number of rhs feature vectors */
 		virtual int32_t get_num_rhs_vectors() const;
 
@@ -94,6 +122,9 @@ class KernelMulticlassMachine : public MulticlassMachine
 		/** kernel */
 		std::shared_ptr<Kernel> m_kernel;
 
+		/** kernel matrix shared by the submachines trained in parallel */
+		std::shared_ptr<CustomKernel> m_train_kernel;
+
 };
 }
 #endif
@@ -29,17 +29,23 @@ LinearMachine::LinearMachine(const std::shared_ptr<LinearMachine>& machine) : Ma
 	auto w_clone = w.clone();
 	set_w(w_clone);
 	set_bias(machine->get_bias());
+	set_float32_compute(machine->get_float32_compute());
 }
 
 void LinearMachine::init()
 {
 	bias = 0;
 	features = NULL;
+	m_float32_compute = false;
+	m_w_float32_source = NULL;
 
 	SG_ADD(&m_w, "w", "Parameter vector w.", ParameterProperties::MODEL);
 	SG_ADD(&bias, "bias", "Bias b.", ParameterProperties::MODEL);
 	SG_ADD(
 	    (std::shared_ptr<Features>*)&features, "features", "Feature object.");
+	SG_ADD(
+	    &m_float32_compute, "float32_compute",
+	    "Whether to compute in single precision for float32 features.");
 }
 
 
@@ -53,6 +59,21 @@ float64_t LinearMachine::apply_one(int32_t vec_idx)
 	return features->dot(vec_idx, m_w) + bias;
 }
 
+void LinearMachine::set_float32_compute(bool float32_compute)
+{
+	m_float32_compute = float32_compute;
+}
+
+bool LinearMachine::get_float32_compute() const
+{
+	return m_float32_compute;
+}
+
+bool LinearMachine::use_float32(const std::shared_ptr<DotFeatures>& feat) const
+{
+	return m_float32_compute && feat && feat->has_native_float32();
+}
+
 std::shared_ptr<RegressionLabels> LinearMachine::apply_regression(std::shared_ptr<Features> data)
 {
 	SGVector<float64_t> outputs = apply_get_outputs(data);
@@ -82,7 +103,13 @@ SGVector<float64_t> LinearMachine::apply_get_outputs(std::shared_ptr<Features> d
 	ASSERT(num>0)
 	ASSERT(m_w.vlen==features->get_dim_feature_space())
 	SGVector<float64_t> out(num);
-	features->dense_dot_range(out.vector, 0, num, NULL, m_w.vector, m_w.vlen, bias);
+	if (use_float32(features))
+	{
+		auto w = get_w_float32();
+		features->dense_dot_range(out.vector, 0, num, NULL, w.vector, w.vlen, bias);
+	}
+	else
+		features->dense_dot_range(out.vector, 0, num, NULL, m_w.vector, m_w.vlen, bias);
 	return out;
 }
 
@@ -94,6 +121,23 @@ SGVector<float64_t> LinearMachine::get_w() const
 void LinearMachine::set_w(const SGVector<float64_t> w)
 {
 	m_w = w;
+	m_w_float32_source = NULL;
+}
+
+SGVector<float32_t> LinearMachine::get_w_float32()
+{
+	if (m_w_float32_source != m_w.vector || m_w_float32.vlen != m_w.vlen)
+	{
+		if (m_w_float32.vlen != m_w.vlen)
+			m_w_float32 = SGVector<float32_t>(m_w.vlen);
+
+		for (index_t i=0; i<m_w.vlen; i++)
+			m_w_float32[i]=m_w[i];
+
+		m_w_float32_source = m_w.vector;
+	}
+
+	return m_w_float32;
 }
 
 void LinearMachine::set_bias(float64_t b)
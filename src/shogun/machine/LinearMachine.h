@@ -56,6 +56,13 @@ class RegressionLabels;
  *	\li Perceptron (Perceptron)
  *	\li Linear SVMs (SVMSGD, LibLinear, SVMOcas, SVMLin, CSubgradientSVM)
  *
+ *	Learned weights are always stored in double precision. With
+ *	set_float32_compute(true), machines may train and apply in single
+ *	precision whenever the features store float32 values natively (see
+ *	DotFeatures::has_native_float32()), which halves the memory traffic of
+ *	the dot products. Scalars that accumulate over many vectors are kept in
+ *	double precision.
+ *
  *	\sa DotFeatures
  *
  * */
@@ -120,6 +127,18 @@ class LinearMachine : public Machine
 		/** applies to one vector */
 		virtual float64_t apply_one(int32_t vec_idx);
 
+		/** set whether to compute in single precision for float32 features
+		 *
+		 * @param float32_compute whether to compute in single precision
+		 */
+		void set_float32_compute(bool float32_compute);
+
+		/** get whether to compute in single precision for float32 features
+		 *
+		 * @return whether to compute in single precision
+		 */
+		bool get_float32_compute() const;
+
 		/** get features
 		 *
 		 * @return features
@@ -142,6 +161,22 @@ class LinearMachine : public Machine
 		 */
 		virtual SGVector<float64_t> apply_get_outputs(std::shared_ptr<Features> data);
 
+		/** whether to compute in single precision on the given features
+		 *
+		 * @param feat features to compute on
+		 * @return true if float32 compute is enabled and feat stores
+		 * float32 values natively
+		 */
+		bool use_float32(const std::shared_ptr<DotFeatures>& feat) const;
+
+		/** single precision copy of w, which is only converted again once
+		 * w was replaced through set_w() or reallocated by training. Changes
+		 * to the values of w in place have to be followed by set_w().
+		 *
+		 * @return w in single precision
+		 */
+		SGVector<float32_t> get_w_float32();
+
 	private:
 
 		void init();
@@ -153,6 +188,15 @@ class LinearMachine : public Machine
 		/** bias */
 		float64_t bias;
 
+		/** whether to compute in single precision for float32 features */
+		bool m_float32_compute;
+
+		/** single precision copy of w, see get_w_float32() */
+		SGVector<float32_t> m_w_float32;
+
+		/** storage of w that m_w_float32 was converted from */
+		const float64_t* m_w_float32_source;
+
 		/** features */
 		std::shared_ptr<DotFeatures> features;
 };
@@ -134,6 +134,39 @@ class LinearMulticlassMachine : public MulticlassMachine
 			return m_features->get_num_vectors();
 		}
 
+		/** copy the machine without features and labels */
+		virtual std::shared_ptr<Machine> init_submachines_for_train()
+		{
+			auto machine = m_machine->as<LinearMachine>();
+			auto labels = machine->get_labels();
+			machine->set_features(NULL);
+			machine->set_labels(NULL);
+			auto prototype = make_clone(m_machine);
+			machine->set_features(m_features);
+			machine->set_labels(labels);
+
+			return prototype;
+		}
+
+		/** train a submachine on a shallow copy of the features, which
+		 * requires the features to support shallow_subset_copy()
+		 */
+		virtual std::shared_ptr<Machine> train_submachine(
+			std::shared_ptr<Machine> machine,
+			std::shared_ptr<BinaryLabels> labels,
+			SGVector<index_t> subset) const
+		{
+			auto features = m_features->shallow_subset_copy()->as<DotFeatures>();
+			if (subset.vlen)
+				features->add_subset(subset);
+
+			machine->as<LinearMachine>()->set_features(features);
+			machine->set_labels(labels);
+			machine->train();
+
+			return get_machine_from_trained(machine);
+		}
+
 		/** set subset to the features of the machine, deletes old one
 		 *
 		 * @param subset subset instance to set
@@ -6,6 +6,8 @@
  *          Evan Shelhamer, Shell Hu, Thoralf Klein, Viktor Gal
  */
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/progress.h>
 #include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
 #include <shogun/machine/LinearMachine.h>
 #include <shogun/machine/KernelMachine.h>
@@ -14,7 +16,9 @@
 #include <shogun/mathematics/Statistics.h>
 #include <shogun/labels/MultilabelLabels.h>
 
+#include <exception>
 #include <utility>
+#include <vector>
 
 using namespace shogun;
 
@@ -47,8 +51,13 @@ void MulticlassMachine::set_labels(std::shared_ptr<Labels> lab)
 
 void MulticlassMachine::register_parameters()
 {
+	m_parallel_training=false;
+
 	SG_ADD(&m_multiclass_strategy,"multiclass_strategy", "Multiclass strategy");
 	SG_ADD(&m_machine, "machine", "The base machine");
+	SG_ADD(&m_parallel_training, "parallel_training",
+		"Whether the submachines are trained in parallel",
+		ParameterProperties::SETTING);
 }
 
 void MulticlassMachine::init_strategy()
@@ -225,6 +234,12 @@ bool MulticlassMachine::train_machine(std::shared_ptr<Features> data)
 		init_machine_for_train(data);
 
 	m_machines.clear();
+	if (m_parallel_training)
+	{
+		train_machines_parallel();
+		return true;
+	}
+
 	auto train_labels = std::make_shared<BinaryLabels>(get_num_rhs_vectors());
 
 	m_machine->set_labels(train_labels);
@@ -256,6 +271,80 @@ bool MulticlassMachine::train_machine(std::shared_ptr<Features> data)
 	return true;
 }
 
+void MulticlassMachine::train_machines_parallel()
+{
+	/* the strategy sets up one problem after the other on the same labels,
+	 * so the labels and training vectors of all problems are stored first */
+	std::vector<SGVector<float64_t>> problem_labels;
+	std::vector<SGVector<index_t>> problem_subsets;
+	auto train_labels = std::make_shared<BinaryLabels>(get_num_rhs_vectors());
+
+	m_multiclass_strategy->train_start(
+	    multiclass_labels(m_labels), train_labels);
+	while (m_multiclass_strategy->train_has_more())
+	{
+		SGVector<index_t> subset=m_multiclass_strategy->train_prepare_next();
+		if (subset.vlen)
+			train_labels->add_subset(subset);
+
+		problem_labels.push_back(train_labels->get_labels_copy());
+		problem_subsets.push_back(subset);
+
+		if (subset.vlen)
+			train_labels->remove_subset();
+	}
+	m_multiclass_strategy->train_stop();
+
+	auto prototype=init_submachines_for_train();
+	index_t num_problems=problem_labels.size();
+	m_machines.resize(num_problems);
+
+	/* exceptions must not leave the parallel region, the first one is
+	 * rethrown after it */
+	std::exception_ptr train_error;
+	auto pb=SG_PROGRESS(range(num_problems));
+#pragma omp parallel for schedule(dynamic) num_threads(env()->get_num_threads())
+	for (index_t i=0; i<num_problems; i++)
+	{
+		try
+		{
+			auto machine=make_clone(prototype);
+			auto labels=std::make_shared<BinaryLabels>(problem_labels[i]);
+			m_machines[i]=train_submachine(machine, labels, problem_subsets[i]);
+		}
+		catch (...)
+		{
+#pragma omp critical
+			if (!train_error)
+				train_error=std::current_exception();
+		}
+		pb.print_progress();
+	}
+	pb.complete();
+
+	cleanup_submachines_for_train();
+	if (train_error)
+	{
+		// do not leave untrained submachines behind
+		m_machines.clear();
+		std::rethrow_exception(train_error);
+	}
+}
+
+std::shared_ptr<Machine> MulticlassMachine::init_submachines_for_train()
+{
+	not_implemented(SOURCE_LOCATION);
+	return nullptr;
+}
+
+std::shared_ptr<Machine> MulticlassMachine::train_submachine(
+	std::shared_ptr<Machine> machine, std::shared_ptr<BinaryLabels> labels,
+	SGVector<index_t> subset) const
+{
+	not_implemented(SOURCE_LOCATION);
+	return nullptr;
+}
+
 float64_t MulticlassMachine::apply_one(int32_t vec_idx)
 {
 	init_machines_for_apply(NULL);
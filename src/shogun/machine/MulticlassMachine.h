@@ -152,6 +152,28 @@ class MulticlassMachine : public BaseMulticlassMachine
 			m_multiclass_strategy->set_prob_heuris_type(prob_heuris);
 		}
 
+		/** set whether the submachines are trained in parallel
+		 *
+		 * The binary problems of the multiclass strategy are set up one
+		 * after the other and their labels and training vectors are
+		 * stored. Then every problem is trained on a clone of the
+		 * machine, using as many threads as set in the environment. The
+		 * machine has to support being trained in several threads at the
+		 * same time.
+		 *
+		 * @param parallel_training whether to train in parallel
+		 */
+		inline void set_parallel_training(bool parallel_training)
+		{
+			m_parallel_training=parallel_training;
+		}
+
+		/** @return whether the submachines are trained in parallel */
+		inline bool get_parallel_training() const
+		{
+			return m_parallel_training;
+		}
+
 	protected:
 		/** init strategy */
 		void init_strategy();
@@ -162,6 +184,35 @@ class MulticlassMachine : public BaseMulticlassMachine
 		/** train machine */
 		virtual bool train_machine(std::shared_ptr<Features> data = NULL);
 
+		/** train all submachines in parallel, see set_parallel_training() */
+		void train_machines_parallel();
+
+		/** prepare training the submachines in parallel, called after
+		 * init_machine_for_train()
+		 *
+		 * @return copy of the machine without data, which is cloned for
+		 * every submachine
+		 */
+		virtual std::shared_ptr<Machine> init_submachines_for_train();
+
+		/** train a submachine on one binary problem, called from several
+		 * threads at the same time
+		 *
+		 * @param machine untrained clone of the machine
+		 * @param labels labels of the problem
+		 * @param subset training vectors of the problem, all if empty
+		 * @return trained machine, see get_machine_from_trained()
+		 */
+		virtual std::shared_ptr<Machine> train_submachine(
+			std::shared_ptr<Machine> machine,
+			std::shared_ptr<BinaryLabels> labels,
+			SGVector<index_t> subset) const;
+
+		/** release the data shared by the submachines trained in parallel */
+		virtual void cleanup_submachines_for_train()
+		{
+		}
+
 		/** abstract init machine for training method */
 		virtual bool init_machine_for_train(std::shared_ptr<Features> data) = 0;
 
@@ -203,6 +254,9 @@ class MulticlassMachine : public BaseMulticlassMachine
 
 		/** machine */
 		std::shared_ptr<Machine> m_machine;
+
+		/** whether the submachines are trained in parallel */
+		bool m_parallel_training;
 };
 }
 #endif
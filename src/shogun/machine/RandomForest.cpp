@@ -158,7 +158,10 @@ void RandomForest::set_machine_parameters(std::shared_ptr<Machine> m, SGVector<i
 	}
 
 	tree->set_weights(weights);
-	tree->set_sorted_features(m_sorted_transposed_feats, m_sorted_indices);
+	if (m_binned_features)
+		tree->set_binned_features(m_binned_features);
+	else
+		tree->set_sorted_features(m_sorted_transposed_feats, m_sorted_indices);
 	// equate the machine problem types - cloning does not do this
 	tree->set_machine_problem_type(m_machine->as<RandomCARTree>()->get_machine_problem_type());
 }
@@ -172,9 +175,61 @@ bool RandomForest::train_machine(std::shared_ptr<Features> data)
 	
 	require(m_features, "Training features not set!");
 
-	m_machine->as<RandomCARTree>()->pre_sort_features(m_features, m_sorted_transposed_feats, m_sorted_indices);
+	// large data is binned once for histogram split finding in all trees
+	auto tree=m_machine->as<RandomCARTree>();
+	if (tree->use_histograms(m_features->get_num_vectors()) &&
+	    !m_features->get_subset_stack()->has_subsets())
+		m_binned_features=tree->bin_features(m_features);
+	else
+		tree->pre_sort_features(m_features, m_sorted_transposed_feats, m_sorted_indices);
+
+	{
+		std::lock_guard<std::mutex> lock(m_flat_forest_lock);
+		m_flat_forest=nullptr;
+		m_flat_bags.clear();
+	}
+
+	auto result=BaggingMachine::train_machine();
+	m_binned_features=nullptr;
+
+	// compiled once here rather than by the first (possibly concurrent) apply
+	if (result)
+		get_flat_forest();
+	return result;
+}
+
+std::shared_ptr<FlatTreeEnsemble> RandomForest::get_flat_forest()
+{
+	std::lock_guard<std::mutex> lock(m_flat_forest_lock);
+
+	// the bags may also have been replaced through put()
+	if (m_flat_forest && m_flat_bags==m_bags)
+		return m_flat_forest;
+
+	auto flat=std::make_shared<FlatTreeEnsemble>();
+	for (const auto& bag : m_bags)
+	{
+		auto tree=bag->as<RandomCARTree>();
+		flat->add_tree(
+		    tree->get_root()->as<RandomCARTree::bnode_t>(),
+		    tree->get_feature_types());
+	}
+	m_flat_forest=flat;
+	m_flat_bags=m_bags;
+	return flat;
+}
+
+SGMatrix<float64_t> RandomForest::apply_outputs_without_combination(std::shared_ptr<Features> data)
+{
+	require(data, "Data required for prediction");
+	ASSERT(m_num_bags == m_bags.size());
+
+	// other feature types are applied tree by tree
+	if (data->get_feature_class()!=C_DENSE || data->get_feature_type()!=F_DREAL)
+		return BaggingMachine::apply_outputs_without_combination(data);
 
-	return BaggingMachine::train_machine();
+	auto mat=data->as<DenseFeatures<float64_t>>()->get_feature_matrix();
+	return get_flat_forest()->apply(mat);
 }
 
 SGVector<float64_t> RandomForest::get_feature_importances() const
@@ -201,7 +256,10 @@ SGVector<float64_t> RandomForest::get_feature_importances() const
 
 void RandomForest::init()
 {
-	m_machine=std::make_shared<RandomCARTree>();
+	auto tree=std::make_shared<RandomCARTree>();
+	// large forests are trained with approximate histogram splits
+	tree->set_num_bins(255);
+	m_machine=tree;
 	m_weights=SGVector<float64_t>();
 	watch_method("feature_importances", &RandomForest::get_feature_importances);
 	SG_ADD(&m_weights, kWeights, "weights");
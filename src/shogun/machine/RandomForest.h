@@ -33,6 +33,11 @@
 
 #include <shogun/lib/config.h>
 #include <shogun/machine/BaggingMachine.h>
+#include <shogun/multiclass/tree/BinnedFeatureMatrix.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#include <mutex>
+#include <vector>
 
 namespace shogun
 {
@@ -42,6 +47,9 @@ namespace shogun
  * controlled by the user. Test feature vectors are classified/regressed by combining the outputs of all these trained candidate trees using a
  * combination rule (see class CombinationRule). The feature for calculating out-of-box error is also provided to help determine the
  * appropriate number of bags. The evaluatin criteria for calculating this out-of-box error is specified by the user (see class CEvaluation).
+ * Unlike a single CARTree, the trees find splits on large training sets using histograms of at most 255 bins per attribute (see
+ * CARTree::set_num_bins()). For prediction on dense data, all trees are compiled into one FlatTreeEnsemble that is evaluated in blocks
+ * of vectors.
  */
 class RandomForest : public BaggingMachine
 {
@@ -154,6 +162,19 @@ protected:
 	 */
 	virtual void set_machine_parameters(std::shared_ptr<Machine> m, SGVector<index_t> idx);
 
+	/** applies all trees at once using their flattened form
+	 *
+	 * @param data the data to compute the output for
+	 * @return predictions, one column per tree
+	 */
+	virtual SGMatrix<float64_t>
+		apply_outputs_without_combination(std::shared_ptr<Features> data);
+
+	/** @return all trees compiled into one ensemble, built after training
+	 * and rebuilt whenever the bags are replaced
+	 */
+	std::shared_ptr<FlatTreeEnsemble> get_flat_forest();
+
 private:
 	/** initialize parameters */
 	void init();
@@ -167,6 +188,18 @@ private:
 
 	/** Indices of pre-sorted features */
 	SGMatrix<index_t> m_sorted_indices;
+
+	/** Features binned for histogram split finding, used instead of pre-sorted ones */
+	std::shared_ptr<BinnedFeatureMatrix> m_binned_features;
+
+	/** Flattened trees for prediction */
+	std::shared_ptr<FlatTreeEnsemble> m_flat_forest;
+
+	/** Bags from which m_flat_forest was built */
+	std::vector<std::shared_ptr<Machine>> m_flat_bags;
+
+	/** Guards m_flat_forest against concurrent apply calls */
+	std::mutex m_flat_forest_lock;
 #ifndef SWIG
 public:
 	static constexpr std::string_view kWeights = "weights";
@@ -33,6 +33,7 @@
 #include <shogun/machine/StochasticGBMachine.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/RandomNamespace.h>
+#include <shogun/multiclass/tree/CARTree.h>
 #include <shogun/optimization/lbfgs/lbfgs.h>
 
 using namespace shogun;
@@ -173,6 +174,14 @@ bool StochasticGBMachine::train_machine(std::shared_ptr<Features> data)
 	// initialize weak learners array and gamma array
 	initialize_learners();
 
+	// trees that find splits using histograms share one binning of the data
+	m_binned_features=nullptr;
+	auto tree=std::dynamic_pointer_cast<CARTree>(clone_machine());
+	auto subset_size=index_t(m_subset_frac*feats->get_num_vectors());
+	if (tree && tree->use_histograms(subset_size) &&
+	    !feats->get_subset_stack()->has_subsets())
+		m_binned_features=tree->bin_features(feats);
+
 	// cache predicted labels for intermediate models
 	auto interf=std::make_shared<RegressionLabels>(feats->get_num_vectors());
 
@@ -211,6 +220,7 @@ bool StochasticGBMachine::train_machine(std::shared_ptr<Features> data)
 
 	}
 
+	m_binned_features=nullptr;
 
 	return true;
 }
@@ -235,7 +245,7 @@ float64_t StochasticGBMachine::compute_multiplier(
 std::shared_ptr<Machine> StochasticGBMachine::fit_model(const std::shared_ptr<DenseFeatures<float64_t>>& feats, const std::shared_ptr<RegressionLabels>& labels)
 {
 	// clone base machine
-	auto c=m_machine->clone()->as<Machine>();
+	auto c=clone_machine();
 	// train cloned machine
 	c->set_labels(labels);
 	c->train(feats);
@@ -243,6 +253,23 @@ std::shared_ptr<Machine> StochasticGBMachine::fit_model(const std::shared_ptr<De
 	return c;
 }
 
+std::shared_ptr<Machine> StochasticGBMachine::clone_machine() const
+{
+	auto c=m_machine->clone()->as<Machine>();
+	if (auto tree=std::dynamic_pointer_cast<CARTree>(c))
+	{
+		// like in RandomForest, trees find splits on large training sets
+		// using histograms, unless they set a number of bins themselves
+		if (!tree->get_num_bins())
+			tree->set_num_bins(255);
+
+		if (m_binned_features)
+			tree->set_binned_features(m_binned_features);
+	}
+
+	return c;
+}
+
 std::shared_ptr<RegressionLabels> StochasticGBMachine::compute_pseudo_residuals(
     const std::shared_ptr<RegressionLabels>& inter_f, const std::shared_ptr<Labels>& labs)
 {
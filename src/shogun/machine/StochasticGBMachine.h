@@ -43,12 +43,16 @@
 
 namespace shogun
 {
+class BinnedFeatureMatrix;
 
 /** @brief This class implements the stochastic gradient boosting algorithm for ensemble learning invented by Jerome H. Friedman. This class
  * works with a variety of loss functions like squared loss, exponential loss, Huber loss etc which can be accessed through Shogun's
  * CLossFunction interface (cf. http://www.shogun-toolbox.org/doc/en/latest/classshogun_1_1CLossFunction.html). Additionally, it can create
  * an ensemble of any regressor class derived from the Machine class (cf. http://www.shogun-toolbox.org/doc/en/latest/classshogun_1_1Machine.html).
  * For one dimensional optimization, this class uses the backtracking linesearch accessed via Shogun's L-BFGS class.
+ * Weak learners that are CARTrees find splits on large training sets using histograms of at most 255 bins per attribute, unless the
+ * supplied tree sets its own number of bins (see CARTree::set_num_bins() and CARTree::set_histogram_threshold()). The training data is
+ * then binned only once and shared by all trees.
  * A concise description of the algorithm implemented can be found in the following link :
  * http://en.wikipedia.org/wiki/Gradient_boosting#Algorithm
  */
@@ -169,6 +173,13 @@ protected:
 	 */
 	std::shared_ptr<Machine> fit_model(const std::shared_ptr<DenseFeatures<float64_t>>& feats, const std::shared_ptr<RegressionLabels>& labels);
 
+	/** clone base model for training, with histogram split finding enabled
+	 * for trees that do not set a number of bins
+	 *
+	 * @return untrained copy of the base model
+	 */
+	std::shared_ptr<Machine> clone_machine() const;
+
 	/** compute pseudo_residuals
 	 *
 	 * @param inter_f intermediate boosted model labels for training data
@@ -231,6 +242,9 @@ protected:
 
 	/** gamma - weak learner weights */
 	std::vector<float64_t> m_gamma;
+
+	/** training data binned once for all trees if they use histograms */
+	std::shared_ptr<BinnedFeatureMatrix> m_binned_features;
 #ifndef SWIG
 public:
 	static constexpr std::string_view kMachine = "machine";
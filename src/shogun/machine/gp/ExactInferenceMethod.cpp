@@ -341,30 +341,10 @@ SGVector<float64_t> ExactInferenceMethod::get_derivative_wrt_likelihood_model(
 SGVector<float64_t> ExactInferenceMethod::get_derivative_wrt_kernel(
 		Parameters::const_reference param)
 {
-	// create eigen representation of the matrix Q
-	Map<MatrixXd> eigen_Q(m_Q.matrix, m_Q.num_rows, m_Q.num_cols);
-
-	SGVector<float64_t> result;
-	auto visitor = std::make_unique<ShapeVisitor>();
-	param.second->get_value().visit(visitor.get());
-	int64_t len= visitor->get_size();
-	result=SGVector<float64_t>(len);
-
+	// compute derivative wrt kernel parameter: dnlZ=sum(Q.*dK*scale)/2.0
+	SGVector<float64_t> result=m_kernel->get_parameter_gradient_sum(param, m_Q);
 	for (index_t i=0; i<result.vlen; i++)
-	{
-		SGMatrix<float64_t> dK;
-
-		if (result.vlen==1)
-			dK=m_kernel->get_parameter_gradient(param);
-		else
-			dK=m_kernel->get_parameter_gradient(param, i);
-
-		Map<MatrixXd> eigen_dK(dK.matrix, dK.num_rows, dK.num_cols);
-
-		// compute derivative wrt kernel parameter: dnlZ=sum(Q.*dK*scale)/2.0
-		result[i]=(eigen_Q.cwiseProduct(eigen_dK)).sum();
 		result[i] *= std::exp(m_log_scale * 2.0) / 2.0;
-	}
 
 	return result;
 }
@@ -39,6 +39,7 @@
 #include <shogun/mathematics/Math.h>
 
 #include <utility>
+#include <vector>
 
 using namespace shogun;
 
@@ -188,47 +189,53 @@ get_negative_log_marginal_likelihood_derivatives(std::map<Parameters::value_type
 	// get number of derivatives
 	const index_t num_deriv=params.size();
 
-	// create map of derivatives
-	std::map<std::string, SGVector<float64_t>> result;
+	std::vector<SGVector<float64_t>> gradients(num_deriv);
+
+	// kernel derivatives come first and one at a time, as kernels
+	// parallelise over their own matrix (e.g. GaussianARDKernel)
+	for (index_t i=0; i<num_deriv; i++)
+	{
+		auto node = std::next(params.begin(), i);
+		if (node->second==this->m_kernel)
+			gradients[i]=this->get_derivative_wrt_kernel(node->first);
+	}
 
-	#pragma omp parallel for
+	#pragma omp parallel for schedule(dynamic)
 	for (index_t i=0; i<num_deriv; i++)
 	{
-        	SGVector<float64_t> gradient;
 		auto node = std::next(params.begin(), i);
 
 		if((node->second).get() == this)
 		{
 			// try to find dervative wrt InferenceMethod.parameter
-			gradient=this->get_derivative_wrt_inference_method(node->first);
+			gradients[i]=this->get_derivative_wrt_inference_method(node->first);
 		}
 		else if (node->second == this->m_model)
 		{
 			// try to find derivative wrt LikelihoodModel.parameter
-			gradient=this->get_derivative_wrt_likelihood_model(node->first);
+			gradients[i]=this->get_derivative_wrt_likelihood_model(node->first);
 		}
 		else if (node->second ==this->m_kernel)
 		{
-			// try to find derivative wrt Kernel.parameter
-			gradient=this->get_derivative_wrt_kernel(node->first);
+			// computed above
 		}
 		else if (node->second ==this->m_mean)
 		{
 			// try to find derivative wrt MeanFunction.parameter
-			gradient=this->get_derivative_wrt_mean(node->first);
+			gradients[i]=this->get_derivative_wrt_mean(node->first);
 		}
 		else
 		{
 			error("Can't compute derivative of negative log marginal "
 					"likelihood wrt {}.{}", node->second->get_name(), node->first.first);
 		}
-
-		#pragma omp critical
-		{
-			result[node->first.first] = gradient;
-		}
 	}
 
+	// create map of derivatives
+	std::map<std::string, SGVector<float64_t>> result;
+	for (index_t i=0; i<num_deriv; i++)
+		result[std::next(params.begin(), i)->first.first]=gradients[i];
+
 	return result;
 }
 
@@ -0,0 +1,714 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/machine/gp/IterativeExactInferenceMethod.h>
+
+#include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/machine/gp/GaussianLikelihood.h>
+#include <shogun/machine/visitors/ShapeVisitor.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/linalg/ratapprox/tracesampler/NormalSampler.h>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+using namespace shogun;
+using namespace Eigen;
+
+/** default number of kernel matrix entries evaluated at a time */
+static constexpr int64_t KERNEL_BLOCK_ENTRIES=1<<22;
+
+/** Computes the product of a kernel matrix with the columns of V, one block
+ * of rows at a time.
+ *
+ * @param V matrix with as many rows as there are training vectors
+ * @param block_size number of kernel matrix entries per block
+ * @param block returns the rows [start, start+len) of the kernel matrix
+ * @param diagonal if not NULL, filled with the diagonal of the kernel matrix
+ * @return product of the kernel matrix and V
+ */
+static SGMatrix<float64_t> block_product(const SGMatrix<float64_t>& V,
+		int64_t block_size,
+		const std::function<SGMatrix<float64_t>(index_t, index_t)>& block,
+		SGVector<float64_t>* diagonal=NULL)
+{
+	const index_t n=V.num_rows;
+	const index_t rows=std::max<int64_t>(1, block_size/n);
+
+	SGMatrix<float64_t> result(n, V.num_cols);
+	Map<MatrixXd> eigen_V(V.matrix, V.num_rows, V.num_cols);
+	Map<MatrixXd> eigen_result(result.matrix, result.num_rows, result.num_cols);
+
+	for (index_t start=0; start<n; start+=rows)
+	{
+		const index_t len=std::min(rows, n-start);
+		SGMatrix<float64_t> K=block(start, len);
+		Map<MatrixXd> eigen_K(K.matrix, K.num_rows, K.num_cols);
+
+		eigen_result.middleRows(start, len).noalias()=eigen_K*eigen_V;
+		if (diagonal)
+		{
+			for (index_t i=0; i<len; i++)
+				(*diagonal)[start+i]=K(i, start+i);
+		}
+	}
+
+	return result;
+}
+
+IterativeExactInferenceMethod::IterativeExactInferenceMethod()
+	: RandomMixin<Inference>()
+{
+	init();
+}
+
+IterativeExactInferenceMethod::IterativeExactInferenceMethod(
+		std::shared_ptr<Kernel> kern, std::shared_ptr<Features> feat,
+		std::shared_ptr<MeanFunction> m, std::shared_ptr<Labels> lab,
+		std::shared_ptr<LikelihoodModel> mod)
+	: RandomMixin<Inference>(std::move(kern), std::move(feat), std::move(m),
+		std::move(lab), std::move(mod))
+{
+	init();
+}
+
+IterativeExactInferenceMethod::~IterativeExactInferenceMethod()
+{
+}
+
+void IterativeExactInferenceMethod::init()
+{
+	m_preconditioner_rank=100;
+	m_num_probes=10;
+	m_max_iterations=1000;
+	m_tolerance=1e-6;
+	m_block_size=KERNEL_BLOCK_ENTRIES;
+	m_precond_log_det=0;
+	m_log_det=0;
+	m_trace_inv=0;
+
+	SG_ADD(&m_preconditioner_rank, "preconditioner_rank",
+		"Rank of the pivoted Cholesky preconditioner",
+		ParameterProperties::SETTING);
+	SG_ADD(&m_num_probes, "num_probes",
+		"Number of probe vectors of the stochastic estimators",
+		ParameterProperties::SETTING);
+	SG_ADD(&m_max_iterations, "max_iterations",
+		"Maximum number of conjugate gradient iterations",
+		ParameterProperties::SETTING);
+	SG_ADD(&m_tolerance, "tolerance",
+		"Relative residual tolerance of conjugate gradients",
+		ParameterProperties::SETTING);
+	SG_ADD(&m_block_size, "block_size",
+		"Number of kernel matrix entries evaluated at a time",
+		ParameterProperties::SETTING);
+}
+
+void IterativeExactInferenceMethod::set_preconditioner_rank(int32_t rank)
+{
+	require(rank>=0, "Preconditioner rank ({}) must be non-negative", rank);
+	m_preconditioner_rank=rank;
+}
+
+void IterativeExactInferenceMethod::set_num_probes(int32_t num_probes)
+{
+	require(num_probes>0, "Number of probes ({}) must be positive",
+		num_probes);
+	m_num_probes=num_probes;
+}
+
+void IterativeExactInferenceMethod::set_max_iterations(int32_t max_iterations)
+{
+	require(max_iterations>0, "Iteration limit ({}) must be positive",
+		max_iterations);
+	m_max_iterations=max_iterations;
+}
+
+void IterativeExactInferenceMethod::set_tolerance(float64_t tolerance)
+{
+	require(tolerance>0, "Tolerance ({}) must be positive", tolerance);
+	m_tolerance=tolerance;
+}
+
+void IterativeExactInferenceMethod::set_block_size(int64_t block_size)
+{
+	require(block_size>0, "Block size ({}) must be positive", block_size);
+	m_block_size=block_size;
+}
+
+void IterativeExactInferenceMethod::register_minimizer(
+		std::shared_ptr<Minimizer> minimizer)
+{
+	io::warn("The method does not require a minimizer. The provided minimizer will not be used.");
+}
+
+std::shared_ptr<IterativeExactInferenceMethod>
+IterativeExactInferenceMethod::obtain_from_generic(
+		const std::shared_ptr<Inference>& inference)
+{
+	if (inference==NULL)
+		return NULL;
+
+	if (inference->get_inference_type()!=INF_EXACT_ITERATIVE)
+		error("Provided inference is not of type IterativeExactInferenceMethod!");
+
+	return inference->as<IterativeExactInferenceMethod>();
+}
+
+void IterativeExactInferenceMethod::compute_gradient()
+{
+	Inference::compute_gradient();
+
+	if (!m_gradient_update)
+	{
+		update_deriv();
+		m_gradient_update=true;
+		update_parameter_hash();
+	}
+}
+
+void IterativeExactInferenceMethod::update()
+{
+	SG_TRACE("entering");
+
+	Inference::update();
+	update_chol();
+	update_alpha();
+	m_gradient_update=false;
+	update_parameter_hash();
+
+	SG_TRACE("leaving");
+}
+
+void IterativeExactInferenceMethod::check_members() const
+{
+	Inference::check_members();
+
+	require(m_model->get_model_type()==LT_GAUSSIAN,
+		"Exact inference method can only use Gaussian likelihood function");
+	require(m_labels->get_label_type()==LT_REGRESSION,
+		"Labels must be type of CRegressionLabels");
+
+	// the derivative blocks are computed with the kernel initialized on
+	// subsets of the training vectors, where a data-dependent normalizer
+	// would be normalized differently
+	require(std::dynamic_pointer_cast<IdentityKernelNormalizer>(
+		m_kernel->get_normalizer()),
+		"{} does not support kernel normalizer {}, which depends on the "
+		"training data", get_name(), m_kernel->get_normalizer()->get_name());
+}
+
+void IterativeExactInferenceMethod::update_train_kernel()
+{
+	m_kernel->init(m_features, m_features);
+
+	// the kernel matrix is never formed
+	m_ktrtr=SGMatrix<float64_t>();
+}
+
+SGVector<float64_t> IterativeExactInferenceMethod::get_diagonal_vector()
+{
+	if (parameter_hash_changed())
+		update();
+
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	// compute diagonal vector: sW=1/sigma
+	SGVector<float64_t> result(m_features->get_num_vectors());
+	result.set_const(1.0/sigma);
+
+	return result;
+}
+
+float64_t IterativeExactInferenceMethod::get_negative_log_marginal_likelihood()
+{
+	if (parameter_hash_changed())
+		update();
+
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	SGVector<float64_t> y=regression_labels(m_labels)->get_labels();
+	Map<VectorXd> eigen_y(y.vector, y.vlen);
+	SGVector<float64_t> m=m_mean->get_mean_vector(m_features);
+	Map<VectorXd> eigen_m(m.vector, m.vlen);
+	Map<VectorXd> eigen_alpha(m_alpha.vector, m_alpha.vlen);
+
+	// compute negative log of the marginal likelihood:
+	// nlZ=(y-m)'*alpha/2+log(det(B))/2+n*log(2*pi*sigma^2)/2
+	return (eigen_y-eigen_m).dot(eigen_alpha)/2.0+m_log_det/2.0+
+		m_alpha.vlen*std::log(2*Math::PI*Math::sq(sigma))/2.0;
+}
+
+SGVector<float64_t> IterativeExactInferenceMethod::get_alpha()
+{
+	if (parameter_hash_changed())
+		update();
+
+	return SGVector<float64_t>(m_alpha);
+}
+
+SGMatrix<float64_t> IterativeExactInferenceMethod::get_cholesky()
+{
+	error("{} does not compute the Cholesky factor of the kernel matrix",
+		get_name());
+	return SGMatrix<float64_t>();
+}
+
+SGVector<float64_t> IterativeExactInferenceMethod::get_posterior_mean()
+{
+	if (parameter_hash_changed())
+		update();
+
+	// mu=K*alpha*scale^2
+	SGMatrix<float64_t> alpha(m_alpha.vector, m_alpha.vlen, 1, false);
+	SGMatrix<float64_t> mu=block_product(alpha, m_block_size,
+		[this](index_t start, index_t len) {
+			return m_kernel->get_kernel_block(start, start+len);
+		});
+
+	SGVector<float64_t> result(mu.num_rows);
+	Map<VectorXd>(result.vector, result.vlen)=
+		Map<VectorXd>(mu.matrix, mu.num_rows)*std::exp(m_log_scale*2.0);
+
+	return result;
+}
+
+SGMatrix<float64_t> IterativeExactInferenceMethod::get_posterior_covariance()
+{
+	error("{} does not compute the posterior covariance matrix", get_name());
+	return SGMatrix<float64_t>();
+}
+
+SGMatrix<float64_t> IterativeExactInferenceMethod::apply_preconditioner(
+		const SGMatrix<float64_t>& V) const
+{
+	Map<MatrixXd> eigen_L(m_precond_factor.matrix, m_precond_factor.num_rows,
+		m_precond_factor.num_cols);
+	Map<MatrixXd> eigen_C(m_precond_inv_sqrt.matrix,
+		m_precond_inv_sqrt.num_rows, m_precond_inv_sqrt.num_cols);
+	Map<MatrixXd> eigen_V(V.matrix, V.num_rows, V.num_cols);
+
+	SGMatrix<float64_t> result(V.num_rows, V.num_cols);
+	Map<MatrixXd> eigen_result(result.matrix, result.num_rows, result.num_cols);
+
+	// P^(-1/2)*V=V+L*C*L'*V
+	MatrixXd LV=eigen_L.transpose()*eigen_V;
+	eigen_result=eigen_V+eigen_L*(eigen_C*LV);
+
+	return result;
+}
+
+SGMatrix<float64_t> IterativeExactInferenceMethod::apply_operator(
+		const SGMatrix<float64_t>& V) const
+{
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	SGMatrix<float64_t> X=apply_preconditioner(V);
+	SGMatrix<float64_t> KX=block_product(X, m_block_size,
+		[this](index_t start, index_t len) {
+			return m_kernel->get_kernel_block(start, start+len);
+		});
+
+	// B*X=K*X*scale^2/sigma^2+X
+	Map<MatrixXd> eigen_X(X.matrix, X.num_rows, X.num_cols);
+	Map<MatrixXd> eigen_KX(KX.matrix, KX.num_rows, KX.num_cols);
+	eigen_X+=eigen_KX*(std::exp(m_log_scale*2.0)/Math::sq(sigma));
+
+	return apply_preconditioner(X);
+}
+
+void IterativeExactInferenceMethod::update_chol()
+{
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+	const float64_t scale=std::exp(m_log_scale*2.0)/Math::sq(sigma);
+
+	const index_t n=m_features->get_num_vectors();
+	const index_t max_rank=std::min<index_t>(m_preconditioner_rank, n);
+
+	VectorXd d(n);
+#pragma omp parallel for
+	for (index_t i=0; i<n; i++)
+		d[i]=m_kernel->kernel(i, i)*scale;
+
+	// pivoted Cholesky factorisation of K*scale^2/sigma^2, only the columns
+	// at the pivots are evaluated
+	MatrixXd L=MatrixXd::Zero(n, max_rank);
+	const float64_t threshold=n>0 ? d.maxCoeff()*1e-10 : 0;
+	index_t rank=0;
+	for (; rank<max_rank; rank++)
+	{
+		Index pivot;
+		const float64_t max_d=d.maxCoeff(&pivot);
+		if (max_d<=threshold)
+			break;
+
+#pragma omp parallel for
+		for (index_t i=0; i<n; i++)
+			L(i, rank)=m_kernel->kernel(i, pivot)*scale;
+
+		L.col(rank)-=L.leftCols(rank)*L.row(pivot).head(rank).transpose();
+		L.col(rank)/=std::sqrt(max_d);
+		d-=L.col(rank).cwiseAbs2();
+		d[pivot]=0;
+	}
+	SG_DEBUG("Pivoted Cholesky preconditioner of rank {}", rank);
+
+	m_precond_factor=SGMatrix<float64_t>(n, rank);
+	Map<MatrixXd> eigen_L(m_precond_factor.matrix, n, rank);
+	eigen_L=L.leftCols(rank);
+
+	// with L'*L=V*diag(lambda)*V', P^(-1/2)=I+L*V*diag(c)*V'*L' for
+	// c=((1+lambda)^(-1/2)-1)/lambda
+	MatrixXd LtL=eigen_L.transpose()*eigen_L;
+	SelfAdjointEigenSolver<MatrixXd> solver(LtL);
+	const VectorXd& lambda=solver.eigenvalues();
+	VectorXd c(rank);
+	m_precond_log_det=0;
+	for (index_t i=0; i<rank; i++)
+	{
+		const float64_t l=std::max(lambda[i], 0.0);
+		c[i]=l>1e-12 ? (1.0/std::sqrt(1.0+l)-1.0)/l : -0.5;
+		m_precond_log_det+=std::log1p(l);
+	}
+
+	m_precond_inv_sqrt=SGMatrix<float64_t>(rank, rank);
+	Map<MatrixXd>(m_precond_inv_sqrt.matrix, rank, rank)=
+		solver.eigenvectors()*c.asDiagonal()*solver.eigenvectors().transpose();
+
+	// P^(-1)=I-L*(I+L'*L)^(-1)*L'
+	m_precond_inv=SGMatrix<float64_t>(rank, rank);
+	Map<MatrixXd>(m_precond_inv.matrix, rank, rank)=
+		(MatrixXd::Identity(rank, rank)+LtL).llt().solve(
+			MatrixXd::Identity(rank, rank));
+}
+
+void IterativeExactInferenceMethod::update_alpha()
+{
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	SGVector<float64_t> y=regression_labels(m_labels)->get_labels();
+	SGVector<float64_t> m=m_mean->get_mean_vector(m_features);
+	const index_t n=y.vlen;
+	const index_t num_rhs=m_num_probes+1;
+
+	// the same probes in every update, such that the estimates are smooth in
+	// the hyperparameters
+	auto sampler=std::make_shared<NormalSampler>(n);
+	auto prng=m_prng;
+	random::seed(sampler, prng);
+	sampler->precompute();
+
+	SGMatrix<float64_t> probes(n, m_num_probes);
+	for (index_t j=0; j<m_num_probes; j++)
+	{
+		SGVector<float64_t> z=sampler->sample(j);
+		sg_memcpy(probes.get_column_vector(j), z.vector, sizeof(float64_t)*n);
+	}
+
+	// solve P^(-1/2)*B*P^(-1/2)*X=[P^(-1/2)*(y-m), probes] by conjugate
+	// gradients, one pass over the kernel per iteration for all columns
+	SGMatrix<float64_t> residual(n, 1);
+	for (index_t i=0; i<n; i++)
+		residual(i, 0)=y[i]-m[i];
+	residual=apply_preconditioner(residual);
+
+	MatrixXd R(n, num_rhs);
+	R.col(0)=Map<VectorXd>(residual.matrix, n);
+	R.rightCols(m_num_probes)=Map<MatrixXd>(probes.matrix, n, m_num_probes);
+
+	MatrixXd X=MatrixXd::Zero(n, num_rhs);
+	SGMatrix<float64_t> directions(n, num_rhs);
+	Map<MatrixXd> P(directions.matrix, n, num_rhs);
+	P=R;
+
+	VectorXd r_norm2=R.colwise().squaredNorm().transpose();
+	const VectorXd b_norm=r_norm2.cwiseSqrt();
+
+	// CG coefficients of every column, which also give its Lanczos
+	// tridiagonal matrix
+	std::vector<std::vector<float64_t>> cg_alpha(num_rhs);
+	std::vector<std::vector<float64_t>> cg_beta(num_rhs);
+	std::vector<char> active(num_rhs);
+	for (index_t j=0; j<num_rhs; j++)
+		active[j]=b_norm[j]>0;
+
+	index_t iteration=0;
+	for (; iteration<m_max_iterations; iteration++)
+	{
+		if (std::none_of(active.begin(), active.end(), [](char a) { return a; }))
+			break;
+
+		SGMatrix<float64_t> AP_=apply_operator(directions);
+		Map<MatrixXd> AP(AP_.matrix, n, num_rhs);
+
+#pragma omp parallel for
+		for (index_t j=0; j<num_rhs; j++)
+		{
+			if (!active[j])
+				continue;
+
+			const float64_t p_dot_Ap=P.col(j).dot(AP.col(j));
+			if (p_dot_Ap<=0)
+			{
+				active[j]=false;
+				P.col(j).setZero();
+				continue;
+			}
+
+			const float64_t a=r_norm2[j]/p_dot_Ap;
+			X.col(j)+=a*P.col(j);
+			R.col(j)-=a*AP.col(j);
+			cg_alpha[j].push_back(a);
+
+			const float64_t r_norm2_j=R.col(j).squaredNorm();
+			const float64_t b=r_norm2_j/r_norm2[j];
+			r_norm2[j]=r_norm2_j;
+
+			if (std::sqrt(r_norm2_j)<=m_tolerance*b_norm[j])
+			{
+				active[j]=false;
+				P.col(j).setZero();
+				continue;
+			}
+
+			cg_beta[j].push_back(b);
+			P.col(j)=R.col(j)+b*P.col(j);
+		}
+	}
+
+	if (std::any_of(active.begin(), active.end(), [](char a) { return a; }))
+		io::warn("Conjugate gradients did not converge in {} iterations",
+			m_max_iterations);
+	SG_DEBUG("Conjugate gradients took {} iterations", iteration);
+
+	SGMatrix<float64_t> solves(n, num_rhs);
+	Map<MatrixXd>(solves.matrix, n, num_rhs)=X;
+	solves=apply_preconditioner(solves);
+
+	// alpha=P^(-1/2)*X(:,1)/sigma^2
+	m_alpha=SGVector<float64_t>(n);
+	Map<VectorXd>(m_alpha.vector, n)=
+		Map<VectorXd>(solves.matrix, n)/Math::sq(sigma);
+
+	m_probes=apply_preconditioner(probes);
+	m_probe_solves=SGMatrix<float64_t>(n, m_num_probes);
+	Map<MatrixXd>(m_probe_solves.matrix, n, m_num_probes)=
+		Map<MatrixXd>(solves.matrix, n, num_rhs).rightCols(m_num_probes);
+
+	// stochastic Lanczos quadrature: z'*log(A)*z=|z|^2*e1'*log(T)*e1 for
+	// the tridiagonal matrix T with diagonal 1/a_k+b_(k-1)/a_(k-1) and
+	// off-diagonal sqrt(b_k)/a_k
+	float64_t log_det=0;
+	for (index_t j=1; j<num_rhs; j++)
+	{
+		const index_t steps=cg_alpha[j].size();
+		if (!steps)
+			continue;
+
+		VectorXd diagonal(steps);
+		VectorXd off_diagonal(std::max<index_t>(steps-1, 0));
+		for (index_t k=0; k<steps; k++)
+		{
+			diagonal[k]=1.0/cg_alpha[j][k];
+			if (k>0)
+				diagonal[k]+=cg_beta[j][k-1]/cg_alpha[j][k-1];
+			if (k+1<steps)
+				off_diagonal[k]=std::sqrt(cg_beta[j][k])/cg_alpha[j][k];
+		}
+
+		SelfAdjointEigenSolver<MatrixXd> tridiagonal;
+		tridiagonal.computeFromTridiagonal(diagonal, off_diagonal);
+		log_det+=Math::sq(b_norm[j])*
+			tridiagonal.eigenvectors().row(0).array().square().matrix().dot(
+				tridiagonal.eigenvalues().array().log().matrix());
+	}
+
+	// log(det(B))=log(det(P))+log(det(P^(-1/2)*B*P^(-1/2)))
+	m_log_det=m_precond_log_det+log_det/m_num_probes;
+}
+
+void IterativeExactInferenceMethod::update_deriv()
+{
+	Map<MatrixXd> U(m_probes.matrix, m_probes.num_rows, m_probes.num_cols);
+	Map<MatrixXd> V(m_probe_solves.matrix, m_probe_solves.num_rows,
+		m_probe_solves.num_cols);
+	const index_t rank=m_precond_inv.num_rows;
+
+	// tr(B^(-1))=tr(P^(-1))+tr(B^(-1)-P^(-1)), with
+	// tr(P^(-1))=n-rank+tr((I+L'*L)^(-1)) and the remainder estimated from
+	// the probes
+	m_trace_inv=U.rows()-rank+
+		Map<MatrixXd>(m_precond_inv.matrix, rank, rank).trace()+
+		(V-U).cwiseProduct(U).sum()/m_num_probes;
+}
+
+SGVector<float64_t>
+IterativeExactInferenceMethod::get_derivative_wrt_inference_method(
+		Parameters::const_reference param)
+{
+	require(param.first == "log_scale", "Can't compute derivative of "
+			"the nagative log marginal likelihood wrt {}.{} parameter",
+			get_name(), param.first);
+
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	SGVector<float64_t> y=regression_labels(m_labels)->get_labels();
+	Map<VectorXd> eigen_y(y.vector, y.vlen);
+	SGVector<float64_t> m=m_mean->get_mean_vector(m_features);
+	Map<VectorXd> eigen_m(m.vector, m.vlen);
+	Map<VectorXd> eigen_alpha(m_alpha.vector, m_alpha.vlen);
+
+	SGVector<float64_t> result(1);
+
+	// compute derivative wrt kernel scale: dnlZ=sum(Q.*K*scale^2), which is
+	// n-tr(B^(-1))-alpha'*(y-m)+sigma^2*alpha'*alpha as K*scale^2=sigma^2*(B-I)
+	result[0]=m_alpha.vlen-m_trace_inv-eigen_alpha.dot(eigen_y-eigen_m)+
+		Math::sq(sigma)*eigen_alpha.squaredNorm();
+
+	return result;
+}
+
+SGVector<float64_t>
+IterativeExactInferenceMethod::get_derivative_wrt_likelihood_model(
+		Parameters::const_reference param)
+{
+	require(param.first == "log_sigma", "Can't compute derivative of "
+			"the nagative log marginal likelihood wrt {}.{} parameter",
+			m_model->get_name(), param.first);
+
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	Map<VectorXd> eigen_alpha(m_alpha.vector, m_alpha.vlen);
+
+	SGVector<float64_t> result(1);
+
+	// compute derivative wrt likelihood model parameter sigma:
+	// dnlZ=sigma^2*trace(Q)=tr(B^(-1))-sigma^2*alpha'*alpha
+	result[0]=m_trace_inv-Math::sq(sigma)*eigen_alpha.squaredNorm();
+
+	return result;
+}
+
+SGVector<float64_t> IterativeExactInferenceMethod::get_derivative_wrt_kernel(
+		Parameters::const_reference param)
+{
+	// get the sigma variable from the Gaussian likelihood model
+	auto lik=m_model->as<GaussianLikelihood>();
+	float64_t sigma=lik->get_sigma();
+
+	const index_t n=m_alpha.vlen;
+	const index_t num_probes=m_probes.num_cols;
+	const index_t rank=m_precond_factor.num_cols;
+
+	// dK is multiplied with [alpha, U, L] in one pass over its blocks
+	SGMatrix<float64_t> V(n, 1+num_probes+rank);
+	Map<MatrixXd> eigen_V(V.matrix, n, V.num_cols);
+	eigen_V.col(0)=Map<VectorXd>(m_alpha.vector, n);
+	eigen_V.middleCols(1, num_probes)=
+		Map<MatrixXd>(m_probes.matrix, n, num_probes);
+	eigen_V.rightCols(rank)=Map<MatrixXd>(m_precond_factor.matrix, n, rank);
+
+	Map<MatrixXd> U(m_probes.matrix, n, num_probes);
+	Map<MatrixXd> W(m_probe_solves.matrix, n, num_probes);
+	Map<MatrixXd> eigen_L(m_precond_factor.matrix, n, rank);
+	Map<MatrixXd> eigen_S(m_precond_inv.matrix, rank, rank);
+
+	SGVector<float64_t> result;
+	auto visitor = std::make_unique<ShapeVisitor>();
+	param.second->get_value().visit(visitor.get());
+	int64_t len= visitor->get_size();
+	result=SGVector<float64_t>(len);
+
+	// kernel derivatives are computed one at a time (see Inference), so the
+	// blocks may be evaluated by the kernel itself
+	const auto& kernel=m_kernel;
+
+	// there is no block computation of gradients, so the rows of a block are
+	// a subset of a shallow duplicate of the features, on which the kernel
+	// is initialized
+	auto block_features=m_features->duplicate();
+
+	for (index_t i=0; i<result.vlen; i++)
+	{
+		SGVector<float64_t> diagonal(n);
+		SGMatrix<float64_t> dKV=block_product(V, m_block_size,
+			[&](index_t start, index_t len) {
+				SGVector<index_t> indices(len);
+				indices.range_fill(start);
+
+				block_features->add_subset(indices);
+				kernel->init(block_features, m_features);
+				SGMatrix<float64_t> dK=result.vlen==1 ?
+					kernel->get_parameter_gradient(param) :
+					kernel->get_parameter_gradient(param, i);
+				block_features->remove_subset();
+
+				return dK;
+			},
+			&diagonal);
+		kernel->init(m_features, m_features);
+		Map<MatrixXd> eigen_dKV(dKV.matrix, n, dKV.num_cols);
+
+		// tr(B^(-1)*dK)=tr(P^(-1)*dK)+tr((B^(-1)-P^(-1))*dK), with
+		// tr(P^(-1)*dK)=tr(dK)-tr((I+L'*L)^(-1)*L'*dK*L)
+		float64_t trace=Map<VectorXd>(diagonal.vector, n).sum()-
+			(eigen_S*(eigen_L.transpose()*eigen_dKV.rightCols(rank))).trace();
+		trace+=(W-U).cwiseProduct(eigen_dKV.middleCols(1, num_probes)).sum()/
+			num_probes;
+
+		// compute derivative wrt kernel parameter:
+		// dnlZ=sum(Q.*dK*scale^2)/2=(tr(B^(-1)*dK)/sigma^2-alpha'*dK*alpha)*scale^2/2
+		result[i]=trace/Math::sq(sigma)-eigen_V.col(0).dot(eigen_dKV.col(0));
+		result[i]*=std::exp(m_log_scale*2.0)/2.0;
+	}
+
+	return result;
+}
+
+SGVector<float64_t> IterativeExactInferenceMethod::get_derivative_wrt_mean(
+		Parameters::const_reference param)
+{
+	// create eigen representation of alpha vector
+	Map<VectorXd> eigen_alpha(m_alpha.vector, m_alpha.vlen);
+
+	SGVector<float64_t> result;
+	auto visitor = std::make_unique<ShapeVisitor>();
+	param.second->get_value().visit(visitor.get());
+	int64_t len= visitor->get_size();
+	result=SGVector<float64_t>(len);
+
+	for (index_t i=0; i<result.vlen; i++)
+	{
+		SGVector<float64_t> dmu;
+
+		if (result.vlen==1)
+			dmu=m_mean->get_parameter_derivative(m_features, param);
+		else
+			dmu=m_mean->get_parameter_derivative(m_features, param, i);
+
+		Map<VectorXd> eigen_dmu(dmu.vector, dmu.vlen);
+
+		// compute derivative wrt mean parameter: dnlZ=-dmu'*alpha
+		result[i]=-eigen_dmu.dot(eigen_alpha);
+	}
+
+	return result;
+}
@@ -0,0 +1,323 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef CITERATIVEEXACTINFERENCEMETHOD_H_
+#define CITERATIVEEXACTINFERENCEMETHOD_H_
+
+#include <shogun/lib/config.h>
+
+#include <shogun/machine/gp/Inference.h>
+#include <shogun/mathematics/RandomMixin.h>
+
+namespace shogun
+{
+
+/** @brief Exact Gaussian process inference without a kernel matrix.
+ *
+ * Computes the same posterior and marginal likelihood as
+ * ExactInferenceMethod, but never forms the \f$n\times n\f$ kernel matrix
+ * or its Cholesky factor. Kernel rows are evaluated in blocks whenever a
+ * product with
+ *
+ * \f[
+ * B = \frac{s^{2}}{\sigma^{2}}K + I
+ * \f]
+ *
+ * is needed, so memory is linear in the number of training vectors.
+ *
+ * A rank \f$r\f$ pivoted Cholesky factor \f$L\f$ of
+ * \f$\frac{s^{2}}{\sigma^{2}}K\f$ gives the preconditioner
+ * \f$P = LL^{T}+I\f$, whose inverse square root is applied via the
+ * eigendecomposition of the \f$r\times r\f$ matrix \f$L^{T}L\f$. Conjugate
+ * gradients on \f$P^{-1/2}BP^{-1/2}\f$ then solve for
+ * \f$\alpha = B^{-1}(y-m)/\sigma^{2}\f$ and for a set of random probe
+ * vectors \f$z\f$ in one batch, sharing each pass over the kernel.
+ *
+ * The log-determinant in the marginal likelihood is
+ * \f$\log|P| + \log|P^{-1/2}BP^{-1/2}|\f$, where the second term is
+ * estimated by stochastic Lanczos quadrature from the conjugate gradient
+ * coefficients of the probe solves. Traces in the hyperparameter
+ * derivatives are computed exactly for \f$P^{-1}\f$ and by Hutchinson's
+ * estimator for the remainder \f$B^{-1}-P^{-1}\f$, so all estimates are exact
+ * whenever the preconditioner is.
+ *
+ * The probe vectors are drawn from the object's random generator without
+ * advancing it, such that the marginal likelihood is a smooth function of
+ * the hyperparameters.
+ *
+ * The posterior covariance (and thus predictive variances) needs the full
+ * matrix and is not supported.
+ *
+ * Kernel derivatives are evaluated with the kernel initialized on blocks of
+ * training vectors, so normalizers that depend on the training data (e.g.
+ * SqrtDiagKernelNormalizer) are not supported.
+ *
+ * NOTE: The Gaussian Likelihood Function must be used for this inference
+ * method.
+ */
+class IterativeExactInferenceMethod: public RandomMixin<Inference>
+{
+public:
+	/** default constructor */
+	IterativeExactInferenceMethod();
+
+	/** constructor
+	 *
+	 * @param kernel covariance function
+	 * @param features features to use in inference
+	 * @param mean mean function to use
+	 * @param labels labels of the features
+	 * @param model likelihood model to use
+	 */
+	IterativeExactInferenceMethod(std::shared_ptr<Kernel> kernel,
+			std::shared_ptr<Features> features,
+			std::shared_ptr<MeanFunction> mean, std::shared_ptr<Labels> labels,
+			std::shared_ptr<LikelihoodModel> model);
+
+	virtual ~IterativeExactInferenceMethod();
+
+	/** return what type of inference we are
+	 *
+	 * @return inference type EXACT_ITERATIVE
+	 */
+	virtual EInferenceType get_inference_type() const
+	{
+		return INF_EXACT_ITERATIVE;
+	}
+
+	/** returns the name of the inference method
+	 *
+	 * @return name IterativeExactInferenceMethod
+	 */
+	virtual const char* get_name() const
+	{
+		return "IterativeExactInferenceMethod";
+	}
+
+	/** helper method used to specialize a base class instance
+	 *
+	 * @param inference inference method
+	 * @return casted IterativeExactInferenceMethod object
+	 */
+	static std::shared_ptr<IterativeExactInferenceMethod> obtain_from_generic(
+			const std::shared_ptr<Inference>& inference);
+
+	/** get negative log marginal likelihood
+	 *
+	 * @return the negative log of the marginal likelihood function, with
+	 * a stochastic estimate of the log-determinant
+	 */
+	virtual float64_t get_negative_log_marginal_likelihood();
+
+	/** get alpha vector
+	 *
+	 * @return vector to compute posterior mean of Gaussian Process:
+	 *
+	 * \f[
+	 * \mu = K\alpha
+	 * \f]
+	 *
+	 * where \f$\mu\f$ is the mean and \f$K\f$ is the prior covariance matrix.
+	 */
+	virtual SGVector<float64_t> get_alpha();
+
+	/** not supported, the Cholesky factor is never computed */
+	virtual SGMatrix<float64_t> get_cholesky();
+
+	/** get diagonal vector
+	 *
+	 * @return diagonal vector \f$sW=1/\sigma\f$
+	 */
+	virtual SGVector<float64_t> get_diagonal_vector();
+
+	/** returns mean vector \f$\mu\f$ of the posterior Gaussian distribution
+	 * \f$\mathcal{N}(\mu,\Sigma)\f$
+	 *
+	 * @return mean vector
+	 */
+	virtual SGVector<float64_t> get_posterior_mean();
+
+	/** not supported, the covariance matrix is never computed */
+	virtual SGMatrix<float64_t> get_posterior_covariance();
+
+	/**
+	 * @return whether combination of exact inference method and given
+	 * likelihood function supports regression
+	 */
+	virtual bool supports_regression() const
+	{
+		check_members();
+		return m_model->supports_regression();
+	}
+
+	/** update alpha, preconditioner and stochastic estimates */
+	virtual void update();
+
+	/** Set a minimizer
+	 *
+	 * @param minimizer minimizer used in inference method
+	 */
+	virtual void register_minimizer(std::shared_ptr<Minimizer> minimizer);
+
+	/** @return rank of the pivoted Cholesky preconditioner */
+	int32_t get_preconditioner_rank() const { return m_preconditioner_rank; }
+
+	/** set rank of the pivoted Cholesky preconditioner, 0 disables it
+	 *
+	 * @param rank maximum rank
+	 */
+	void set_preconditioner_rank(int32_t rank);
+
+	/** @return number of probe vectors of the stochastic estimators */
+	int32_t get_num_probes() const { return m_num_probes; }
+
+	/** set number of probe vectors of the stochastic estimators
+	 *
+	 * @param num_probes number of probe vectors
+	 */
+	void set_num_probes(int32_t num_probes);
+
+	/** @return maximum number of conjugate gradient iterations */
+	int32_t get_max_iterations() const { return m_max_iterations; }
+
+	/** set maximum number of conjugate gradient iterations
+	 *
+	 * @param max_iterations iteration limit
+	 */
+	void set_max_iterations(int32_t max_iterations);
+
+	/** @return relative residual norm at which conjugate gradients stop */
+	float64_t get_tolerance() const { return m_tolerance; }
+
+	/** set relative residual norm at which conjugate gradients stop
+	 *
+	 * @param tolerance tolerance
+	 */
+	void set_tolerance(float64_t tolerance);
+
+	/** @return number of kernel matrix entries evaluated at a time */
+	int64_t get_block_size() const { return m_block_size; }
+
+	/** set number of kernel matrix entries evaluated at a time, a block
+	 * holds at least one row of the kernel matrix
+	 *
+	 * @param block_size number of kernel matrix entries
+	 */
+	void set_block_size(int64_t block_size);
+
+protected:
+	/** check if members of object are valid for inference */
+	virtual void check_members() const;
+
+	/** initialises the kernel on the training features, without computing
+	 * the kernel matrix
+	 */
+	virtual void update_train_kernel();
+
+	/** update alpha vector, probe solves and log-determinant */
+	virtual void update_alpha();
+
+	/** update pivoted Cholesky preconditioner */
+	virtual void update_chol();
+
+	/** update trace estimate required for the derivatives */
+	virtual void update_deriv();
+
+	/** returns derivative of negative log marginal likelihood wrt parameter of
+	 * CInference class
+	 *
+	 * @param param parameter of CInference class
+	 *
+	 * @return derivative of negative log marginal likelihood
+	 */
+	virtual SGVector<float64_t> get_derivative_wrt_inference_method(
+			Parameters::const_reference param);
+
+	/** returns derivative of negative log marginal likelihood wrt parameter of
+	 * likelihood model
+	 *
+	 * @param param parameter of given likelihood model
+	 *
+	 * @return derivative of negative log marginal likelihood
+	 */
+	virtual SGVector<float64_t> get_derivative_wrt_likelihood_model(
+			Parameters::const_reference param);
+
+	/** returns derivative of negative log marginal likelihood wrt kernel's
+	 * parameter
+	 *
+	 * @param param parameter of given kernel
+	 *
+	 * @return derivative of negative log marginal likelihood
+	 */
+	virtual SGVector<float64_t> get_derivative_wrt_kernel(
+			Parameters::const_reference param);
+
+	/** returns derivative of negative log marginal likelihood wrt mean
+	 * function's parameter
+	 *
+	 * @param param parameter of given mean function
+	 *
+	 * @return derivative of negative log marginal likelihood
+	 */
+	virtual SGVector<float64_t> get_derivative_wrt_mean(
+			Parameters::const_reference param);
+
+	/** update gradients */
+	virtual void compute_gradient();
+
+private:
+	void init();
+
+	/** applies \f$P^{-1/2}\f$ to the columns of a matrix */
+	SGMatrix<float64_t> apply_preconditioner(const SGMatrix<float64_t>& V) const;
+
+	/** applies \f$P^{-1/2}BP^{-1/2}\f$ to the columns of a matrix */
+	SGMatrix<float64_t> apply_operator(const SGMatrix<float64_t>& V) const;
+
+	/** rank of the pivoted Cholesky preconditioner */
+	int32_t m_preconditioner_rank;
+
+	/** number of probe vectors */
+	int32_t m_num_probes;
+
+	/** maximum number of conjugate gradient iterations */
+	int32_t m_max_iterations;
+
+	/** relative residual tolerance of conjugate gradients */
+	float64_t m_tolerance;
+
+	/** number of kernel matrix entries evaluated at a time */
+	int64_t m_block_size;
+
+	/** pivoted Cholesky factor \f$L\f$ of the scaled kernel matrix */
+	SGMatrix<float64_t> m_precond_factor;
+
+	/** \f$C\f$ such that \f$P^{-1/2}=I+LCL^{T}\f$ */
+	SGMatrix<float64_t> m_precond_inv_sqrt;
+
+	/** \f$(I+L^{T}L)^{-1}\f$, such that
+	 * \f$tr(P^{-1}D)=tr(D)-tr((I+L^{T}L)^{-1}L^{T}DL)\f$
+	 */
+	SGMatrix<float64_t> m_precond_inv;
+
+	/** \f$\log|P|\f$ */
+	float64_t m_precond_log_det;
+
+	/** preconditioned probe vectors \f$u=P^{-1/2}z\f$ */
+	SGMatrix<float64_t> m_probes;
+
+	/** solves \f$v=P^{-1/2}(P^{-1/2}BP^{-1/2})^{-1}z\f$, such that
+	 * \f$E[v^{T}Du]=tr(B^{-1}D)\f$
+	 */
+	SGMatrix<float64_t> m_probe_solves;
+
+	/** estimate of \f$\log|B|\f$ */
+	float64_t m_log_det;
+
+	/** estimate of \f$tr(B^{-1})\f$ */
+	float64_t m_trace_inv;
+};
+}
+#endif /* CITERATIVEEXACTINFERENCEMETHOD_H_ */
@@ -36,6 +36,8 @@
 #include <memory>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGSparseVector.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/config.h>
@@ -72,6 +74,23 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_ADD, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_ADD
 
+/**
+ * Wrapper method of add operation result = alpha*A + beta*B for a sparse
+ * matrix A and a dense matrix B.
+ *
+ * @see linalg::add
+ */
+#define BACKEND_GENERIC_SPARSE_ADD(Type, Container)                            \
+	virtual void add(                                                          \
+	    const Container<Type>& a, const SGMatrix<Type>& b, Type alpha,         \
+	    Type beta, SGMatrix<Type>& result) const                               \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_ADD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_ADD
+
 /**
  * Wrapper method of add column vector result = alpha*A.col(i) + beta*b.
  *
@@ -323,6 +342,22 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE_EXCEPT_FLOAT64(BACKEND_GENERIC_DOT, SGVector)
 #undef BACKEND_GENERIC_DOT
 
+/**
+ * Wrapper method of dot-product of a sparse and a dense vector.
+ *
+ * @see linalg::dot
+ */
+#define BACKEND_GENERIC_SPARSE_DOT(Type, Container)                            \
+	virtual Type dot(                                                          \
+	    const SGSparseVector<Type>& a, const SGVector<Type>& b) const          \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+		return 0;                                                              \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_DOT, SGSparseVector)
+#undef BACKEND_GENERIC_SPARSE_DOT
+
 /**
  * Wrapper method of eigenvalues and eigenvectors computation.
  *
@@ -540,6 +575,38 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_MATRIX_PROD, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_MATRIX_PROD
 
+/**
+ * Wrapper method of product of a sparse matrix with a dense vector.
+ *
+ * @see linalg::matrix_prod
+ */
+#define BACKEND_GENERIC_SPARSE_MATRIX_PROD(Type, Container)                    \
+	virtual void matrix_prod(                                                  \
+	    const Container<Type>& a, const SGVector<Type>& b,                     \
+	    SGVector<Type>& result, bool transpose) const                          \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_MATRIX_PROD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_MATRIX_PROD
+
+/**
+ * Wrapper method of product of a sparse matrix with a dense matrix.
+ *
+ * @see linalg::matrix_prod
+ */
+#define BACKEND_GENERIC_SPARSE_MATRIX_PROD(Type, Container)                    \
+	virtual void matrix_prod(                                                  \
+	    const Container<Type>& a, const SGMatrix<Type>& b,                     \
+	    SGMatrix<Type>& result, bool transpose) const                          \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_MATRIX_PROD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_MATRIX_PROD
+
 /**
  * Wrapper method of max method. Return the largest element in a vector or
  * matrix.
@@ -695,6 +762,22 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_SCALE, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_SCALE
 
+/**
+ * Wrapper method of scale operation result = alpha*A for sparse matrices,
+ * where result has the sparsity pattern of A.
+ *
+ * @see linalg::scale
+ */
+#define BACKEND_GENERIC_SPARSE_SCALE(Type, Container)                          \
+	virtual void scale(                                                        \
+	    const Container<Type>& a, Type alpha, Container<Type>& result) const   \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_SCALE, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_SCALE
+
 /**
  * Wrapper method that scales every matrix column with respective coefficient.
  *
@@ -837,6 +920,21 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_COLWISE_SUM, SGMatrix)
 #undef BACKEND_GENERIC_COLWISE_SUM
 
+/**
+ * Wrapper method of matrix colwise sum that works with sparse matrices.
+ *
+ * @see linalg::colwise_sum
+ */
+#define BACKEND_GENERIC_SPARSE_COLWISE_SUM(Type, Container)                    \
+	virtual SGVector<Type> colwise_sum(const Container<Type>& a) const         \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+		return 0;                                                              \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_COLWISE_SUM, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_COLWISE_SUM
+
 /**
  * Wrapper method of matrix colwise sum that works with dense matrices.
  *
@@ -867,6 +965,21 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_ROWWISE_SUM, SGMatrix)
 #undef BACKEND_GENERIC_ROWWISE_SUM
 
+/**
+ * Wrapper method of matrix rowwise sum that works with sparse matrices.
+ *
+ * @see linalg::rowwise_sum
+ */
+#define BACKEND_GENERIC_SPARSE_ROWWISE_SUM(Type, Container)                    \
+	virtual SGVector<Type> rowwise_sum(const Container<Type>& a) const         \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+		return 0;                                                              \
+	}
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_ROWWISE_SUM, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_ROWWISE_SUM
+
 /**
  * Wrapper method of matrix rowwise sum that works with dense matrices.
  *
@@ -59,6 +59,15 @@ namespace shogun
 		BACKEND_GENERIC_IN_PLACE_ADD(complex128_t, SGMatrix);
 #undef BACKEND_GENERIC_IN_PLACE_ADD
 
+/** Implementation of @see LinalgBackendBase::add */
+#define BACKEND_GENERIC_SPARSE_ADD(Type, Container)                            \
+	virtual void add(                                                          \
+	    const Container<Type>& a, const SGMatrix<Type>& b, Type alpha,         \
+	    Type beta, SGMatrix<Type>& result) const;
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_ADD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_ADD
+
 /** Implementation of @see LinalgBackendBase::add_col_vec */
 #define BACKEND_GENERIC_ADD_COL_VEC(Type, Container)                           \
 	virtual void add_col_vec(                                                  \
@@ -184,6 +193,14 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE_EXCEPT_FLOAT64(BACKEND_GENERIC_DOT, SGVector)
 #undef BACKEND_GENERIC_DOT
 
+/** Implementation of @see LinalgBackendBase::dot */
+#define BACKEND_GENERIC_SPARSE_DOT(Type, Container)                            \
+	virtual Type dot(                                                          \
+	    const Container<Type>& a, const SGVector<Type>& b) const;
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_DOT, SGSparseVector)
+#undef BACKEND_GENERIC_SPARSE_DOT
+
 /** Implementation of @see LinalgBackendBase::eigen_solver */
 #define BACKEND_GENERIC_EIGEN_SOLVER(Type, Container)                          \
 	virtual void eigen_solver(                                                 \
@@ -301,6 +318,18 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_MATRIX_PROD, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_MATRIX_PROD
 
+/** Implementation of @see LinalgBackendBase::matrix_prod */
+#define BACKEND_GENERIC_SPARSE_MATRIX_PROD(Type, Container)                    \
+	virtual void matrix_prod(                                                  \
+	    const Container<Type>& a, const SGVector<Type>& b,                     \
+	    SGVector<Type>& result, bool transpose) const;                         \
+	virtual void matrix_prod(                                                  \
+	    const Container<Type>& a, const SGMatrix<Type>& b,                     \
+	    SGMatrix<Type>& result, bool transpose) const;
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_MATRIX_PROD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_MATRIX_PROD
+
 /** Implementation of @see LinalgBackendBase::max */
 #define BACKEND_GENERIC_MAX(Type, Container)                                   \
 	virtual Type max(const Container<Type>& a) const;
@@ -375,6 +404,14 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_SCALE, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_SCALE
 
+/** Implementation of @see LinalgBackendBase::scale */
+#define BACKEND_GENERIC_SPARSE_SCALE(Type, Container)                          \
+	virtual void scale(                                                        \
+	    const Container<Type>& a, Type alpha, Container<Type>& result) const;
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_SCALE, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_SCALE
+
 /** Implementation of @see linalg::scale */
 #define BACKEND_GENERIC_IN_PLACE_COLWISE_SCALE(Type, Container)                \
 	virtual void scale(                                                        \
@@ -446,6 +483,13 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_COLWISE_SUM, SGMatrix)
 #undef BACKEND_GENERIC_COLWISE_SUM
 
+/** Implementation of @see LinalgBackendBase::colwise_sum */
+#define BACKEND_GENERIC_SPARSE_COLWISE_SUM(Type, Container)                    \
+	virtual SGVector<Type> colwise_sum(const Container<Type>& a) const;
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_COLWISE_SUM, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_COLWISE_SUM
+
 /** Implementation of @see LinalgBackendBase::colwise_sum */
 #define BACKEND_GENERIC_BLOCK_COLWISE_SUM(Type, Container)                     \
 	virtual SGVector<Type> colwise_sum(                                        \
@@ -460,6 +504,13 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_ROWWISE_SUM, SGMatrix)
 #undef BACKEND_GENERIC_ROWWISE_SUM
 
+/** Implementation of @see LinalgBackendBase::rowwise_sum */
+#define BACKEND_GENERIC_SPARSE_ROWWISE_SUM(Type, Container)                    \
+	virtual SGVector<Type> rowwise_sum(const Container<Type>& a) const;
+		DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+		    BACKEND_GENERIC_SPARSE_ROWWISE_SUM, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_ROWWISE_SUM
+
 /** Implementation of @see LinalgBackendBase::rowwise_sum */
 #define BACKEND_GENERIC_BLOCK_ROWWISE_SUM(Type, Container)                     \
 	virtual SGVector<Type> rowwise_sum(                                        \
@@ -952,6 +1003,42 @@ namespace shogun
 		/** Eigen3 set matrix to zero method */
 		template <typename T>
 		void zero_impl(SGMatrix<T>& a) const;
+
+		/** Eigen3 result = alpha*A + beta*B method for a sparse matrix A */
+		template <typename T>
+		void add_impl(
+		    const SGSparseMatrix<T>& a, const SGMatrix<T>& b, T alpha, T beta,
+		    SGMatrix<T>& result) const;
+
+		/** Eigen3 sparse vector dot-product with a dense vector method */
+		template <typename T>
+		T dot_impl(const SGSparseVector<T>& a, const SGVector<T>& b) const;
+
+		/** Eigen3 sparse matrix * vector in-place product method */
+		template <typename T>
+		void matrix_prod_impl(
+		    const SGSparseMatrix<T>& a, const SGVector<T>& b,
+		    SGVector<T>& result, bool transpose) const;
+
+		/** Eigen3 sparse matrix * dense matrix in-place product method */
+		template <typename T>
+		void matrix_prod_impl(
+		    const SGSparseMatrix<T>& a, const SGMatrix<T>& b,
+		    SGMatrix<T>& result, bool transpose) const;
+
+		/** Eigen3 sparse matrix scale method */
+		template <typename T>
+		void scale_impl(
+		    const SGSparseMatrix<T>& a, T alpha,
+		    SGSparseMatrix<T>& result) const;
+
+		/** Eigen3 sparse matrix colwise sum method */
+		template <typename T>
+		SGVector<T> colwise_sum_impl(const SGSparseMatrix<T>& a) const;
+
+		/** Eigen3 sparse matrix rowwise sum method */
+		template <typename T>
+		SGVector<T> rowwise_sum_impl(const SGSparseMatrix<T>& a) const;
 	};
 }
 
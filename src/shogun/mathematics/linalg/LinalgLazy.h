@@ -0,0 +1,418 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef LINALG_LAZY_H_
+#define LINALG_LAZY_H_
+
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/mathematics/eigen3.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace shogun
+{
+
+	namespace linalg
+	{
+
+		/** @brief Lazily evaluated elementwise expressions.
+		 *
+		 * Every elementwise operation of the linalg namespace makes a pass
+		 * over memory and most of them allocate their result, so a chain of
+		 * them streams the data through the cache once per operation. The
+		 * functions of this namespace only build an expression tree, which
+		 * eval() computes in a single pass into a given vector or matrix:
+		 *
+		 * @code
+		 * using namespace linalg::lazy;
+		 * // g = g .* a .* (1 - a)
+		 * eval(ref(g) * ref(a) * (1 - ref(a)), g);
+		 * @endcode
+		 *
+		 * Expressions only reference their operands, which therefore have to
+		 * outlive the evaluation. The result may be one of the operands, as
+		 * every element only depends on the elements at the same position.
+		 *
+		 * eval() splits the elements into blocks that are evaluated in
+		 * parallel. Each block is computed by one Eigen array expression and
+		 * is thus vectorized.
+		 */
+		namespace lazy
+		{
+			/** number of elements evaluated by one thread at a time */
+			constexpr int64_t EVAL_BLOCK_SIZE = 8192;
+
+			/** Base class of all expressions.
+			 *
+			 * An expression has the element type Scalar, a shape
+			 * (rows() and cols()) and returns an Eigen array expression of
+			 * its elements [begin, begin+size) in column-major order from
+			 * segment(begin, size).
+			 */
+			template <typename Derived>
+			class Expression
+			{
+			public:
+				/** @return the actual expression */
+				const Derived& derived() const
+				{
+					return static_cast<const Derived&>(*this);
+				}
+			};
+
+			/** Leaf of an expression, referencing a vector or matrix */
+			template <typename T>
+			class Operand : public Expression<Operand<T>>
+			{
+			public:
+				typedef T Scalar;
+
+				Operand(const T* data, index_t rows, index_t cols)
+				    : m_data(data), m_rows(rows), m_cols(cols)
+				{
+				}
+
+				index_t rows() const
+				{
+					return m_rows;
+				}
+
+				index_t cols() const
+				{
+					return m_cols;
+				}
+
+				auto segment(int64_t begin, index_t size) const
+				{
+					return Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+					    m_data + begin, size);
+				}
+
+			private:
+				const T* m_data;
+				index_t m_rows;
+				index_t m_cols;
+			};
+
+			/** Elementwise function of one expression */
+			template <typename E, typename F>
+			class Unary : public Expression<Unary<E, F>>
+			{
+			public:
+				typedef typename E::Scalar Scalar;
+
+				Unary(const E& expr, F op) : m_expr(expr), m_op(op)
+				{
+				}
+
+				index_t rows() const
+				{
+					return m_expr.rows();
+				}
+
+				index_t cols() const
+				{
+					return m_expr.cols();
+				}
+
+				auto segment(int64_t begin, index_t size) const
+				{
+					return m_op(m_expr.segment(begin, size));
+				}
+
+			private:
+				E m_expr;
+				F m_op;
+			};
+
+			/** Elementwise function of two expressions of the same shape */
+			template <typename L, typename R, typename F>
+			class Binary : public Expression<Binary<L, R, F>>
+			{
+			public:
+				static_assert(
+				    std::is_same<
+				        typename L::Scalar, typename R::Scalar>::value,
+				    "linalg::lazy: operands of different types");
+
+				typedef typename L::Scalar Scalar;
+
+				Binary(const L& lhs, const R& rhs, F op)
+				    : m_lhs(lhs), m_rhs(rhs), m_op(op)
+				{
+					require(
+					    lhs.rows() == rhs.rows() && lhs.cols() == rhs.cols(),
+					    "Dimension mismatch! A({}x{}) vs B({}x{})",
+					    lhs.rows(), lhs.cols(), rhs.rows(), rhs.cols());
+				}
+
+				index_t rows() const
+				{
+					return m_lhs.rows();
+				}
+
+				index_t cols() const
+				{
+					return m_lhs.cols();
+				}
+
+				auto segment(int64_t begin, index_t size) const
+				{
+					return m_op(
+					    m_lhs.segment(begin, size), m_rhs.segment(begin, size));
+				}
+
+			private:
+				L m_lhs;
+				R m_rhs;
+				F m_op;
+			};
+
+			template <typename E, typename F>
+			Unary<E, F> make_unary(const Expression<E>& a, F op)
+			{
+				return Unary<E, F>(a.derived(), op);
+			}
+
+			template <typename L, typename R, typename F>
+			Binary<L, R, F>
+			make_binary(const Expression<L>& a, const Expression<R>& b, F op)
+			{
+				return Binary<L, R, F>(a.derived(), b.derived(), op);
+			}
+
+			/** @return expression of the elements of a vector */
+			template <typename T>
+			Operand<T> ref(const SGVector<T>& a)
+			{
+				return Operand<T>(a.vector, a.vlen, 1);
+			}
+
+			/** @return expression of the elements of a matrix */
+			template <typename T>
+			Operand<T> ref(const SGMatrix<T>& a)
+			{
+				return Operand<T>(a.matrix, a.num_rows, a.num_cols);
+			}
+
+			/** @return expression of alpha * a + beta * b */
+			template <typename L, typename R>
+			auto
+			add(const Expression<L>& a, const Expression<R>& b,
+			    typename L::Scalar alpha = 1, typename L::Scalar beta = 1)
+			{
+				return make_binary(
+				    a, b, [alpha, beta](const auto& x, const auto& y) {
+					    return alpha * x + beta * y;
+				    });
+			}
+
+			/** @return expression of a .* b */
+			template <typename L, typename R>
+			auto element_prod(const Expression<L>& a, const Expression<R>& b)
+			{
+				return make_binary(a, b, [](const auto& x, const auto& y) {
+					return x * y;
+				});
+			}
+
+			/** @return expression of a ./ b */
+			template <typename L, typename R>
+			auto element_div(const Expression<L>& a, const Expression<R>& b)
+			{
+				return make_binary(a, b, [](const auto& x, const auto& y) {
+					return x / y;
+				});
+			}
+
+			/** @return expression of alpha * a */
+			template <typename E>
+			auto scale(const Expression<E>& a, typename E::Scalar alpha)
+			{
+				return make_unary(
+				    a, [alpha](const auto& x) { return alpha * x; });
+			}
+
+			/** @return expression of a + b for a scalar b */
+			template <typename E>
+			auto add_scalar(const Expression<E>& a, typename E::Scalar b)
+			{
+				return make_unary(a, [b](const auto& x) { return x + b; });
+			}
+
+			/** @return expression of exp(a) */
+			template <typename E>
+			auto exponent(const Expression<E>& a)
+			{
+				return make_unary(a, [](const auto& x) { return x.exp(); });
+			}
+
+			/** @return expression of log(a) */
+			template <typename E>
+			auto log(const Expression<E>& a)
+			{
+				return make_unary(a, [](const auto& x) { return x.log(); });
+			}
+
+			/** @return expression of sqrt(a) */
+			template <typename E>
+			auto sqrt(const Expression<E>& a)
+			{
+				return make_unary(a, [](const auto& x) { return x.sqrt(); });
+			}
+
+			/** @return expression of 1/(1+exp(-a)) */
+			template <typename E>
+			auto logistic(const Expression<E>& a)
+			{
+				typedef typename E::Scalar T;
+				return make_unary(a, [](const auto& x) {
+					return (T(1) + (-x).exp()).inverse();
+				});
+			}
+
+			/** @return expression of max(a, 0) */
+			template <typename E>
+			auto rectified_linear(const Expression<E>& a)
+			{
+				typedef typename E::Scalar T;
+				return make_unary(a, [](const auto& x) { return x.max(T(0)); });
+			}
+
+			template <typename L, typename R>
+			auto operator+(const Expression<L>& a, const Expression<R>& b)
+			{
+				return add(a, b);
+			}
+
+			template <typename L, typename R>
+			auto operator-(const Expression<L>& a, const Expression<R>& b)
+			{
+				return add(a, b, 1, -1);
+			}
+
+			template <typename L, typename R>
+			auto operator*(const Expression<L>& a, const Expression<R>& b)
+			{
+				return element_prod(a, b);
+			}
+
+			template <typename L, typename R>
+			auto operator/(const Expression<L>& a, const Expression<R>& b)
+			{
+				return element_div(a, b);
+			}
+
+			template <typename E>
+			auto operator-(const Expression<E>& a)
+			{
+				return scale(a, -1);
+			}
+
+			template <typename E>
+			auto operator*(const Expression<E>& a, typename E::Scalar alpha)
+			{
+				return scale(a, alpha);
+			}
+
+			template <typename E>
+			auto operator*(typename E::Scalar alpha, const Expression<E>& a)
+			{
+				return scale(a, alpha);
+			}
+
+			template <typename E>
+			auto operator+(const Expression<E>& a, typename E::Scalar b)
+			{
+				return add_scalar(a, b);
+			}
+
+			template <typename E>
+			auto operator+(typename E::Scalar b, const Expression<E>& a)
+			{
+				return add_scalar(a, b);
+			}
+
+			template <typename E>
+			auto operator-(const Expression<E>& a, typename E::Scalar b)
+			{
+				return add_scalar(a, -b);
+			}
+
+			template <typename E>
+			auto operator-(typename E::Scalar b, const Expression<E>& a)
+			{
+				return make_unary(a, [b](const auto& x) { return b - x; });
+			}
+
+			/** Evaluates an expression into memory of its size */
+			template <typename E>
+			void eval_blocks(const E& expr, typename E::Scalar* result)
+			{
+				typedef typename E::Scalar T;
+				const int64_t size = int64_t(expr.rows()) * expr.cols();
+				const int64_t num_blocks =
+				    (size + EVAL_BLOCK_SIZE - 1) / EVAL_BLOCK_SIZE;
+
+#pragma omp parallel for if (num_blocks > 1)
+				for (int64_t b = 0; b < num_blocks; ++b)
+				{
+					const int64_t begin = b * EVAL_BLOCK_SIZE;
+					const index_t size_b =
+					    std::min(EVAL_BLOCK_SIZE, size - begin);
+					Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>(
+					    result + begin, size_b) = expr.segment(begin, size_b);
+				}
+			}
+
+			/** Evaluates an expression in one pass.
+			 *
+			 * @param expr Expression with as many rows as the vector and one
+			 * column
+			 * @param result Pre-allocated vector, may be an operand of expr
+			 */
+			template <typename E, typename T>
+			void eval(const Expression<E>& expr, SGVector<T>& result)
+			{
+				static_assert(
+				    std::is_same<typename E::Scalar, T>::value,
+				    "linalg::lazy::eval: result of different type");
+
+				const auto& e = expr.derived();
+				require(
+				    e.rows() == result.vlen && e.cols() == 1,
+				    "Dimension mismatch! Expression ({}x{}) vs result "
+				    "vector ({}).",
+				    e.rows(), e.cols(), result.vlen);
+				eval_blocks(e, result.vector);
+			}
+
+			/** Evaluates an expression in one pass.
+			 *
+			 * @param expr Expression of the shape of the matrix
+			 * @param result Pre-allocated matrix, may be an operand of expr
+			 */
+			template <typename E, typename T>
+			void eval(const Expression<E>& expr, SGMatrix<T>& result)
+			{
+				static_assert(
+				    std::is_same<typename E::Scalar, T>::value,
+				    "linalg::lazy::eval: result of different type");
+
+				const auto& e = expr.derived();
+				require(
+				    e.rows() == result.num_rows && e.cols() == result.num_cols,
+				    "Dimension mismatch! Expression ({}x{}) vs result "
+				    "matrix ({}x{}).",
+				    e.rows(), e.cols(), result.num_rows, result.num_cols);
+				eval_blocks(e, result.matrix);
+			}
+		}
+	}
+}
+
+#endif // LINALG_LAZY_H_
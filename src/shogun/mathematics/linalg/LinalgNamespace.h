@@ -1676,6 +1676,275 @@ namespace shogun
 			add(temp_matrix, c, c, alpha, beta);
 		}
 
+		/**
+		 * Sparse vector dot-product with a dense vector. b has to be at
+		 * least as long as the largest feature index of a.
+		 *
+		 * @param a Sparse vector
+		 * @param b Dense vector
+		 * @return The dot product of \f$\mathbf{a}\f$ and \f$\mathbf{b}\f$
+		 */
+		template <typename T>
+		T dot(const SGSparseVector<T>& a, const SGVector<T>& b)
+		{
+			for (index_t k = 0; k < a.num_feat_entries; ++k)
+			{
+				require(
+				    a.features[k].feat_index >= 0 &&
+				        a.features[k].feat_index < b.vlen,
+				    "Feature index {} of sparse vector a is out of bounds of "
+				    "vector b of length {}.",
+				    a.features[k].feat_index, b.vlen);
+			}
+
+			return env()->linalg()->get_cpu_backend()->dot(a, b);
+		}
+
+		/**
+		 * Performs the operation \f$x = Ab\f$ with a sparse matrix A.
+		 * This version returns the result in-place.
+		 * User should pass an appropriately allocated memory vector.
+		 *
+		 * @param A The sparse matrix
+		 * @param b The vector
+		 * @param result Result vector
+		 * @param transpose Whether to transpose the matrix. Default false
+		 */
+		template <typename T>
+		void matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGVector<T>& b,
+		    SGVector<T>& result, bool transpose = false)
+		{
+			if (transpose)
+			{
+				require(
+				    A.num_features == b.vlen,
+				    "Row number of sparse matrix A ({}) doesn't match length "
+				    "of vector b ({}).",
+				    A.num_features, b.vlen);
+				require(
+				    result.vlen == A.num_vectors,
+				    "Length of vector result ({}) doesn't match column number "
+				    "of sparse matrix A ({}).",
+				    result.vlen, A.num_vectors);
+			}
+			else
+			{
+				require(
+				    A.num_vectors == b.vlen,
+				    "Column number of sparse matrix A ({}) doesn't match "
+				    "length of vector b ({}).",
+				    A.num_vectors, b.vlen);
+				require(
+				    result.vlen == A.num_features,
+				    "Length of vector result ({}) doesn't match row number of "
+				    "sparse matrix A ({}).",
+				    result.vlen, A.num_features);
+			}
+
+			env()->linalg()->get_cpu_backend()->matrix_prod(
+			    A, b, result, transpose);
+		}
+
+		/**
+		 * Performs the operation \f$x = Ab\f$ with a sparse matrix A.
+		 * This version returns the result in a newly created vector.
+		 *
+		 * @param A The sparse matrix
+		 * @param b The vector
+		 * @param transpose Whether to transpose the matrix. Default false
+		 * @return result Result vector
+		 */
+		template <typename T>
+		SGVector<T> matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGVector<T>& b,
+		    bool transpose = false)
+		{
+			SGVector<T> result(transpose ? A.num_vectors : A.num_features);
+			matrix_prod(A, b, result, transpose);
+			return result;
+		}
+
+		/**
+		 * Performs the operation C = A * B with a sparse matrix A and a dense
+		 * matrix B.
+		 * This version returns the result in-place.
+		 * User should pass an appropriately allocated memory matrix.
+		 *
+		 * @param A The sparse matrix
+		 * @param B The dense matrix
+		 * @param result Result matrix
+		 * @param transpose Whether to transpose the sparse matrix. Default
+		 * false
+		 */
+		template <typename T>
+		void matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGMatrix<T>& B,
+		    SGMatrix<T>& result, bool transpose = false)
+		{
+			auto rows_A = transpose ? A.num_vectors : A.num_features;
+			auto cols_A = transpose ? A.num_features : A.num_vectors;
+			require(
+			    cols_A == B.num_rows,
+			    "Number of columns of sparse matrix A ({}) doesn't match "
+			    "number of rows of matrix B ({}).",
+			    cols_A, B.num_rows);
+			require(
+			    result.num_rows == rows_A && result.num_cols == B.num_cols,
+			    "Dimension mismatch! Result matrix is {}x{}, expected {}x{}.",
+			    result.num_rows, result.num_cols, rows_A, B.num_cols);
+
+			env()->linalg()->get_cpu_backend()->matrix_prod(
+			    A, B, result, transpose);
+		}
+
+		/**
+		 * Performs the operation C = A * B with a sparse matrix A and a dense
+		 * matrix B.
+		 * This version returns the result in a newly created matrix.
+		 *
+		 * @param A The sparse matrix
+		 * @param B The dense matrix
+		 * @param transpose Whether to transpose the sparse matrix. Default
+		 * false
+		 * @return Result matrix
+		 */
+		template <typename T>
+		SGMatrix<T> matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGMatrix<T>& B,
+		    bool transpose = false)
+		{
+			SGMatrix<T> result(
+			    transpose ? A.num_vectors : A.num_features, B.num_cols);
+			matrix_prod(A, B, result, transpose);
+			return result;
+		}
+
+		/**
+		 * Performs the operation result = alpha * a + beta * b with a sparse
+		 * matrix a and a dense matrix b.
+		 * This version returns the result in-place.
+		 * User should pass an appropriately pre-allocated memory matrix
+		 * Or pass the operand b as a result
+		 *
+		 * @param a Sparse matrix
+		 * @param b Dense matrix
+		 * @param result The matrix that saves the result
+		 * @param alpha Constant to be multiplied by the sparse matrix
+		 * @param beta Constant to be multiplied by the dense matrix
+		 */
+		template <typename T>
+		void add(
+		    const SGSparseMatrix<T>& a, const SGMatrix<T>& b,
+		    SGMatrix<T>& result, T alpha = 1, T beta = 1)
+		{
+			require(
+			    a.num_features == b.num_rows && a.num_vectors == b.num_cols,
+			    "Dimension mismatch! Sparse matrix a is {}x{}, matrix b is "
+			    "{}x{}.",
+			    a.num_features, a.num_vectors, b.num_rows, b.num_cols);
+			require(
+			    result.num_rows == b.num_rows && result.num_cols == b.num_cols,
+			    "Dimension mismatch! Result matrix is {}x{}, expected {}x{}.",
+			    result.num_rows, result.num_cols, b.num_rows, b.num_cols);
+
+			env()->linalg()->get_cpu_backend()->add(a, b, alpha, beta, result);
+		}
+
+		/**
+		 * Performs the operation C = alpha * A + beta * B with a sparse
+		 * matrix A and a dense matrix B.
+		 * This version returns the result in a newly created matrix.
+		 *
+		 * @param a Sparse matrix
+		 * @param b Dense matrix
+		 * @param alpha Constant to be multiplied by the sparse matrix
+		 * @param beta Constant to be multiplied by the dense matrix
+		 * @return The result matrix
+		 */
+		template <typename T>
+		SGMatrix<T>
+		add(const SGSparseMatrix<T>& a, const SGMatrix<T>& b, T alpha = 1,
+		    T beta = 1)
+		{
+			SGMatrix<T> result(b.num_rows, b.num_cols);
+			add(a, b, result, alpha, beta);
+			return result;
+		}
+
+		/**
+		 * Performs the operation result = alpha * A on sparse matrices.
+		 * The result has to have the same sparsity pattern as A, e.g. be A
+		 * itself or a copy of it.
+		 *
+		 * @param A Sparse matrix
+		 * @param result The sparse matrix of alpha * A
+		 * @param alpha Scale factor
+		 */
+		template <typename T>
+		void scale(
+		    const SGSparseMatrix<T>& A, SGSparseMatrix<T>& result, T alpha = 1)
+		{
+			require(
+			    A.num_vectors == result.num_vectors,
+			    "Number of columns of sparse matrix A ({}) must match "
+			    "sparse matrix result ({}).",
+			    A.num_vectors, result.num_vectors);
+			for (index_t i = 0; i < A.num_vectors; ++i)
+			{
+				require(
+				    A[i].num_feat_entries == result[i].num_feat_entries,
+				    "Column {} of sparse matrix result has {} non-zero "
+				    "entries, sparse matrix A has {}.",
+				    i, result[i].num_feat_entries, A[i].num_feat_entries);
+			}
+
+			env()->linalg()->get_cpu_backend()->scale(A, alpha, result);
+		}
+
+		/**
+		 * Performs the operation B = alpha * A on sparse matrices.
+		 * This version returns the result in a newly created sparse matrix.
+		 *
+		 * @param A Sparse matrix
+		 * @param alpha Scale factor
+		 * @return Sparse matrix of alpha * A
+		 */
+		template <typename T>
+		SGSparseMatrix<T> scale(const SGSparseMatrix<T>& A, T alpha = 1)
+		{
+			SGSparseMatrix<T> result(A.num_features, A.num_vectors);
+			for (index_t i = 0; i < A.num_vectors; ++i)
+				result[i] = A[i].clone();
+
+			scale(A, result, alpha);
+			return result;
+		}
+
+		/**
+		 * Sums the columns of a sparse matrix.
+		 *
+		 * @param A Sparse matrix
+		 * @return Vector with the sum of every column
+		 */
+		template <typename T>
+		SGVector<T> colwise_sum(const SGSparseMatrix<T>& A)
+		{
+			return env()->linalg()->get_cpu_backend()->colwise_sum(A);
+		}
+
+		/**
+		 * Sums the rows of a sparse matrix.
+		 *
+		 * @param A Sparse matrix
+		 * @return Vector with the sum of every row
+		 */
+		template <typename T>
+		SGVector<T> rowwise_sum(const SGSparseMatrix<T>& A)
+		{
+			return env()->linalg()->get_cpu_backend()->rowwise_sum(A);
+		}
+
 		/**
 		 * Returns the largest element in a vector or matrix
 		 *
@@ -2113,6 +2382,31 @@ namespace shogun
 			return env()->linalg()->get_cpu_backend()->rowwise_sum(a, no_diag);
 		}
 
+		/**
+		 * Method that computes the squared Euclidean distances between the
+		 * columns of two matrices as
+		 * \f$d_{i,j}=||a_i||^2+||b_j||^2-2a_i^Tb_j\f$, i.e. with a single
+		 * matrix product. Cancellation may leave tiny negative values for
+		 * close points, which are clamped to zero.
+		 *
+		 * @param A matrix with one point per column
+		 * @param B matrix with one point per column, as many rows as A
+		 * @param result pre-allocated matrix of size A.num_cols x B.num_cols
+		 */
+		template <typename T>
+		void squared_distances(
+		    const SGMatrix<T>& A, const SGMatrix<T>& B, SGMatrix<T>& result)
+		{
+			matrix_prod(A, B, result, true, false);
+
+			auto a_sq = colwise_sum(element_prod(A, A));
+			auto b_sq = colwise_sum(element_prod(B, B));
+			for (index_t j = 0; j < result.num_cols; ++j)
+				for (index_t i = 0; i < result.num_rows; ++i)
+					result(i, j) =
+					    Math::max(a_sq[i] + b_sq[j] - 2 * result(i, j), T(0));
+		}
+
 		/**
 		 * Compute the singular value decomposition \f$A = U S V^{*}\f$ of a
 		 * matrix.
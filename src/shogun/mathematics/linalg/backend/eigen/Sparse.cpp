@@ -0,0 +1,273 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/mathematics/linalg/LinalgBackendEigen.h>
+#include <shogun/mathematics/linalg/LinalgMacros.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+/** The sparse matrices are stored column by column, like Eigen's compressed
+ * column storage, so the operations below work on them directly instead of
+ * copying them to an Eigen::SparseMatrix first. Operations over matrices with
+ * at least this many columns run in parallel.
+ */
+static constexpr index_t SPARSE_PARALLEL_MIN_VECTORS = 256;
+
+/** Maximum number of partial results that a product scattering columns into
+ * rows is split into. The number of partials only depends on the shape of
+ * the matrix, and they are summed in a fixed order, so the result does not
+ * depend on the number of threads.
+ */
+static constexpr index_t SPARSE_MAX_PARTIALS = 16;
+
+#define BACKEND_GENERIC_SPARSE_ADD(Type, Container)                            \
+	void LinalgBackendEigen::add(                                              \
+	    const Container<Type>& a, const SGMatrix<Type>& b, Type alpha,         \
+	    Type beta, SGMatrix<Type>& result) const                               \
+	{                                                                          \
+		add_impl(a, b, alpha, beta, result);                                   \
+	}
+DEFINE_FOR_NON_INTEGER_REAL_PTYPE(BACKEND_GENERIC_SPARSE_ADD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_ADD
+
+#define BACKEND_GENERIC_SPARSE_DOT(Type, Container)                            \
+	Type LinalgBackendEigen::dot(                                              \
+	    const Container<Type>& a, const SGVector<Type>& b) const               \
+	{                                                                          \
+		return dot_impl(a, b);                                                 \
+	}
+DEFINE_FOR_NON_INTEGER_REAL_PTYPE(BACKEND_GENERIC_SPARSE_DOT, SGSparseVector)
+#undef BACKEND_GENERIC_SPARSE_DOT
+
+#define BACKEND_GENERIC_SPARSE_MATRIX_PROD(Type, Container)                    \
+	void LinalgBackendEigen::matrix_prod(                                      \
+	    const Container<Type>& a, const SGVector<Type>& b,                     \
+	    SGVector<Type>& result, bool transpose) const                          \
+	{                                                                          \
+		matrix_prod_impl(a, b, result, transpose);                             \
+	}                                                                          \
+	void LinalgBackendEigen::matrix_prod(                                      \
+	    const Container<Type>& a, const SGMatrix<Type>& b,                     \
+	    SGMatrix<Type>& result, bool transpose) const                          \
+	{                                                                          \
+		matrix_prod_impl(a, b, result, transpose);                             \
+	}
+DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+    BACKEND_GENERIC_SPARSE_MATRIX_PROD, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_MATRIX_PROD
+
+#define BACKEND_GENERIC_SPARSE_SCALE(Type, Container)                          \
+	void LinalgBackendEigen::scale(                                            \
+	    const Container<Type>& a, Type alpha, Container<Type>& result) const   \
+	{                                                                          \
+		scale_impl(a, alpha, result);                                          \
+	}
+DEFINE_FOR_NON_INTEGER_REAL_PTYPE(BACKEND_GENERIC_SPARSE_SCALE, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_SCALE
+
+#define BACKEND_GENERIC_SPARSE_COLWISE_SUM(Type, Container)                    \
+	SGVector<Type> LinalgBackendEigen::colwise_sum(const Container<Type>& a)   \
+	    const                                                                  \
+	{                                                                          \
+		return colwise_sum_impl(a);                                            \
+	}
+DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+    BACKEND_GENERIC_SPARSE_COLWISE_SUM, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_COLWISE_SUM
+
+#define BACKEND_GENERIC_SPARSE_ROWWISE_SUM(Type, Container)                    \
+	SGVector<Type> LinalgBackendEigen::rowwise_sum(const Container<Type>& a)   \
+	    const                                                                  \
+	{                                                                          \
+		return rowwise_sum_impl(a);                                            \
+	}
+DEFINE_FOR_NON_INTEGER_REAL_PTYPE(
+    BACKEND_GENERIC_SPARSE_ROWWISE_SUM, SGSparseMatrix)
+#undef BACKEND_GENERIC_SPARSE_ROWWISE_SUM
+
+#undef DEFINE_FOR_NON_INTEGER_REAL_PTYPE
+
+template <typename T>
+void LinalgBackendEigen::add_impl(
+    const SGSparseMatrix<T>& a, const SGMatrix<T>& b, T alpha, T beta,
+    SGMatrix<T>& result) const
+{
+	typename SGMatrix<T>::EigenMatrixXtMap b_eig = b;
+	typename SGMatrix<T>::EigenMatrixXtMap result_eig = result;
+
+	result_eig = beta * b_eig;
+
+#pragma omp parallel for if (a.num_vectors >= SPARSE_PARALLEL_MIN_VECTORS)
+	for (index_t i = 0; i < a.num_vectors; ++i)
+	{
+		const auto& vec = a[i];
+		auto col = result.get_column_vector(i);
+		for (index_t k = 0; k < vec.num_feat_entries; ++k)
+			col[vec.features[k].feat_index] += alpha * vec.features[k].entry;
+	}
+}
+
+template <typename T>
+T LinalgBackendEigen::dot_impl(
+    const SGSparseVector<T>& a, const SGVector<T>& b) const
+{
+	T result = 0;
+	for (index_t k = 0; k < a.num_feat_entries; ++k)
+		result += a.features[k].entry * b.vector[a.features[k].feat_index];
+
+	return result;
+}
+
+template <typename T>
+void LinalgBackendEigen::matrix_prod_impl(
+    const SGSparseMatrix<T>& a, const SGVector<T>& b, SGVector<T>& result,
+    bool transpose) const
+{
+	if (transpose)
+	{
+#pragma omp parallel for if (a.num_vectors >= SPARSE_PARALLEL_MIN_VECTORS)
+		for (index_t i = 0; i < a.num_vectors; ++i)
+			result[i] = dot_impl(a[i], b);
+
+		return;
+	}
+
+	typename SGVector<T>::EigenVectorXtMap result_eig = result;
+	result_eig.setZero();
+
+	// columns scatter into arbitrary rows, so blocks of columns accumulate
+	// into their own partial result
+	auto num_partials = std::min(
+	    a.num_vectors / SPARSE_PARALLEL_MIN_VECTORS, SPARSE_MAX_PARTIALS);
+	if (num_partials < 2)
+	{
+		for (index_t i = 0; i < a.num_vectors; ++i)
+		{
+			const auto& vec = a[i];
+			for (index_t k = 0; k < vec.num_feat_entries; ++k)
+				result[vec.features[k].feat_index] +=
+				    vec.features[k].entry * b[i];
+		}
+		return;
+	}
+
+	typename SGMatrix<T>::EigenMatrixXt partials =
+	    SGMatrix<T>::EigenMatrixXt::Zero(a.num_features, num_partials);
+
+#pragma omp parallel for
+	for (index_t p = 0; p < num_partials; ++p)
+	{
+		auto end = int64_t(a.num_vectors) * (p + 1) / num_partials;
+		for (index_t i = int64_t(a.num_vectors) * p / num_partials; i < end;
+		     ++i)
+		{
+			const auto& vec = a[i];
+			for (index_t k = 0; k < vec.num_feat_entries; ++k)
+				partials(vec.features[k].feat_index, p) +=
+				    vec.features[k].entry * b[i];
+		}
+	}
+
+	for (index_t p = 0; p < num_partials; ++p)
+		result_eig += partials.col(p);
+}
+
+template <typename T>
+void LinalgBackendEigen::matrix_prod_impl(
+    const SGSparseMatrix<T>& a, const SGMatrix<T>& b, SGMatrix<T>& result,
+    bool transpose) const
+{
+	if (transpose)
+	{
+#pragma omp parallel for if (a.num_vectors >= SPARSE_PARALLEL_MIN_VECTORS)
+		for (index_t i = 0; i < a.num_vectors; ++i)
+		{
+			const auto& vec = a[i];
+			for (index_t j = 0; j < b.num_cols; ++j)
+			{
+				auto b_col = b.get_column_vector(j);
+				T sum = 0;
+				for (index_t k = 0; k < vec.num_feat_entries; ++k)
+					sum += vec.features[k].entry *
+					       b_col[vec.features[k].feat_index];
+				result(i, j) = sum;
+			}
+		}
+
+		return;
+	}
+
+	typename SGMatrix<T>::EigenMatrixXtMap result_eig = result;
+	result_eig.setZero();
+
+	// every column of the result is written by one thread only
+#pragma omp parallel for if (b.num_cols >= SPARSE_PARALLEL_MIN_VECTORS)
+	for (index_t j = 0; j < b.num_cols; ++j)
+	{
+		auto b_col = b.get_column_vector(j);
+		auto result_col = result.get_column_vector(j);
+		for (index_t i = 0; i < a.num_vectors; ++i)
+		{
+			if (b_col[i] == 0)
+				continue;
+
+			const auto& vec = a[i];
+			for (index_t k = 0; k < vec.num_feat_entries; ++k)
+				result_col[vec.features[k].feat_index] +=
+				    vec.features[k].entry * b_col[i];
+		}
+	}
+}
+
+template <typename T>
+void LinalgBackendEigen::scale_impl(
+    const SGSparseMatrix<T>& a, T alpha, SGSparseMatrix<T>& result) const
+{
+#pragma omp parallel for if (a.num_vectors >= SPARSE_PARALLEL_MIN_VECTORS)
+	for (index_t i = 0; i < a.num_vectors; ++i)
+	{
+		const auto& vec = a[i];
+		auto& result_vec = result[i];
+		for (index_t k = 0; k < vec.num_feat_entries; ++k)
+			result_vec.features[k].entry = alpha * vec.features[k].entry;
+	}
+}
+
+template <typename T>
+SGVector<T>
+LinalgBackendEigen::colwise_sum_impl(const SGSparseMatrix<T>& a) const
+{
+	SGVector<T> result(a.num_vectors);
+
+#pragma omp parallel for if (a.num_vectors >= SPARSE_PARALLEL_MIN_VECTORS)
+	for (index_t i = 0; i < a.num_vectors; ++i)
+	{
+		const auto& vec = a[i];
+		T sum = 0;
+		for (index_t k = 0; k < vec.num_feat_entries; ++k)
+			sum += vec.features[k].entry;
+		result[i] = sum;
+	}
+
+	return result;
+}
+
+template <typename T>
+SGVector<T>
+LinalgBackendEigen::rowwise_sum_impl(const SGSparseMatrix<T>& a) const
+{
+	SGVector<T> result(a.num_features);
+	result.zero();
+
+	for (index_t i = 0; i < a.num_vectors; ++i)
+	{
+		const auto& vec = a[i];
+		for (index_t k = 0; k < vec.num_feat_entries; ++k)
+			result[vec.features[k].feat_index] += vec.features[k].entry;
+	}
+
+	return result;
+}
@@ -19,6 +19,10 @@
 
 //#define DEBUG_KNN
 
+// test examples per progress step, many distance tiles such that all
+// threads are busy in between
+static constexpr index_t KNN_CHUNK_SIZE=4096;
+
 using namespace shogun;
 
 KNN::KNN()
@@ -115,41 +119,32 @@ SGMatrix<index_t> KNN::nearest_neighbors()
 	    n >= m_k,
 	    "K ({}) must not be larger than the number of examples ({}).", m_k, n);
 
-	//distances to train data
-	SGVector<float64_t> dists(m_train_labels.vlen);
-	//indices to train data
-	SGVector<index_t> train_idxs(m_train_labels.vlen);
-	//pre-allocation of the nearest neighbors
-	SGMatrix<index_t> NN(m_k, n);
-
 	distance->precompute_lhs();
 	distance->precompute_rhs();
 
-	//for each test example
-	for (auto i : SG_PROGRESS(range(n)))
+	//indices of the nearest train examples of each test example, computed
+	//from tiles of train-to-test distances
+	SGMatrix<index_t> NN(m_k, n);
+	const index_t num_chunks=(n+KNN_CHUNK_SIZE-1)/KNN_CHUNK_SIZE;
+	for (auto c : SG_PROGRESS(range(num_chunks)))
 	{
 		COMPUTATION_CONTROLLERS
-		//lhs idx 0..num train examples-1 (i.e., all train examples) and rhs idx i
-		distances_lhs(dists,0,m_train_labels.vlen-1,i);
-
-		//fill in an array with 0..num train examples-1
-		for (int32_t j=0; j<m_train_labels.vlen; j++)
-			train_idxs[j]=j;
-
-		//sort the distance vector between test example i and all train examples
-		Math::qsort_index(dists.vector, train_idxs.vector, m_train_labels.vlen);
+		const index_t begin=c*KNN_CHUNK_SIZE;
+		const index_t end=Math::min(begin+KNN_CHUNK_SIZE, index_t(n));
+		SGMatrix<index_t> chunk=distance->k_nearest_lhs(m_k, begin, end);
+		sg_memcpy(NN.get_column_vector(begin), chunk.matrix,
+			sizeof(index_t)*m_k*(end-begin));
+	}
 
 #ifdef DEBUG_KNN
-		io::print("\nQuick sort query {}\n", i);
+	for (int32_t i=0; i<n; i++)
+	{
+		io::print("\nNearest neighbors of query {}\n", i);
 		for (int32_t j=0; j<m_k; j++)
-			io::print("{} ", train_idxs[j]);
+			io::print("{} ", NN(j,i));
 		io::print("\n");
-#endif
-
-		//fill in the output the indices of the nearest neighbors
-		for (int32_t j=0; j<m_k; j++)
-			NN(j,i) = train_idxs[j];
 	}
+#endif
 
 	distance->reset_precompute();
 
@@ -194,36 +189,26 @@ std::shared_ptr<MulticlassLabels> KNN::classify_NN()
 	require(num_lab, "No vectors on right hand side");
 
 	auto output = std::make_shared<MulticlassLabels>(num_lab);
-	SGVector<float64_t> distances(m_train_labels.vlen);
 
 	io::info("{} test examples", num_lab);
 
 	distance->precompute_lhs();
 
-	// for each test example
-	for (auto i : SG_PROGRESS(range(num_lab)))
+	// nearest train example of every test example
+	const index_t num_chunks=(num_lab+KNN_CHUNK_SIZE-1)/KNN_CHUNK_SIZE;
+	for (auto c : SG_PROGRESS(range(num_chunks)))
 	{
 		COMPUTATION_CONTROLLERS
-		// get distances from i-th test example to 0..num_m_train_labels-1 train examples
-		distances_lhs(distances,0,m_train_labels.vlen-1,i);
-		int32_t j;
-
-		// assuming 0th train examples as nearest to i-th test example
-		int32_t out_idx = 0;
-		float64_t min_dist = distances.vector[0];
+		const index_t begin=c*KNN_CHUNK_SIZE;
+		const index_t end=Math::min(begin+KNN_CHUNK_SIZE, index_t(num_lab));
+		SGVector<float64_t> min_dists;
+		SGVector<index_t> nearest=distance->nearest_lhs(min_dists, begin, end);
 
-		// searching for nearest neighbor by comparing distances
-		for (j=0; j<m_train_labels.vlen; j++)
+		for (index_t i=begin; i<end; i++)
 		{
-			if (distances.vector[j]<min_dist)
-			{
-				min_dist = distances.vector[j];
-				out_idx = j;
-			}
+			output->set_label(
+				i, m_train_labels.vector[nearest[i-begin]]+m_min_label);
 		}
-
-		// label i-th test example with label of nearest neighbor with out_idx index
-		output->set_label(i,m_train_labels.vector[out_idx]+m_min_label);
 	}
 
 	distance->reset_precompute();
@@ -0,0 +1,99 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/io/SGIO.h>
+#include <shogun/multiclass/tree/BinnedFeatureMatrix.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+BinnedFeatureMatrix::BinnedFeatureMatrix(
+	const SGMatrix<float64_t>& mat, int32_t max_bins, float64_t missing,
+	float64_t eq_delta)
+	: m_num_features(mat.num_rows), m_num_vectors(mat.num_cols),
+	  m_max_bins(max_bins)
+{
+	require(max_bins>=2 && max_bins<=65535,
+		"Number of bins ({}) must be in [2, 65535]", max_bins);
+
+	auto num_codes=int64_t(m_num_features)*m_num_vectors;
+	// the largest code is reserved for missing values
+	if (max_bins<=255)
+		m_codes8.resize(num_codes);
+	else
+		m_codes16.resize(num_codes);
+
+	std::vector<std::vector<float64_t>> upper(m_num_features);
+#pragma omp parallel for
+	for (index_t f=0; f<m_num_features; f++)
+	{
+		if (m_codes8.empty())
+			bin_feature(mat, f, missing, eq_delta, upper[f], m_codes16.data());
+		else
+			bin_feature(mat, f, missing, eq_delta, upper[f], m_codes8.data());
+	}
+
+	m_bin_offsets.resize(m_num_features+1, 0);
+	for (index_t f=0; f<m_num_features; f++)
+	{
+		m_bin_offsets[f+1]=m_bin_offsets[f]+upper[f].size();
+		m_bin_upper.insert(m_bin_upper.end(), upper[f].begin(), upper[f].end());
+	}
+}
+
+template <class C>
+void BinnedFeatureMatrix::bin_feature(
+	const SGMatrix<float64_t>& mat, index_t feat, float64_t missing,
+	float64_t eq_delta, std::vector<float64_t>& upper, C* codes) const
+{
+	std::vector<float64_t> values;
+	values.reserve(m_num_vectors);
+	for (index_t i=0; i<m_num_vectors; i++)
+	{
+		if (mat(feat, i)!=missing)
+			values.push_back(mat(feat, i));
+	}
+	std::sort(values.begin(), values.end());
+
+	// largest value of every group of equal values
+	std::vector<float64_t> group_upper;
+	if (!values.empty())
+	{
+		float64_t z=values[0];
+		for (size_t j=1; j<values.size(); j++)
+		{
+			if (values[j]<=z+eq_delta)
+				continue;
+
+			group_upper.push_back(values[j-1]);
+			z=values[j];
+		}
+		group_upper.push_back(values.back());
+	}
+
+	if (group_upper.size()<=size_t(m_max_bins))
+		upper=std::move(group_upper);
+	else
+	{
+		// bins end at quantiles, moved to the end of their group
+		for (int64_t k=1; k<=m_max_bins; k++)
+		{
+			auto q=values[k*values.size()/m_max_bins-1];
+			auto g=*std::lower_bound(group_upper.begin(), group_upper.end(), q);
+			if (upper.empty() || g>upper.back())
+				upper.push_back(g);
+		}
+	}
+
+	auto feat_codes=codes+int64_t(feat)*m_num_vectors;
+	for (index_t i=0; i<m_num_vectors; i++)
+	{
+		if (mat(feat, i)==missing)
+			feat_codes[i]=m_max_bins;
+		else
+			feat_codes[i]=std::lower_bound(upper.begin(), upper.end(),
+				mat(feat, i))-upper.begin();
+	}
+}
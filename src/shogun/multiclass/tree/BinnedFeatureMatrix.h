@@ -0,0 +1,123 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _BINNEDFEATUREMATRIX_H__
+#define _BINNEDFEATUREMATRIX_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+#include <shogun/lib/SGMatrix.h>
+
+#include <vector>
+
+namespace shogun
+{
+/** @brief Dense feature matrix whose values are replaced by the index of
+ * their quantile bin, as used for histogram based split finding in trees.
+ *
+ * Every feature is binned on its own. If a feature has at most max_bins
+ * distinct values, every value gets its own bin, otherwise the bin
+ * boundaries are placed at quantiles of the values, never splitting equal
+ * values. Each bin remembers the largest value that fell into it, so that
+ * a split after bin b corresponds to the threshold x <= get_bin_upper(f, b)
+ * on the original values.
+ *
+ * Codes are stored as uint8_t for up to 255 bins and as uint16_t
+ * otherwise. They are stored feature-major, i.e. the codes of all vectors
+ * for one feature are contiguous, so that building the histogram of a
+ * feature scans a single block of memory.
+ * Missing values (see CARTree::MISSING) are mapped to the code max_bins,
+ * which is larger than the code of every bin.
+ */
+class BinnedFeatureMatrix
+{
+public:
+	/** constructor
+	 *
+	 * @param mat feature matrix, one vector per column
+	 * @param max_bins maximum number of bins per feature, in [2, 65535]
+	 * @param missing value that marks a missing feature
+	 * @param eq_delta values that differ by at most this are considered equal
+	 */
+	BinnedFeatureMatrix(
+		const SGMatrix<float64_t>& mat, int32_t max_bins, float64_t missing,
+		float64_t eq_delta);
+
+	BinnedFeatureMatrix(const BinnedFeatureMatrix&)=delete;
+	BinnedFeatureMatrix& operator=(const BinnedFeatureMatrix&)=delete;
+
+	/** @return number of features */
+	index_t get_num_features() const { return m_num_features; }
+
+	/** @return number of vectors */
+	index_t get_num_vectors() const { return m_num_vectors; }
+
+	/** @return maximum number of bins, which is also the missing code */
+	int32_t get_max_bins() const { return m_max_bins; }
+
+	/** @param feat feature index
+	 * @return number of bins of the feature
+	 */
+	int32_t get_num_bins(index_t feat) const
+	{
+		return m_bin_offsets[feat+1]-m_bin_offsets[feat];
+	}
+
+	/** @param feat feature index
+	 * @param bin bin of the feature
+	 * @return largest value of the bin
+	 */
+	float64_t get_bin_upper(index_t feat, int32_t bin) const
+	{
+		return m_bin_upper[m_bin_offsets[feat]+bin];
+	}
+
+	/** @return whether codes are stored as uint8_t */
+	bool has_codes8() const { return !m_codes8.empty(); }
+
+	/** @return codes if stored as uint8_t, NULL otherwise. The code of
+	 * vector v for feature f is at f*get_num_vectors()+v.
+	 */
+	const uint8_t* get_codes8() const
+	{
+		return m_codes8.empty() ? NULL : m_codes8.data();
+	}
+
+	/** @return codes if stored as uint16_t, NULL otherwise */
+	const uint16_t* get_codes16() const
+	{
+		return m_codes16.empty() ? NULL : m_codes16.data();
+	}
+
+	/** @param feat feature index
+	 * @param vec vector index
+	 * @return bin of the value or get_max_bins() if it is missing
+	 */
+	int32_t get_code(index_t feat, index_t vec) const
+	{
+		auto pos=int64_t(feat)*m_num_vectors+vec;
+		return m_codes8.empty() ? m_codes16[pos] : m_codes8[pos];
+	}
+
+private:
+	template <class C>
+	void bin_feature(
+		const SGMatrix<float64_t>& mat, index_t feat, float64_t missing,
+		float64_t eq_delta, std::vector<float64_t>& upper, C* codes) const;
+
+	index_t m_num_features;
+	index_t m_num_vectors;
+	int32_t m_max_bins;
+
+	/** bins of feature f are [m_bin_offsets[f], m_bin_offsets[f+1]) */
+	std::vector<int64_t> m_bin_offsets;
+	/** largest value of every bin */
+	std::vector<float64_t> m_bin_upper;
+
+	std::vector<uint8_t> m_codes8;
+	std::vector<uint16_t> m_codes16;
+};
+}
+#endif /* _BINNEDFEATUREMATRIX_H__ */
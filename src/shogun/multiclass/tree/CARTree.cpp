@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/lib/View.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/RandomNamespace.h>
@@ -37,6 +38,11 @@
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/multiclass/tree/CARTree.h>
 #include <shogun/multiclass/tree/FeatureImportanceTree.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
 
 using namespace Eigen;
 using namespace shogun;
@@ -193,7 +199,9 @@ void CARTree::clear_weights()
 
 void CARTree::set_feature_types(SGVector<bool> ft)
 {
+	std::lock_guard<std::mutex> lock(m_flat_tree_lock);
 	m_nominal=ft;
+	m_flat_tree=nullptr;
 }
 
 SGVector<bool> CARTree::get_feature_types() const
@@ -203,7 +211,9 @@ SGVector<bool> CARTree::get_feature_types() const
 
 void CARTree::clear_feature_types()
 {
+	std::lock_guard<std::mutex> lock(m_flat_tree_lock);
 	m_nominal=SGVector<bool>();
+	m_flat_tree=nullptr;
 }
 
 int32_t CARTree::get_num_folds() const
@@ -245,6 +255,60 @@ void CARTree::set_label_epsilon(float64_t ep)
 	m_label_epsilon=ep;
 }
 
+void CARTree::set_num_bins(int32_t bins)
+{
+	require(bins==0 || (bins>=2 && bins<=65535),
+		"Number of bins should be 0 or in [2, 65535]. Supplied value is {}", bins);
+	m_num_bins=bins;
+}
+
+int32_t CARTree::get_num_bins() const
+{
+	return m_num_bins;
+}
+
+void CARTree::set_histogram_threshold(index_t num_vectors)
+{
+	require(num_vectors>=0,"Histogram threshold should not be negative. Supplied value is {}",num_vectors);
+	m_histogram_threshold=num_vectors;
+}
+
+index_t CARTree::get_histogram_threshold() const
+{
+	return m_histogram_threshold;
+}
+
+bool CARTree::use_histograms(index_t num_vectors) const
+{
+	if (m_num_bins==0 || num_vectors<m_histogram_threshold)
+		return false;
+
+	return std::none_of(m_nominal.begin(), m_nominal.end(), [](bool b) { return b; });
+}
+
+void CARTree::set_parallel_node_size(index_t num_vectors)
+{
+	require(num_vectors>=0,"Parallel node size should not be negative. Supplied value is {}",num_vectors);
+	m_parallel_node_size=num_vectors;
+}
+
+index_t CARTree::get_parallel_node_size() const
+{
+	return m_parallel_node_size;
+}
+
+std::shared_ptr<BinnedFeatureMatrix> CARTree::bin_features(const std::shared_ptr<Features>& data) const
+{
+	require(m_num_bins>0, "Histogram split finding is disabled");
+	auto mat=data->as<DenseFeatures<float64_t>>()->get_feature_matrix();
+	return std::make_shared<BinnedFeatureMatrix>(mat, m_num_bins, MISSING, EQ_DELTA);
+}
+
+void CARTree::set_binned_features(std::shared_ptr<BinnedFeatureMatrix> binned)
+{
+	m_binned_features=std::move(binned);
+}
+
 bool CARTree::types_set()
 {
 	return m_nominal.size() != 0;
@@ -260,6 +324,12 @@ bool CARTree::train_machine(std::shared_ptr<Features> data)
 	require(data,"Data required for training");
 	require(data->get_feature_class()==C_DENSE,"Dense data required for training");
 
+	{
+		std::lock_guard<std::mutex> lock(m_flat_tree_lock);
+		m_flat_tree=nullptr;
+		m_flat_root=nullptr;
+	}
+
 	auto dense_features = data->as<DenseFeatures<float64_t>>();
 	auto num_features = dense_features->get_num_features();
 	auto num_vectors = dense_features->get_num_vectors();
@@ -293,12 +363,54 @@ bool CARTree::train_machine(std::shared_ptr<Features> data)
 	}
 
 	auto dense_labels = m_labels->as<DenseLabels>();
-	set_root(CARTtrain(dense_features,m_weights,dense_labels,0));
+
+	// bin the data unless it was binned for several trees already
+	auto binned_features=m_binned_features;
+	BinnedNode root_bins;
+	if (binned_features)
+	{
+		require(binned_features->get_num_features()==num_features,
+			"Binned data has {} features, training data {}",
+			binned_features->get_num_features(), num_features);
+
+		// rows of the binned data, mapped through all subsets of the stack
+		root_bins.rows=SGVector<index_t>(num_vectors);
+		auto subset_stack=dense_features->get_subset_stack();
+		for (index_t i=0; i<num_vectors; i++)
+			root_bins.rows[i]=subset_stack->subset_idx_conversion(i);
+
+		require(Math::max(root_bins.rows.vector, root_bins.rows.vlen)<binned_features->get_num_vectors(),
+			"Training data is not a subset of the binned data");
+	}
+	else if (use_histograms(num_vectors))
+	{
+		binned_features=bin_features(dense_features);
+		root_bins.rows=SGVector<index_t>(num_vectors);
+		linalg::range_fill(root_bins.rows);
+	}
+
+	m_binned_features=binned_features;
+	if (m_binned_features && m_mode==PT_MULTICLASS)
+	{
+		index_t n_ulabels;
+		auto ulabels=get_unique_labels(dense_labels->get_labels(), n_ulabels);
+		m_histogram_classes=SGVector<float64_t>(n_ulabels);
+		sg_memcpy(m_histogram_classes.vector, ulabels.vector, n_ulabels*sizeof(float64_t));
+	}
+
+	// the root grows from a generator seeded by m_prng, which advances it
+	// by one draw, so that retraining grows a new tree
+	prng_type prng(m_prng());
+	set_root(CARTtrain(dense_features,m_weights,dense_labels,0,prng,m_binned_features ? &root_bins : NULL));
 
 	if (m_apply_cv_pruning)
 	{
-		prune_by_cross_validation(dense_features,m_folds);
+		prune_by_cross_validation(dense_features,m_folds,root_bins.rows);
 	}
+
+	// binned data is only needed during training
+	m_binned_features=nullptr;
+	m_histogram_classes=SGVector<float64_t>();
 	// compute feature importances and normalize it
 	if (m_root)
 	{
@@ -342,7 +454,7 @@ void CARTree::pre_sort_features(const std::shared_ptr<Features>& data, SGMatrix<
 
 }
 
-std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>> CARTree::CARTtrain(std::shared_ptr<DenseFeatures<float64_t>> data, const SGVector<float64_t>& weights, std::shared_ptr<DenseLabels> labels, int32_t level)
+std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>> CARTree::CARTtrain(std::shared_ptr<DenseFeatures<float64_t>> data, const SGVector<float64_t>& weights, std::shared_ptr<DenseLabels> labels, int32_t level, prng_type& prng, BinnedNode* binned)
 {
 	require(labels,"labels have to be supplied");
 	require(data,"data matrix has to be supplied");
@@ -453,12 +565,14 @@ std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>> CARTree::CARTtrain(std::
 			linalg::range_fill(indices);
 		best_attribute = compute_best_attribute(
 		    m_sorted_features, weights, labels, left, right, left_final,
-		    num_missing_final, c_left, c_right, node_impurity, 0, indices);
+		    num_missing_final, c_left, c_right, node_impurity, prng, 0,
+		    indices, binned);
 	}
 	else
 		best_attribute = compute_best_attribute(
 		    mat, weights, labels, left, right, left_final, num_missing_final,
-		    c_left, c_right, node_impurity);
+		    c_left, c_right, node_impurity, prng, 0, SGVector<index_t>(),
+		    binned);
 
 	if (best_attribute==-1)
 	{
@@ -508,17 +622,88 @@ std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>> CARTree::CARTtrain(std::
 		}
 	}
 
-	// left child
-	auto feats_train = view(data, subsetl);
-	auto labels_train = view(labels, subsetl);
-	auto left_child =
-	    CARTtrain(feats_train, weightsl, labels_train, level + 1);
+	// in histogram mode, the histogram of the larger child is the
+	// difference of the histograms of the node and the smaller child,
+	// both with the label shift of the node
+	BinnedNode binsl, binsr;
+	if (binned)
+	{
+		binsl.rows=get_binned_rows(binned->rows, subsetl);
+		binsr.rows=get_binned_rows(binned->rows, subsetr);
+		binsl.label_shift=binned->label_shift;
+		binsr.label_shift=binned->label_shift;
+
+		std::vector<float64_t> hist;
+		hist.swap(binned->histogram);
+		if (!hist.empty())
+		{
+			bool smaller_left=subsetl.vlen<=subsetr.vlen;
+			auto& hist_small=smaller_left ? binsl.histogram : binsr.histogram;
+			auto& hist_large=smaller_left ? binsr.histogram : binsl.histogram;
+
+			SGVector<index_t> all_feats(num_feats);
+			linalg::range_fill(all_feats);
+			build_histogram(
+			    binned->rows, smaller_left ? subsetl : subsetr, weights,
+			    labels_vec, binned->label_shift, all_feats.vector, num_feats,
+			    hist_small);
+
+			for (size_t k=0; k<hist.size(); ++k)
+				hist[k]-=hist_small[k];
+			hist_large.swap(hist);
+		}
+	}
 
-	// right child
-	feats_train = view(data, subsetr);
-	labels_train = view(labels, subsetr);
-	auto right_child =
-	    CARTtrain(feats_train, weightsr, labels_train, level + 1);
+	auto feats_left = view(data, subsetl);
+	auto labels_left = view(labels, subsetl);
+	auto feats_right = view(data, subsetr);
+	auto labels_right = view(labels, subsetr);
+	// every subtree draws from a generator of its own, so the tree does not
+	// depend on the order in which subtrees are grown
+	prng_type prng_left(prng());
+	prng_type prng_right(prng());
+	std::shared_ptr<bnode_t> left_child, right_child;
+	auto grow_left = [&]() {
+		left_child = CARTtrain(
+		    feats_left, weightsl, labels_left, level + 1, prng_left,
+		    binned ? &binsl : NULL);
+	};
+	auto grow_right = [&]() {
+		right_child = CARTtrain(
+		    feats_right, weightsr, labels_right, level + 1, prng_right,
+		    binned ? &binsr : NULL);
+	};
+
+	if (grow_in_parallel(subsetl.vlen, subsetr.vlen))
+	{
+		// the first parallel split opens the team that runs all subtree
+		// tasks, deeper splits only add tasks to it
+#ifdef HAVE_OPENMP
+		if (!omp_in_parallel())
+		{
+#pragma omp parallel num_threads(env()->get_num_threads())
+#pragma omp single
+			{
+#pragma omp task default(shared)
+				grow_left();
+				grow_right();
+#pragma omp taskwait
+			}
+		}
+		else
+#endif
+		{
+#pragma omp task default(shared)
+			grow_left();
+			grow_right();
+#pragma omp taskwait
+		}
+	}
+	else
+	{
+		grow_left();
+		grow_right();
+	}
 
 	// set node parameters
 	node->data.attribute_id=best_attribute;
@@ -561,9 +746,15 @@ index_t CARTree::compute_best_attribute(
     std::shared_ptr<DenseLabels> labels, SGVector<float64_t>& left,
     SGVector<float64_t>& right, SGVector<bool>& is_left_final,
     index_t& num_missing_final, index_t& count_left, index_t& count_right,
-    float64_t& impurity, index_t subset_size,
-    const SGVector<index_t>& active_indices)
+    float64_t& impurity, prng_type& prng, index_t subset_size,
+    const SGVector<index_t>& active_indices, BinnedNode* binned)
 {
+	if (binned)
+		return compute_best_binned_attribute(
+		    weights, labels->get_labels(), left, right, is_left_final,
+		    num_missing_final, count_left, count_right, impurity, prng,
+		    subset_size, *binned);
+
 	auto labels_vec=labels->get_labels();
 	auto num_vecs=labels->get_num_labels();
 	auto num_feats = (m_pre_sort) ? mat.num_cols : mat.num_rows;
@@ -601,7 +792,7 @@ index_t CARTree::compute_best_attribute(
 	if (subset_size)
 	{
 		num_feats=subset_size;
-		random::shuffle(idx, m_prng);
+		random::shuffle(idx, prng);
 	}
 
 	float64_t max_gain=MIN_SPLIT_GAIN;
@@ -886,6 +1077,269 @@ index_t CARTree::compute_best_attribute(
 	return best_attribute;
 }
 
+index_t CARTree::get_histogram_stride() const
+{
+	// vector count followed by the weight of every class or by the
+	// weight, weighted label sum and weighted squared label sum
+	return (m_mode==PT_MULTICLASS) ? m_histogram_classes.vlen+1 : 4;
+}
+
+SGVector<index_t> CARTree::get_binned_rows(
+    const SGVector<index_t>& rows, const SGVector<index_t>& positions) const
+{
+	SGVector<index_t> result(positions.vlen);
+	for (index_t i=0;i<positions.vlen;++i)
+		result[i]=rows[positions[i]];
+
+	return result;
+}
+
+bool CARTree::grow_in_parallel(index_t num_left, index_t num_right) const
+{
+	if (m_parallel_node_size==0 || env()->get_num_threads()<2)
+		return false;
+
+	return std::min(num_left, num_right)>=m_parallel_node_size;
+}
+
+namespace
+{
+	template <class C>
+	void fill_histogram(
+	    const C* codes, index_t num_binned_vecs, const index_t* rows,
+	    const index_t* positions, index_t num_vecs, const float64_t* weights,
+	    const float64_t* labels, float64_t label_shift, const index_t* classes,
+	    const index_t* feats, index_t num_feats, index_t num_slots,
+	    index_t stride, float64_t* hist)
+	{
+		// attributes are independent, so every thread fills whole histograms
+		// from the contiguous codes of its attribute
+		#pragma omp parallel for
+		for (index_t f=0;f<num_feats;++f)
+		{
+			auto h=hist+int64_t(f)*num_slots*stride;
+			auto feat_codes=codes+int64_t(feats[f])*num_binned_vecs;
+			for (index_t j=0;j<num_vecs;++j)
+			{
+				auto p=positions ? positions[j] : j;
+				auto bin=h+int64_t(feat_codes[rows[p]])*stride;
+				bin[0]+=1;
+				if (classes)
+					bin[1+classes[j]]+=weights[p];
+				else
+				{
+					auto y=labels[p]-label_shift;
+					bin[1]+=weights[p];
+					bin[2]+=weights[p]*y;
+					bin[3]+=weights[p]*y*y;
+				}
+			}
+		}
+	}
+
+	/** weighted variance of the labels from their histogram moments. The
+	 * moments are taken of the labels minus a shift close to their mean,
+	 * so that the difference below does not cancel for large labels.
+	 */
+	float64_t moment_deviation(const float64_t* moments)
+	{
+		auto mean=moments[2]/moments[1];
+		return std::max(moments[3]/moments[1]-mean*mean, 0.0);
+	}
+
+	/** weighted mean of the labels, 0 if all weights are 0 */
+	float64_t weighted_mean(
+	    const SGVector<float64_t>& weights, const SGVector<float64_t>& labels)
+	{
+		float64_t sum=0, sum_weights=0;
+		for (index_t j=0;j<labels.vlen;++j)
+		{
+			sum+=weights[j]*labels[j];
+			sum_weights+=weights[j];
+		}
+		return sum_weights>0 ? sum/sum_weights : 0;
+	}
+}
+
+void CARTree::build_histogram(
+    const SGVector<index_t>& rows, const SGVector<index_t>& positions,
+    const SGVector<float64_t>& weights,
+    const SGVector<float64_t>& labels_vec, float64_t label_shift,
+    const index_t* feats, index_t num_feats,
+    std::vector<float64_t>& hist) const
+{
+	auto num_slots=m_binned_features->get_max_bins()+1;
+	auto stride=get_histogram_stride();
+	auto num_vecs=positions.vlen ? positions.vlen : labels_vec.vlen;
+	auto pos=positions.vlen ? positions.vector : NULL;
+	hist.assign(int64_t(num_feats)*num_slots*stride, 0.0);
+
+	std::vector<index_t> classes;
+	if (m_mode==PT_MULTICLASS)
+	{
+		classes.resize(num_vecs);
+		for (index_t j=0;j<num_vecs;++j)
+		{
+			auto y=labels_vec[pos ? pos[j] : j];
+			classes[j]=std::lower_bound(m_histogram_classes.begin(),
+				m_histogram_classes.end(), y)-m_histogram_classes.begin();
+		}
+	}
+
+	auto num_binned_vecs=m_binned_features->get_num_vectors();
+	if (m_binned_features->has_codes8())
+		fill_histogram(
+		    m_binned_features->get_codes8(), num_binned_vecs,
+		    rows.vector, pos, num_vecs, weights.vector, labels_vec.vector,
+		    label_shift, classes.empty() ? NULL : classes.data(), feats,
+		    num_feats, num_slots, stride, hist.data());
+	else
+		fill_histogram(
+		    m_binned_features->get_codes16(), num_binned_vecs,
+		    rows.vector, pos, num_vecs, weights.vector, labels_vec.vector,
+		    label_shift, classes.empty() ? NULL : classes.data(), feats,
+		    num_feats, num_slots, stride, hist.data());
+}
+
+index_t CARTree::compute_best_binned_attribute(
+    const SGVector<float64_t>& weights, const SGVector<float64_t>& labels_vec,
+    SGVector<float64_t>& left, SGVector<float64_t>& right,
+    SGVector<bool>& is_left_final, index_t& num_missing_final,
+    index_t& count_left, index_t& count_right, float64_t& impurity,
+    prng_type& prng, index_t subset_size, BinnedNode& binned)
+{
+	auto num_vecs=labels_vec.vlen;
+	auto num_feats=m_binned_features->get_num_features();
+	auto num_slots=m_binned_features->get_max_bins()+1;
+	auto stride=get_histogram_stride();
+
+	// if all labels same early stop
+	auto minmax=std::minmax_element(labels_vec.begin(), labels_vec.end());
+	float64_t delta=(m_mode==PT_REGRESSION) ? m_label_epsilon : 0;
+	if (*minmax.second<=*minmax.first+delta)
+	{
+		binned.histogram.clear();
+		return -1;
+	}
+
+	SGVector<index_t> idx(num_feats);
+	linalg::range_fill(idx);
+	if (subset_size)
+	{
+		num_feats=subset_size;
+		random::shuffle(idx, prng);
+	}
+
+	// histograms of all attributes are kept for the children of the node,
+	// partial ones are built for the chosen attributes only
+	std::vector<float64_t> hist;
+	if (!subset_size && binned.histogram.size()==size_t(num_feats)*num_slots*stride)
+		hist.swap(binned.histogram);
+	else
+	{
+		if (m_mode==PT_REGRESSION)
+			binned.label_shift=weighted_mean(weights, labels_vec);
+		build_histogram(binned.rows, SGVector<index_t>(), weights, labels_vec, binned.label_shift, idx.vector, num_feats, hist);
+	}
+	binned.histogram.clear();
+
+	auto num_classes=stride-1;
+	SGVector<float64_t> wtotal(num_classes), wleft(num_classes), wright(num_classes);
+	std::vector<float64_t> total(stride), cum(stride), rest(stride);
+
+	float64_t max_gain=MIN_SPLIT_GAIN;
+	float64_t max_impurity=MIN_SPLIT_GAIN;
+	index_t best_attribute=-1;
+	int32_t best_bin=-1;
+
+	for (index_t i=0;i<num_feats;++i)
+	{
+		auto h=hist.data()+int64_t(i)*num_slots*stride;
+		auto num_bins=m_binned_features->get_num_bins(idx[i]);
+
+		// totals without missing values, which are in the last slot
+		std::fill(total.begin(), total.end(), 0.0);
+		int32_t num_filled=0;
+		for (int32_t b=0;b<num_bins;++b)
+		{
+			auto bin=h+int64_t(b)*stride;
+			if (bin[0]==0)
+				continue;
+
+			++num_filled;
+			for (index_t k=0;k<stride;++k)
+				total[k]+=bin[k];
+		}
+
+		// if only one unique value - it cannot be used to split
+		if (num_filled<2 || (m_mode!=PT_MULTICLASS && total[1]<=0))
+			continue;
+
+		if (m_mode==PT_MULTICLASS)
+			sg_memcpy(wtotal.vector, &total[1], num_classes*sizeof(float64_t));
+
+		std::fill(cum.begin(), cum.end(), 0.0);
+		for (int32_t b=0;b<num_bins;++b)
+		{
+			auto bin=h+int64_t(b)*stride;
+			if (bin[0]==0)
+				continue;
+
+			for (index_t k=0;k<stride;++k)
+				cum[k]+=bin[k];
+			if (cum[0]==total[0])
+				break;
+
+			float64_t g=0;
+			if (m_mode==PT_MULTICLASS)
+			{
+				for (index_t k=0;k<num_classes;++k)
+				{
+					wleft[k]=cum[k+1];
+					wright[k]=total[k+1]-cum[k+1];
+				}
+				g=gain(wleft, wright, wtotal, max_impurity);
+			}
+			else
+			{
+				for (index_t k=0;k<stride;++k)
+					rest[k]=total[k]-cum[k];
+
+				max_impurity=moment_deviation(total.data());
+				g=max_impurity-moment_deviation(cum.data())*(cum[1]/total[1])-
+					moment_deviation(rest.data())*(rest[1]/total[1]);
+			}
+			impurity=std::max(max_impurity, impurity);
+
+			if (g>max_gain)
+			{
+				max_gain=g;
+				best_attribute=idx[i];
+				best_bin=b;
+				num_missing_final=num_vecs-total[0];
+			}
+		}
+	}
+
+	if (best_attribute==-1)
+		return -1;
+
+	left[0]=m_binned_features->get_bin_upper(best_attribute, best_bin);
+	right[0]=left[0];
+	count_left=1;
+	count_right=1;
+	for (index_t j=0;j<num_vecs;++j)
+	{
+		is_left_final[j]=m_binned_features->get_code(
+			best_attribute, binned.rows[j])<=best_bin;
+	}
+
+	if (!subset_size)
+		binned.histogram.swap(hist);
+
+	return best_attribute;
+}
+
 SGVector<bool> CARTree::surrogate_split(SGMatrix<float64_t> m,SGVector<float64_t> weights, SGVector<bool> nm_left, int32_t attr) const
 {
 	// return vector - left/right belongingness
@@ -1140,69 +1594,35 @@ float64_t CARTree::least_squares_deviation(const SGVector<float64_t>& feats, con
 	return dev/total_weight;
 }
 
+std::shared_ptr<FlatTreeEnsemble> CARTree::get_flat_tree()
+{
+	std::lock_guard<std::mutex> lock(m_flat_tree_lock);
+
+	auto root=get_root()->as<bnode_t>();
+	if (m_flat_tree && m_flat_root==root)
+		return m_flat_tree;
+
+	m_flat_tree=std::make_shared<FlatTreeEnsemble>();
+	m_flat_tree->add_tree(root, m_nominal);
+	m_flat_root=root;
+	return m_flat_tree;
+}
+
 std::shared_ptr<Labels> CARTree::apply_from_current_node(const std::shared_ptr<DenseFeatures<float64_t>>& feats, const std::shared_ptr<bnode_t>& current)
 {
 	auto num_vecs=feats->get_num_vectors();
 	require(num_vecs>0, "No data provided in apply");
 
-	SGVector<float64_t> labels(num_vecs);
-	for (index_t i=0;i<num_vecs;++i)
+	std::shared_ptr<FlatTreeEnsemble> flat;
+	if (current==get_root())
+		flat=get_flat_tree();
+	else
 	{
-		auto sample=feats->get_feature_vector(i);
-		auto node=current;
-
-
-		// until leaf is reached
-		while(node->data.num_leaves!=1)
-		{
-			auto leftchild=node->left();
-
-			if (m_nominal[node->data.attribute_id])
-			{
-				SGVector<float64_t> comp=leftchild->data.transit_into_values;
-				bool flag=false;
-				for (index_t k=0;k<comp.vlen;++k)
-				{
-					if (comp[k]==sample[node->data.attribute_id])
-					{
-						flag=true;
-						break;
-					}
-				}
-
-				if (flag)
-				{
-
-					node=leftchild;
-
-				}
-				else
-				{
-
-					node=node->right();
-				}
-			}
-			else
-			{
-				if (sample[node->data.attribute_id]<=leftchild->data.transit_into_values[0])
-				{
-
-					node=leftchild;
-
-				}
-				else
-				{
-
-					node=node->right();
-				}
-			}
-
-
-		}
-
-		labels[i]=node->data.node_label;
-
+		// subtrees of pruning are only applied once
+		flat=std::make_shared<FlatTreeEnsemble>();
+		flat->add_tree(current, m_nominal);
 	}
+	auto labels=flat->apply(feats->get_feature_matrix()).get_column(0);
 
 	switch(m_mode)
 	{
@@ -1223,7 +1643,7 @@ std::shared_ptr<Labels> CARTree::apply_from_current_node(const std::shared_ptr<D
 	return NULL;
 }
 
-void CARTree::prune_by_cross_validation(const std::shared_ptr<DenseFeatures<float64_t>>& data, int32_t folds)
+void CARTree::prune_by_cross_validation(const std::shared_ptr<DenseFeatures<float64_t>>& data, int32_t folds, const SGVector<index_t>& binned_rows)
 {
 	auto num_vecs=data->get_num_vectors();
 
@@ -1263,7 +1683,13 @@ void CARTree::prune_by_cross_validation(const std::shared_ptr<DenseFeatures<floa
 			subset_weights[j]=m_weights[train_indices.at(j)];
 
 		// train with training subset
-		auto root = CARTtrain(feats_train, subset_weights, labels_train, 0);
+		BinnedNode fold_bins;
+		if (m_binned_features)
+			fold_bins.rows=get_binned_rows(binned_rows, subset);
+		prng_type prng(m_prng());
+		auto root = CARTtrain(
+		    feats_train, subset_weights, labels_train, 0, prng,
+		    m_binned_features ? &fold_bins : NULL);
 
 		// prune trained tree
 		auto tmax=std::make_shared<TreeMachine<CARTreeNodeData>>();
@@ -1508,6 +1934,10 @@ void CARTree::init()
 	m_label_epsilon=1e-7;
 	m_sorted_features=SGMatrix<float64_t>();
 	m_sorted_indices=SGMatrix<index_t>();
+	m_num_bins=0;
+	m_histogram_threshold=10000;
+	m_parallel_node_size=1000;
+	m_binned_features=nullptr;
 
 	SG_ADD(
 	    &m_feature_importances, "feature_importances", "feature importances",
@@ -1525,6 +1955,13 @@ void CARTree::init()
 	SG_ADD(&m_max_depth, "max_depth", "max allowed tree depth");
 	SG_ADD(&m_min_node_size, "min_node_size", "min allowed node size");
 	SG_ADD(&m_label_epsilon, "label_epsilon", "epsilon for labels");
+	SG_ADD(&m_num_bins, "num_bins", "max number of bins per attribute in histogram mode");
+	SG_ADD(
+	    &m_histogram_threshold, "histogram_threshold",
+	    "number of training vectors from which on histograms are used");
+	SG_ADD(
+	    &m_parallel_node_size, "parallel_node_size",
+	    "min number of vectors in both children for growing subtrees in parallel");
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&m_mode, "mode",
 	    "problem type (multiclass or regression)", ParameterProperties::NONE,
@@ -38,10 +38,13 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DenseSubSamplesFeatures.h>
 #include <shogun/mathematics/RandomMixin.h>
+#include <shogun/multiclass/tree/BinnedFeatureMatrix.h>
 #include <shogun/multiclass/tree/CARTreeNodeData.h>
 #include <shogun/multiclass/tree/FeatureImportanceTree.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
 #include <shogun/multiclass/tree/TreeMachine.h>
 
+#include <mutex>
 #include <vector>
 
 namespace shogun
@@ -80,7 +83,23 @@ namespace shogun
  * have been sent to left/right child. If all possible surrogate splits are used up but some data points are still to be
  * assigned left/right child, majority rule is used, ie. the data points are assigned the child where majority of data points
  * have gone from the node. \n
- * cf. http://pic.dhe.ibm.com/infocenter/spssstat/v20r0m0/index.jsp?topic=%2Fcom.ibm.spss.statistics.help%2Falg_tree-cart.htm
+ * cf. http://pic.dhe.ibm.com/infocenter/spssstat/v20r0m0/index.jsp?topic=%2Fcom.ibm.spss.statistics.help%2Falg_tree-cart.htm \n \n
+ *
+ * HISTOGRAM SPLIT FINDING : \n
+ * If enabled by set_num_bins(), which is off by default, splits on large training sets (see set_histogram_threshold()) without
+ * nominal attributes are found approximately. Every attribute is quantile-binned once into at most get_num_bins() bins (see
+ * BinnedFeatureMatrix) and the best split of a node is found by scanning per-bin histograms of class weights (classification)
+ * or of the weighted label moments (regression) instead of sorting the attribute values of every node.
+ * When all attributes are considered in a split, only the histogram of the smaller child is built from the data, the other one is the
+ * difference to the histogram of its parent. Thresholds are always values that occur in the training data, so attributes with at most
+ * get_num_bins() distinct values yield the same splits as the exact search.
+ *
+ * PARALLEL GROWING AND INFERENCE : \n
+ * The two subtrees of a node are grown as parallel OpenMP tasks if both children hold at least get_parallel_node_size() training
+ * vectors. Subtrees do not share any state, so the tree is the same as the one grown serially. Random attribute subsets are drawn
+ * from a generator of the node, which seeds the generators of both children, so randomized trees do not depend on the number of
+ * threads either. For prediction, the tree is compiled
+ * into a FlatTreeEnsemble, a contiguous node table through which blocks of vectors are routed together.
  */
 class CARTree : public RandomMixin<FeatureImportanceTree<CARTreeNodeData>>
 {
@@ -238,12 +257,89 @@ public:
 
 	void set_sorted_features(SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices);
 
+	/** set maximum number of bins per attribute for histogram split finding
+	 *
+	 * @param bins number of bins in [2, 65535] or 0 to always find splits
+	 * exactly, which is the default
+	 */
+	void set_num_bins(int32_t bins);
+
+	/** get maximum number of bins per attribute for histogram split finding
+	 *
+	 * @return number of bins, 0 if histograms are disabled
+	 */
+	int32_t get_num_bins() const;
+
+	/** set number of training vectors from which on splits are found using histograms
+	 *
+	 * @param num_vectors minimum number of training vectors
+	 */
+	void set_histogram_threshold(index_t num_vectors);
+
+	/** get number of training vectors from which on splits are found using histograms
+	 *
+	 * @return minimum number of training vectors
+	 */
+	index_t get_histogram_threshold() const;
+
+	/** whether training on a number of vectors uses histogram split finding,
+	 * which requires all attributes to be continuous
+	 *
+	 * @param num_vectors number of training vectors
+	 * @return true if histograms are used
+	 */
+	bool use_histograms(index_t num_vectors) const;
+
+	/** set minimum number of training vectors in both children of a node
+	 * for growing the two subtrees in parallel
+	 *
+	 * @param num_vectors minimum number of vectors or 0 to grow serially
+	 */
+	void set_parallel_node_size(index_t num_vectors);
+
+	/** get minimum number of training vectors in both children of a node
+	 * for growing the two subtrees in parallel
+	 *
+	 * @return minimum number of vectors, 0 if trees are grown serially
+	 */
+	index_t get_parallel_node_size() const;
+
+#ifndef SWIG // SWIG should skip this part
+	/** quantile-bin training data for histogram split finding, so that it can
+	 * be shared by several trees via set_binned_features()
+	 *
+	 * @param data dense training data without subsets
+	 * @return binned data
+	 */
+	std::shared_ptr<BinnedFeatureMatrix> bin_features(const std::shared_ptr<Features>& data) const;
+
+	/** set binned data for the next training. The training data has to be
+	 * the binned data itself or a subset view of it.
+	 *
+	 * @param binned binned data from bin_features()
+	 */
+	void set_binned_features(std::shared_ptr<BinnedFeatureMatrix> binned);
+#endif
+
 	/**return feature importance
 	 * this way is the same as sklearn
 	 */
 	SGVector<float64_t> get_feature_importance();
 
 protected:
+	/** @brief state of a node in histogram mode */
+	struct BinnedNode
+	{
+		/** rows of the vectors of the node in the binned data */
+		SGVector<index_t> rows;
+
+		/** histograms of all attributes of the node, empty if unknown */
+		std::vector<float64_t> histogram;
+
+		/** value subtracted from the labels in the moments of histogram */
+		float64_t label_shift=0;
+	};
+
 	/** train machine - build CART from training data
 	 * @param data training data
 	 * @return true
@@ -256,9 +352,12 @@ protected:
 	 * @param weights vector of weights of data points
 	 * @param labels labels of data points
 	 * @param level current tree depth
+	 * @param prng random generator of the node, which seeds the generators
+	 * of its subtrees
+	 * @param binned state of the node in histogram mode, NULL otherwise
 	 * @return pointer to the root of the CART subtree
 	 */
-	virtual std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>> CARTtrain(std::shared_ptr<DenseFeatures<float64_t>> data, const SGVector<float64_t>& weights, std::shared_ptr<DenseLabels> labels, int32_t level);
+	virtual std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>> CARTtrain(std::shared_ptr<DenseFeatures<float64_t>> data, const SGVector<float64_t>& weights, std::shared_ptr<DenseLabels> labels, int32_t level, prng_type& prng, BinnedNode* binned=NULL);
 
 	/** modify labels for compute_best_attribute
 	 *
@@ -280,6 +379,8 @@ protected:
 	 * @param count_left stores number of feature values for left transition
 	 * @param count_right stores number of feature values for right transition
 	 * @param impurity impurity of current node
+	 * @param prng random generator of the node
+	 * @param binned state of the node in histogram mode, NULL otherwise
 	 * @return index to the best attribute
 	 */
 	virtual index_t compute_best_attribute(
@@ -287,8 +388,69 @@ protected:
 		std::shared_ptr<DenseLabels> labels, SGVector<float64_t>& left,
 		SGVector<float64_t>& right, SGVector<bool>& is_left_final,
 		index_t& num_missing, index_t& count_left, index_t& count_right,
-		float64_t& impurity, index_t subset_size = 0,
-		const SGVector<index_t>& active_indices = SGVector<index_t>());
+		float64_t& impurity, prng_type& prng, index_t subset_size = 0,
+		const SGVector<index_t>& active_indices = SGVector<index_t>(),
+		BinnedNode* binned = NULL);
+
+	/** computes best attribute for CARTtrain from histograms of the binned data
+	 *
+	 * @param weights data weights
+	 * @param labels_vec data labels
+	 * @param left stores threshold for left transition
+	 * @param right stores threshold for right transition
+	 * @param is_left_final stores which feature vectors go to the left child
+	 * @param num_missing number of missing attributes
+	 * @param count_left stores number of feature values for left transition
+	 * @param count_right stores number of feature values for right transition
+	 * @param impurity impurity of current node
+	 * @param prng random generator of the node
+	 * @param subset_size number of randomly chosen attributes or 0 for all
+	 * @param binned state of the node, whose histograms are taken and kept
+	 * for its children if all attributes are considered
+	 * @return index to the best attribute
+	 */
+	index_t compute_best_binned_attribute(
+		const SGVector<float64_t>& weights, const SGVector<float64_t>& labels_vec,
+		SGVector<float64_t>& left, SGVector<float64_t>& right,
+		SGVector<bool>& is_left_final, index_t& num_missing,
+		index_t& count_left, index_t& count_right, float64_t& impurity,
+		prng_type& prng, index_t subset_size, BinnedNode& binned);
+
+	/** builds histograms of a set of vectors of a node
+	 *
+	 * @param rows rows of the vectors of the node in the binned data
+	 * @param positions positions of the vectors in the node, empty for all
+	 * @param weights weights of the vectors of the node
+	 * @param labels_vec labels of the vectors of the node
+	 * @param label_shift value subtracted from the labels in regression
+	 * @param feats attributes to build histograms of
+	 * @param num_feats number of attributes
+	 * @param hist stores one histogram per attribute in order of feats
+	 */
+	void build_histogram(
+		const SGVector<index_t>& rows, const SGVector<index_t>& positions,
+		const SGVector<float64_t>& weights,
+		const SGVector<float64_t>& labels_vec, float64_t label_shift,
+		const index_t* feats, index_t num_feats,
+		std::vector<float64_t>& hist) const;
+
+	/** @return number of values per histogram bin */
+	index_t get_histogram_stride() const;
+
+	/** @param rows rows of the vectors of a node in the binned data
+	 * @param positions positions of some vectors in the node
+	 * @return rows of these vectors in the binned data
+	 */
+	SGVector<index_t> get_binned_rows(
+		const SGVector<index_t>& rows, const SGVector<index_t>& positions) const;
+
+	/** whether the subtrees of a node are grown in parallel
+	 *
+	 * @param num_left number of training vectors of the left child
+	 * @param num_right number of training vectors of the right child
+	 * @return true if both subtrees are large enough
+	 */
+	bool grow_in_parallel(index_t num_left, index_t num_right) const;
 
 	/** handles missing values through surrogate splits
 	 *
@@ -382,12 +544,18 @@ protected:
 	 */
 	std::shared_ptr<Labels> apply_from_current_node(const std::shared_ptr<DenseFeatures<float64_t>>& feats, const std::shared_ptr<bnode_t>& current);
 
+	/** @return the tree below the root flattened for prediction, built on
+	 * first use and kept until the root or the feature types change
+	 */
+	std::shared_ptr<FlatTreeEnsemble> get_flat_tree();
+
 	/** prune by cross validation
 	 *
 	 * @param data training data
 	 * @param folds the integer V for V-fold cross validation
+	 * @param binned_rows rows of the data in the binned data in histogram mode
 	 */
-	void prune_by_cross_validation(const std::shared_ptr<DenseFeatures<float64_t>>& data, int32_t folds);
+	void prune_by_cross_validation(const std::shared_ptr<DenseFeatures<float64_t>>& data, int32_t folds, const SGVector<index_t>& binned_rows=SGVector<index_t>());
 
 	/** computes error in classification/regression
 	 * for classification it eveluates weight_missclassified/total_weight
@@ -483,6 +651,30 @@ protected:
 
 	/** minimum number of feature vectors required in a node **/
 	int32_t m_min_node_size;
+
+	/** max number of bins per attribute in histogram split finding, 0 to disable **/
+	int32_t m_num_bins;
+
+	/** number of training vectors from which on histograms are used **/
+	index_t m_histogram_threshold;
+
+	/** min number of vectors in both children for growing subtrees in parallel **/
+	index_t m_parallel_node_size;
+
+	/** binned training data, set during training in histogram mode **/
+	std::shared_ptr<BinnedFeatureMatrix> m_binned_features;
+
+	/** sorted unique labels of the training data in histogram mode (classification) **/
+	SGVector<float64_t> m_histogram_classes;
+
+	/** flattened tree for prediction **/
+	std::shared_ptr<FlatTreeEnsemble> m_flat_tree;
+
+	/** root from which m_flat_tree was built **/
+	std::shared_ptr<bnode_t> m_flat_root;
+
+	/** guards m_flat_tree against concurrent apply calls **/
+	std::mutex m_flat_tree_lock;
 };
 } /* namespace shogun */
 
@@ -0,0 +1,98 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/ensemble/MajorityVote.h"
+#include "shogun/machine/RandomForest.h"
+#include "shogun/multiclass/tree/CARTree.h"
+#include "shogun/util/benchmark_data.h"
+
+namespace shogun
+{
+
+/** range(0) vectors of dimension range(1) from 4 blobs */
+class TreeFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		feats = benchmark_data::dense_features(st.range(0), st.range(1), 4);
+		labels = benchmark_data::multiclass_labels(st.range(0), 4);
+		feature_types = SGVector<bool>(st.range(1));
+		feature_types.set_const(false);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		feats.reset();
+		labels.reset();
+	}
+
+	std::shared_ptr<RandomForest> create_forest()
+	{
+		auto forest = std::make_shared<RandomForest>(feats, labels, 32, 4);
+		forest->set_feature_types(feature_types);
+		forest->set_combination_rule(std::make_shared<MajorityVote>());
+		forest->put("seed", benchmark_data::seed);
+		return forest;
+	}
+
+	std::shared_ptr<DenseFeatures<float64_t>> feats;
+	std::shared_ptr<MulticlassLabels> labels;
+	SGVector<bool> feature_types;
+};
+
+#define ADD_TREE_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(4)->Ranges({{1024, 65536}, {8, 32}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(TreeFixture, CARTree_train_exact)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto tree = std::make_shared<CARTree>(feature_types, PT_MULTICLASS);
+		tree->set_num_bins(0);
+		tree->set_labels(labels);
+		tree->train(feats);
+	}
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_TREE_ARGS(BENCHMARK_REGISTER_F(TreeFixture, CARTree_train_exact))
+
+BENCHMARK_DEFINE_F(TreeFixture, CARTree_train_histogram)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto tree = std::make_shared<CARTree>(feature_types, PT_MULTICLASS);
+		tree->set_num_bins(256);
+		tree->set_histogram_threshold(0);
+		tree->set_labels(labels);
+		tree->train(feats);
+	}
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_TREE_ARGS(BENCHMARK_REGISTER_F(TreeFixture, CARTree_train_histogram))
+
+BENCHMARK_DEFINE_F(TreeFixture, RandomForest_train)(benchmark::State& st)
+{
+	for (auto _ : st)
+		create_forest()->train();
+
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_TREE_ARGS(BENCHMARK_REGISTER_F(TreeFixture, RandomForest_train))
+
+BENCHMARK_DEFINE_F(TreeFixture, RandomForest_apply)(benchmark::State& st)
+{
+	auto forest = create_forest();
+	forest->train();
+
+	for (auto _ : st)
+		benchmark::DoNotOptimize(forest->apply_multiclass(feats));
+
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_TREE_ARGS(BENCHMARK_REGISTER_F(TreeFixture, RandomForest_apply))
+
+}
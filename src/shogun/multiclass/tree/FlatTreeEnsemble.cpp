@@ -0,0 +1,108 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/io/SGIO.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+FlatTreeEnsemble::FlatTreeEnsemble() : m_num_features(0)
+{
+}
+
+void FlatTreeEnsemble::add_tree(
+	const std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>>& root,
+	const SGVector<bool>& nominal)
+{
+	require(root, "Tree machine not yet trained.");
+	m_roots.push_back(add_node(root, nominal));
+}
+
+int32_t FlatTreeEnsemble::add_node(
+	const std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>>& node,
+	const SGVector<bool>& nominal)
+{
+	int32_t index=m_attribute.size();
+	m_attribute.push_back(LEAF);
+	m_value.push_back(node->data.node_label);
+	m_right.push_back(-1);
+	m_category_begin.push_back(0);
+	m_category_end.push_back(0);
+
+	// same leaf test as in CARTree
+	if (node->data.num_leaves==1)
+		return index;
+
+	auto left=node->left();
+	auto attr=node->data.attribute_id;
+	const auto& transit=left->data.transit_into_values;
+	m_num_features=std::max(m_num_features, attr+1);
+	if (nominal.vlen && nominal[attr])
+	{
+		m_attribute[index]=-attr-2;
+		m_category_begin[index]=m_categories.size();
+		m_categories.insert(m_categories.end(), transit.begin(), transit.end());
+		m_category_end[index]=m_categories.size();
+	}
+	else
+	{
+		m_attribute[index]=attr;
+		m_value[index]=transit[0];
+	}
+
+	add_node(left, nominal);
+	m_right[index]=add_node(node->right(), nominal);
+	return index;
+}
+
+SGMatrix<float64_t> FlatTreeEnsemble::apply(const SGMatrix<float64_t>& data) const
+{
+	require(data.num_rows>=m_num_features,
+		"Data has {} features, the trees split on up to {}",
+		data.num_rows, m_num_features);
+
+	index_t num_vecs=data.num_cols;
+	index_t num_trees=get_num_trees();
+	index_t num_blocks=(num_vecs+BLOCK_SIZE-1)/BLOCK_SIZE;
+	SGMatrix<float64_t> outputs(num_vecs, num_trees);
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t b=0; b<num_blocks; b++)
+	{
+		auto begin=b*BLOCK_SIZE;
+		auto size=std::min(BLOCK_SIZE, num_vecs-begin);
+		const float64_t* vecs=data.matrix+int64_t(begin)*data.num_rows;
+
+		int32_t nodes[BLOCK_SIZE];
+		for (index_t t=0; t<num_trees; t++)
+		{
+			std::fill(nodes, nodes+size, m_roots[t]);
+
+			// move every vector of the block one level down per pass
+			bool active=true;
+			while (active)
+			{
+				active=false;
+				for (index_t i=0; i<size; i++)
+				{
+					auto n=nodes[i];
+					if (m_attribute[n]==LEAF)
+						continue;
+
+					nodes[i]=goes_left(n, vecs+int64_t(i)*data.num_rows) ?
+						n+1 : m_right[n];
+					active=true;
+				}
+			}
+
+			auto out=outputs.get_column_vector(t)+begin;
+			for (index_t i=0; i<size; i++)
+				out[i]=m_value[nodes[i]];
+		}
+	}
+
+	return outputs;
+}
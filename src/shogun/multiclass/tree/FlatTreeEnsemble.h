@@ -0,0 +1,121 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _FLATTREEENSEMBLE_H__
+#define _FLATTREEENSEMBLE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/multiclass/tree/BinaryTreeMachineNode.h>
+#include <shogun/multiclass/tree/CARTreeNodeData.h>
+
+#include <memory>
+#include <vector>
+
+namespace shogun
+{
+/** @brief Read-only, flattened form of one or more CART trees for fast
+ * prediction.
+ *
+ * The nodes of all trees are stored as a structure of arrays in depth-first
+ * order, so that the left child of a node is the next node and only the
+ * index of the right child is kept. A continuous split sends a vector left
+ * if its attribute value is at most the threshold of the node, a nominal
+ * split if the value is one of the categories of the left child. Leaves
+ * hold the label of the tree node.
+ *
+ * apply() routes blocks of vectors through one tree after the other, one
+ * level at a time for the whole block. This keeps the block and the upper
+ * levels of the tree in cache and lets the loads of different vectors
+ * overlap instead of following one pointer chain at a time. Blocks are
+ * processed in parallel.
+ */
+class FlatTreeEnsemble
+{
+public:
+	/** constructor */
+	FlatTreeEnsemble();
+
+	FlatTreeEnsemble(const FlatTreeEnsemble&)=delete;
+	FlatTreeEnsemble& operator=(const FlatTreeEnsemble&)=delete;
+
+	/** appends a tree
+	 *
+	 * @param root root of a trained CART tree
+	 * @param nominal type of each attribute (true for nominal), empty if
+	 * all attributes are continuous
+	 */
+	void add_tree(
+		const std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>>& root,
+		const SGVector<bool>& nominal);
+
+	/** @return number of trees */
+	index_t get_num_trees() const { return m_roots.size(); }
+
+	/** @return number of nodes of all trees */
+	index_t get_num_nodes() const { return m_attribute.size(); }
+
+	/** applies all trees
+	 *
+	 * @param data feature matrix, one vector per column
+	 * @return outputs with the label of vector i in tree t at (i, t)
+	 */
+	SGMatrix<float64_t> apply(const SGMatrix<float64_t>& data) const;
+
+private:
+	/** @return index of the appended node */
+	int32_t add_node(
+		const std::shared_ptr<BinaryTreeMachineNode<CARTreeNodeData>>& node,
+		const SGVector<bool>& nominal);
+
+	/** @return whether the vector goes to the left child of node */
+	bool goes_left(int32_t node, const float64_t* vec) const
+	{
+		auto attr=m_attribute[node];
+		if (attr>=0)
+			return vec[attr]<=m_value[node];
+
+		auto value=vec[-attr-2];
+		for (auto k=m_category_begin[node]; k<m_category_end[node]; ++k)
+		{
+			if (m_categories[k]==value)
+				return true;
+		}
+		return false;
+	}
+
+	/** attribute of a leaf */
+	static constexpr int32_t LEAF=-1;
+
+	/** number of vectors routed through a tree together */
+	static constexpr index_t BLOCK_SIZE=64;
+
+	/** first node of every tree */
+	std::vector<int32_t> m_roots;
+
+	/** split attribute a as a for continuous and -a-2 for nominal splits,
+	 * LEAF for leaves
+	 */
+	std::vector<int32_t> m_attribute;
+
+	/** threshold of continuous splits, label of leaves */
+	std::vector<float64_t> m_value;
+
+	/** right child of splits */
+	std::vector<int32_t> m_right;
+
+	/** categories of the left child of nominal splits are
+	 * m_categories[m_category_begin[n]..m_category_end[n])
+	 */
+	std::vector<int32_t> m_category_begin;
+	std::vector<int32_t> m_category_end;
+	std::vector<float64_t> m_categories;
+
+	/** number of attributes needed by the trees */
+	int32_t m_num_features;
+};
+}
+#endif /* _FLATTREEENSEMBLE_H__ */
@@ -83,6 +83,8 @@ protected:
 	 * @param num_missing number of missing attributes
 	 * @param count_left stores number of feature values for left transition
 	 * @param count_right stores number of feature values for right transition
+	 * @param prng random generator of the node
+	 * @param binned state of the node in histogram mode, NULL otherwise
 	 * @return index to the best attribute
 	 */
 	virtual index_t compute_best_attribute(
@@ -90,8 +92,9 @@ protected:
 		std::shared_ptr<DenseLabels> labels, SGVector<float64_t>& left,
 		SGVector<float64_t>& right, SGVector<bool>& is_left_final,
 		index_t& num_missing, index_t& count_left, index_t& count_right,
-		float64_t& impurity, index_t subset_size = 0,
-		const SGVector<index_t>& active_indices = SGVector<index_t>());
+		float64_t& impurity, prng_type& prng, index_t subset_size = 0,
+		const SGVector<index_t>& active_indices = SGVector<index_t>(),
+		BinnedNode* binned = NULL);
 
 private:
 	/** initialize parameters */
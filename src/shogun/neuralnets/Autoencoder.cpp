@@ -151,13 +151,15 @@ std::shared_ptr<DenseFeatures< float64_t >> Autoencoder::reconstruct(
 	return std::make_shared<DenseFeatures<float64_t>>(reconstructed);
 }
 
-float64_t Autoencoder::compute_error(SGMatrix< float64_t > targets)
+float64_t Autoencoder::compute_batch_error(
+	const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+	SGMatrix<float64_t> targets)
 {
-	float64_t error = NeuralNetwork::compute_error(targets);
+	float64_t error = NeuralNetwork::compute_batch_error(layers, targets);
 
 	if (m_contraction_coefficient != 0.0)
 		error +=
-			get_layer(1)->compute_contraction_term(get_section(m_params,1));
+			layers[1]->compute_contraction_term(get_section(m_params,1));
 
 	return error;
 }
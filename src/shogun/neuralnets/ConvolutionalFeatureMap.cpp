@@ -36,20 +36,32 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+
+#include <algorithm>
+#include <vector>
 
 using namespace shogun;
 
+/** number of chunks the batch is split into when computing the parameter
+ * gradients. The gradients of every chunk are summed separately and the
+ * chunks are added in order, so the result does not depend on the number
+ * of threads.
+ */
+static const int32_t GRADIENT_NUM_CHUNKS=16;
+
 CConvolutionalFeatureMap::CConvolutionalFeatureMap(
 	int32_t input_width, int32_t input_height,
 	int32_t radius_x, int32_t radius_y,
 	int32_t stride_x, int32_t stride_y,
 	int32_t index,
 	EConvMapActivationFunction function,
-	ENLAutoencoderPosition autoencoder_position) :
+	ENLAutoencoderPosition autoencoder_position,
+	int32_t num_maps) :
 		m_input_width(input_width), m_input_height(input_height),
 		m_radius_x(radius_x), m_radius_y(radius_y),
 		m_stride_x(stride_x), m_stride_y(stride_y),
-		m_index(index),
+		m_index(index), m_num_maps(num_maps),
 		m_activation_function(function),
 		m_autoencoder_position(autoencoder_position)
 {
@@ -57,11 +69,19 @@ CConvolutionalFeatureMap::CConvolutionalFeatureMap(
 	{
 		m_output_width = m_input_width/m_stride_x;
 		m_output_height = m_input_height/m_stride_y;
+
+		m_num_positions_x = m_output_width;
+		m_num_positions_y = m_output_height;
 	}
 	else
 	{
 		m_output_width = m_input_width;
 		m_output_height = m_input_height;
+
+		// the filter is only applied at every stride-th pixel, the other
+		// outputs are left at the bias
+		m_num_positions_x = (m_input_width+m_stride_x-1)/m_stride_x;
+		m_num_positions_y = (m_input_height+m_stride_y-1)/m_stride_y;
 	}
 
 	m_input_num_neurons = m_input_width*m_input_height;
@@ -79,55 +99,53 @@ void CConvolutionalFeatureMap::compute_activations(
 	SGVector< int32_t > input_indices,
 	SGMatrix<float64_t> activations)
 {
+	std::vector<SGMatrix<float64_t>> inputs;
+	std::vector<int32_t> inputs_row_offsets;
+	get_input_channels(layers, input_indices, false, inputs, inputs_row_offsets);
+
+	SGMatrix<float64_t> filters = get_filters(parameters, inputs.size());
+	int32_t num_parameters_per_map = 1+filters.num_rows;
+	int32_t num_positions = m_num_positions_x*m_num_positions_y;
+	int32_t num_rows = m_num_maps*m_output_num_neurons;
 	int32_t batch_size = activations.num_cols;
 
-	float64_t bias = parameters[0];
-	for (int32_t i=0; i<m_output_num_neurons; i++)
+	#pragma omp parallel
 	{
+		SGMatrix<float64_t> columns(filters.num_rows, num_positions);
+		SGMatrix<float64_t> outputs(num_positions, m_num_maps);
+
+		#pragma omp for
 		for (int32_t j=0; j<batch_size; j++)
 		{
-			activations(i+m_row_offset,j) = bias;
-		}
-	}
-
-	int32_t weights_index_offset = 1;
-	for (int32_t l=0; l<input_indices.vlen; l++)
-	{
-		auto& layer = layers[input_indices[l]];
+			im2col(inputs, inputs_row_offsets, j, columns);
+			linalg::matrix_prod(columns, filters, outputs, true, false);
 
-		int32_t num_maps = layer->get_num_neurons()/m_input_num_neurons;
+			float64_t* result = activations.get_column_vector(j)+m_row_offset;
+			for (int32_t m=0; m<m_num_maps; m++)
+			{
+				float64_t* map_result = result+m*m_output_num_neurons;
+				float64_t bias = parameters[m*num_parameters_per_map];
+				for (int32_t i=0; i<m_output_num_neurons; i++)
+					map_result[i] = bias;
 
-		for (int32_t m=0; m<num_maps; m++)
-		{
-			SGMatrix<float64_t> weights_matrix(parameters.vector+weights_index_offset,
-				m_filter_height, m_filter_width, false);
-			weights_index_offset += m_filter_height*m_filter_width;
+				for (int32_t p=0; p<num_positions; p++)
+					map_result[get_output_row(p)] += outputs(p,m);
+			}
 
-			convolve(layer->get_activations(), weights_matrix, activations,
-				false, false, m*m_input_num_neurons, m_row_offset);
+			if (m_activation_function==CMAF_LOGISTIC)
+			{
+				for (int32_t i=0; i<num_rows; i++)
+					result[i] = 1.0/(1.0+std::exp(-1.0*result[i]));
+			}
+			else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
+			{
+				for (int32_t i=0; i<num_rows; i++)
+					result[i] = Math::max<float64_t>(0, result[i]);
+			}
 		}
-
-
-	}
-
-	if (m_activation_function==CMAF_LOGISTIC)
-	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
-			for (int32_t j=0; j<batch_size; j++)
-				activations(i + m_row_offset, j) =
-				    1.0 /
-				    (1.0 + std::exp(-1.0 * activations(i + m_row_offset, j)));
-	}
-	else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
-	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
-			for (int32_t j=0; j<batch_size; j++)
-				activations(i+m_row_offset,j) =
-					Math::max<float64_t>(0, activations(i+m_row_offset,j));
 	}
 }
 
-
 void CConvolutionalFeatureMap::compute_gradients(
 	SGVector< float64_t > parameters,
 	SGMatrix<float64_t> activations,
@@ -136,60 +154,105 @@ void CConvolutionalFeatureMap::compute_gradients(
 	SGVector< int32_t > input_indices,
 	SGVector< float64_t > parameter_gradients)
 {
+	std::vector<SGMatrix<float64_t>> inputs;
+	std::vector<SGMatrix<float64_t>> input_gradients;
+	std::vector<int32_t> inputs_row_offsets;
+	get_input_channels(layers, input_indices, false, inputs, inputs_row_offsets);
+	get_input_channels(layers, input_indices, true, input_gradients,
+		inputs_row_offsets);
+
+	bool compute_input_gradients = std::any_of(input_gradients.begin(),
+		input_gradients.end(),
+		[](const SGMatrix<float64_t>& g) { return g.num_rows>0; });
+
+	SGMatrix<float64_t> filters = get_filters(parameters, inputs.size());
+	int32_t num_parameters_per_map = 1+filters.num_rows;
+	int32_t num_positions = m_num_positions_x*m_num_positions_y;
+	int32_t num_rows = m_num_maps*m_output_num_neurons;
 	int32_t batch_size = activation_gradients.num_cols;
 
-	if (m_activation_function==CMAF_LOGISTIC)
+	int32_t num_chunks = std::max(1, std::min(batch_size, GRADIENT_NUM_CHUNKS));
+	std::vector<SGMatrix<float64_t>> chunk_filter_gradients(num_chunks);
+	std::vector<SGVector<float64_t>> chunk_bias_gradients(num_chunks);
+
+	#pragma omp parallel
 	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
+		SGMatrix<float64_t> columns(filters.num_rows, num_positions);
+		SGMatrix<float64_t> local_gradients(num_positions, m_num_maps);
+
+		#pragma omp for schedule(dynamic)
+		for (int32_t chunk=0; chunk<num_chunks; chunk++)
 		{
-			for (int32_t j=0; j<batch_size; j++)
+			SGMatrix<float64_t> filter_gradients(filters.num_rows, m_num_maps);
+			SGVector<float64_t> bias_gradients(m_num_maps);
+			filter_gradients.zero();
+			bias_gradients.zero();
+
+			int32_t end = int64_t(batch_size)*(chunk+1)/num_chunks;
+			for (int32_t j=int64_t(batch_size)*chunk/num_chunks; j<end; j++)
 			{
-				activation_gradients(i+m_row_offset,j) *=
-					activation_gradients(i+m_row_offset,j) *
-					(1.0-activation_gradients(i+m_row_offset,j));
-			}
-		}
-	}
-	else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
-	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
-			for (int32_t j=0; j<batch_size; j++)
-				if (activations(i+m_row_offset,j)==0)
-					activation_gradients(i+m_row_offset,j) = 0;
-	}
+				float64_t* gradients =
+					activation_gradients.get_column_vector(j)+m_row_offset;
+				const float64_t* outputs =
+					activations.get_column_vector(j)+m_row_offset;
 
-	float64_t bias_gradient = 0;
-	for (int32_t i=0; i<m_output_num_neurons; i++)
-		for (int32_t j=0; j<batch_size; j++)
-			bias_gradient += activation_gradients(i+m_row_offset,j);
+				if (m_activation_function==CMAF_LOGISTIC)
+				{
+					for (int32_t i=0; i<num_rows; i++)
+						gradients[i] *= outputs[i]*(1.0-outputs[i]);
+				}
+				else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
+				{
+					for (int32_t i=0; i<num_rows; i++)
+						if (outputs[i]==0)
+							gradients[i] = 0;
+				}
 
-	parameter_gradients[0] = bias_gradient;
+				for (int32_t m=0; m<m_num_maps; m++)
+				{
+					const float64_t* map_gradients =
+						gradients+m*m_output_num_neurons;
+					for (int32_t i=0; i<m_output_num_neurons; i++)
+						bias_gradients[m] += map_gradients[i];
 
-	int32_t weights_index_offset = 1;
-	for (int32_t l=0; l<input_indices.vlen; l++)
-	{
-		auto layer = layers[input_indices[l]];
+					for (int32_t p=0; p<num_positions; p++)
+						local_gradients(p,m) = map_gradients[get_output_row(p)];
+				}
 
-		int32_t num_maps = layer->get_num_neurons()/m_input_num_neurons;
+				im2col(inputs, inputs_row_offsets, j, columns);
+				linalg::dgemm(1.0, columns, local_gradients, false, false, 1.0,
+					filter_gradients);
 
-		for (int32_t m=0; m<num_maps; m++)
-		{
-			SGMatrix<float64_t> W(parameters.vector+weights_index_offset,
-				m_filter_height, m_filter_width, false);
-			SGMatrix<float64_t> WG(parameter_gradients.vector+weights_index_offset,
-				m_filter_height, m_filter_width, false);
-			weights_index_offset += m_filter_height*m_filter_width;
-
-			compute_weight_gradients(layer->get_activations(),
-				activation_gradients, WG, m*m_input_num_neurons, m_row_offset);
-
-			if (!layer->is_input())
-				convolve(activation_gradients, W,
-					layer->get_activation_gradients(), true, false,
-					m_row_offset, m*m_input_num_neurons);
+				if (compute_input_gradients)
+				{
+					linalg::matrix_prod(filters, local_gradients, columns,
+						false, true);
+					col2im(columns, j, input_gradients, inputs_row_offsets);
+				}
+			}
+
+			chunk_filter_gradients[chunk] = filter_gradients;
+			chunk_bias_gradients[chunk] = bias_gradients;
 		}
+	}
 
+	SGMatrix<float64_t> filter_gradients = chunk_filter_gradients[0];
+	SGVector<float64_t> bias_gradients = chunk_bias_gradients[0];
+	for (int32_t chunk=1; chunk<num_chunks; chunk++)
+	{
+		linalg::add(filter_gradients, chunk_filter_gradients[chunk],
+			filter_gradients);
+		linalg::add(bias_gradients, chunk_bias_gradients[chunk],
+			bias_gradients);
+	}
 
+	for (int32_t m=0; m<m_num_maps; m++)
+	{
+		float64_t* map_gradients =
+			parameter_gradients.vector+m*num_parameters_per_map;
+		map_gradients[0] = bias_gradients[m];
+		for (int32_t k=0; k<filters.num_rows; k++)
+			map_gradients[k+1] = filter_gradients(k,m);
 	}
 }
 
@@ -199,153 +262,198 @@ void CConvolutionalFeatureMap::pool_activations(
 	SGMatrix< float64_t > pooled_activations,
 	SGMatrix< float64_t > max_indices)
 {
-	int32_t result_row_offset = m_row_offset;
 	int32_t result_width = m_output_width;
 	int32_t result_height = m_output_height;
 
 	if (m_autoencoder_position == NLAP_NONE)
 	{
-		result_row_offset /= (pooling_width*pooling_height);
 		result_width /= pooling_width;
 		result_height /= pooling_height;
 	}
 
+	#pragma omp parallel for
 	for (int32_t i=0; i<pooled_activations.num_cols; i++)
 	{
-		SGMatrix<float64_t> image(
-			activations.matrix+i*activations.num_rows + m_row_offset,
-			m_output_height, m_output_width, false);
+		for (int32_t m=0; m<m_num_maps; m++)
+		{
+			int32_t row_offset = m_row_offset+m*m_output_num_neurons;
+			int32_t result_row_offset = row_offset;
+			if (m_autoencoder_position == NLAP_NONE)
+				result_row_offset /= (pooling_width*pooling_height);
 
-		SGMatrix<float64_t> result(
-			pooled_activations.matrix+i*pooled_activations.num_rows + result_row_offset,
-			result_height, result_width, false);
+			const float64_t* image =
+				activations.matrix+int64_t(i)*activations.num_rows+row_offset;
 
-		SGMatrix<float64_t> indices(
-			max_indices.matrix+i*max_indices.num_rows + result_row_offset,
-			result_height, result_width, false);
+			SGMatrix<float64_t> result(
+				pooled_activations.matrix+int64_t(i)*pooled_activations.num_rows
+				+ result_row_offset, result_height, result_width, false);
 
-		if (m_autoencoder_position != NLAP_NONE)
-		{
-			result.zero();
-			indices.set_const(-1.0);
-		}
+			SGMatrix<float64_t> indices(
+				max_indices.matrix+int64_t(i)*max_indices.num_rows
+				+ result_row_offset, result_height, result_width, false);
 
-		for (int32_t x=0; x<m_output_width; x+=pooling_width)
-		{
-			for (int32_t y=0; y<m_output_height; y+=pooling_height)
+			if (m_autoencoder_position != NLAP_NONE)
 			{
-				float64_t max = image(y,x);
-				int32_t max_index = m_row_offset+y+x*image.num_rows;
+				result.zero();
+				indices.set_const(-1.0);
+			}
 
-				for (int32_t x1=x; x1<x+pooling_width; x1++)
+			for (int32_t x=0; x<m_output_width; x+=pooling_width)
+			{
+				for (int32_t y=0; y<m_output_height; y+=pooling_height)
 				{
-					for (int32_t y1=y; y1<y+pooling_height; y1++)
+					int32_t max_index = y+x*m_output_height;
+					float64_t max = image[max_index];
+
+					// scan the pooling region column by column, i.e. along
+					// contiguous memory
+					for (int32_t x1=x; x1<x+pooling_width; x1++)
 					{
-						if (image(y1,x1) > max)
+						const float64_t* column = image+x1*m_output_height;
+						for (int32_t y1=y; y1<y+pooling_height; y1++)
 						{
-							max = image(y1,x1);
-							max_index = m_row_offset+y1+x1*image.num_rows;
+							if (column[y1] > max)
+							{
+								max = column[y1];
+								max_index = y1+x1*m_output_height;
+							}
 						}
 					}
-				}
-				if (m_autoencoder_position == NLAP_NONE)
-				{
-					result(y/pooling_height, x/pooling_width) = max;
-					indices(y/pooling_height, x/pooling_width) = max_index;
-				}
-				else
-				{
-					result(y, x) = max;
-					indices(y, x) = max_index;
+
+					int32_t res_y = y, res_x = x;
+					if (m_autoencoder_position == NLAP_NONE)
+					{
+						res_y /= pooling_height;
+						res_x /= pooling_width;
+					}
+					result(res_y, res_x) = max;
+					indices(res_y, res_x) = row_offset+max_index;
 				}
 			}
 		}
 	}
 }
 
-void CConvolutionalFeatureMap::convolve(
-	SGMatrix< float64_t > inputs,
-	SGMatrix< float64_t > weights,
-	SGMatrix< float64_t > outputs,
-	bool flip,
-	bool reset_output,
-	int32_t inputs_row_offset,
- 	int32_t outputs_row_offset)
+void CConvolutionalFeatureMap::get_input_channels(
+	const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+	SGVector<int32_t> input_indices, bool gradients,
+	std::vector<SGMatrix<float64_t>>& channels,
+	std::vector<int32_t>& row_offsets) const
+{
+	channels.clear();
+	row_offsets.clear();
+	for (int32_t l=0; l<input_indices.vlen; l++)
+	{
+		auto& layer = layers[input_indices[l]];
+
+		SGMatrix<float64_t> matrix;
+		if (!gradients)
+			matrix = layer->get_activations();
+		else if (!layer->is_input())
+			matrix = layer->get_activation_gradients();
+
+		int32_t num_maps = layer->get_num_neurons()/m_input_num_neurons;
+		for (int32_t m=0; m<num_maps; m++)
+		{
+			channels.push_back(matrix);
+			row_offsets.push_back(m*m_input_num_neurons);
+		}
+	}
+}
+
+SGMatrix<float64_t> CConvolutionalFeatureMap::get_filters(
+	SGVector<float64_t> parameters, int32_t num_channels) const
 {
-	for (int32_t i=0; i<outputs.num_cols; i++)
+	int32_t num_weights = num_channels*m_filter_width*m_filter_height;
+	require(parameters.vlen>=m_num_maps*(1+num_weights),
+		"Expected {} parameters for {} maps with {} input channels, got {}",
+		m_num_maps*(1+num_weights), m_num_maps, num_channels, parameters.vlen);
+
+	SGMatrix<float64_t> filters(num_weights, m_num_maps);
+	for (int32_t m=0; m<m_num_maps; m++)
 	{
-		SGMatrix<float64_t> image(
-			inputs.matrix+i*inputs.num_rows + inputs_row_offset,
-			m_input_height, m_input_width, false);
+		sg_memcpy(filters.get_column_vector(m),
+			parameters.vector+m*(1+num_weights)+1,
+			sizeof(float64_t)*num_weights);
+	}
+	return filters;
+}
 
-		SGMatrix<float64_t> result(
-			outputs.matrix+i*outputs.num_rows + outputs_row_offset,
-			m_output_height, m_output_width, false);
+void CConvolutionalFeatureMap::im2col(
+	const std::vector<SGMatrix<float64_t>>& channels,
+	const std::vector<int32_t>& row_offsets, int32_t image,
+	SGMatrix<float64_t> columns) const
+{
+	int32_t filter_size = m_filter_width*m_filter_height;
+	int32_t num_channels = channels.size();
 
-		for (int32_t x=0; x<m_input_width; x+=m_stride_x)
+	// the filter is flipped, i.e. filter element (r_y-dy, r_x-dx) is applied
+	// to the pixel at offset (dy, dx) from the center of the patch
+	for (int32_t px=0; px<m_num_positions_x; px++)
+	{
+		for (int32_t py=0; py<m_num_positions_y; py++)
 		{
-			for (int32_t y=0; y<m_input_height; y+=m_stride_y)
+			int32_t x = px*m_stride_x;
+			int32_t y = py*m_stride_y;
+			float64_t* column =
+				columns.get_column_vector(py+px*m_num_positions_y);
+
+			for (int32_t c=0; c<num_channels; c++)
 			{
-				int32_t res_x = m_autoencoder_position == NLAP_NONE ? x/m_stride_x : x;
-				int32_t res_y = m_autoencoder_position == NLAP_NONE ? y/m_stride_y : y;
+				const float64_t* input = channels[c].matrix+
+					int64_t(image)*channels[c].num_rows+row_offsets[c];
+				float64_t* patch = column+(c+1)*filter_size-1;
 
-				float64_t sum = reset_output ? 0 : result(res_y,res_x);
 				for (int32_t x1=x-m_radius_x; x1<=x+m_radius_x; x1++)
 				{
 					for (int32_t y1=y-m_radius_y; y1<=y+m_radius_y; y1++)
 					{
-						if (x1>=0 && y1>=0 && x1<image.num_cols && y1<image.num_rows)
-						{
-							if (flip)
-								sum +=
-									weights(y1-y+m_radius_y,x1-x+m_radius_x)*image(y1,x1);
-							else
-								sum +=
-									weights(m_radius_y-y1+y,m_radius_x-x1+x)*image(y1,x1);
-						}
+						if (x1>=0 && y1>=0 &&
+							x1<m_input_width && y1<m_input_height)
+							*patch = input[y1+x1*m_input_height];
+						else
+							*patch = 0;
+						patch--;
 					}
 				}
-				result(res_y,res_x) = sum;
 			}
 		}
 	}
 }
 
-void CConvolutionalFeatureMap::compute_weight_gradients(
-	SGMatrix< float64_t > inputs,
-	SGMatrix< float64_t > local_gradients,
-	SGMatrix< float64_t > weight_gradients,
-	int32_t inputs_row_offset,
- 	int32_t local_gradients_row_offset)
+void CConvolutionalFeatureMap::col2im(SGMatrix<float64_t> columns,
+	int32_t image, const std::vector<SGMatrix<float64_t>>& channels,
+	const std::vector<int32_t>& row_offsets) const
 {
-	weight_gradients.zero();
-	for (int32_t i=0; i<local_gradients.num_cols; i++)
-	{
-		SGMatrix<float64_t> image(
-			inputs.matrix+i*inputs.num_rows + inputs_row_offset,
-			m_input_height, m_input_width, false);
-
-		SGMatrix<float64_t> LG_image(
-			local_gradients.matrix+i*local_gradients.num_rows
-			+ local_gradients_row_offset, m_output_height, m_output_width, false);
+	int32_t filter_size = m_filter_width*m_filter_height;
+	int32_t num_channels = channels.size();
 
-		for (int32_t x=0; x<m_input_width; x+=m_stride_x)
+	for (int32_t px=0; px<m_num_positions_x; px++)
+	{
+		for (int32_t py=0; py<m_num_positions_y; py++)
 		{
-			for (int32_t y=0; y<m_input_height; y+=m_stride_y)
+			int32_t x = px*m_stride_x;
+			int32_t y = py*m_stride_y;
+			const float64_t* column =
+				columns.get_column_vector(py+px*m_num_positions_y);
+
+			for (int32_t c=0; c<num_channels; c++)
 			{
+				if (channels[c].num_rows==0)
+					continue;
+
+				float64_t* output = channels[c].matrix+
+					int64_t(image)*channels[c].num_rows+row_offsets[c];
+				const float64_t* patch = column+(c+1)*filter_size-1;
+
 				for (int32_t x1=x-m_radius_x; x1<=x+m_radius_x; x1++)
 				{
 					for (int32_t y1=y-m_radius_y; y1<=y+m_radius_y; y1++)
 					{
-						if (x1>=0 && y1>=0 && x1<image.num_cols && y1<image.num_rows)
-						{
-							if (m_autoencoder_position == NLAP_NONE)
-								weight_gradients(m_radius_y-y1+y,m_radius_x-x1+x) +=
-									LG_image(y/m_stride_y,x/m_stride_x)*image(y1,x1);
-							else
-								weight_gradients(m_radius_y-y1+y,m_radius_x-x1+x) +=
-									LG_image(y,x)*image(y1,x1);
-						}
+						if (x1>=0 && y1>=0 &&
+							x1<m_input_width && y1<m_input_height)
+							output[y1+x1*m_input_height] += *patch;
+						patch--;
 					}
 				}
 			}
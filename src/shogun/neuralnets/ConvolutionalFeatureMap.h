@@ -37,6 +37,8 @@
 #include <shogun/lib/common.h>
 #include <shogun/neuralnets/NeuralLayer.h>
 
+#include <vector>
+
 namespace shogun
 {
 
@@ -58,8 +60,16 @@ enum EConvMapActivationFunction
 template <class T> class SGVector;
 template <class T> class SGMatrix;
 
-/** @brief Handles convolution and gradient calculation for a single feature
- * map in a convolutional neural network
+/** @brief Handles convolution and gradient calculation for one or more
+ * consecutive feature maps in a convolutional neural network
+ *
+ * The convolutions are lowered to matrix products: the patches of an input
+ * image that the filters are applied to are copied into the columns of a
+ * matrix (im2col), which is then multiplied with the filters of all maps at
+ * once. The gradients with respect to the filters and the inputs are
+ * computed the same way, the latter by scattering the product of the
+ * filters and the output gradients back into the input images (col2im).
+ * The images of a mini-batch are processed in parallel.
  */
 class CConvolutionalFeatureMap
 {
@@ -77,18 +87,22 @@ public:
 	 * its outputs in.
 	 * @param function Activation function
 	 * @param autoencoder_position Autoencoder position
+	 * @param num_maps Number of consecutive maps, starting at index, that
+	 * are handled together
 	 */
 	CConvolutionalFeatureMap(int32_t input_width, int32_t input_height,
 			int32_t radius_x, int32_t radius_y,
 			int32_t stride_x=1, int32_t stride_y=1,
 			int32_t index=0,
 			EConvMapActivationFunction function = CMAF_IDENTITY,
-			ENLAutoencoderPosition autoencoder_position = NLAP_NONE);
+			ENLAutoencoderPosition autoencoder_position = NLAP_NONE,
+			int32_t num_maps=1);
 
-	/** Computes the activations of the feature map
+	/** Computes the activations of the feature maps
 	 *
-	 * @param parameters Vector of parameters for the map. length
-	 * width*height+(2*radius_x+1)+(2*radius_y+1)
+	 * @param parameters Vector of parameters for the maps. For each map a
+	 * bias followed by one (2*radius_y+1)x(2*radius_x+1) filter per input
+	 * channel
 	 * @param layers The layers array that forms the network in which the map
 	 * is being used
 	 * @param input_indices Indices of the layers that are connected to the map
@@ -101,10 +115,11 @@ public:
 			SGMatrix<float64_t> activations);
 
 	/** Computes the gradients with respect to the parameters and the inputs to
-	 * the map
+	 * the maps. The input gradients are added to the activation gradients of
+	 * the input layers.
 	 *
-	 * @param parameters Vector of parameters for the map. length
-	 * width*height+(2*radius_x+1)+(2*radius_y+1)
+	 * @param parameters Vector of parameters for the maps, see
+	 * compute_activations()
 	 * @param activations Activations of the map
 	 * @param activation_gradients Gradients of the error with respect to the
 	 * map's activations
@@ -134,41 +149,67 @@ public:
 			SGMatrix<float64_t> max_indices);
 
 protected:
-	/** Perfoms convolution
+	/** Collects the input channels of the maps
+	 *
+	 * @param layers The layers array that forms the network in which the maps
+	 * are being used
+	 * @param input_indices Indices of the layers that are connected to the maps
+	 * @param gradients If true, the activation gradients of the layers are
+	 * collected instead of the activations, and empty matrices for input
+	 * layers
+	 * @param channels Matrix holding each channel
+	 * @param row_offsets Row at which each channel starts in its matrix
+	 */
+	void get_input_channels(
+			const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+			SGVector<int32_t> input_indices, bool gradients,
+			std::vector<SGMatrix<float64_t>>& channels,
+			std::vector<int32_t>& row_offsets) const;
+
+	/** Copies the filters of all maps out of the parameters
 	 *
-	 * @param inputs Inputs matrix. Each column in the matrix is treated as an
-	 * image in column major format
-	 * @param weights Convolution filter
-	 * @param outputs Output matrix
-	 * @param flip If true the weights are flipped, performing cross-correlation
-	 * instead of convolution
-	 * @param reset_output true the output is reset to zero before performing
-	 * convolution
-	 * @param inputs_row_offset Index of the row at which the input image starts
-	 * @param outputs_row_offset Index of the row at which the output image starts
+	 * @param parameters Vector of parameters for the maps
+	 * @param num_channels Number of input channels
+	 * @return Matrix with the filters of map m, all channels stacked, in
+	 * column m
 	 */
-	void convolve(SGMatrix<float64_t> inputs,
-			SGMatrix<float64_t> weights,
-			SGMatrix<float64_t> outputs,
-			bool flip,
-			bool reset_output,
-			int32_t inputs_row_offset,
- 			int32_t outputs_row_offset);
-
-	/** Computes the gradients of the error with respect to the weights, for a
-	 * particular input matrix
+	SGMatrix<float64_t> get_filters(SGVector<float64_t> parameters,
+			int32_t num_channels) const;
+
+	/** Copies the patches of one input image that the filters are applied to
+	 * into the columns of a matrix
 	 *
-	 * @param inputs Inputs matrix
-	 * @param local_gradients Gradients with respect the map's pre-activations
-	 * @param weight_gradients Matrix to store the gradients in
-	 * @param inputs_row_offset Offset for accessing the rows of the inputs matrix
-	 * @param local_gradients_row_offset Offset for accessing the rows of the local gradients matrix
+	 * @param channels Input channels, see get_input_channels()
+	 * @param row_offsets Row offsets of the channels
+	 * @param image Index of the image in the batch
+	 * @param columns Matrix of size (num_channels*filter size) x (number of
+	 * filter positions) to store the patches in
 	 */
-	void compute_weight_gradients(SGMatrix<float64_t> inputs,
-			SGMatrix<float64_t> local_gradients,
-			SGMatrix<float64_t> weight_gradients,
-			int32_t inputs_row_offset,
- 			int32_t local_gradients_row_offset);
+	void im2col(const std::vector<SGMatrix<float64_t>>& channels,
+			const std::vector<int32_t>& row_offsets, int32_t image,
+			SGMatrix<float64_t> columns) const;
+
+	/** Adds the columns of a matrix of the im2col() layout back to the
+	 * pixels of the input images they were copied from
+	 *
+	 * @param columns Matrix of the im2col() layout
+	 * @param image Index of the image in the batch
+	 * @param channels Input channels, empty ones are skipped
+	 * @param row_offsets Row offsets of the channels
+	 */
+	void col2im(SGMatrix<float64_t> columns, int32_t image,
+			const std::vector<SGMatrix<float64_t>>& channels,
+			const std::vector<int32_t>& row_offsets) const;
+
+	/** @return Row of filter position p in the output of a map */
+	int32_t get_output_row(int32_t p) const
+	{
+		if (m_autoencoder_position == NLAP_NONE)
+			return p;
+
+		return (p%m_num_positions_y)*m_stride_y +
+			(p/m_num_positions_y)*m_stride_x*m_output_height;
+	}
 
 protected:
 	/** Width of the input */
@@ -189,11 +230,14 @@ protected:
 	/** Stride in the y direcetion */
 	int32_t m_stride_y;
 
-	/** Index of this feature map in its layer. This affects which
+	/** Index of the first feature map in its layer. This affects which
 	 * part of the activations/activation_gradients matrix that map will use
 	 */
 	int32_t m_index;
 
+	/** Number of feature maps */
+	int32_t m_num_maps;
+
 	/** The map's activation function */
 	EConvMapActivationFunction m_activation_function;
 
@@ -218,6 +262,12 @@ protected:
 	/** Height of the convolution filter */
 	int32_t m_filter_height;
 
+	/** Number of positions of the filter on the x (width) axis */
+	int32_t m_num_positions_x;
+
+	/** Number of positions of the filter on the y (height) axis */
+	int32_t m_num_positions_y;
+
 	/** For autoencoders, specifies the position of the layer in the autoencoder,
 	 * i.e an encoding layer or a decoding layer. Default value is NLAP_NONE
 	 */
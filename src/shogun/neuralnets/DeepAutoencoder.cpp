@@ -220,15 +220,17 @@ std::shared_ptr<NeuralNetwork> DeepAutoencoder::convert_to_neural_network(
 	return net;
 }
 
-float64_t DeepAutoencoder::compute_error(SGMatrix< float64_t > targets)
+float64_t DeepAutoencoder::compute_batch_error(
+	const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+	SGMatrix<float64_t> targets)
 {
-	float64_t error = NeuralNetwork::compute_error(targets);
+	float64_t error = NeuralNetwork::compute_batch_error(layers, targets);
 
 	if (m_contraction_coefficient != 0.0)
 
 	for (int32_t i=1; i<=(m_num_layers-1)/2; i++)
 		error +=
-			get_layer(i)->compute_contraction_term(get_section(m_params,i));
+			layers[i]->compute_contraction_term(get_section(m_params,i));
 
 	return error;
 }
@@ -188,12 +188,17 @@ public:
 
 protected:
 	/** Computes the error between the output layer's activations and the given
-	 * target activations.
+	 * target activations, plus the contraction term if the autoencoder is
+	 * contractive.
+	 *
+	 * @param layers layers of the network
 	 *
 	 * @param targets desired values for the network's output, matrix of size
 	 * num_neurons_output_layer*batch_size
 	 */
-	virtual float64_t compute_error(SGMatrix<float64_t> targets);
+	virtual float64_t compute_batch_error(
+		const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+		SGMatrix<float64_t> targets);
 
 private:
 	void init();
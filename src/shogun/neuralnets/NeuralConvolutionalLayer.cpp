@@ -161,25 +161,16 @@ void NeuralConvolutionalLayer::compute_activations(
 		SGVector<float64_t> parameters,
 		const std::vector<std::shared_ptr<NeuralLayer>>& layers)
 {
-	int32_t num_parameters_per_map =
-		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
-
-	for (int32_t m=0; m<m_num_maps; m++)
-	{
-		SGVector<float64_t> map_params(
-			parameters.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
-
-		CConvolutionalFeatureMap map(m_input_width, m_input_height,
-			m_radius_x, m_radius_y, m_stride_x, m_stride_y, m,
-			m_activation_function, autoencoder_position);
+	// all maps share the patches of the inputs, so they are handled together
+	CConvolutionalFeatureMap maps(m_input_width, m_input_height,
+		m_radius_x, m_radius_y, m_stride_x, m_stride_y, 0,
+		m_activation_function, autoencoder_position, m_num_maps);
 
-		map.compute_activations(map_params, layers, m_input_indices,
-			m_convolution_output);
+	maps.compute_activations(parameters, layers, m_input_indices,
+		m_convolution_output);
 
-		map.pool_activations(m_convolution_output,
-			m_pooling_width, m_pooling_height, m_activations, m_max_indices);
-	}
+	maps.pool_activations(m_convolution_output,
+		m_pooling_width, m_pooling_height, m_activations, m_max_indices);
 }
 
 void NeuralConvolutionalLayer::compute_gradients(
@@ -212,27 +203,13 @@ void NeuralConvolutionalLayer::compute_gradients(
 				m_convolution_output_gradients(m_max_indices(i,j),j) =
 					m_activation_gradients(i,j);
 
-	int32_t num_parameters_per_map =
-		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
-
-	for (int32_t m=0; m<m_num_maps; m++)
-	{
-		SGVector<float64_t> map_params(
-			parameters.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
+	CConvolutionalFeatureMap maps(m_input_width, m_input_height,
+		m_radius_x, m_radius_y, m_stride_x, m_stride_y, 0,
+		m_activation_function, autoencoder_position, m_num_maps);
 
-		SGVector<float64_t> map_gradients(
-			parameter_gradients.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
-
-		CConvolutionalFeatureMap map(m_input_width, m_input_height,
-			m_radius_x, m_radius_y, m_stride_x, m_stride_y, m,
-			m_activation_function, autoencoder_position);
-
-		map.compute_gradients(map_params, m_convolution_output,
-			m_convolution_output_gradients, layers,
-			m_input_indices, map_gradients);
-	}
+	maps.compute_gradients(parameters, m_convolution_output,
+		m_convolution_output_gradients, layers,
+		m_input_indices, parameter_gradients);
 }
 
 float64_t NeuralConvolutionalLayer::compute_error(SGMatrix<float64_t> targets)
@@ -34,6 +34,7 @@
 #include <shogun/neuralnets/NeuralLogisticLayer.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/lib/SGVector.h>
+#include <shogun/mathematics/linalg/LinalgLazy.h>
 
 using namespace shogun;
 
@@ -53,9 +54,8 @@ void NeuralLogisticLayer::compute_activations(
 	NeuralLinearLayer::compute_activations(parameters, layers);
 
 	// apply logistic activation function
-	int32_t length = m_num_neurons*m_batch_size;
-	for (int32_t i=0; i<length; i++)
-		m_activations[i] = 1.0 / (1.0 + std::exp(-1.0 * m_activations[i]));
+	using namespace linalg::lazy;
+	eval(logistic(ref(m_activations)), m_activations);
 }
 
 float64_t NeuralLogisticLayer::compute_contraction_term(
@@ -117,7 +117,7 @@ void NeuralLogisticLayer::compute_local_gradients(SGMatrix<float64_t> targets)
 	NeuralLinearLayer::compute_local_gradients(targets);
 
 	// multiply by the derivative of the logistic function
-	int32_t length = m_num_neurons*m_batch_size;
-	for (int32_t i=0; i<length; i++)
-		m_local_gradients[i] *= m_activations[i] * (1.0-m_activations[i]);
+	using namespace linalg::lazy;
+	eval(ref(m_local_gradients)*ref(m_activations)*(1.0-ref(m_activations)),
+		m_local_gradients);
 }
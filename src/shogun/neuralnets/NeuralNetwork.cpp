@@ -31,8 +31,10 @@
  * Written (W) 2014 Khaled Nasr
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/RandomNamespace.h>
 #include <shogun/mathematics/UniformRealDistribution.h>
@@ -42,6 +44,11 @@
 
 using namespace shogun;
 
+/** chunk size of forward_propagate_chunked() for streaming features if none
+ * is set
+ */
+static constexpr int32_t STREAMING_CHUNK_SIZE = 1024;
+
 NeuralNetwork::NeuralNetwork()
 : RandomMixin<Machine>()
 {
@@ -153,6 +160,9 @@ void NeuralNetwork::initialize_neural_network(float64_t sigma)
 
 		get_layer(i)->set_batch_size(m_batch_size);
 	}
+
+	m_inference_layers.clear();
+	m_inference_inputs.clear();
 }
 
 NeuralNetwork::~NeuralNetwork()
@@ -162,10 +172,11 @@ NeuralNetwork::~NeuralNetwork()
 
 std::shared_ptr<BinaryLabels> NeuralNetwork::apply_binary(std::shared_ptr<Features> data)
 {
-	SGMatrix<float64_t> output_activations = forward_propagate(data);
-	auto labels = std::make_shared<BinaryLabels>(m_batch_size);
+	SGMatrix<float64_t> output_activations = compute_outputs(data);
+	int32_t num_vectors = output_activations.num_cols;
+	auto labels = std::make_shared<BinaryLabels>(num_vectors);
 
-	for (int32_t i=0; i<m_batch_size; i++)
+	for (int32_t i=0; i<num_vectors; i++)
 	{
 		if (get_num_outputs()==1)
 		{
@@ -191,10 +202,10 @@ std::shared_ptr<BinaryLabels> NeuralNetwork::apply_binary(std::shared_ptr<Featur
 
 std::shared_ptr<RegressionLabels> NeuralNetwork::apply_regression(std::shared_ptr<Features> data)
 {
-	SGMatrix<float64_t> output_activations = forward_propagate(data);
-	SGVector<float64_t> labels_vec(m_batch_size);
+	SGMatrix<float64_t> output_activations = compute_outputs(data);
+	SGVector<float64_t> labels_vec(output_activations.num_cols);
 
-	for (int32_t i=0; i<m_batch_size; i++)
+	for (int32_t i=0; i<labels_vec.vlen; i++)
 			labels_vec[i] = output_activations[i];
 
 	return std::make_shared<RegressionLabels>(labels_vec);
@@ -203,10 +214,10 @@ std::shared_ptr<RegressionLabels> NeuralNetwork::apply_regression(std::shared_pt
 
 std::shared_ptr<MulticlassLabels> NeuralNetwork::apply_multiclass(std::shared_ptr<Features> data)
 {
-	SGMatrix<float64_t> output_activations = forward_propagate(data);
-	SGVector<float64_t> labels_vec(m_batch_size);
+	SGMatrix<float64_t> output_activations = compute_outputs(data);
+	SGVector<float64_t> labels_vec(output_activations.num_cols);
 
-	for (int32_t i=0; i<m_batch_size; i++)
+	for (int32_t i=0; i<labels_vec.vlen; i++)
 	{
 		labels_vec[i] = Math::arg_max(
 			output_activations.matrix+i*get_num_outputs(), 1, get_num_outputs());
@@ -215,7 +226,7 @@ std::shared_ptr<MulticlassLabels> NeuralNetwork::apply_multiclass(std::shared_pt
 	auto labels = std::make_shared<MulticlassLabels>(labels_vec);
 
 	labels->allocate_confidences_for(get_num_outputs());
-	for (int32_t i=0; i<m_batch_size; i++)
+	for (int32_t i=0; i<labels_vec.vlen; i++)
 	{
 		labels->set_multiclass_confidences(i, SGVector<float64_t>(
 			output_activations.matrix, get_num_outputs(), i*get_num_outputs()));
@@ -227,7 +238,7 @@ std::shared_ptr<MulticlassLabels> NeuralNetwork::apply_multiclass(std::shared_pt
 std::shared_ptr<DenseFeatures< float64_t >> NeuralNetwork::transform(
 	std::shared_ptr<DenseFeatures< float64_t >> data)
 {
-	SGMatrix<float64_t> output_activations = forward_propagate(data);
+	SGMatrix<float64_t> output_activations = compute_outputs(data);
 	return std::make_shared<DenseFeatures<float64_t>>(output_activations);
 }
 
@@ -266,6 +277,10 @@ bool NeuralNetwork::train_machine(std::shared_ptr<Features> data)
 		get_layer(i)->is_training = false;
 	m_is_training = false;
 
+	// the copies of the layers for inference were made with the old settings
+	m_inference_layers.clear();
+	m_inference_inputs.clear();
+
 	return result;
 }
 
@@ -281,6 +296,11 @@ bool NeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 	if (m_gd_mini_batch_size==0) m_gd_mini_batch_size = training_set_size;
 	set_batch_size(m_gd_mini_batch_size);
 
+	require(m_gd_num_shards>=1,
+		"Number of mini-batch shards ({}) must be >= 1", m_gd_num_shards);
+	if (m_gd_num_shards>1)
+		init_shards(m_gd_mini_batch_size);
+
 	int32_t n_param = get_num_parameters();
 	SGVector<float64_t> gradients(n_param);
 
@@ -316,7 +336,9 @@ bool NeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 			for (int32_t k=0; k<n_param; k++)
 				m_params[k] += m_gd_momentum*param_updates[k];
 
-			float64_t e = compute_gradients(inputs_batch, targets_batch, gradients);
+			float64_t e = m_shard_layers.empty() ?
+				compute_gradients(inputs_batch, targets_batch, gradients) :
+				compute_gradients_sharded(inputs_batch, targets_batch, gradients);
 
 
 			for (int32_t k=0; k<m_num_layers; k++)
@@ -360,6 +382,8 @@ bool NeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 		}
 	}
 
+	m_shard_layers.clear();
+
 	return true;
 }
 
@@ -454,46 +478,192 @@ SGMatrix<float64_t> NeuralNetwork::forward_propagate(std::shared_ptr<Features> d
 
 SGMatrix<float64_t> NeuralNetwork::forward_propagate(
 	SGMatrix<float64_t> inputs, int32_t j)
+{
+	return forward_pass(m_layers, inputs, j);
+}
+
+SGMatrix<float64_t> NeuralNetwork::forward_pass(
+	const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+	SGMatrix<float64_t> inputs, int32_t j)
 {
 	if (j==-1)
 		j = m_num_layers-1;
 
 	for (int32_t i=0; i<=j; i++)
 	{
-		auto layer = get_layer(i);
+		auto& layer = layers[i];
 
 		if (layer->is_input())
 			layer->compute_activations(inputs);
 		else
-			layer->compute_activations(get_section(m_params, i), m_layers);
+			layer->compute_activations(get_section(m_params, i), layers);
 
 		layer->dropout_activations();
 	}
 
-	return get_layer(j)->get_activations();
+	return layers[j]->get_activations();
+}
+
+SGMatrix<float64_t> NeuralNetwork::compute_outputs(std::shared_ptr<Features> data)
+{
+	require(data != NULL, "Invalid (NULL) feature pointer");
+
+	if (m_inference_chunk_size>0 ||
+		data->get_feature_class()==C_STREAMING_DENSE)
+		return forward_propagate_chunked(data);
+
+	return forward_propagate(data);
+}
+
+SGMatrix<float64_t> NeuralNetwork::forward_propagate_chunked(
+	std::shared_ptr<Features> data)
+{
+	require(data != NULL, "Invalid (NULL) feature pointer");
+	require(m_inference_chunk_size>=0,
+		"Inference chunk size ({}) must be >= 0", m_inference_chunk_size);
+
+	int32_t chunk_size = m_inference_chunk_size>0 ?
+		m_inference_chunk_size : STREAMING_CHUNK_SIZE;
+	int32_t num_workers = Math::max(env()->get_num_threads(), 1);
+	int32_t num_outputs = get_num_outputs();
+
+	if (data->get_feature_class()!=C_STREAMING_DENSE)
+	{
+		SGMatrix<float64_t> inputs = features_to_matrix(data);
+		index_t num_vectors = inputs.num_cols;
+		int64_t num_chunks = (num_vectors+chunk_size-1)/chunk_size;
+		num_workers = Math::max<int64_t>(
+			Math::min<int64_t>(num_workers, num_chunks), 1);
+		init_inference_buffers(num_workers, chunk_size);
+
+		SGMatrix<float64_t> outputs(num_outputs, num_vectors);
+
+#pragma omp parallel for num_threads(num_workers)
+		for (int32_t w=0; w<num_workers; w++)
+		{
+			// worker w propagates the chunks w, w+num_workers, ...
+			for (int64_t c=w; c<num_chunks; c+=num_workers)
+			{
+				index_t begin = c*chunk_size;
+				index_t size = Math::min<index_t>(chunk_size, num_vectors-begin);
+
+				SGMatrix<float64_t> chunk(
+					inputs.matrix+int64_t(begin)*m_num_inputs,
+					m_num_inputs, chunk_size, false);
+				if (size<chunk_size)
+				{
+					// the last chunk is copied into the buffer so that the
+					// layers keep their batch size
+					chunk = m_inference_inputs[w];
+					sg_memcpy(chunk.matrix,
+						inputs.matrix+int64_t(begin)*m_num_inputs,
+						int64_t(size)*m_num_inputs*sizeof(float64_t));
+				}
+
+				auto activations =
+					forward_pass(m_inference_layers[w], chunk, -1);
+				sg_memcpy(outputs.matrix+int64_t(begin)*num_outputs,
+					activations.matrix,
+					int64_t(size)*num_outputs*sizeof(float64_t));
+			}
+		}
+
+		return outputs;
+	}
+
+	require(data->get_feature_type()==F_DREAL,
+		"Feature type must be F_DREAL");
+	auto stream = data->as<StreamingDenseFeatures<float64_t>>();
+	init_inference_buffers(num_workers, chunk_size);
+
+	std::vector<float64_t> outputs;
+	std::vector<index_t> sizes(num_workers);
+	bool stream_ended = false;
+
+	stream->start_parser();
+	while (!stream_ended)
+	{
+		// read one chunk per worker from the stream, which is sequential,
+		// and propagate the chunks in parallel
+		int32_t num_chunks = 0;
+		while (num_chunks<num_workers && !stream_ended)
+		{
+			auto& buffer = m_inference_inputs[num_chunks];
+			index_t size = 0;
+			while (size<chunk_size)
+			{
+				if (!stream->get_next_example())
+				{
+					stream_ended = true;
+					break;
+				}
+
+				SGVector<float64_t> vec = stream->get_vector();
+				require(vec.vlen==m_num_inputs,
+					"Number of features ({}) must match the network's number "
+					"of inputs ({})", vec.vlen, m_num_inputs);
+				sg_memcpy(buffer.get_column_vector(size), vec.vector,
+					m_num_inputs*sizeof(float64_t));
+				stream->release_example();
+				size++;
+			}
+
+			if (size>0)
+				sizes[num_chunks++] = size;
+		}
+
+#pragma omp parallel for num_threads(num_workers)
+		for (int32_t w=0; w<num_chunks; w++)
+			forward_pass(m_inference_layers[w], m_inference_inputs[w], -1);
+
+		for (int32_t w=0; w<num_chunks; w++)
+		{
+			auto activations =
+				m_inference_layers[w][m_num_layers-1]->get_activations();
+			outputs.insert(outputs.end(), activations.matrix,
+				activations.matrix+int64_t(sizes[w])*num_outputs);
+		}
+	}
+	stream->end_parser();
+
+	SGMatrix<float64_t> result(num_outputs, outputs.size()/num_outputs);
+	sg_memcpy(result.matrix, outputs.data(), outputs.size()*sizeof(float64_t));
+	return result;
 }
 
 float64_t NeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 		SGMatrix<float64_t> targets, SGVector<float64_t> gradients)
 {
 	forward_propagate(inputs);
+	backward_pass(m_layers, targets, gradients);
+	regularize_gradients(gradients);
+
+	return compute_error(targets);
+}
 
+void NeuralNetwork::backward_pass(
+	const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+	SGMatrix<float64_t> targets, SGVector<float64_t> gradients)
+{
 	for (int32_t i=0; i<m_num_layers; i++)
 	{
-		if (!get_layer(i)->is_input())
-			get_layer(i)->get_activation_gradients().zero();
+		if (!layers[i]->is_input())
+			layers[i]->get_activation_gradients().zero();
 	}
 
 	for (int32_t i=m_num_layers-1; i>=0; i--)
 	{
 		if (i==m_num_layers-1)
-			get_layer(i)->compute_gradients(get_section(m_params,i), targets,
-				m_layers, get_section(gradients,i));
+			layers[i]->compute_gradients(get_section(m_params,i), targets,
+				layers, get_section(gradients,i));
 		else
-			get_layer(i)->compute_gradients(get_section(m_params,i),
-				SGMatrix<float64_t>(), m_layers, get_section(gradients,i));
+			layers[i]->compute_gradients(get_section(m_params,i),
+				SGMatrix<float64_t>(), layers, get_section(gradients,i));
 	}
+}
 
+void NeuralNetwork::regularize_gradients(SGVector<float64_t> gradients)
+{
 	// L2 regularization
 	if (m_l2_coefficient != 0.0)
 	{
@@ -524,13 +694,138 @@ float64_t NeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 			get_layer(i)->enforce_max_norm(layer_params, m_max_norm);
 		}
 	}
+}
 
-	return compute_error(targets);
+void NeuralNetwork::init_shards(int32_t batch_size)
+{
+	int32_t num_shards = Math::min(m_gd_num_shards, batch_size);
+
+	m_shard_layers.clear();
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		int32_t shard_size = int64_t(s+1)*batch_size/num_shards -
+			int64_t(s)*batch_size/num_shards;
+
+		auto layers = clone_layers(shard_size);
+		// every shard draws its own dropout masks, from a seed that only
+		// depends on the seed of the network
+		for (auto& layer : layers)
+			seed(layer);
+
+		m_shard_layers.push_back(layers);
+	}
+}
+
+std::vector<std::shared_ptr<NeuralLayer>> NeuralNetwork::clone_layers(
+	int32_t batch_size)
+{
+	std::vector<std::shared_ptr<NeuralLayer>> layers;
+	for (int32_t i=0; i<m_num_layers; i++)
+		layers.push_back(get_layer(i)->clone()->as<NeuralLayer>());
+
+	for (int32_t i=0; i<m_num_layers; i++)
+	{
+		if (!layers[i]->is_input())
+			layers[i]->initialize_neural_layer(
+				layers, layers[i]->get_input_indices());
+		layers[i]->set_batch_size(batch_size);
+	}
+
+	return layers;
+}
+
+void NeuralNetwork::init_inference_buffers(
+	int32_t num_workers, int32_t chunk_size)
+{
+	if (m_inference_layers.size()>=(size_t)num_workers &&
+		m_inference_inputs[0].num_rows==m_num_inputs &&
+		m_inference_inputs[0].num_cols==chunk_size)
+		return;
+
+	m_inference_layers.clear();
+	m_inference_inputs.clear();
+	for (int32_t w=0; w<num_workers; w++)
+	{
+		m_inference_layers.push_back(clone_layers(chunk_size));
+		SGMatrix<float64_t> buffer(m_num_inputs, chunk_size);
+		buffer.zero();
+		m_inference_inputs.push_back(buffer);
+	}
+}
+
+float64_t NeuralNetwork::compute_gradients_sharded(SGMatrix<float64_t> inputs,
+		SGMatrix<float64_t> targets, SGVector<float64_t> gradients)
+{
+	int32_t batch_size = inputs.num_cols;
+	int32_t num_shards = m_shard_layers.size();
+
+	SGMatrix<float64_t> shard_gradients(m_total_num_parameters, num_shards);
+	SGVector<float64_t> shard_errors(num_shards);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		int32_t begin = int64_t(s)*batch_size/num_shards;
+		int32_t size = int64_t(s+1)*batch_size/num_shards - begin;
+		const auto& layers = m_shard_layers[s];
+
+		SGMatrix<float64_t> inputs_shard(
+			inputs.matrix+int64_t(begin)*inputs.num_rows,
+			inputs.num_rows, size, false);
+		SGMatrix<float64_t> targets_shard(
+			targets.matrix+int64_t(begin)*targets.num_rows,
+			targets.num_rows, size, false);
+		SGVector<float64_t> g(shard_gradients.get_column_vector(s),
+			m_total_num_parameters, false);
+
+		forward_pass(layers, inputs_shard, -1);
+		backward_pass(layers, targets_shard, g);
+
+		// the errors and gradients are averages over the shard
+		float64_t weight = (float64_t)size/batch_size;
+		for (int32_t i=0; i<m_total_num_parameters; i++)
+			g[i] *= weight;
+		shard_errors[s] = weight*compute_batch_error(layers, targets_shard);
+	}
+
+	// pairwise reduction, its order of summation does not depend on the
+	// number of threads
+	for (int32_t step=1; step<num_shards; step*=2)
+	{
+#pragma omp parallel for
+		for (int32_t s=0; s<num_shards-step; s+=2*step)
+		{
+			float64_t* g = shard_gradients.get_column_vector(s);
+			float64_t* h = shard_gradients.get_column_vector(s+step);
+			for (int32_t i=0; i<m_total_num_parameters; i++)
+				g[i] += h[i];
+			shard_errors[s] += shard_errors[s+step];
+		}
+	}
+
+	sg_memcpy(gradients.vector, shard_gradients.matrix,
+		m_total_num_parameters*sizeof(float64_t));
+	regularize_gradients(gradients);
+
+	return shard_errors[0] + compute_regularization_error();
 }
 
 float64_t NeuralNetwork::compute_error(SGMatrix<float64_t> targets)
 {
-	float64_t error = get_layer(m_num_layers-1)->compute_error(targets);
+	return compute_batch_error(m_layers, targets) +
+		compute_regularization_error();
+}
+
+float64_t NeuralNetwork::compute_batch_error(
+	const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+	SGMatrix<float64_t> targets)
+{
+	return layers[m_num_layers-1]->compute_error(targets);
+}
+
+float64_t NeuralNetwork::compute_regularization_error()
+{
+	float64_t error = 0;
 
 	// L2 regularization
 	if (m_l2_coefficient != 0.0)
@@ -775,6 +1070,8 @@ void NeuralNetwork::init()
 	m_gd_learning_rate_decay = 1.0;
 	m_gd_momentum = 0.9;
 	m_gd_error_damping_coeff = -1.0;
+	m_gd_num_shards = 1;
+	m_inference_chunk_size = 0;
 	m_epsilon = 1.0e-5;
 	m_num_inputs = 0;
 	m_num_layers = 0;
@@ -806,6 +1103,12 @@ void NeuralNetwork::init()
 	SG_ADD(
 	    &m_gd_error_damping_coeff, "gd_error_damping_coeff",
 	    "Gradient Descent Error Damping Coeff");
+	SG_ADD(
+	    &m_gd_num_shards, "gd_num_shards",
+	    "Number of shards of a Gradient Descent Mini-batch");
+	SG_ADD(
+	    &m_inference_chunk_size, "inference_chunk_size",
+	    "Number of vectors forward propagated at once when applying");
 	SG_ADD(&m_epsilon, "epsilon", "Epsilon");
 	SG_ADD(&m_num_inputs, "num_inputs", "Number of Inputs");
 	SG_ADD(&m_num_layers, "num_layers", "Number of Layers");
@@ -467,6 +467,57 @@ public:
 		return m_gd_error_damping_coeff;
 	}
 
+	/** Sets the number of shards each mini-batch is split into during
+	 * gradient descent training
+	 *
+	 * The shards are forward and backward propagated in parallel, each
+	 * through its own copy of the layers, and their gradients are summed up
+	 * in a fixed order. The result thus only depends on the number of shards
+	 * and not on the number of threads.
+	 *
+	 * default value is 1 (no sharding)
+	 *
+	 * @param gd_num_shards number of shards of a mini-batch
+	 */
+	void set_gd_num_shards(int32_t gd_num_shards)
+	{
+		m_gd_num_shards = gd_num_shards;
+	}
+
+	/** Returns the number of shards of a mini-batch */
+	int32_t get_gd_num_shards() const
+	{
+		return m_gd_num_shards;
+	}
+
+	/** Sets the number of vectors that are forward propagated at once when
+	 * the network is applied
+	 *
+	 * The vectors are propagated in chunks of this size, each thread through
+	 * its own copy of the layers, whose activation buffers are allocated once
+	 * and reused for all chunks. Only the activations of one chunk per thread
+	 * are thus held in memory.
+	 *
+	 * If 0, dense features are propagated as one batch and streaming
+	 * features in chunks of 1024 vectors.
+	 *
+	 * default value is 0
+	 *
+	 * @param inference_chunk_size number of vectors propagated at once
+	 */
+	void set_inference_chunk_size(int32_t inference_chunk_size)
+	{
+		m_inference_chunk_size = inference_chunk_size;
+	}
+
+	/** Returns the number of vectors that are propagated at once when the
+	 * network is applied
+	 */
+	int32_t get_inference_chunk_size() const
+	{
+		return m_inference_chunk_size;
+	}
+
 protected:
 	/** trains the network */
 	virtual bool train_machine(std::shared_ptr<Features> data=NULL);
@@ -502,6 +553,22 @@ protected:
 	 */
 	virtual SGMatrix<float64_t> forward_propagate(SGMatrix<float64_t> inputs, int32_t j=-1);
 
+	/** Applies forward propagation in chunks of m_inference_chunk_size
+	 * vectors, see set_inference_chunk_size()
+	 *
+	 * @param data input features, either DenseFeatures or
+	 * StreamingDenseFeatures of type float64_t
+	 *
+	 * @return activations of the last layer
+	 */
+	SGMatrix<float64_t> forward_propagate_chunked(std::shared_ptr<Features> data);
+
+	/** Computes the activations of the last layer for applying the network,
+	 * using forward_propagate_chunked() for streaming features or if a chunk
+	 * size is set and forward_propagate() otherwise
+	 */
+	SGMatrix<float64_t> compute_outputs(std::shared_ptr<Features> data);
+
 	/** Sets the batch size (the number of train/test cases) the network is
 	 * expected to deal with.
 	 * Allocates memory for the activations, local gradients, input gradients
@@ -548,6 +615,19 @@ protected:
 	 */
 	virtual float64_t compute_error(SGMatrix<float64_t> targets);
 
+	/** Computes the part of the error that is averaged over the batch, i.e
+	 * the error of the output layer, from the given layers, which are either
+	 * m_layers or a copy of them that holds a shard of the batch.
+	 *
+	 * @param layers layers of the network
+	 *
+	 * @param targets desired values for the network's output, matrix of size
+	 * num_neurons_output_layer*batch_size
+	 */
+	virtual float64_t compute_batch_error(
+		const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+		SGMatrix<float64_t> targets);
+
 	virtual bool is_label_valid(std::shared_ptr<Labels >lab) const;
 
 	/** returns a pointer to layer i in the network */
@@ -591,6 +671,48 @@ private:
 	template<class T>
 	SGVector<T> get_section(SGVector<T> v, int32_t i) const;
 
+	/** Forward propagates the inputs through the given layers up to layer j
+	 *
+	 * @return activations of layer j
+	 */
+	SGMatrix<float64_t> forward_pass(
+		const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+		SGMatrix<float64_t> inputs, int32_t j);
+
+	/** Backpropagates through the given layers, after a forward_pass(), and
+	 * fills gradients with the gradients of the batch error
+	 */
+	void backward_pass(const std::vector<std::shared_ptr<NeuralLayer>>& layers,
+		SGMatrix<float64_t> targets, SGVector<float64_t> gradients);
+
+	/** Adds the gradients of the L1/L2 regularization terms and enforces the
+	 * max-norm constraint
+	 */
+	void regularize_gradients(SGVector<float64_t> gradients);
+
+	/** Returns the L1/L2 regularization terms of the error */
+	float64_t compute_regularization_error();
+
+	/** Returns a copy of the layers, set up for the given batch size */
+	std::vector<std::shared_ptr<NeuralLayer>> clone_layers(int32_t batch_size);
+
+	/** Creates a copy of the layers for each of the
+	 * min(m_gd_num_shards, batch_size) shards of a batch
+	 */
+	void init_shards(int32_t batch_size);
+
+	/** Creates the layers and input buffers of forward_propagate_chunked()
+	 * for the given number of threads, unless they already exist
+	 */
+	void init_inference_buffers(int32_t num_workers, int32_t chunk_size);
+
+	/** Same as compute_gradients(), but splits the batch into the shards of
+	 * init_shards(), which are propagated in parallel. The gradients of the
+	 * shards are combined by a pairwise reduction in a fixed order.
+	 */
+	float64_t compute_gradients_sharded(SGMatrix<float64_t> inputs,
+			SGMatrix<float64_t> targets, SGVector<float64_t> gradients);
+
 protected:
 	/** number of neurons in the input layer */
 	int32_t m_num_inputs;
@@ -731,7 +853,28 @@ protected:
 	 */
 	float64_t m_gd_error_damping_coeff;
 
+	/** number of shards each mini-batch is split into during gradient
+	 * descent training, default value is 1
+	 */
+	int32_t m_gd_num_shards;
+
+	/** number of vectors that are forward propagated at once when the network
+	 * is applied, 0 for the whole set of dense features
+	 */
+	int32_t m_inference_chunk_size;
+
 private:
+	/** copies of the layers, one for each shard of a mini-batch */
+	std::vector<std::vector<std::shared_ptr<NeuralLayer>>> m_shard_layers;
+
+	/** copies of the layers, one for each thread of
+	 * forward_propagate_chunked()
+	 */
+	std::vector<std::vector<std::shared_ptr<NeuralLayer>>> m_inference_layers;
+
+	/** input buffers of forward_propagate_chunked(), one for each thread */
+	std::vector<SGMatrix<float64_t>> m_inference_inputs;
+
 	/** temperary pointers to the training data, used to pass the data to L-BFGS
 	 * routines
 	 */
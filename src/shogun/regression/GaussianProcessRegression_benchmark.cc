@@ -0,0 +1,83 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/kernel/GaussianKernel.h"
+#include "shogun/machine/gp/ExactInferenceMethod.h"
+#include "shogun/machine/gp/GaussianLikelihood.h"
+#include "shogun/machine/gp/ZeroMean.h"
+#include "shogun/regression/GaussianProcessRegression.h"
+#include "shogun/util/benchmark_data.h"
+
+namespace shogun
+{
+
+/** range(0) training vectors of dimension 8 */
+class GPFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		auto data = benchmark_data::gaussians(st.range(0), 8);
+		feats = std::make_shared<DenseFeatures<float64_t>>(data);
+		labels = benchmark_data::regression_labels(data);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		feats.reset();
+		labels.reset();
+	}
+
+	std::shared_ptr<GaussianProcessRegression> create_gp()
+	{
+		auto kernel = std::make_shared<GaussianKernel>(10, 2.0);
+		auto inf = std::make_shared<ExactInferenceMethod>(
+		    kernel, feats, std::make_shared<ZeroMean>(), labels,
+		    std::make_shared<GaussianLikelihood>());
+		return std::make_shared<GaussianProcessRegression>(inf);
+	}
+
+	std::shared_ptr<DenseFeatures<float64_t>> feats;
+	std::shared_ptr<RegressionLabels> labels;
+};
+
+#define ADD_GP_ARGS(WHAT)	\
+	WHAT->RangeMultiplier(2)->Range(128, 2048)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(GPFixture, ExactInference_train)(benchmark::State& st)
+{
+	for (auto _ : st)
+		create_gp()->train();
+
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_GP_ARGS(BENCHMARK_REGISTER_F(GPFixture, ExactInference_train))
+
+BENCHMARK_DEFINE_F(GPFixture, ExactInference_negative_log_marginal_likelihood)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto inf = create_gp()->get_inference_method();
+		benchmark::DoNotOptimize(inf->get_negative_log_marginal_likelihood());
+	}
+
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_GP_ARGS(BENCHMARK_REGISTER_F(GPFixture, ExactInference_negative_log_marginal_likelihood))
+
+BENCHMARK_DEFINE_F(GPFixture, ExactInference_apply)(benchmark::State& st)
+{
+	auto gp = create_gp();
+	gp->train();
+
+	for (auto _ : st)
+		benchmark::DoNotOptimize(gp->apply_regression(feats));
+
+	st.SetItemsProcessed(st.iterations() * feats->get_num_vectors());
+}
+ADD_GP_ARGS(BENCHMARK_REGISTER_F(GPFixture, ExactInference_apply))
+
+}
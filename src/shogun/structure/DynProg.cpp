@@ -21,7 +21,9 @@
 #include <ctype.h>
 #include <limits.h>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 using namespace shogun;
 
@@ -95,7 +97,8 @@ DynProg::DynProg(int32_t num_svms /*= 8 */)
 	  m_num_raw_data(0),
 
 	  m_long_transitions(true),
-	  m_long_transition_threshold(1000)
+	  m_long_transition_threshold(1000),
+	  m_checkpoint_interval(0)
 {
 	trans_list_forward = NULL ;
 	trans_list_forward_cnt = NULL ;
@@ -1094,11 +1097,8 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 #endif
 		DynamicArray<float64_t> long_transition_content_scores_loss(m_N,m_N) ; // 2d
 
-		if (nbest!=1)
-		{
+		if (nbest!=1 && long_transitions)
 			error("Long transitions are not supported for nbest!=1");
-			long_transitions = false ;
-		}
 		long_transition_content_scores.set_const(-Math::INFTY);
 #ifdef DYNPROG_DEBUG
 		long_transition_content_scores_pen.set_const(0) ;
@@ -1247,19 +1247,70 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 	      }*/
 	    ASSERT(nbest < 32000)
 
-	    DynamicArray<float64_t> delta(m_seq_len, m_N, nbest); // 3d
+	    // the recursion at position t only reads delta at the positions
+	    // within the look-back of t and at the start positions of the 5'
+	    // parts of long transitions, so delta is kept for the last window
+	    // positions only
+	    int32_t window = 1 ;
+	    {
+		    int32_t max_len = 0 ;
+		    for (int32_t i = 0; i < m_N; i++)
+			    for (int32_t j = 0; j < m_N; j++)
+				    max_len = Math::max(max_len, look_back.element(i, j)) ;
+
+		    int32_t start_5p_part = 0 ;
+		    for (int32_t t = 1; t < m_seq_len; t++)
+		    {
+			    int32_t first = t ;
+			    while (first > 0 && m_pos[t] - m_pos[first - 1] <= max_len)
+				    first-- ;
+			    if (long_transitions)
+			    {
+				    first = Math::min(first, start_5p_part) ;
+				    for (int32_t s = start_5p_part;
+				         m_pos[t] - m_pos[s] > m_long_transition_threshold; s++)
+					    start_5p_part = s ;
+			    }
+			    window = Math::max(window, t - first + 1) ;
+		    }
+	    }
+	    SG_DEBUG("window={}", window)
+
+	    // with checkpoints, psi, ktable and ptable only hold the positions
+	    // [table_offset, table_offset+interval) of one block
+	    const bool use_checkpoints =
+	        m_checkpoint_interval > 0 && m_checkpoint_interval < m_seq_len ;
+	    const int32_t interval =
+	        use_checkpoints ? m_checkpoint_interval : m_seq_len ;
+	    int32_t table_offset = 0 ;
+
+	    DynamicArray<float64_t> delta(window, m_N, nbest); // 3d
 	    float64_t* delta_array = delta.get_array();
 	    // delta.set_const(0) ;
+	    auto delta_at = [&](int32_t t, T_STATES j, int16_t k) -> float64_t& {
+		    return delta.element(delta_array, t % window, j, k, window, m_N) ;
+	    } ;
 
-	    DynamicArray<T_STATES> psi(m_seq_len, m_N, nbest); // 3d
+	    DynamicArray<T_STATES> psi(interval, m_N, nbest); // 3d
 	    // psi.set_const(0) ;
 
-	    DynamicArray<int16_t> ktable(m_seq_len, m_N, nbest); // 3d
+	    DynamicArray<int16_t> ktable(interval, m_N, nbest); // 3d
 	    // ktable.set_const(0) ;
 
-	    DynamicArray<int32_t> ptable(m_seq_len, m_N, nbest); // 3d
+	    DynamicArray<int32_t> ptable(interval, m_N, nbest); // 3d
 	    // ptable.set_const(0) ;
 
+	    // segment starts within the look-back of a position, their lengths,
+	    // content values and penalties
+	    const int32_t num_svm_values =
+	        m_num_lin_feat_plifs_cum[m_num_raw_data] + m_num_intron_plifs ;
+	    std::vector<int32_t> segment_starts(window) ;
+	    std::vector<int32_t> segment_lengths(window) ;
+	    std::vector<float64_t> segment_penalties(window) ;
+	    std::vector<float64_t> segment_penalties_buffer(window) ;
+	    std::vector<float64_t> segment_svm_values(
+	        int64_t(window) * num_svm_values, 0) ;
+
 	    DynamicArray<float64_t> delta_end(nbest);
 	    // delta_end.set_const(0) ;
 
@@ -1353,7 +1404,7 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 			for (T_STATES i=0; i<m_N; i++)
 			{
 				//delta.element(0, i, 0) = get_p(i) + seq.element(i,0) ;        // get_p defined in HMM.h to be equiv to initial_state_distribution
-				delta.element(delta_array, 0, i, 0, m_seq_len, m_N) = get_p(i) + seq.element(i,0) ;        // get_p defined in HMM.h to be equiv to initial_state_distribution
+				delta_at(0, i, 0) = get_p(i) + seq.element(i,0) ;        // get_p defined in HMM.h to be equiv to initial_state_distribution
 				psi.element(0,i,0)   = 0 ;
 				if (nbest>1)
 					ktable.element(0,i,0)  = 0 ;
@@ -1364,7 +1415,7 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 					delta.get_array_size(dim1, dim2, dim3) ;
 					//SG_DEBUG("i={}, k={} -- {}, {}, {}", i, k, dim1, dim2, dim3)
 					//delta.element(0, i, k)    = -CMath::INFTY ;
-					delta.element(delta_array, 0, i, k, m_seq_len, m_N)    = -Math::INFTY ;
+					delta_at(0, i, k)    = -Math::INFTY ;
 					psi.element(0,i,0)      = 0 ;                  // <--- what's this for?
 					if (nbest>1)
 						ktable.element(0,i,k)     = 0 ;
@@ -1393,8 +1444,111 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 
 		SG_DEBUG("START_RECURSION ")
 
-		// recursion
-		for (int32_t t=1; t<m_seq_len; t++)
+		// updates the best 5' part of the long transition from
+		// trans_list_forward[j][i] to j with the segment starts that are
+		// more than m_long_transition_threshold away from position t
+		auto update_long_transition_5p = [&](int32_t t, T_STATES j, int32_t i)
+		{
+			T_STATES ii = trans_list_forward[j][i] ;
+			const float64_t *elem_val = trans_list_forward_val[j] ;
+			const int32_t *elem_id = trans_list_forward_id[j] ;
+			const auto penalty = PEN[index_N(j,ii)]->as<PlifBase>() ;
+
+			int32_t start = long_transition_content_start.get_element(ii, j) ;
+			int32_t end_5p_part = start ;
+			for (int32_t start_5p_part=start; m_pos[t]-m_pos[start_5p_part] > m_long_transition_threshold ; start_5p_part++)
+			{
+				// find end_5p_part, which is greater than start_5p_part and at least m_long_transition_threshold away
+				while (end_5p_part<=t && m_pos[end_5p_part+1]-m_pos[start_5p_part]<=m_long_transition_threshold)
+					end_5p_part++ ;
+
+				ASSERT(m_pos[end_5p_part+1]-m_pos[start_5p_part] > m_long_transition_threshold || end_5p_part==t)
+				ASSERT(m_pos[end_5p_part]-m_pos[start_5p_part] <= m_long_transition_threshold)
+
+				float64_t pen_val = 0.0;
+				/* recompute penalty, if necessary */
+				if (penalty)
+				{
+					int32_t frame = m_orf_info.element(ii,0);
+					lookup_content_svm_values(start_5p_part, end_5p_part, m_pos[start_5p_part], m_pos[end_5p_part], svm_value, frame); // * t -> end_5p_part
+					pen_val = penalty->lookup_penalty(m_pos[end_5p_part]-m_pos[start_5p_part], svm_value) ;
+				}
+
+				/*if (m_pos[start_5p_part]==1003)
+				  {
+				  io::print("Part1: {} - {}   vs  {} - {}\n", m_pos[t], m_pos[ts], m_pos[end_5p_part], m_pos[start_5p_part]);
+				  io::print("Part1: ts={}  t={}  start_5p_part={}  m_seq_len={}\n", m_pos[ts], m_pos[t], m_pos[start_5p_part], m_seq_len);
+				  }*/
+
+				float64_t mval_trans = -( elem_val[i] + pen_val*0.5 + delta_at(start_5p_part, ii, 0) ) ;
+				//float64_t mval_trans = -( elem_val[i] + delta_at(ts, ii, 0) ) ; // enable this for the incomplete extra check
+
+				float64_t segment_loss_part1=0.0 ;
+				if (with_loss)
+				{  // this is the loss from the start of the long segment (5' part + middle section)
+
+					segment_loss_part1 = m_seg_loss_obj->get_segment_loss(start_5p_part /*long_transition_content_start_position.get_element(ii,j)*/, end_5p_part, elem_id[i]); // * unsure
+
+					mval_trans -= segment_loss_part1 ;
+				}
+
+
+				if (0)//m_pos[end_5p_part] - m_pos[long_transition_content_start_position.get_element(ii, j)] > look_back_orig_/*m_long_transition_max*/)
+				{
+					// this restricts the maximal length of segments,
+					// but the current implementation is not valid since the
+					// long transition is discarded without loocking if there
+					// is a second best long transition in between
+					long_transition_content_scores.set_element(-Math::INFTY, ii, j) ;
+					long_transition_content_start_position.set_element(0, ii, j) ;
+					if (with_loss)
+						long_transition_content_scores_loss.set_element(0.0, ii, j) ;
+#ifdef DYNPROG_DEBUG
+					long_transition_content_scores_pen.set_element(0.0, ii, j) ;
+					long_transition_content_scores_elem.set_element(0.0, ii, j) ;
+					long_transition_content_scores_prev.set_element(0.0, ii, j) ;
+					long_transition_content_end_position.set_element(0, ii, j) ;
+#endif
+				}
+				if (with_loss)
+				{
+					float64_t old_loss = long_transition_content_scores_loss.get_element(ii, j) ;
+					float64_t new_loss = m_seg_loss_obj->get_segment_loss(long_transition_content_start_position.get_element(ii,j), end_5p_part, elem_id[i]);
+					float64_t score = long_transition_content_scores.get_element(ii, j) - old_loss + new_loss ;
+					long_transition_content_scores.set_element(score, ii, j) ;
+					long_transition_content_scores_loss.set_element(new_loss, ii, j) ;
+#ifdef DYNPROG_DEBUG
+					long_transition_content_end_position.set_element(end_5p_part, ii, j) ;
+#endif
+
+				}
+				if (-long_transition_content_scores.get_element(ii, j) > mval_trans )
+				{
+					/* then the old long transition is either too far away or worse than the current one */
+					long_transition_content_scores.set_element(-mval_trans, ii, j) ;
+					long_transition_content_start_position.set_element(start_5p_part, ii, j) ;
+					if (with_loss)
+						long_transition_content_scores_loss.set_element(segment_loss_part1, ii, j) ;
+#ifdef DYNPROG_DEBUG
+					long_transition_content_scores_pen.set_element(pen_val*0.5, ii, j) ;
+					long_transition_content_scores_elem.set_element(elem_val[i], ii, j) ;
+					long_transition_content_scores_prev.set_element(delta_at(start_5p_part, ii, 0), ii, j) ;
+					/*ASSERT(fabs(long_transition_content_scores.get_element(ii, j)-(long_transition_content_scores_pen.get_element(ii, j) +
+					  long_transition_content_scores_elem.get_element(ii, j) +
+					  long_transition_content_scores_prev.get_element(ii, j)))<1e-6) ;*/
+					long_transition_content_end_position.set_element(end_5p_part, ii, j) ;
+#endif
+				}
+				//
+				// this sets the position where the search for better 5'parts is started the next time
+				// whithout this the prediction takes ages
+				//
+				long_transition_content_start.set_element(start_5p_part, ii, j) ;
+			}
+		} ;
+
+		// recursion of position t
+		auto compute_column = [&](int32_t t)
 		{
 			for (T_STATES j=0; j<m_N; j++)
 			{
@@ -1402,11 +1556,25 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 				{ // if we cannot observe the symbol here, then we can omit the rest
 					for (int16_t k=0; k<nbest; k++)
 					{
-						delta.element(delta_array, t, j, k, m_seq_len, m_N)    = seq.element(j,t) ;
-						psi.element(t,j,k)         = 0 ;
+						delta_at(t, j, k)    = seq.element(j,t) ;
+						psi.element(t-table_offset,j,k)         = 0 ;
 						if (nbest>1)
-							ktable.element(t,j,k)  = 0 ;
-						ptable.element(t,j,k)      = 0 ;
+							ktable.element(t-table_offset,j,k)  = 0 ;
+						ptable.element(t-table_offset,j,k)      = 0 ;
+					}
+
+					// the 5' parts of long transitions are nevertheless
+					// updated, so that they only refer to positions within
+					// the window of delta
+					if (long_transitions)
+					{
+						for (int32_t i=0; i<trans_list_forward_cnt[j]; i++)
+						{
+							T_STATES ii = trans_list_forward[j][i] ;
+							if (m_orf_info.element(ii,0)==-1 &&
+								look_back.element(j, ii)==m_long_transition_threshold)
+								update_long_transition_5p(t, j, i) ;
+						}
 					}
 				}
 				else
@@ -1482,106 +1650,118 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 
 							if (ok)
 							{
-
-								float64_t segment_loss = 0.0 ;
-								if (with_loss)
+								segment_starts[num_ok_pos] = ts ;
+								segment_lengths[num_ok_pos] = m_pos[t]-m_pos[ts] ;
+								if (penalty)
 								{
-									segment_loss = m_seg_loss_obj->get_segment_loss(ts, t, elem_id[i]);
-									//if (segment_loss!=segment_loss2)
-										//io::print("segment_loss:{} segment_loss2:{}\n", segment_loss, segment_loss2);
+									int32_t frame = orf_from;//m_orf_info.element(ii,0);
+									lookup_content_svm_values(ts, t, m_pos[ts], m_pos[t], &segment_svm_values[int64_t(num_ok_pos)*num_svm_values], frame);
 								}
-								////////////////////////////////////////////////////////
-								// BEST_PATH_TRANS
-								////////////////////////////////////////////////////////
-
-								int32_t frame = orf_from;//m_orf_info.element(ii,0);
-								lookup_content_svm_values(ts, t, m_pos[ts], m_pos[t], svm_value, frame);
+								num_ok_pos++ ;
+							}
+						}
 
-								float64_t pen_val = 0.0 ;
-								if (penalty)
-								{
+						// look up the penalties of all segments ending at t at once
+						if (penalty)
+						{
 #ifdef DYNPROG_TIMING_DETAIL
-									MyTime.start() ;
+							MyTime.start() ;
 #endif
-									pen_val = penalty->lookup_penalty(m_pos[t]-m_pos[ts], svm_value) ;
-
+							penalty->lookup_penalties(
+								segment_lengths.data(), segment_svm_values.data(),
+								num_svm_values, num_ok_pos, segment_penalties.data(),
+								segment_penalties_buffer.data()) ;
 #ifdef DYNPROG_TIMING_DETAIL
-									MyTime.stop() ;
-									content_plifs_time += MyTime.time_diff_sec() ;
+							MyTime.stop() ;
+							content_plifs_time += MyTime.time_diff_sec() ;
 #endif
-								}
+						}
+
+						for (int32_t s=0; s<num_ok_pos; s++)
+						{
+							int32_t ts = segment_starts[s] ;
+
+							float64_t segment_loss = 0.0 ;
+							if (with_loss)
+								segment_loss = m_seg_loss_obj->get_segment_loss(ts, t, elem_id[i]);
+
+							////////////////////////////////////////////////////////
+							// BEST_PATH_TRANS
+							////////////////////////////////////////////////////////
+
+							float64_t pen_val = 0.0 ;
+							if (penalty)
+								pen_val = segment_penalties[s] ;
 
 #ifdef DYNPROG_TIMING_DETAIL
-								MyTime.start() ;
+							MyTime.start() ;
 #endif
-								num_ok_pos++ ;
 
-								if (nbest==1)
-								{
-									float64_t  val        = elem_val[i] + pen_val ;
-									if (with_loss)
-										val              += segment_loss ;
+							if (nbest==1)
+							{
+								float64_t  val        = elem_val[i] + pen_val ;
+								if (with_loss)
+									val              += segment_loss ;
 
-									float64_t mval = -(val + delta.element(delta_array, ts, ii, 0, m_seq_len, m_N)) ;
+								float64_t mval = -(val + delta_at(ts, ii, 0)) ;
 
-									if (mval<fixedtempvv_)
-									{
-										fixedtempvv_ = mval ;
-										fixedtempii_ = ii + ts*m_N;
-										fixed_list_len = 1 ;
-										fixedtemplong = false ;
-									}
+								if (mval<fixedtempvv_)
+								{
+									fixedtempvv_ = mval ;
+									fixedtempii_ = ii + ts*m_N;
+									fixed_list_len = 1 ;
+									fixedtemplong = false ;
 								}
-								else
+							}
+							else
+							{
+								for (int16_t diff=0; diff<nbest; diff++)
 								{
-									for (int16_t diff=0; diff<nbest; diff++)
-									{
-										float64_t  val        = elem_val[i]  ;
-										val                  += pen_val ;
-										if (with_loss)
-											val              += segment_loss ;
+									float64_t  val        = elem_val[i]  ;
+									val                  += pen_val ;
+									if (with_loss)
+										val              += segment_loss ;
 
-										float64_t mval = -(val + delta.element(delta_array, ts, ii, diff, m_seq_len, m_N)) ;
+									float64_t mval = -(val + delta_at(ts, ii, diff)) ;
 
-										/* only place -val in fixedtempvv if it is one of the nbest lowest values in there */
-										/* fixedtempvv[i], i=0:nbest-1, is sorted so that fixedtempvv[0] <= fixedtempvv[1] <= ...*/
-										/* fixed_list_len has the number of elements in fixedtempvv */
+									/* only place -val in fixedtempvv if it is one of the nbest lowest values in there */
+									/* fixedtempvv[i], i=0:nbest-1, is sorted so that fixedtempvv[0] <= fixedtempvv[1] <= ...*/
+									/* fixed_list_len has the number of elements in fixedtempvv */
 
-										if ((fixed_list_len < nbest) || ((0==fixed_list_len) || (mval < fixedtempvv[fixed_list_len-1])))
+									if ((fixed_list_len < nbest) || ((0==fixed_list_len) || (mval < fixedtempvv[fixed_list_len-1])))
+									{
+										if ( (fixed_list_len<nbest) && ((0==fixed_list_len) || (mval>fixedtempvv[fixed_list_len-1])) )
 										{
-											if ( (fixed_list_len<nbest) && ((0==fixed_list_len) || (mval>fixedtempvv[fixed_list_len-1])) )
-											{
-												fixedtempvv[fixed_list_len] = mval ;
-												fixedtempii[fixed_list_len] = ii + diff*m_N + ts*m_N*nbest;
-												fixed_list_len++ ;
-											}
-											else  // must have mval < fixedtempvv[fixed_list_len-1]
+											fixedtempvv[fixed_list_len] = mval ;
+											fixedtempii[fixed_list_len] = ii + diff*m_N + ts*m_N*nbest;
+											fixed_list_len++ ;
+										}
+										else  // must have mval < fixedtempvv[fixed_list_len-1]
+										{
+											int32_t addhere = fixed_list_len;
+											while ((addhere > 0) && (mval < fixedtempvv[addhere-1]))
+												addhere--;
+
+											// move everything from addhere+1 one forward
+											for (int32_t jj=fixed_list_len-1; jj>addhere; jj--)
 											{
-												int32_t addhere = fixed_list_len;
-												while ((addhere > 0) && (mval < fixedtempvv[addhere-1]))
-													addhere--;
-
-												// move everything from addhere+1 one forward
-												for (int32_t jj=fixed_list_len-1; jj>addhere; jj--)
-												{
-													fixedtempvv[jj] = fixedtempvv[jj-1];
-													fixedtempii[jj] = fixedtempii[jj-1];
-												}
-
-												fixedtempvv[addhere] = mval;
-												fixedtempii[addhere] = ii + diff*m_N + ts*m_N*nbest;
-
-												if (fixed_list_len < nbest)
-													fixed_list_len++;
+												fixedtempvv[jj] = fixedtempvv[jj-1];
+												fixedtempii[jj] = fixedtempii[jj-1];
 											}
+
+											fixedtempvv[addhere] = mval;
+											fixedtempii[addhere] = ii + diff*m_N + ts*m_N*nbest;
+
+											if (fixed_list_len < nbest)
+												fixed_list_len++;
 										}
 									}
 								}
+							}
 #ifdef DYNPROG_TIMING_DETAIL
-								MyTime.stop() ;
-								inner_loop_max_time += MyTime.time_diff_sec() ;
+							MyTime.stop() ;
+							inner_loop_max_time += MyTime.time_diff_sec() ;
 #endif
-							}
 						}
 #ifdef DYNPROG_TIMING
 						MyTime3.stop() ;
@@ -1646,97 +1826,7 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 
 							// update table for 5' part  of the long segment
 
-							int32_t start = long_transition_content_start.get_element(ii, j) ;
-							int32_t end_5p_part = start ;
-							for (int32_t start_5p_part=start; m_pos[t]-m_pos[start_5p_part] > m_long_transition_threshold ; start_5p_part++)
-							{
-								// find end_5p_part, which is greater than start_5p_part and at least m_long_transition_threshold away
-								while (end_5p_part<=t && m_pos[end_5p_part+1]-m_pos[start_5p_part]<=m_long_transition_threshold)
-									end_5p_part++ ;
-
-								ASSERT(m_pos[end_5p_part+1]-m_pos[start_5p_part] > m_long_transition_threshold || end_5p_part==t)
-								ASSERT(m_pos[end_5p_part]-m_pos[start_5p_part] <= m_long_transition_threshold)
-
-								float64_t pen_val = 0.0;
-								/* recompute penalty, if necessary */
-								if (penalty)
-								{
-									int32_t frame = m_orf_info.element(ii,0);
-									lookup_content_svm_values(start_5p_part, end_5p_part, m_pos[start_5p_part], m_pos[end_5p_part], svm_value, frame); // * t -> end_5p_part
-									pen_val = penalty->lookup_penalty(m_pos[end_5p_part]-m_pos[start_5p_part], svm_value) ;
-								}
-
-								/*if (m_pos[start_5p_part]==1003)
-								  {
-								  io::print("Part1: {} - {}   vs  {} - {}\n", m_pos[t], m_pos[ts], m_pos[end_5p_part], m_pos[start_5p_part]);
-								  io::print("Part1: ts={}  t={}  start_5p_part={}  m_seq_len={}\n", m_pos[ts], m_pos[t], m_pos[start_5p_part], m_seq_len);
-								  }*/
-
-								float64_t mval_trans = -( elem_val[i] + pen_val*0.5 + delta.element(delta_array, start_5p_part, ii, 0, m_seq_len, m_N) ) ;
-								//float64_t mval_trans = -( elem_val[i] + delta.element(delta_array, ts, ii, 0, m_seq_len, m_N) ) ; // enable this for the incomplete extra check
-
-								float64_t segment_loss_part1=0.0 ;
-								if (with_loss)
-								{  // this is the loss from the start of the long segment (5' part + middle section)
-
-									segment_loss_part1 = m_seg_loss_obj->get_segment_loss(start_5p_part /*long_transition_content_start_position.get_element(ii,j)*/, end_5p_part, elem_id[i]); // * unsure
-
-									mval_trans -= segment_loss_part1 ;
-								}
-
-
-								if (0)//m_pos[end_5p_part] - m_pos[long_transition_content_start_position.get_element(ii, j)] > look_back_orig_/*m_long_transition_max*/)
-								{
-									// this restricts the maximal length of segments,
-									// but the current implementation is not valid since the
-									// long transition is discarded without loocking if there
-									// is a second best long transition in between
-									long_transition_content_scores.set_element(-Math::INFTY, ii, j) ;
-									long_transition_content_start_position.set_element(0, ii, j) ;
-									if (with_loss)
-										long_transition_content_scores_loss.set_element(0.0, ii, j) ;
-#ifdef DYNPROG_DEBUG
-									long_transition_content_scores_pen.set_element(0.0, ii, j) ;
-									long_transition_content_scores_elem.set_element(0.0, ii, j) ;
-									long_transition_content_scores_prev.set_element(0.0, ii, j) ;
-									long_transition_content_end_position.set_element(0, ii, j) ;
-#endif
-								}
-								if (with_loss)
-								{
-									float64_t old_loss = long_transition_content_scores_loss.get_element(ii, j) ;
-									float64_t new_loss = m_seg_loss_obj->get_segment_loss(long_transition_content_start_position.get_element(ii,j), end_5p_part, elem_id[i]);
-									float64_t score = long_transition_content_scores.get_element(ii, j) - old_loss + new_loss ;
-									long_transition_content_scores.set_element(score, ii, j) ;
-									long_transition_content_scores_loss.set_element(new_loss, ii, j) ;
-#ifdef DYNPROG_DEBUG
-									long_transition_content_end_position.set_element(end_5p_part, ii, j) ;
-#endif
-
-								}
-								if (-long_transition_content_scores.get_element(ii, j) > mval_trans )
-								{
-									/* then the old long transition is either too far away or worse than the current one */
-									long_transition_content_scores.set_element(-mval_trans, ii, j) ;
-									long_transition_content_start_position.set_element(start_5p_part, ii, j) ;
-									if (with_loss)
-										long_transition_content_scores_loss.set_element(segment_loss_part1, ii, j) ;
-#ifdef DYNPROG_DEBUG
-									long_transition_content_scores_pen.set_element(pen_val*0.5, ii, j) ;
-									long_transition_content_scores_elem.set_element(elem_val[i], ii, j) ;
-									long_transition_content_scores_prev.set_element(delta.element(delta_array, start_5p_part, ii, 0, m_seq_len, m_N), ii, j) ;
-									/*ASSERT(fabs(long_transition_content_scores.get_element(ii, j)-(long_transition_content_scores_pen.get_element(ii, j) +
-									  long_transition_content_scores_elem.get_element(ii, j) +
-									  long_transition_content_scores_prev.get_element(ii, j)))<1e-6) ;*/
-									long_transition_content_end_position.set_element(end_5p_part, ii, j) ;
-#endif
-								}
-								//
-								// this sets the position where the search for better 5'parts is started the next time
-								// whithout this the prediction takes ages
-								//
-								long_transition_content_start.set_element(start_5p_part, ii, j) ;
-							}
+							update_long_transition_5p(t, j, i) ;
 
 							// consider the 3' part at the end of the long segment:
 							// * with length = m_long_transition_threshold
@@ -1863,31 +1953,103 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 								fromtjk = fixedtempii[k];
 							}
 
-							delta.element(delta_array, t, j, k, m_seq_len, m_N)    = -minusscore + seq.element(j,t);
-							psi.element(t,j,k)      = (fromtjk%m_N) ;
+							delta_at(t, j, k)    = -minusscore + seq.element(j,t);
+							psi.element(t-table_offset,j,k)      = (fromtjk%m_N) ;
 							if (nbest>1)
-								ktable.element(t,j,k)   = (fromtjk%(m_N*nbest)-psi.element(t,j,k))/m_N ;
-							ptable.element(t,j,k)   = (fromtjk-(fromtjk%(m_N*nbest)))/(m_N*nbest) ;
+								ktable.element(t-table_offset,j,k)   = (fromtjk%(m_N*nbest)-psi.element(t-table_offset,j,k))/m_N ;
+							ptable.element(t-table_offset,j,k)   = (fromtjk-(fromtjk%(m_N*nbest)))/(m_N*nbest) ;
 						}
 						else
 						{
-							delta.element(delta_array, t, j, k, m_seq_len, m_N)    = -Math::INFTY ;
-							psi.element(t,j,k)      = 0 ;
+							delta_at(t, j, k)    = -Math::INFTY ;
+							psi.element(t-table_offset,j,k)      = 0 ;
 							if (nbest>1)
-								ktable.element(t,j,k)     = 0 ;
-							ptable.element(t,j,k)     = 0 ;
+								ktable.element(t-table_offset,j,k)     = 0 ;
+							ptable.element(t-table_offset,j,k)     = 0 ;
 						}
 					}
 				}
 			}
+		} ;
+
+		// the state of the recursion before a position, from which the
+		// tables of the following positions can be recomputed
+		struct Checkpoint
+		{
+			std::vector<float64_t> delta ;
+			std::vector<float64_t> long_transition_scores ;
+			std::vector<float64_t> long_transition_scores_loss ;
+			std::vector<int32_t> long_transition_start ;
+			std::vector<int32_t> long_transition_start_position ;
+		} ;
+		std::vector<Checkpoint> checkpoints ;
+
+		auto save_checkpoint = [&]()
+		{
+			checkpoints.push_back({
+				std::vector<float64_t>(delta.begin(), delta.end()),
+				std::vector<float64_t>(
+					long_transition_content_scores.begin(),
+					long_transition_content_scores.end()),
+				std::vector<float64_t>(
+					long_transition_content_scores_loss.begin(),
+					long_transition_content_scores_loss.end()),
+				std::vector<int32_t>(
+					long_transition_content_start.begin(),
+					long_transition_content_start.end()),
+				std::vector<int32_t>(
+					long_transition_content_start_position.begin(),
+					long_transition_content_start_position.end())}) ;
+		} ;
+
+		// block of positions whose psi, ktable and ptable are in memory
+		int32_t loaded_block = 0 ;
+
+		// recomputes the tables of the block of position t from its
+		// checkpoint, unless they are already in memory
+		auto load_block = [&](int32_t t)
+		{
+			int32_t block = t/interval ;
+			if (block==loaded_block)
+				return ;
+
+			const auto& checkpoint = checkpoints[block] ;
+			std::copy(checkpoint.delta.begin(), checkpoint.delta.end(), delta.begin()) ;
+			std::copy(checkpoint.long_transition_scores.begin(), checkpoint.long_transition_scores.end(),
+					long_transition_content_scores.begin()) ;
+			std::copy(checkpoint.long_transition_scores_loss.begin(), checkpoint.long_transition_scores_loss.end(),
+					long_transition_content_scores_loss.begin()) ;
+			std::copy(checkpoint.long_transition_start.begin(), checkpoint.long_transition_start.end(),
+					long_transition_content_start.begin()) ;
+			std::copy(checkpoint.long_transition_start_position.begin(), checkpoint.long_transition_start_position.end(),
+					long_transition_content_start_position.begin()) ;
+
+			table_offset = block*interval ;
+			int32_t end = Math::min(table_offset+interval, m_seq_len) ;
+			for (int32_t s=Math::max(table_offset, 1); s<end; s++)
+				compute_column(s) ;
+			loaded_block = block ;
+		} ;
+
+		// recursion
+		for (int32_t t=1; t<m_seq_len; t++)
+		{
+			if (use_checkpoints && (t==1 || t%interval==0))
+			{
+				save_checkpoint() ;
+				table_offset = t/interval*interval ;
+			}
+			compute_column(t) ;
 		}
+		loaded_block = (m_seq_len-1)/interval ;
+
 		{ //termination
 			int32_t list_len = 0 ;
 			for (int16_t diff=0; diff<nbest; diff++)
 			{
 				for (T_STATES i=0; i<m_N; i++)
 				{
-					oldtempvv[list_len] = -(delta.element(delta_array, (m_seq_len-1), i, diff, m_seq_len, m_N)+get_q(i)) ;
+					oldtempvv[list_len] = -(delta_at(m_seq_len-1, i, diff)+get_q(i)) ;
 					oldtempii[list_len] = i + diff*m_N ;
 					list_len++ ;
 				}
@@ -1922,10 +2084,12 @@ void DynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 				{
 					ASSERT(i+1<m_seq_len)
 					//SG_DEBUG("s={} p={} q={}", state_seq[i], pos_seq[i], q)
-					state_seq[i+1] = psi.element(pos_seq[i], state_seq[i], q);
-					pos_seq[i+1]   = ptable.element(pos_seq[i], state_seq[i], q) ;
+					load_block(pos_seq[i]) ;
+					int32_t pos = pos_seq[i]-table_offset ;
+					state_seq[i+1] = psi.element(pos, state_seq[i], q);
+					pos_seq[i+1]   = ptable.element(pos, state_seq[i], q) ;
 					if (nbest>1)
-						q              = ktable.element(pos_seq[i], state_seq[i], q) ;
+						q              = ktable.element(pos, state_seq[i], q) ;
 					i++ ;
 				}
 				//SG_DEBUG("s={} p={} q={}", state_seq[i], pos_seq[i], q)
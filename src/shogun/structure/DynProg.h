@@ -477,6 +477,31 @@ public:
 		//m_long_transition_max = max_len;
 	}
 
+	/** set the number of positions between two checkpoints of the
+	 * decoding
+	 *
+	 * Only the checkpoints and the back pointers of one interval are kept
+	 * in memory, the back pointers of the other intervals are recomputed
+	 * from their checkpoint during the traceback. An interval of about
+	 * the square root of the sequence length minimizes the memory at the
+	 * cost of about one more forward pass.
+	 *
+	 * @param interval positions between two checkpoints, 0 to keep the
+	 * back pointers of the whole sequence
+	 */
+	void set_checkpoint_interval(int32_t interval)
+	{
+		require(interval==0 || interval>1,
+			"Checkpoint interval ({}) has to be 0 or larger than 1", interval);
+		m_checkpoint_interval = interval;
+	}
+
+	/** @return the number of positions between two checkpoints */
+	int32_t get_checkpoint_interval() const
+	{
+		return m_checkpoint_interval;
+	}
+
 protected:
 
 	/* helper functions */
@@ -753,6 +778,8 @@ protected:
 	/** threshold for transitions that are computed
 	 *  the traditional way*/
 	int32_t m_long_transition_threshold  ;
+	/** positions between two checkpoints of the decoding, 0 for none */
+	int32_t m_checkpoint_interval;
 	/** maximal length of a long transition
 	 *  Note: is ignored in the current implementation
 	 *        => arbitrarily long transitions can be decoded
@@ -198,6 +198,31 @@ float64_t Plif::lookup_penalty(int32_t p_value, float64_t* svm_values) const
 	return lookup_penalty((float64_t) p_value, svm_values) ;
 }
 
+void Plif::lookup_penalties(
+	const int32_t* p_values, float64_t* svm_values, int32_t svm_stride,
+	int32_t num, float64_t* result, float64_t* buffer) const
+{
+	if (use_svm)
+	{
+		for (int32_t i=0; i<num; i++)
+			result[i]=lookup_penalty_svm(p_values[i], svm_values+int64_t(i)*svm_stride) ;
+		return ;
+	}
+
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t p_value=p_values[i] ;
+		if ((p_value<min_value) || (p_value>max_value))
+			result[i]=-Math::INFTY ;
+		else if (!do_calc)
+			result[i]=p_value ;
+		else if (cache!=NULL && p_value>=0)
+			result[i]=cache[p_value] ;
+		else
+			result[i]=lookup_penalty((float64_t) p_value, NULL) ;
+	}
+}
+
 float64_t Plif::lookup_penalty(float64_t p_value, float64_t* svm_values) const
 {
 	if (use_svm)
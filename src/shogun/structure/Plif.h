@@ -73,6 +73,21 @@ class Plif: public PlifBase
 		 */
 		float64_t lookup_penalty(int32_t p_value, float64_t* svm_values) const;
 
+		/** lookup the penalties of several int32_t values at once
+		 *
+		 * @param p_values values
+		 * @param svm_values SVM values of all values
+		 * @param svm_stride number of SVM values per value
+		 * @param num number of values
+		 * @param result the num penalties are written here
+		 * @param buffer scratch space owned by the caller, num values for
+		 * every level of nested PlifArrays
+		 */
+		void lookup_penalties(
+			const int32_t* p_values, float64_t* svm_values,
+			int32_t svm_stride, int32_t num, float64_t* result,
+			float64_t* buffer) const;
+
 		/** lookup
 		 *
 		 * @param p_value value
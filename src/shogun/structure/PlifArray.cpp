@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include <shogun/io/SGIO.h>
+#include <shogun/lib/SGVector.h>
 
 #include <shogun/structure/PlifArray.h>
 #include <shogun/structure/Plif.h>
@@ -97,6 +98,26 @@ float64_t PlifArray::lookup_penalty(
 	return ret ;
 }
 
+void PlifArray::lookup_penalties(
+	const int32_t* p_values, float64_t* svm_values, int32_t svm_stride,
+	int32_t num, float64_t* result, float64_t* buffer) const
+{
+	// sum up the plifs in the same order as lookup_penalty(), nested plif
+	// arrays use the buffer behind the one of this array
+	for (int32_t k=0; k<num; k++)
+		result[k]=0.0 ;
+	for (const auto& plif : m_array)
+	{
+		plif->lookup_penalties(
+			p_values, svm_values, svm_stride, num, buffer, buffer+num) ;
+		for (int32_t k=0; k<num; k++)
+			result[k]+=buffer[k] ;
+	}
+	for (int32_t k=0; k<num; k++)
+		if (p_values[k]<min_value || p_values[k]>max_value)
+			result[k]=-Math::INFTY ;
+}
+
 void PlifArray::penalty_clear_derivative()
 {
 	for (int32_t i=0; i<m_array.size(); i++)
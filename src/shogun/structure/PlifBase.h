@@ -45,6 +45,27 @@ class PlifBase : public SGObject
 		virtual float64_t lookup_penalty(
 			int32_t p_value, float64_t* svm_values) const =0;
 
+		/** lookup the penalties of several int32_t values at once
+		 *
+		 * @param p_values values
+		 * @param svm_values SVM values of all values, the ones of value i
+		 * start at svm_values+i*svm_stride
+		 * @param svm_stride number of SVM values per value
+		 * @param num number of values
+		 * @param result the num penalties are written here
+		 * @param buffer scratch space owned by the caller, num values for
+		 * every level of nested PlifArrays
+		 */
+		virtual void lookup_penalties(
+			const int32_t* p_values, float64_t* svm_values,
+			int32_t svm_stride, int32_t num, float64_t* result,
+			float64_t* buffer) const
+		{
+			for (int32_t i=0; i<num; i++)
+				result[i]=lookup_penalty(
+					p_values[i], svm_values+int64_t(i)*svm_stride);
+		}
+
 		/** penalty clear derivative
 		 *
 		 * abstrace base method
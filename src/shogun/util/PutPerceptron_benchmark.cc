@@ -126,7 +126,7 @@ namespace shogun
 				perceptron->w = perceptron->weights;
 			};
 			perceptron->m_callback = callback;
-    			st.ResumeTiming();
+			st.ResumeTiming();
 			perceptron->train(feats, labels);
 		}
 	}
@@ -141,7 +141,23 @@ namespace shogun
 				perceptron->put<SGVector<float64_t>>("w", perceptron->weights);
 			};
 			perceptron->m_callback = callback;
-    			st.ResumeTiming();
+			st.ResumeTiming();
+			perceptron->train(feats, labels);
+		}
+	}
+
+	BENCHMARK_DEFINE_F(DataFixture, perceptron_with_handle)(benchmark::State& st)
+	{
+		for (auto _ : st)
+		{
+			st.PauseTiming();
+			auto perceptron = std::make_shared<MockPerceptron>();
+			auto w = perceptron->get_handle<SGVector<float64_t>>("w");
+			std::function<void()> callback = [&perceptron, &w]() {
+				w.put(perceptron->weights);
+			};
+			perceptron->m_callback = callback;
+			st.ResumeTiming();
 			perceptron->train(feats, labels);
 		}
 	}
@@ -163,5 +179,13 @@ namespace shogun
 	            {8 << 5, 8 << 8} // range for number of feature vectors
 	        })
 	    ->Unit(benchmark::kMillisecond);
-}
 
+	BENCHMARK_REGISTER_F(DataFixture, perceptron_with_handle)
+	    ->Ranges(
+	        {
+	            {8, 1 << 8} // range for dimensions of feature vector
+	            ,
+	            {8 << 5, 8 << 8} // range for number of feature vectors
+	        })
+	    ->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,112 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _BENCHMARK_DATA_H_
+#define _BENCHMARK_DATA_H_
+
+#include <shogun/features/DataGenerator.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/mathematics/Math.h>
+
+#include <random>
+
+namespace shogun
+{
+	/** Synthetic data shared by the benchmarks. All of it is generated from
+	 * a fixed seed, so that results of different runs and releases are
+	 * comparable.
+	 */
+	namespace benchmark_data
+	{
+		/** seed of all generated data */
+		constexpr int32_t seed = 17;
+
+		/** samples of well separated Gaussian blobs, see
+		 * DataGenerator::generate_gaussians()
+		 *
+		 * @param num_vecs number of vectors, rounded down to a multiple of
+		 * num_classes
+		 * @param num_dim dimension of the vectors
+		 * @param num_classes number of blobs
+		 * @return matrix with the vectors of blob c in the c-th block of
+		 * columns
+		 */
+		inline SGMatrix<float64_t>
+		gaussians(index_t num_vecs, index_t num_dim, index_t num_classes = 2)
+		{
+			std::mt19937_64 prng(seed);
+			return DataGenerator::generate_gaussians(
+			    num_vecs / num_classes, num_classes, num_dim, prng);
+		}
+
+		/** dense features of gaussians() */
+		inline std::shared_ptr<DenseFeatures<float64_t>> dense_features(
+		    index_t num_vecs, index_t num_dim, index_t num_classes = 2)
+		{
+			return std::make_shared<DenseFeatures<float64_t>>(
+			    gaussians(num_vecs, num_dim, num_classes));
+		}
+
+		/** sparse features of gaussians(), where only every
+		 * 1/density-th entry of a vector is kept
+		 */
+		inline std::shared_ptr<SparseFeatures<float64_t>> sparse_features(
+		    index_t num_vecs, index_t num_dim, float64_t density)
+		{
+			auto data = gaussians(num_vecs, num_dim);
+			auto stride = Math::max(index_t(1), index_t(1 / density));
+			for (index_t i = 0; i < data.num_cols; ++i)
+			{
+				for (index_t j = 0; j < num_dim; ++j)
+				{
+					if ((i + j) % stride)
+						data(j, i) = 0;
+				}
+			}
+			return std::make_shared<SparseFeatures<float64_t>>(data);
+		}
+
+		/** +1 for the first and -1 for the second blob of gaussians() */
+		inline std::shared_ptr<BinaryLabels> binary_labels(index_t num_vecs)
+		{
+			num_vecs = num_vecs / 2 * 2;
+			SGVector<float64_t> labels(num_vecs);
+			for (index_t i = 0; i < num_vecs; ++i)
+				labels[i] = i < num_vecs / 2 ? 1 : -1;
+			return std::make_shared<BinaryLabels>(labels);
+		}
+
+		/** the blob of every vector of gaussians() */
+		inline std::shared_ptr<MulticlassLabels>
+		multiclass_labels(index_t num_vecs, index_t num_classes)
+		{
+			auto per_class = num_vecs / num_classes;
+			SGVector<float64_t> labels(per_class * num_classes);
+			for (index_t i = 0; i < labels.vlen; ++i)
+				labels[i] = i / per_class;
+			return std::make_shared<MulticlassLabels>(labels);
+		}
+
+		/** smooth, noise free regression targets for a feature matrix */
+		inline std::shared_ptr<RegressionLabels>
+		regression_labels(const SGMatrix<float64_t>& data)
+		{
+			SGVector<float64_t> labels(data.num_cols);
+			for (index_t i = 0; i < data.num_cols; ++i)
+			{
+				float64_t sum = 0;
+				for (index_t j = 0; j < data.num_rows; ++j)
+					sum += data(j, i);
+				labels[i] = std::sin(sum / data.num_rows);
+			}
+			return std::make_shared<RegressionLabels>(labels);
+		}
+	}
+}
+
+#endif /* _BENCHMARK_DATA_H_ */
@@ -583,3 +583,28 @@ TEST(SGObject, auto_parameter)
     obj->put(MockObject::kAutoParameter, 1);
     EXPECT_EQ(obj->get<int32_t>(MockObject::kAutoParameter), 1);
 }
+
+TEST(SGObject, parameter_handle)
+{
+	auto obj = std::make_shared<MockObject>();
+	auto handle = obj->get_handle<int32_t>(MockObject::kWatchedInt);
+	EXPECT_EQ(handle.name(), MockObject::kWatchedInt);
+
+	handle.put(89);
+	EXPECT_EQ(obj->get_watched(), 89);
+	obj->set_watched(12);
+	EXPECT_EQ(handle.get(), 12);
+
+	auto constrained =
+	    obj->get_handle<int32_t>(MockObject::kConstrainedParameter);
+	EXPECT_THROW(constrained.put(0), ShogunException);
+	EXPECT_EQ(constrained.get(), 1);
+
+	auto method = obj->get_handle<int>(MockObject::kSomeMethod);
+	EXPECT_EQ(method.get(), obj->some_method());
+	EXPECT_THROW(method.put(0), ShogunException);
+
+	EXPECT_THROW(obj->get_handle<int32_t>("foo"), ShogunException);
+	EXPECT_THROW(
+	    obj->get_handle<float64_t>(MockObject::kInt).get(), ShogunException);
+}
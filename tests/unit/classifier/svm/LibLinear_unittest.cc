@@ -436,3 +436,53 @@ TEST_F(LibLinearFixture, simple_set_train_L2R_LR_DUAL_BIAS)
 	// bias, not l1
 	train_with_solver_simple(liblinear_solver_type, true, false, t_w);
 }
+
+TEST_F(LibLinearFixture, float32_compute_matches_float64)
+{
+	generate_data_l2();
+
+	auto to_float32 = [](const std::shared_ptr<DenseFeatures<float64_t>>& f) {
+		auto mat = f->get_feature_matrix();
+		SGMatrix<float32_t> mat32(mat.num_rows, mat.num_cols);
+		for (auto i : range(mat.num_rows * mat.num_cols))
+			mat32[i] = mat[i];
+		return std::make_shared<DenseFeatures<float32_t>>(mat32);
+	};
+	auto train_feats32 = to_float32(train_feats);
+	auto test_feats32 = to_float32(test_feats);
+
+	for (auto solver : {L2R_L2LOSS_SVC_DUAL, L2R_L1LOSS_SVC_DUAL, L2R_LR_DUAL})
+	{
+		auto ll = std::make_shared<LibLinear>(solver);
+		ll->set_bias_enabled(true);
+		ll->set_labels(ground_truth);
+		ll->put("seed", 100);
+		ll->train(train_feats);
+
+		auto ll32 = std::make_shared<LibLinear>(solver);
+		ll32->set_bias_enabled(true);
+		ll32->set_float32_compute(true);
+		ll32->set_labels(ground_truth);
+		ll32->put("seed", 100);
+		ll32->train(train_feats32);
+
+		auto w = ll->get_w();
+		auto w32 = ll32->get_w();
+		ASSERT_EQ(w32.vlen, w.vlen);
+		for (auto i : range(w.vlen))
+			EXPECT_NEAR(w32[i], w[i], 1e-2);
+		EXPECT_NEAR(ll32->get_bias(), ll->get_bias(), 1e-2);
+
+		auto outputs = ll->apply_binary(test_feats)->get_values();
+		auto outputs32 = ll32->apply_binary(test_feats32)->get_values();
+		for (auto i : range(outputs.vlen))
+			EXPECT_NEAR(outputs32[i], outputs[i], 1e-2);
+
+		// the cached single precision w follows a replaced w
+		ll32->set_w(w);
+		ll32->set_bias(ll->get_bias());
+		outputs32 = ll32->apply_binary(test_feats32)->get_values();
+		for (auto i : range(outputs.vlen))
+			EXPECT_NEAR(outputs32[i], outputs[i], 1e-4);
+	}
+}
@@ -0,0 +1,152 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/clustering/Hierarchical.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/mathematics/NormalDistribution.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace shogun;
+
+/** merge distances of a naive agglomerative clustering, in merge order */
+static std::vector<float64_t>
+reference_merge_distances(SGMatrix<float64_t> data, HIERARCHICAL_LINKAGE linkage)
+{
+	auto num=data.num_cols;
+	std::vector<std::vector<index_t>> clusters;
+	for (index_t i=0; i<num; i++)
+		clusters.push_back({i});
+
+	auto point_dist=[&](index_t a, index_t b) {
+		float64_t d=0;
+		for (index_t k=0; k<data.num_rows; k++)
+			d+=(data(k, a)-data(k, b))*(data(k, a)-data(k, b));
+		return std::sqrt(d);
+	};
+
+	auto cluster_dist=[&](const std::vector<index_t>& a, const std::vector<index_t>& b) {
+		if (linkage==LINKAGE_WARD)
+		{
+			float64_t d=0;
+			for (index_t k=0; k<data.num_rows; k++)
+			{
+				float64_t ca=0, cb=0;
+				for (auto i : a)
+					ca+=data(k, i)/a.size();
+				for (auto i : b)
+					cb+=data(k, i)/b.size();
+				d+=(ca-cb)*(ca-cb);
+			}
+			return std::sqrt(2.0*a.size()*b.size()/(a.size()+b.size())*d);
+		}
+
+		float64_t result=linkage==LINKAGE_COMPLETE ? 0 : 1e100;
+		float64_t sum=0;
+		for (auto i : a)
+		{
+			for (auto j : b)
+			{
+				auto d=point_dist(i, j);
+				sum+=d;
+				result=linkage==LINKAGE_COMPLETE ? std::max(result, d) : std::min(result, d);
+			}
+		}
+		return linkage==LINKAGE_AVERAGE ? sum/(a.size()*b.size()) : result;
+	};
+
+	std::vector<float64_t> distances;
+	while (clusters.size()>1)
+	{
+		size_t best_a=0, best_b=1;
+		auto best=cluster_dist(clusters[0], clusters[1]);
+		for (size_t a=0; a<clusters.size(); a++)
+		{
+			for (size_t b=a+1; b<clusters.size(); b++)
+			{
+				auto d=cluster_dist(clusters[a], clusters[b]);
+				if (d<best)
+				{
+					best=d;
+					best_a=a;
+					best_b=b;
+				}
+			}
+		}
+		distances.push_back(best);
+		clusters[best_a].insert(clusters[best_a].end(), clusters[best_b].begin(), clusters[best_b].end());
+		clusters.erase(clusters.begin()+best_b);
+	}
+	std::sort(distances.begin(), distances.end());
+	return distances;
+}
+
+TEST(Hierarchical, single_linkage_cluster_pairs)
+{
+	SGMatrix<float64_t> data(1, 5);
+	data(0, 0)=0;
+	data(0, 1)=1;
+	data(0, 2)=3;
+	data(0, 3)=7;
+	data(0, 4)=15;
+
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto distance=std::make_shared<EuclideanDistance>(feats, feats);
+	auto hierarchical=std::make_shared<Hierarchical>(2, distance);
+	hierarchical->train();
+
+	auto merge_distances=hierarchical->get_merge_distances();
+	EXPECT_EQ(merge_distances[0], 1);
+	EXPECT_EQ(merge_distances[1], 2);
+
+	// 0 and 1 form cluster 5, which is merged with 2 into cluster 6
+	auto pairs=hierarchical->get_cluster_pairs();
+	EXPECT_EQ(pairs(0, 0), 0);
+	EXPECT_EQ(pairs(1, 0), 1);
+	EXPECT_EQ(pairs(0, 1), 2);
+	EXPECT_EQ(pairs(1, 1), 5);
+
+	// all four merges are done, so every point ends up in cluster 8
+	auto assignment=hierarchical->get_assignment();
+	for (index_t i=0; i<assignment.vlen; i++)
+		EXPECT_EQ(assignment[i], 8);
+}
+
+TEST(Hierarchical, linkages_match_naive_clustering)
+{
+	const index_t num=30;
+	std::mt19937_64 prng(17);
+	NormalDistribution<float64_t> normal;
+	SGMatrix<float64_t> data(2, num);
+	for (index_t i=0; i<2*num; i++)
+		data[i]=normal(prng);
+
+	auto dense=std::make_shared<DenseFeatures<float64_t>>(data);
+	// sparse features take the generic path for Ward linkage
+	auto sparse=std::make_shared<SparseFeatures<float64_t>>(data);
+
+	for (auto linkage : {LINKAGE_SINGLE, LINKAGE_COMPLETE, LINKAGE_AVERAGE, LINKAGE_WARD})
+	{
+		auto expected=reference_merge_distances(data, linkage);
+		for (auto feats : std::vector<std::shared_ptr<DotFeatures>>{dense, sparse})
+		{
+			// with num/2+1 merges, all performed merges are visible
+			const int32_t merges=num/2+1;
+			auto hierarchical=std::make_shared<Hierarchical>(
+				merges, std::make_shared<EuclideanDistance>(feats, feats));
+			hierarchical->set_linkage(linkage);
+			hierarchical->train();
+
+			auto merge_distances=hierarchical->get_merge_distances();
+			for (index_t l=0; l<num-merges+1; l++)
+				EXPECT_NEAR(merge_distances[l], expected[l], 1e-9);
+			EXPECT_EQ(merge_distances[num-merges+1], -1);
+		}
+	}
+}
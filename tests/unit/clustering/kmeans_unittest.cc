@@ -9,10 +9,14 @@
 #include <shogun/clustering/KMeans.h>
 #include <shogun/clustering/KMeansMiniBatch.h>
 #include <shogun/distance/EuclideanDistance.h>
+#include <shogun/distance/ManhattanMetric.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/lib/observers/ParameterObserver.h>
 #include <shogun/lib/observers/ParameterObserverLogger.h>
+#include <shogun/mathematics/NormalDistribution.h>
+
+#include <random>
 
 using namespace shogun;
 
@@ -293,3 +297,67 @@ TEST(KMeans, random_centers_assign)
 
 }
 
+TEST(KMeans, bounded_solvers_match_lloyd)
+{
+	/* 1000 points around 20 well separated blob centers, 50 clusters */
+	const int32_t dim=8;
+	const int32_t num_points=1000;
+	const int32_t k=50;
+	std::mt19937_64 prng(17);
+	NormalDistribution<float64_t> normal_dist;
+
+	SGMatrix<float64_t> data(dim, num_points);
+	for (int32_t i=0; i<num_points; i++)
+	{
+		for (int32_t j=0; j<dim; j++)
+			data(j, i)=10.0*((i%20)>>(j%5)&1)+normal_dist(prng);
+	}
+
+	SGMatrix<float64_t> initial_centers(dim, k);
+	for (int32_t c=0; c<k; c++)
+	{
+		for (int32_t j=0; j<dim; j++)
+			initial_centers(j, c)=data(j, 7*c);
+	}
+
+	auto features=std::make_shared<DenseFeatures<float64_t>>(data);
+	SGMatrix<float64_t> lloyd_centers;
+	SGVector<float64_t> lloyd_labels;
+
+	for (auto solver : {KMEANS_LLOYD, KMEANS_ELKAN, KMEANS_HAMERLY})
+	{
+		auto distance=std::make_shared<EuclideanDistance>(features, features);
+		auto clustering=std::make_shared<KMeans>(k, distance, initial_centers);
+		clustering->set_solver_type(solver);
+		clustering->train(features);
+
+		auto centers=clustering->get_cluster_centers();
+		auto labels=clustering->apply(features)->as<MulticlassLabels>()->get_labels();
+		if (solver==KMEANS_LLOYD)
+		{
+			lloyd_centers=centers.clone();
+			lloyd_labels=labels;
+			continue;
+		}
+
+		for (int32_t i=0; i<num_points; i++)
+			EXPECT_EQ(labels[i], lloyd_labels[i]);
+		for (int32_t c=0; c<k; c++)
+		{
+			for (int32_t j=0; j<dim; j++)
+				EXPECT_NEAR(centers(j, c), lloyd_centers(j, c), 1E-10);
+		}
+	}
+}
+
+TEST(KMeans, bounded_solver_requires_euclidean)
+{
+	SGMatrix<float64_t> rect(2, 4);
+	rect.set_const(1.0);
+	auto features=std::make_shared<DenseFeatures<float64_t>>(rect);
+	auto distance=std::make_shared<ManhattanMetric>(features, features);
+	auto clustering=std::make_shared<KMeans>(2, distance);
+	clustering->set_solver_type(KMEANS_HAMERLY);
+
+	EXPECT_THROW(clustering->train(features), ShogunException);
+}
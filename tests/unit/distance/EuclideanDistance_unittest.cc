@@ -11,6 +11,10 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DenseSubSamplesFeatures.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/NormalDistribution.h>
+
+#include <algorithm>
+#include <random>
 
 using namespace shogun;
 
@@ -144,4 +148,143 @@ TEST(EuclideanDistance, heterogenous_features)
 
 
 
+}
+
+static std::shared_ptr<DenseFeatures<float64_t>>
+create_random_features(index_t dim, index_t num_vectors, std::mt19937_64& prng)
+{
+	SGMatrix<float64_t> data(dim, num_vectors);
+	NormalDistribution<float64_t> normal_dist;
+	for (index_t i=0; i<num_vectors; ++i)
+	{
+		for (index_t j=0; j<dim; ++j)
+			data(j, i)=normal_dist(prng);
+	}
+	return std::make_shared<DenseFeatures<float64_t>>(data);
+}
+
+TEST(EuclideanDistance, compute_distance_block)
+{
+	std::mt19937_64 prng(12);
+	auto features_lhs=create_random_features(5, 30, prng);
+	auto features_rhs=create_random_features(5, 20, prng);
+	auto euclidean=std::make_shared<EuclideanDistance>(features_lhs, features_rhs);
+
+	SGMatrix<float64_t> block(7, 11);
+	euclidean->compute_distance_block(3, 10, 4, 15, block);
+	for (index_t j=0; j<block.num_cols; ++j)
+	{
+		for (index_t i=0; i<block.num_rows; ++i)
+			EXPECT_NEAR(block(i, j), euclidean->distance(3+i, 4+j), 1E-12);
+	}
+}
+
+TEST(EuclideanDistance, compute_distance_block_after_subset)
+{
+	std::mt19937_64 prng(13);
+	auto features_lhs=create_random_features(5, 30, prng);
+	auto features_rhs=create_random_features(5, 20, prng);
+	auto euclidean=std::make_shared<EuclideanDistance>(features_lhs, features_rhs);
+
+	// the subsets keep the number of vectors but not the vectors
+	SGVector<index_t> lhs_subset(30), rhs_subset(20);
+	for (index_t i=0; i<lhs_subset.vlen; ++i)
+		lhs_subset[i]=lhs_subset.vlen-1-i;
+	for (index_t i=0; i<rhs_subset.vlen; ++i)
+		rhs_subset[i]=(i+7)%rhs_subset.vlen;
+	features_lhs->add_subset(lhs_subset);
+	features_rhs->add_subset(rhs_subset);
+
+	SGMatrix<float64_t> block(7, 11);
+	euclidean->compute_distance_block(3, 10, 4, 15, block);
+	for (index_t j=0; j<block.num_cols; ++j)
+	{
+		auto b=features_rhs->get_feature_vector(4+j);
+		for (index_t i=0; i<block.num_rows; ++i)
+		{
+			auto a=features_lhs->get_feature_vector(3+i);
+			float64_t expected=0;
+			for (index_t k=0; k<a.vlen; ++k)
+				expected+=(a[k]-b[k])*(a[k]-b[k]);
+			EXPECT_NEAR(block(i, j), std::sqrt(expected), 1E-12);
+		}
+	}
+}
+
+TEST(EuclideanDistance, nearest_rhs_and_lhs)
+{
+	// more vectors than fit into a single tile
+	std::mt19937_64 prng(12);
+	auto features_lhs=create_random_features(4, 600, prng);
+	auto features_rhs=create_random_features(4, 300, prng);
+	auto euclidean=std::make_shared<EuclideanDistance>(features_lhs, features_rhs);
+	auto dists=euclidean->get_distance_matrix();
+
+	SGVector<float64_t> min_dists;
+	auto nearest=euclidean->nearest_rhs(min_dists);
+	ASSERT_EQ(nearest.vlen, 600);
+	for (index_t i=0; i<600; ++i)
+	{
+		index_t best=0;
+		for (index_t j=1; j<300; ++j)
+		{
+			if (dists(i, j)<dists(i, best))
+				best=j;
+		}
+		EXPECT_EQ(nearest[i], best);
+		EXPECT_NEAR(min_dists[i], dists(i, best), 1E-12);
+	}
+
+	nearest=euclidean->nearest_lhs(min_dists);
+	ASSERT_EQ(nearest.vlen, 300);
+	for (index_t j=0; j<300; ++j)
+	{
+		index_t best=0;
+		for (index_t i=1; i<600; ++i)
+		{
+			if (dists(i, j)<dists(best, j))
+				best=i;
+		}
+		EXPECT_EQ(nearest[j], best);
+		EXPECT_NEAR(min_dists[j], dists(best, j), 1E-12);
+	}
+}
+
+TEST(EuclideanDistance, k_nearest_lhs)
+{
+	std::mt19937_64 prng(12);
+	auto features_lhs=create_random_features(3, 500, prng);
+	auto features_rhs=create_random_features(3, 40, prng);
+	auto euclidean=std::make_shared<EuclideanDistance>(features_lhs, features_rhs);
+	auto dists=euclidean->get_distance_matrix();
+
+	const int32_t k=5;
+	auto NN=euclidean->k_nearest_lhs(k);
+	ASSERT_EQ(NN.num_rows, k);
+	ASSERT_EQ(NN.num_cols, 40);
+
+	for (index_t j=0; j<40; ++j)
+	{
+		SGVector<float64_t> col(500);
+		for (index_t i=0; i<500; ++i)
+			col[i]=dists(i, j);
+		std::sort(col.vector, col.vector+col.vlen);
+
+		for (index_t l=0; l<k; ++l)
+			EXPECT_NEAR(dists(NN(l, j), j), col[l], 1E-12);
+	}
+	// a range of rhs vectors gives the same columns
+	auto NN_range=euclidean->k_nearest_lhs(k, 10, 25);
+	ASSERT_EQ(NN_range.num_cols, 15);
+	for (index_t j=0; j<15; ++j)
+	{
+		for (index_t l=0; l<k; ++l)
+			EXPECT_EQ(NN_range(l, j), NN(l, j+10));
+	}
+
+	SGVector<float64_t> min_dists;
+	auto nearest=euclidean->nearest_lhs(min_dists, 10, 25);
+	ASSERT_EQ(nearest.vlen, 15);
+	for (index_t j=0; j<15; ++j)
+		EXPECT_EQ(nearest[j], NN(0, j+10));
 }
@@ -0,0 +1,157 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/distributions/HMM.h>
+#include <shogun/features/StringFeatures.h>
+
+#include <random>
+#include <vector>
+
+using namespace shogun;
+
+static std::shared_ptr<StringFeatures<uint16_t>> observations()
+{
+	std::mt19937_64 prng(7);
+	std::vector<SGVector<uint16_t>> strings;
+	for (index_t i=0; i<40; i++)
+	{
+		SGVector<uint16_t> string(5+prng()%26);
+		for (index_t t=0; t<string.vlen; t++)
+			string[t]=prng()%4;
+		strings.push_back(string);
+	}
+	return std::make_shared<StringFeatures<uint16_t>>(strings, RAWDNA);
+}
+
+/** copy of hmm using the given engine */
+static std::shared_ptr<HMM> with_engine(
+	const std::shared_ptr<HMM>& hmm, EHMMEngine engine)
+{
+	auto copy=std::make_shared<HMM>(hmm);
+	copy->set_engine(engine);
+	return copy;
+}
+
+static void expect_same_model(
+	const std::shared_ptr<HMM>& a, const std::shared_ptr<HMM>& b)
+{
+	for (T_STATES i=0; i<a->get_N(); i++)
+	{
+		EXPECT_NEAR(a->get_p(i), b->get_p(i), 1e-6);
+		EXPECT_NEAR(a->get_q(i), b->get_q(i), 1e-6);
+		for (T_STATES j=0; j<a->get_N(); j++)
+			EXPECT_NEAR(a->get_a(i, j), b->get_a(i, j), 1e-6);
+		for (uint16_t j=0; j<a->get_M(); j++)
+			EXPECT_NEAR(a->get_b(i, j), b->get_b(i, j), 1e-6);
+	}
+}
+
+TEST(HMM, vectorized_engine_probabilities)
+{
+	auto obs=observations();
+	auto hmm=std::make_shared<HMM>(obs, 3, 4, 1e-3);
+	auto recursive=with_engine(hmm, HMM_ENGINE_RECURSIVE);
+
+	auto default_num_threads=env()->get_num_threads();
+	for (auto num_threads : {1, 4})
+	{
+		env()->set_num_threads(num_threads);
+		auto vectorized=with_engine(hmm, HMM_ENGINE_VECTORIZED);
+
+		EXPECT_NEAR(
+			vectorized->model_probability(), recursive->model_probability(),
+			1e-6);
+		EXPECT_NEAR(vectorized->best_path(-1), recursive->best_path(-1), 1e-9);
+
+		for (index_t dim=0; dim<obs->get_num_vectors(); dim++)
+		{
+			EXPECT_NEAR(
+				vectorized->best_path(dim), recursive->best_path(dim), 1e-9);
+			for (index_t t=0; t<obs->get_vector_length(dim); t++)
+			{
+				EXPECT_EQ(
+					vectorized->get_best_path_state(dim, t),
+					recursive->get_best_path_state(dim, t));
+			}
+		}
+	}
+	env()->set_num_threads(default_num_threads);
+}
+
+TEST(HMM, vectorized_engine_training)
+{
+	auto hmm=std::make_shared<HMM>(observations(), 3, 4, 1e-3);
+	auto recursive=with_engine(hmm, HMM_ENGINE_RECURSIVE);
+	auto vectorized=with_engine(hmm, HMM_ENGINE_VECTORIZED);
+
+	auto recursive_bw=with_engine(recursive, HMM_ENGINE_RECURSIVE);
+	auto vectorized_bw=with_engine(vectorized, HMM_ENGINE_VECTORIZED);
+	recursive_bw->estimate_model_baum_welch(recursive);
+	vectorized_bw->estimate_model_baum_welch(vectorized);
+	expect_same_model(recursive_bw, vectorized_bw);
+	EXPECT_NEAR(
+		vectorized->model_probability(), recursive->model_probability(), 1e-6);
+
+	auto recursive_vit=with_engine(recursive, HMM_ENGINE_RECURSIVE);
+	auto vectorized_vit=with_engine(vectorized, HMM_ENGINE_VECTORIZED);
+	recursive_vit->estimate_model_viterbi(recursive);
+	vectorized_vit->estimate_model_viterbi(vectorized);
+	expect_same_model(recursive_vit, vectorized_vit);
+}
+
+TEST(HMM, vectorized_engine_tables_follow_model_changes)
+{
+	auto hmm=std::make_shared<HMM>(observations(), 3, 4, 1e-3);
+	auto recursive=with_engine(hmm, HMM_ENGINE_RECURSIVE);
+	auto vectorized=with_engine(hmm, HMM_ENGINE_VECTORIZED);
+
+	// the tables of the initial model are reused for all best paths
+	float64_t path_prob=vectorized->best_path(-1);
+	EXPECT_NEAR(vectorized->best_path(0), recursive->best_path(0), 1e-9);
+	EXPECT_NEAR(path_prob, recursive->best_path(-1), 1e-9);
+
+	// and copied again once training changed the model
+	vectorized->estimate_model_baum_welch(
+		with_engine(vectorized, HMM_ENGINE_VECTORIZED));
+	recursive->estimate_model_baum_welch(
+		with_engine(recursive, HMM_ENGINE_RECURSIVE));
+	EXPECT_NEAR(vectorized->best_path(-1), recursive->best_path(-1), 1e-6);
+	EXPECT_NEAR(vectorized->best_path(0), recursive->best_path(0), 1e-6);
+}
+
+TEST(HMM, vectorized_engine_independent_of_threads)
+{
+	auto hmm=std::make_shared<HMM>(observations(), 3, 4, 1e-3);
+
+	auto default_num_threads=env()->get_num_threads();
+	env()->set_num_threads(1);
+	auto serial=with_engine(hmm, HMM_ENGINE_VECTORIZED);
+	float64_t model_prob=serial->model_probability();
+	float64_t path_prob=serial->best_path(-1);
+	auto serial_bw=with_engine(serial, HMM_ENGINE_VECTORIZED);
+	serial_bw->estimate_model_baum_welch(serial);
+
+	for (auto num_threads : {2, 3, 4})
+	{
+		env()->set_num_threads(num_threads);
+		auto parallel=with_engine(hmm, HMM_ENGINE_VECTORIZED);
+		EXPECT_EQ(parallel->model_probability(), model_prob);
+		EXPECT_EQ(parallel->best_path(-1), path_prob);
+
+		auto parallel_bw=with_engine(parallel, HMM_ENGINE_VECTORIZED);
+		parallel_bw->estimate_model_baum_welch(parallel);
+		for (T_STATES i=0; i<hmm->get_N(); i++)
+		{
+			EXPECT_EQ(parallel_bw->get_p(i), serial_bw->get_p(i));
+			EXPECT_EQ(parallel_bw->get_q(i), serial_bw->get_q(i));
+			for (T_STATES j=0; j<hmm->get_N(); j++)
+				EXPECT_EQ(parallel_bw->get_a(i, j), serial_bw->get_a(i, j));
+			for (uint16_t j=0; j<hmm->get_M(); j++)
+				EXPECT_EQ(parallel_bw->get_b(i, j), serial_bw->get_b(i, j));
+		}
+	}
+	env()->set_num_threads(default_num_threads);
+}
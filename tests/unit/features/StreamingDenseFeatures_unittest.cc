@@ -66,6 +66,62 @@ TEST(StreamingDenseFeaturesTest, example_reading_from_file)
 
 
 
+	std::remove(fname);
+}
+
+TEST(StreamingDenseFeaturesTest, parallel_parsing_from_file)
+{
+	int32_t seed = 17;
+	index_t n=1000;
+	index_t dim=3;
+	index_t num_single=300;
+	char fname[] = "StreamingDenseFeatures_parallel.XXXXXX";
+	generate_temp_filename(fname);
+
+	std::mt19937_64 prng(seed);
+	NormalDistribution<float64_t> normal_dist;
+
+	SGMatrix<float64_t> data(dim,n);
+	for (index_t i=0; i<dim*n; ++i)
+		data.matrix[i] = normal_dist(prng);
+
+	auto orig_feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto saved_features = std::make_shared<CSVFile>(fname, 'w');
+	orig_feats->save(saved_features);
+	saved_features->close();
+
+	auto input = std::make_shared<StreamingAsciiFile>(fname);
+	input->set_delimiter(',');
+	auto feats
+		= std::make_shared<StreamingDenseFeatures<float64_t>>(input, false, 16);
+	feats->set_num_parse_threads(4);
+	feats->start_parser();
+
+	// examples arrive in input order, one at a time and in batches
+	for (index_t i=0; i<num_single; i++)
+	{
+		ASSERT_TRUE(feats->get_next_example());
+		SGVector<float64_t> example = feats->get_vector();
+		ASSERT_EQ(dim, example.vlen);
+
+		for (index_t j = 0; j < dim; j++)
+			EXPECT_NEAR(data(j, i), example.vector[j], 1E-5);
+
+		feats->release_example();
+	}
+
+	auto streamed=feats->get_streamed_features(n)->as<DenseFeatures<float64_t>>();
+	feats->end_parser();
+
+	SGMatrix<float64_t> rest=streamed->get_feature_matrix();
+	ASSERT_EQ(dim, rest.num_rows);
+	ASSERT_EQ(n-num_single, rest.num_cols);
+	for (index_t i=0; i<rest.num_cols; i++)
+	{
+		for (index_t j = 0; j < dim; j++)
+			EXPECT_NEAR(data(j, num_single+i), rest(j, i), 1E-5);
+	}
+
 	std::remove(fname);
 }
 
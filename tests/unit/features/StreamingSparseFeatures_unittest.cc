@@ -11,6 +11,7 @@
 
 #include <shogun/io/streaming/StreamingAsciiFile.h>
 #include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/io/LibSVMFile.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
 #include <shogun/mathematics/UniformRealDistribution.h>
@@ -77,6 +78,69 @@ TEST(StreamingSparseFeaturesTest, parse_file)
   stream_features->end_parser();
 
 
+  SG_FREE(data);
+  SG_FREE(labels);
+
+  std::remove(fname);
+}
+
+TEST(StreamingSparseFeaturesTest, parallel_get_streamed_features)
+{
+  char fname[] = "StreamingSparseFeatures_parallel.XXXXXX";
+  generate_temp_filename(fname);
+
+  int32_t seed = 100;
+  int32_t max_num_entries=20;
+  int32_t num_vec=500;
+  int32_t num_feat=0;
+
+  std::mt19937_64 prng(seed);
+  UniformIntDistribution<int32_t> uniform_int_dist;
+  UniformRealDistribution<float64_t> uniform_real_dist;
+
+  SGSparseVector<float64_t>* data=SG_MALLOC(SGSparseVector<float64_t>, num_vec);
+  float64_t* labels=SG_MALLOC(float64_t, num_vec);
+  for (int32_t i=0; i<num_vec; i++)
+  {
+    data[i]=SGSparseVector<float64_t>(uniform_int_dist(prng, {1, max_num_entries}));
+    labels[i]=(float64_t) uniform_int_dist(prng, {-1, 1});
+    for (int32_t j=0; j<data[i].num_feat_entries; j++)
+    {
+      int32_t feat_index=(j+1)*2;
+      if (feat_index>num_feat)
+        num_feat=feat_index;
+
+      data[i].features[j].feat_index=feat_index-1;
+      data[i].features[j].entry=uniform_real_dist(prng, {0.0, 1.0});
+    }
+  }
+  auto fout = std::make_shared<LibSVMFile>(fname, 'w');
+  fout->set_sparse_matrix(data, num_feat, num_vec, labels);
+
+  auto file = std::make_shared<StreamingAsciiFile>(fname);
+  auto stream_features =
+    std::make_shared<StreamingSparseFeatures<float64_t>>(file, true, 32);
+  stream_features->set_num_parse_threads(3);
+  stream_features->start_parser();
+
+  auto streamed = stream_features->get_streamed_features(num_vec)
+    ->as<SparseFeatures<float64_t>>();
+  stream_features->end_parser();
+
+  ASSERT_EQ(num_vec, streamed->get_num_vectors());
+  EXPECT_EQ(num_feat, streamed->get_num_features());
+  for (index_t i = 0; i < num_vec; i++)
+  {
+    auto v = streamed->get_sparse_feature_vector(i);
+    ASSERT_EQ(data[i].num_feat_entries, v.num_feat_entries);
+
+    for (index_t j = 0; j < data[i].num_feat_entries; j++)
+    {
+      EXPECT_EQ(data[i].features[j].feat_index, v.features[j].feat_index);
+      EXPECT_DOUBLE_EQ(data[i].features[j].entry, v.features[j].entry);
+    }
+  }
+
   SG_FREE(data);
   SG_FREE(labels);
 
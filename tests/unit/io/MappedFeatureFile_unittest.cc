@@ -0,0 +1,221 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/io/MappedFeatureFile.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace shogun;
+
+TEST(MappedFeatureFile, dense_round_trip)
+{
+	const char* fname="MappedFeatureFile_dense.bin";
+	const int32_t num_feat=7, num_vec=300;
+	SGMatrix<float64_t> data(num_feat, num_vec);
+	for (index_t i=0; i<num_feat*num_vec; i++)
+		data.matrix[i]=i*0.5-17;
+
+	MappedFeatureFile<float64_t>::write(fname, data);
+
+	auto file=std::make_shared<MappedFeatureFile<float64_t>>(fname);
+	EXPECT_EQ(file->get_layout(), MFL_DENSE);
+	EXPECT_EQ(file->get_num_features(), num_feat);
+	EXPECT_EQ(file->get_num_vectors(), num_vec);
+
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(file);
+	// the file object is kept alive by the features
+	file.reset();
+
+	ASSERT_EQ(feats->get_num_features(), num_feat);
+	ASSERT_EQ(feats->get_num_vectors(), num_vec);
+	EXPECT_EQ(
+		uintptr_t(feats->get_feature_matrix().matrix)%MAPPED_FEATURES_ALIGNMENT,
+		0);
+
+	SGVector<float64_t> w(num_feat);
+	for (index_t j=0; j<num_feat; j++)
+		w[j]=j+1;
+
+	for (index_t i=0; i<num_vec; i++)
+	{
+		auto vec=feats->get_feature_vector(i);
+		float64_t expected=0;
+		for (index_t j=0; j<num_feat; j++)
+		{
+			EXPECT_EQ(vec[j], data(j, i));
+			expected+=w[j]*data(j, i);
+		}
+		EXPECT_NEAR(feats->dot(i, w), expected, 1e-10);
+	}
+
+	auto copy=std::make_shared<DenseFeatures<float64_t>>(*feats);
+	feats.reset();
+	EXPECT_EQ(copy->get_feature_vector(num_vec-1)[num_feat-1],
+		data(num_feat-1, num_vec-1));
+	unlink(fname);
+}
+
+TEST(MappedFeatureFile, sparse_round_trip)
+{
+	const char* fname="MappedFeatureFile_sparse.bin";
+	const int32_t num_feat=50, num_vec=100;
+	SGSparseMatrix<float64_t> data(num_feat, num_vec);
+	for (index_t i=0; i<num_vec; i++)
+	{
+		// vector i has i%5 entries, including empty ones
+		SGSparseVector<float64_t> vec(i%5);
+		for (index_t k=0; k<vec.num_feat_entries; k++)
+		{
+			vec.features[k].feat_index=(i+11*k)%num_feat/5*5+k;
+			vec.features[k].entry=i+0.25*k;
+		}
+		vec.sort_features();
+		data[i]=vec;
+	}
+
+	MappedFeatureFile<float64_t>::write(fname, data);
+
+	auto file=std::make_shared<MappedFeatureFile<float64_t>>(fname);
+	EXPECT_EQ(file->get_layout(), MFL_SPARSE);
+	EXPECT_EQ(file->get_num_entries(), 200);
+
+	auto feats=std::make_shared<SparseFeatures<float64_t>>(file);
+	file.reset();
+	ASSERT_EQ(feats->get_num_features(), num_feat);
+	ASSERT_EQ(feats->get_num_vectors(), num_vec);
+
+	SGVector<float64_t> w(num_feat);
+	for (index_t j=0; j<num_feat; j++)
+		w[j]=0.5*j;
+
+	for (index_t i=0; i<num_vec; i++)
+	{
+		auto vec=feats->get_sparse_feature_vector(i);
+		ASSERT_EQ(vec.num_feat_entries, data[i].num_feat_entries);
+
+		float64_t expected=0;
+		for (index_t k=0; k<vec.num_feat_entries; k++)
+		{
+			EXPECT_EQ(vec.features[k].feat_index, data[i].features[k].feat_index);
+			EXPECT_EQ(vec.features[k].entry, data[i].features[k].entry);
+			expected+=w[data[i].features[k].feat_index]*data[i].features[k].entry;
+		}
+		EXPECT_NEAR(feats->dense_dot(1.0, i, w.vector, num_feat, 0), expected,
+			1e-10);
+		feats->free_sparse_feature_vector(i);
+	}
+	unlink(fname);
+}
+
+TEST(MappedFeatureFile, rejects_invalid_files)
+{
+	const char* fname="MappedFeatureFile_invalid.bin";
+	SGMatrix<float64_t> data(3, 4);
+	data.zero();
+	MappedFeatureFile<float64_t>::write(fname, data);
+
+	// wrong value type and wrong layout
+	EXPECT_THROW(MappedFeatureFile<int32_t> file(fname), ShogunException);
+	MappedFeatureFile<float64_t> dense(fname);
+	EXPECT_THROW(dense.get_sparse_view(), ShogunException);
+
+	// unknown layout version
+	FILE* f=fopen(fname, "r+b");
+	ASSERT_NE(f, nullptr);
+	uint32_t version=MAPPED_FEATURES_VERSION+1;
+	fseek(f, offsetof(MappedFeatureHeader, version), SEEK_SET);
+	fwrite(&version, sizeof(version), 1, f);
+	fclose(f);
+	EXPECT_THROW(MappedFeatureFile<float64_t> file(fname), ShogunException);
+
+	// truncated data block
+	MappedFeatureFile<float64_t>::write(fname, data);
+	ASSERT_EQ(truncate(fname, MAPPED_FEATURES_ALIGNMENT+8), 0);
+	EXPECT_THROW(MappedFeatureFile<float64_t> file(fname), ShogunException);
+
+	// not a mapped feature file
+	f=fopen(fname, "wb");
+	fputs("1,2,3\n", f);
+	fclose(f);
+	EXPECT_THROW(MappedFeatureFile<float64_t> file(fname), ShogunException);
+
+	// sparse feature index beyond the number of features
+	SGSparseMatrix<float64_t> sparse(3, 1);
+	SGSparseVector<float64_t> vec(1);
+	vec.features[0].feat_index=3;
+	vec.features[0].entry=1;
+	sparse[0]=vec;
+	EXPECT_THROW(
+		MappedFeatureFile<float64_t>::write(fname, sparse), ShogunException);
+
+	// corrupt sparse feature index in the file, only found on request
+	vec.features[0].feat_index=2;
+	MappedFeatureFile<float64_t>::write(fname, sparse);
+	EXPECT_NO_THROW(MappedFeatureFile<float64_t> file(fname, true));
+	f=fopen(fname, "r+b");
+	ASSERT_NE(f, nullptr);
+	MappedFeatureHeader header;
+	ASSERT_EQ(fread(&header, sizeof(header), 1, f), 1u);
+	index_t feat_index=-1;
+	fseek(f, header.data_offset+offsetof(SGSparseVectorEntry<float64_t>,
+		feat_index), SEEK_SET);
+	fwrite(&feat_index, sizeof(feat_index), 1, f);
+	fclose(f);
+	EXPECT_NO_THROW(MappedFeatureFile<float64_t> file(fname));
+	EXPECT_THROW(
+		MappedFeatureFile<float64_t> file(fname, true), ShogunException);
+
+	unlink(fname);
+}
+
+TEST(MappedFeatureFile, modifications_stay_in_memory)
+{
+	const char* fname="MappedFeatureFile_modified.bin";
+	SGSparseMatrix<float64_t> data(10, 2);
+	for (index_t i=0; i<data.num_vectors; i++)
+	{
+		SGSparseVector<float64_t> vec(3);
+		for (index_t k=0; k<vec.num_feat_entries; k++)
+		{
+			vec.features[k].feat_index=9-3*k-i;
+			vec.features[k].entry=k+1;
+		}
+		data[i]=vec;
+	}
+	MappedFeatureFile<float64_t>::write(fname, data);
+
+	auto feats=std::make_shared<SparseFeatures<float64_t>>(
+		std::make_shared<MappedFeatureFile<float64_t>>(fname));
+	feats->sort_features();
+	for (index_t i=0; i<data.num_vectors; i++)
+	{
+		auto vec=feats->get_sparse_feature_vector(i);
+		for (index_t k=0; k<vec.num_feat_entries; k++)
+			EXPECT_EQ(vec.features[k].feat_index, 3*k+3-i);
+		feats->free_sparse_feature_vector(i);
+	}
+
+	// the file itself is unchanged
+	MappedFeatureFile<float64_t> sparse_file(fname);
+	auto sparse=sparse_file.get_sparse_view();
+	for (index_t k=0; k<3; k++)
+		EXPECT_EQ(sparse[0].features[k].feat_index, 9-3*k);
+
+	SGMatrix<float64_t> matrix(2, 3);
+	matrix.set_const(1);
+	MappedFeatureFile<float64_t>::write(fname, matrix);
+	auto dense=std::make_shared<DenseFeatures<float64_t>>(
+		std::make_shared<MappedFeatureFile<float64_t>>(fname));
+	dense->get_feature_matrix()(1, 2)=5;
+	EXPECT_EQ(dense->get_feature_vector(2)[1], 5);
+	MappedFeatureFile<float64_t> dense_file(fname);
+	EXPECT_EQ(dense_file.get_dense_view()(1, 2), 1);
+
+	unlink(fname);
+}
@@ -31,6 +31,7 @@
 #include <gtest/gtest.h>
 #include <shogun/lib/config.h>
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
@@ -39,6 +40,8 @@
 #include <shogun/kernel/GaussianKernel.h>
 #include <shogun/mathematics/Math.h>
 
+#include <random>
+
 using namespace shogun;
 
 
@@ -729,3 +732,81 @@ TEST(GaussianARDKernel,get_parameter_gradient_diagonal)
 
 
 }
+
+TEST(GaussianARDKernel,get_parameter_gradient_sum)
+{
+	// more vectors than one tile of the fused gradient
+	const index_t dim=3;
+	const index_t n=300;
+	const index_t m=270;
+	std::mt19937_64 prng(7);
+	std::normal_distribution<float64_t> normal;
+
+	SGMatrix<float64_t> feat_train(dim, n);
+	SGMatrix<float64_t> lat_feat_train(dim, m);
+	SGMatrix<float64_t> weights(n, m);
+	for (auto& v : feat_train)
+		v=normal(prng);
+	for (auto& v : lat_feat_train)
+		v=normal(prng);
+	for (auto& v : weights)
+		v=normal(prng);
+
+	auto features_train=std::make_shared<DenseFeatures<float64_t>>(feat_train);
+	auto latent_features_train=std::make_shared<DenseFeatures<float64_t>>(lat_feat_train);
+
+	SGVector<float64_t> vector_weights(dim);
+	vector_weights[0]=0.5;
+	vector_weights[1]=1.2;
+	vector_weights[2]=0.8;
+
+	SGMatrix<float64_t> matrix_weights(dim, 2);
+	matrix_weights.zero();
+	matrix_weights(0,0)=0.6;
+	matrix_weights(1,0)=-0.3;
+	matrix_weights(2,0)=0.2;
+	matrix_weights(1,1)=0.9;
+	matrix_weights(2,1)=0.4;
+
+	for (index_t type=0; type<3; type++)
+	{
+		auto kernel=std::make_shared<GaussianARDKernel>(10);
+		if (type==0)
+			kernel->set_scalar_weights(0.7);
+		else if (type==1)
+			kernel->set_vector_weights(vector_weights);
+		else
+			kernel->set_matrix_weights(matrix_weights);
+		kernel->init(features_train, latent_features_train);
+
+		auto params=kernel->get_params();
+		auto weight_param=params.find("log_weights");
+
+		SGVector<float64_t> vec=kernel->get_parameter_gradient_sum(
+			*weight_param, weights);
+		for (index_t i=0; i<vec.vlen; i++)
+		{
+			SGMatrix<float64_t> mat=vec.vlen==1 ?
+				kernel->get_parameter_gradient(*weight_param) :
+				kernel->get_parameter_gradient(*weight_param, i);
+
+			float64_t sum=0;
+			for (index_t j=0; j<n*m; j++)
+				sum+=weights[j]*mat[j];
+			EXPECT_NEAR(vec[i], sum, 1e-8*std::abs(sum));
+		}
+
+		// row blocks are reduced in a fixed order
+		auto default_num_threads=env()->get_num_threads();
+		for (auto num_threads : {1, 3})
+		{
+			env()->set_num_threads(num_threads);
+			SGVector<float64_t> other=kernel->get_parameter_gradient_sum(
+				*weight_param, weights);
+			for (index_t i=0; i<vec.vlen; i++)
+				EXPECT_EQ(other[i], vec[i]);
+		}
+		env()->set_num_threads(default_num_threads);
+	}
+}
+
@@ -0,0 +1,244 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/kernel/KernelRowCache.h>
+
+using namespace shogun;
+
+namespace
+{
+	int32_t fill_row(KernelRowCache& cache, int32_t docnum)
+	{
+		auto slot=cache.reserve(docnum);
+		if (slot==-1)
+			return slot;
+
+		for (int32_t a=0; a<cache.get_activenum(); a++)
+			cache.set(slot, a, docnum*1000.0+cache.active2totdoc(a));
+		cache.commit(docnum, slot);
+		return slot;
+	}
+}
+
+TEST(KernelRowCache, store_and_lookup)
+{
+	const int32_t totdoc=100;
+	KernelRowCache cache(totdoc, 1, false, 1);
+	EXPECT_EQ(cache.get_max_elems(), totdoc);
+	EXPECT_EQ(cache.get_activenum(), totdoc);
+
+	EXPECT_EQ(cache.lookup(3), -1);
+	ASSERT_NE(fill_row(cache, 3), -1);
+
+	auto slot=cache.lookup(3);
+	ASSERT_NE(slot, -1);
+	for (int32_t a=0; a<totdoc; a++)
+		EXPECT_EQ(cache.get(slot, a), 3000.0+a);
+
+	EXPECT_EQ(cache.get_hits(), 1);
+	EXPECT_EQ(cache.get_misses(), 1);
+	EXPECT_EQ(cache.get_num_elems(), 1);
+}
+
+TEST(KernelRowCache, reserved_rows_are_invisible)
+{
+	KernelRowCache cache(10, 1, false, 1);
+
+	auto slot=cache.reserve(4);
+	ASSERT_NE(slot, -1);
+	EXPECT_EQ(cache.get_slot(4), -1);
+	EXPECT_FALSE(cache.touch(4));
+
+	cache.commit(4, slot);
+	EXPECT_EQ(cache.get_slot(4), slot);
+	EXPECT_TRUE(cache.touch(4));
+}
+
+TEST(KernelRowCache, evicts_least_recently_used)
+{
+	// room for exactly four rows of length 65536
+	const int32_t totdoc=65536;
+	KernelRowCache cache(totdoc, 2, false, 1);
+	ASSERT_EQ(cache.get_max_elems(), 4);
+
+	for (int32_t i=0; i<4; i++)
+	{
+		cache.set_time(i);
+		ASSERT_NE(fill_row(cache, i), -1);
+	}
+	EXPECT_FALSE(cache.space_available());
+
+	// row 0 is used again and hence row 1 is the oldest
+	cache.set_time(4);
+	EXPECT_TRUE(cache.touch(0));
+
+	cache.set_time(5);
+	ASSERT_NE(fill_row(cache, 10), -1);
+	EXPECT_EQ(cache.get_slot(1), -1);
+	EXPECT_NE(cache.get_slot(0), -1);
+	EXPECT_NE(cache.get_slot(2), -1);
+	EXPECT_NE(cache.get_slot(3), -1);
+	EXPECT_EQ(cache.get_evictions(), 1);
+
+	cache.set_time(6);
+	ASSERT_NE(fill_row(cache, 11), -1);
+	EXPECT_EQ(cache.get_slot(2), -1);
+	EXPECT_EQ(cache.get_evictions(), 2);
+}
+
+TEST(KernelRowCache, eviction_policies)
+{
+	// row 0 is read after it was queued, but before rows 2 and 3 were
+	for (auto eviction : {KCE_LRU, KCE_SECOND_CHANCE})
+	{
+		const int32_t totdoc=65536;
+		KernelRowCache cache(totdoc, 2, false, 1, eviction);
+		ASSERT_EQ(cache.get_max_elems(), 4);
+		EXPECT_EQ(cache.get_eviction(), eviction);
+
+		cache.set_time(0);
+		ASSERT_NE(fill_row(cache, 0), -1);
+		cache.set_time(1);
+		EXPECT_TRUE(cache.touch(0));
+		ASSERT_NE(fill_row(cache, 1), -1);
+		cache.set_time(2);
+		ASSERT_NE(fill_row(cache, 2), -1);
+		cache.set_time(3);
+		ASSERT_NE(fill_row(cache, 3), -1);
+		cache.set_time(4);
+		EXPECT_TRUE(cache.touch(1));
+
+		cache.set_time(5);
+		ASSERT_NE(fill_row(cache, 10), -1);
+		EXPECT_EQ(cache.get_evictions(), 1);
+		EXPECT_NE(cache.get_slot(1), -1);
+		EXPECT_NE(cache.get_slot(3), -1);
+		if (eviction==KCE_LRU)
+		{
+			// row 0 is the least recently used row
+			EXPECT_EQ(cache.get_slot(0), -1);
+			EXPECT_NE(cache.get_slot(2), -1);
+		}
+		else
+		{
+			// rows 0 and 1 get a second chance, row 2 is the first not read
+			EXPECT_NE(cache.get_slot(0), -1);
+			EXPECT_EQ(cache.get_slot(2), -1);
+		}
+	}
+}
+
+TEST(KernelRowCache, more_shards_than_slots)
+{
+	// room for four rows in eight shards
+	const int32_t totdoc=65536;
+	KernelRowCache cache(totdoc, 2, false, 8);
+	ASSERT_EQ(cache.get_max_elems(), 4);
+	ASSERT_EQ(cache.get_num_shards(), 8);
+
+	// a working set of rows in the same shard takes all slots
+	std::vector<int32_t> slots;
+	for (int32_t i=0; i<4; i++)
+	{
+		slots.push_back(cache.reserve(8*i));
+		ASSERT_NE(slots.back(), -1);
+	}
+	EXPECT_FALSE(cache.space_available());
+	EXPECT_EQ(cache.reserve(32), -1);
+
+	for (int32_t i=0; i<4; i++)
+		cache.commit(8*i, slots[i]);
+
+	// rows of other shards evict the least recently used rows of shard 0
+	for (int32_t i=0; i<4; i++)
+	{
+		cache.set_time(i+1);
+		ASSERT_NE(fill_row(cache, 8*i+1), -1);
+		EXPECT_EQ(cache.get_slot(8*i), -1);
+	}
+	EXPECT_EQ(cache.get_evictions(), 4);
+	EXPECT_EQ(cache.get_num_elems(), 4);
+}
+
+TEST(KernelRowCache, float32_doubles_capacity)
+{
+	const int32_t totdoc=65536;
+	KernelRowCache cache64(totdoc, 2, false, 1);
+	KernelRowCache cache32(totdoc, 2, true, 1);
+
+	EXPECT_EQ(cache32.get_max_elems(), 2*cache64.get_max_elems());
+	EXPECT_EQ(cache32.get_buffer_bytes(), cache64.get_buffer_bytes());
+
+	auto slot=cache32.reserve(7);
+	cache32.set(slot, 3, 0.25);
+	cache32.commit(7, slot);
+	EXPECT_EQ(cache32.get(cache32.lookup(7), 3), 0.25);
+}
+
+TEST(KernelRowCache, shrink_keeps_active_entries)
+{
+	const int32_t totdoc=20;
+	KernelRowCache cache(totdoc, 1, false, 2);
+
+	for (int32_t i=0; i<5; i++)
+		ASSERT_NE(fill_row(cache, i), -1);
+
+	// deactivate all odd examples
+	std::vector<int32_t> after(totdoc);
+	for (int32_t j=0; j<totdoc; j++)
+		after[j]=(j+1)%2;
+	cache.shrink(totdoc, totdoc, after.data());
+
+	EXPECT_EQ(cache.get_activenum(), totdoc/2);
+	for (int32_t i=0; i<5; i++)
+	{
+		auto slot=cache.lookup(i);
+		ASSERT_NE(slot, -1);
+		for (int32_t a=0; a<cache.get_activenum(); a++)
+		{
+			EXPECT_EQ(cache.active2totdoc(a), 2*a);
+			EXPECT_EQ(cache.get(slot, a), i*1000.0+2*a);
+		}
+	}
+	EXPECT_EQ(cache.totdoc2active(3), -1);
+	EXPECT_EQ(cache.totdoc2active(4), 2);
+}
+
+TEST(KernelRowCache, concurrent_readers_and_writers)
+{
+	const int32_t totdoc=4096;
+	// room for 32 rows in 8 shards
+	KernelRowCache cache(totdoc, 1, false, 8);
+	ASSERT_EQ(cache.get_num_shards(), 8);
+
+	int64_t wrong=0;
+#pragma omp parallel for reduction(+:wrong)
+	for (int32_t i=0; i<20000; i++)
+	{
+		auto docnum=(i*7919)%totdoc;
+		{
+			auto lock=cache.lock_shared(docnum);
+			auto slot=cache.lookup(docnum);
+			if (slot!=-1)
+			{
+				for (int32_t a=0; a<totdoc; a+=97)
+					wrong+=cache.get(slot, a)!=docnum*1000.0+a;
+				continue;
+			}
+		}
+
+		// commit() drops the row if another thread cached it meanwhile
+		auto slot=cache.reserve(docnum);
+		if (slot==-1)
+			continue;
+		for (int32_t a=0; a<totdoc; a++)
+			cache.set(slot, a, docnum*1000.0+a);
+		cache.commit(docnum, slot);
+	}
+
+	EXPECT_EQ(wrong, 0);
+	EXPECT_EQ(cache.get_hits()+cache.get_misses(), 20000);
+	EXPECT_LE(cache.get_num_elems(), cache.get_max_elems());
+}
@@ -29,11 +29,15 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/kernel/SigmoidKernel.h>
 #include <shogun/mathematics/NormalDistribution.h>
 
 using namespace shogun;
@@ -366,7 +370,119 @@ TEST(Kernel, gaussian_get_kernel_matrix)
 	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
 	for (index_t i=0; i<km.num_rows; i++)
 		for (index_t j=0; j<km.num_cols; ++j)
-			EXPECT_NEAR(kernel->kernel(i,j), km(i, j), 1E-15);
+			EXPECT_NEAR(kernel->kernel(i,j), km(i, j), 1E-12);
 
 
 }
+
+TEST(Kernel, blocked_get_kernel_matrix_symmetric)
+{
+	const int32_t seed = 100;
+	// more than one block in each direction
+	const index_t num_feats=300;
+	const index_t dim=5;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data = generate_std_norm_matrix(num_feats, dim, prng);
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+
+	std::vector<std::shared_ptr<Kernel>> kernels{
+		std::make_shared<GaussianKernel>(feats, feats, 2),
+		std::make_shared<LinearKernel>(feats, feats),
+		std::make_shared<PolyKernel>(feats, feats, 3, 1.0, 0.5),
+		std::make_shared<SigmoidKernel>(feats, feats, 10, 0.1, 0.5)};
+
+	for (auto& kernel : kernels)
+	{
+		SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+		ASSERT_EQ(km.num_rows, num_feats);
+		ASSERT_EQ(km.num_cols, num_feats);
+		for (index_t i=0; i<km.num_rows; i++)
+		{
+			for (index_t j=0; j<km.num_cols; ++j)
+			{
+				EXPECT_NEAR(kernel->kernel(i,j), km(i, j), 1E-10);
+				EXPECT_EQ(km(i, j), km(j, i));
+			}
+		}
+	}
+}
+
+TEST(Kernel, blocked_get_kernel_matrix_subset)
+{
+	const int32_t seed = 100;
+	const index_t num_feats_p=270;
+	const index_t num_feats_q=40;
+	const index_t dim=4;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data_p = generate_std_norm_matrix(num_feats_p, dim, prng);
+	SGMatrix<float64_t> data_q = generate_std_norm_matrix(num_feats_q, dim, prng);
+	auto feats_p=std::make_shared<DenseFeatures<float64_t>>(data_p);
+	auto feats_q=std::make_shared<DenseFeatures<float64_t>>(data_q);
+
+	SGVector<index_t> subset(num_feats_q/2);
+	for (index_t i=0; i<subset.vlen; ++i)
+		subset[i]=2*i+1;
+	feats_q->add_subset(subset);
+
+	auto kernel=std::make_shared<PolyKernel>(feats_p, feats_q, 2, 1.0, 1.0);
+	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+	ASSERT_EQ(km.num_rows, num_feats_p);
+	ASSERT_EQ(km.num_cols, subset.vlen);
+	for (index_t i=0; i<km.num_rows; i++)
+		for (index_t j=0; j<km.num_cols; ++j)
+			EXPECT_NEAR(kernel->kernel(i,j), km(i, j), 1E-10);
+}
+
+TEST(Kernel, compute_batch_blocked)
+{
+	const int32_t seed = 100;
+	// more than one block of support vectors and of test vectors
+	const index_t num_train=600;
+	const index_t num_test=300;
+	const index_t dim=5;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> train = generate_std_norm_matrix(num_train, dim, prng);
+	SGMatrix<float64_t> test = generate_std_norm_matrix(num_test, dim, prng);
+	auto feats_train=std::make_shared<DenseFeatures<float64_t>>(train);
+	auto feats_test=std::make_shared<DenseFeatures<float64_t>>(test);
+
+	// every other training vector in reverse order
+	SGVector<int32_t> idx(num_train/2);
+	SGVector<float64_t> weights(idx.vlen);
+	for (index_t i=0; i<idx.vlen; ++i)
+	{
+		idx[i]=num_train-1-2*i;
+		weights[i]=std::sin(i);
+	}
+
+	std::vector<std::shared_ptr<Kernel>> kernels{
+		std::make_shared<GaussianKernel>(feats_train, feats_test, 2),
+		std::make_shared<LinearKernel>(feats_train, feats_test),
+		std::make_shared<PolyKernel>(feats_train, feats_test, 3, 1.0, 0.5)};
+
+	auto default_num_threads=env()->get_num_threads();
+	for (auto& kernel : kernels)
+	{
+		ASSERT_TRUE(kernel->has_block_computation());
+
+		env()->set_num_threads(1);
+		auto sums=kernel->compute_batch_blocked(idx, weights);
+		env()->set_num_threads(4);
+		auto sums_parallel=kernel->compute_batch_blocked(idx, weights);
+
+		ASSERT_EQ(sums.vlen, num_test);
+		for (index_t j=0; j<num_test; ++j)
+		{
+			float64_t expected=0;
+			for (index_t i=0; i<idx.vlen; ++i)
+				expected+=weights[i]*kernel->kernel(idx[i], j);
+
+			EXPECT_NEAR(sums[j], expected, 1E-8);
+			EXPECT_EQ(sums[j], sums_parallel[j]);
+		}
+	}
+	env()->set_num_threads(default_num_threads);
+}
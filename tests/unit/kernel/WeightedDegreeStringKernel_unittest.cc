@@ -0,0 +1,100 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/kernel/string/WeightedDegreePositionStringKernel.h>
+#include <shogun/kernel/string/WeightedDegreeStringKernel.h>
+
+#include <random>
+#include <vector>
+
+using namespace shogun;
+
+static std::shared_ptr<StringFeatures<char>>
+dna_strings(index_t num_strings, index_t len, uint64_t seed)
+{
+	std::mt19937_64 prng(seed);
+	const char* acgt="ACGT";
+	std::vector<SGVector<char>> strings;
+	for (index_t i=0; i<num_strings; i++)
+	{
+		SGVector<char> string(len);
+		for (index_t j=0; j<len; j++)
+			string[j]=acgt[prng()%4];
+		strings.push_back(string);
+	}
+	return std::make_shared<StringFeatures<char>>(strings, DNA);
+}
+
+/** checks the tries and the batch computation against the kernel matrix */
+static void check_linadd(const std::shared_ptr<Kernel>& kernel)
+{
+	auto matrix=kernel->get_kernel_matrix();
+
+	std::vector<int32_t> idx(matrix.num_rows);
+	std::vector<float64_t> alphas(matrix.num_rows);
+	for (index_t i=0; i<matrix.num_rows; i++)
+	{
+		idx[i]=i;
+		alphas[i]=(i%3) ? 0.1*(i%7)-0.3 : 0.0;
+	}
+
+	std::vector<int32_t> vec_idx(matrix.num_cols);
+	std::vector<float64_t> expected(matrix.num_cols, 0.0);
+	for (index_t j=0; j<matrix.num_cols; j++)
+	{
+		vec_idx[j]=j;
+		for (index_t i=0; i<matrix.num_rows; i++)
+			expected[j]+=alphas[i]*matrix(i, j);
+	}
+
+	auto default_num_threads=env()->get_num_threads();
+	for (auto num_threads : {1, 4})
+	{
+		env()->set_num_threads(num_threads);
+
+		kernel->init_optimization(matrix.num_rows, idx.data(), alphas.data());
+		for (index_t j=0; j<matrix.num_cols; j++)
+			EXPECT_NEAR(kernel->compute_optimized(j), expected[j], 1e-4);
+		kernel->delete_optimization();
+
+		std::vector<float64_t> result(matrix.num_cols, 0.0);
+		kernel->compute_batch(
+			matrix.num_cols, vec_idx.data(), result.data(), matrix.num_rows,
+			idx.data(), alphas.data());
+		for (index_t j=0; j<matrix.num_cols; j++)
+			EXPECT_NEAR(result[j], expected[j], 1e-4);
+	}
+	env()->set_num_threads(default_num_threads);
+}
+
+TEST(WeightedDegreeStringKernel, parallel_tries)
+{
+	auto kernel=std::make_shared<WeightedDegreeStringKernel>(
+		dna_strings(30, 23, 3), dna_strings(11, 23, 5), 6);
+	check_linadd(kernel);
+}
+
+TEST(WeightedDegreePositionStringKernel, parallel_tries)
+{
+	const index_t len=23;
+	const int32_t degree=6;
+	SGVector<float64_t> weights(degree);
+	for (index_t i=0; i<degree; i++)
+		weights[i]=1.0/(i+1);
+	SGVector<int32_t> shifts(len);
+	for (index_t i=0; i<len; i++)
+		shifts[i]=i%3;
+
+	for (auto opt_type : {SLOWBUTMEMEFFICIENT, FASTBUTMEMHUNGRY})
+	{
+		auto kernel=std::make_shared<WeightedDegreePositionStringKernel>(
+			10, weights, degree, 0, shifts);
+		kernel->set_optimization_type(opt_type);
+		kernel->init(dna_strings(30, len, 3), dna_strings(11, len, 5));
+		check_linadd(kernel);
+	}
+}
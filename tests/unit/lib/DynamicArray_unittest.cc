@@ -111,6 +111,38 @@ TYPED_TEST(DynamicArrayFixture, const_set_array)
 	SG_FREE(array);
 }
 
+TYPED_TEST(DynamicArrayFixture, multidimensional_arrays)
+{
+	this->wrapper_array->resize_array(2, 3, 4);
+	EXPECT_EQ(24, this->wrapper_array->get_num_elements());
+	this->wrapper_array->set_const((TypeParam)1);
+	for (index_t k = 0; k < 4; k++)
+		for (index_t j = 0; j < 3; j++)
+			for (index_t i = 0; i < 2; i++)
+				EXPECT_EQ(
+				    this->wrapper_array->get_element(i, j, k), (TypeParam)1);
+
+	TypeParam* array = SG_MALLOC(TypeParam, 24);
+	for (int32_t i = 0; i < 24; i++)
+		array[i] = (TypeParam)(i % 2);
+
+	this->wrapper_array->set_array(array, 4, 6, true, true);
+	EXPECT_EQ(24, this->wrapper_array->get_num_elements());
+	for (index_t j = 0; j < 6; j++)
+		for (index_t i = 0; i < 4; i++)
+			EXPECT_EQ(this->wrapper_array->get_element(i, j), array[i + 4 * j]);
+
+	this->wrapper_array->set_array(array, 2, 3, 4, true, true);
+	EXPECT_EQ(24, this->wrapper_array->get_num_elements());
+	for (index_t k = 0; k < 4; k++)
+		for (index_t j = 0; j < 3; j++)
+			for (index_t i = 0; i < 2; i++)
+				EXPECT_EQ(
+				    this->wrapper_array->get_element(i, j, k),
+				    array[i + 2 * (j + 3 * k)]);
+	SG_FREE(array);
+}
+
 #if 0
 TYPED_TEST(DynamicArrayFixture, get_array)
 {
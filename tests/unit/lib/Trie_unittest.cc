@@ -0,0 +1,77 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/lib/Trie.h>
+
+#include <random>
+#include <vector>
+
+using namespace shogun;
+
+TEST(Trie, add_examples_by_tree_variable_length)
+{
+	const int32_t degree=5;
+	const int32_t max_len=29;
+	const int32_t num_examples=100;
+	std::mt19937_64 prng(7);
+
+	// examples shorter than max_len are padded with zeros
+	std::vector<std::vector<int32_t>> examples(num_examples);
+	std::vector<int32_t> lens(num_examples);
+	std::vector<float32_t> alphas(num_examples);
+	for (int32_t e=0; e<num_examples; e++)
+	{
+		lens[e]=max_len-prng()%20;
+		examples[e].assign(max_len, 0);
+		for (int32_t i=0; i<lens[e]; i++)
+			examples[e][i]=prng()%4;
+		alphas[e]=(prng()%100)/50.0-1.0;
+	}
+	std::vector<float64_t> weights(degree);
+	for (int32_t j=0; j<degree; j++)
+		weights[j]=1.0/(j+1);
+
+	// an example only ends up in the trees before its end
+	CTrie<DNATrie> expected(degree);
+	expected.create(max_len);
+	for (int32_t e=0; e<num_examples; e++)
+	{
+		for (int32_t t=0; t<lens[e]; t++)
+			expected.add_to_trie(t, 0, examples[e].data(), alphas[e], weights.data(), false);
+	}
+
+	auto default_num_threads=env()->get_num_threads();
+	for (auto num_threads : {1, 4})
+	{
+		env()->set_num_threads(num_threads);
+
+		CTrie<DNATrie> trie(degree);
+		trie.create(max_len);
+		trie.add_examples_by_tree(0, max_len, num_examples, max_len,
+			[&](int32_t e, int32_t* vec)
+			{
+				for (int32_t i=0; i<max_len; i++)
+					vec[i]=examples[e][i];
+				return lens[e];
+			},
+			[&](CTrie<DNATrie>& shard, int32_t tree, int32_t* vec, int32_t len, int32_t e)
+			{
+				ASSERT_LT(tree, len);
+				shard.add_to_trie(tree, 0, vec, alphas[e], weights.data(), false);
+			});
+
+		for (int32_t e=0; e<num_examples; e++)
+		{
+			for (int32_t t=0; t<max_len; t++)
+			{
+				EXPECT_EQ(
+					trie.compute_by_tree_helper(examples[e].data(), max_len, t, t, t, weights.data(), false),
+					expected.compute_by_tree_helper(examples[e].data(), max_len, t, t, t, weights.data(), false));
+			}
+		}
+	}
+	env()->set_num_threads(default_num_threads);
+}
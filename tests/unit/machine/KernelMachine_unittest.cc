@@ -0,0 +1,210 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/features/DataGenerator.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/normalizer/AvgDiagKernelNormalizer.h>
+#include <shogun/kernel/normalizer/SqrtDiagKernelNormalizer.h>
+#include <shogun/labels/BinaryLabels.h>
+
+#include <random>
+
+using namespace shogun;
+
+class KernelMachineReduction : public ::testing::Test
+{
+public:
+	virtual void SetUp()
+	{
+		const index_t num_per_class=100;
+		std::mt19937_64 prng(5);
+		auto data=DataGenerator::generate_gaussians(num_per_class, 2, 2, prng);
+		// overlapping blobs, so that many vectors become support vectors
+		for (auto& v : data)
+			v*=0.5;
+		features=std::make_shared<DenseFeatures<float64_t>>(data);
+
+		SGVector<float64_t> lab(2*num_per_class);
+		for (index_t i=0; i<lab.vlen; i++)
+			lab[i]=i<num_per_class ? 1 : -1;
+
+		auto kernel=std::make_shared<GaussianKernel>(features, features, 1.0);
+		svm=std::make_shared<LibSVM>(10, kernel, std::make_shared<BinaryLabels>(lab));
+		svm->train();
+	}
+
+	std::shared_ptr<DenseFeatures<float64_t>> features;
+	std::shared_ptr<LibSVM> svm;
+};
+
+TEST_F(KernelMachineReduction, without_budget_is_exact)
+{
+	auto reduced=std::make_shared<KernelMachine>(svm);
+	auto error=reduced->reduce_support_vectors(0);
+	EXPECT_NEAR(error, 0, 1e-6);
+
+	auto outputs=svm->apply_binary(features);
+	auto reduced_outputs=reduced->apply_binary(features);
+	for (index_t i=0; i<outputs->get_num_labels(); i++)
+		EXPECT_NEAR(outputs->get_value(i), reduced_outputs->get_value(i), 1e-6);
+}
+
+TEST_F(KernelMachineReduction, budget_bounds_error)
+{
+	const index_t num_sv=svm->get_num_support_vectors();
+	ASSERT_GT(num_sv, 20);
+
+	// |f(x)-f'(x)| <= error*||w|| as k(x, x)=1
+	float64_t norm_sq=0;
+	auto alphas=svm->get_alphas();
+	auto svs=svm->get_support_vectors();
+	auto kernel=svm->get_kernel();
+	for (index_t i=0; i<num_sv; i++)
+		for (index_t j=0; j<num_sv; j++)
+			norm_sq+=alphas[i]*alphas[j]*kernel->kernel(svs[i], svs[j]);
+
+	float64_t previous_error=1;
+	for (auto budget : {5, 10, 20})
+	{
+		auto reduced=std::make_shared<KernelMachine>(svm);
+		auto error=reduced->reduce_support_vectors(budget);
+		EXPECT_LE(reduced->get_num_support_vectors(), budget);
+		EXPECT_LE(error, previous_error);
+		previous_error=error;
+
+		// the original machine is unchanged
+		EXPECT_EQ(svm->get_num_support_vectors(), num_sv);
+
+		auto outputs=svm->apply_binary(features);
+		auto reduced_outputs=reduced->apply_binary(features);
+		for (index_t i=0; i<outputs->get_num_labels(); i++)
+		{
+			auto diff=std::abs(
+				outputs->get_value(i)-reduced_outputs->get_value(i));
+			EXPECT_LE(diff, error*std::sqrt(norm_sq)+1e-8);
+		}
+	}
+
+	auto reduced=std::make_shared<KernelMachine>(svm);
+	auto error=reduced->reduce_support_vectors(0, 0.1);
+	EXPECT_LE(error, 0.1);
+	EXPECT_LT(reduced->get_num_support_vectors(), num_sv);
+}
+
+TEST_F(KernelMachineReduction, leaves_shared_kernel_untouched)
+{
+	auto kernel=svm->get_kernel();
+	auto test_features=std::make_shared<DenseFeatures<float64_t>>(
+		features->get_feature_matrix().clone());
+	kernel->init(features, test_features);
+
+	auto reduced=std::make_shared<KernelMachine>(svm);
+	ASSERT_EQ(reduced->get_kernel(), kernel);
+	reduced->reduce_support_vectors(10);
+	EXPECT_EQ(kernel->get_lhs(), features);
+	EXPECT_EQ(kernel->get_rhs(), test_features);
+	EXPECT_EQ(kernel->get_num_vec_lhs(), features->get_num_vectors());
+
+	kernel->remove_rhs();
+	reduced->reduce_support_vectors(5);
+	EXPECT_EQ(kernel->get_lhs(), features);
+	EXPECT_EQ(kernel->get_rhs(), nullptr);
+
+	// fails while computing kernel values of the support vectors
+	kernel->init(features, test_features);
+	reduced->set_alphas(SGVector<float64_t>(1));
+	EXPECT_THROW(reduced->reduce_support_vectors(0), ShogunException);
+	EXPECT_EQ(kernel->get_lhs(), features);
+	EXPECT_EQ(kernel->get_rhs(), test_features);
+}
+
+TEST_F(KernelMachineReduction, rejects_data_dependent_normalizer)
+{
+	auto kernel=svm->get_kernel();
+	auto reduced=std::make_shared<KernelMachine>(svm);
+	const index_t num_sv=reduced->get_num_support_vectors();
+
+	kernel->set_normalizer(std::make_shared<AvgDiagKernelNormalizer>());
+	EXPECT_THROW(reduced->reduce_support_vectors(10), ShogunException);
+	EXPECT_EQ(reduced->get_num_support_vectors(), num_sv);
+
+	kernel->set_normalizer(std::make_shared<SqrtDiagKernelNormalizer>());
+	reduced->reduce_support_vectors(10);
+	EXPECT_LE(reduced->get_num_support_vectors(), 10);
+}
+
+TEST_F(KernelMachineReduction, keeps_linadd_optimization_of_shared_kernel)
+{
+	auto kernel=std::make_shared<LinearKernel>(features, features);
+	auto linear_svm=std::make_shared<LibSVM>(10, kernel, svm->get_labels());
+	linear_svm->train();
+	linear_svm->init_kernel_optimization();
+	ASSERT_TRUE(kernel->get_is_initialized());
+
+	SGVector<float64_t> expected(features->get_num_vectors());
+	for (index_t i=0; i<expected.vlen; i++)
+		expected[i]=linear_svm->apply_one(i);
+
+	// a single vector cannot represent the two dimensional normal exactly
+	auto reduced=std::make_shared<KernelMachine>(linear_svm);
+	auto error=reduced->reduce_support_vectors(1);
+	EXPECT_GT(error, 0);
+	ASSERT_EQ(reduced->get_num_support_vectors(), 1);
+
+	// the source machine keeps the kernel and its optimization
+	EXPECT_TRUE(kernel->get_is_initialized());
+	for (index_t i=0; i<expected.vlen; i++)
+		EXPECT_NEAR(linear_svm->apply_one(i), expected[i], 1e-10);
+
+	auto reduced_kernel=reduced->get_kernel();
+	ASSERT_NE(reduced_kernel, kernel);
+	EXPECT_FALSE(reduced_kernel->get_is_initialized());
+	EXPECT_EQ(reduced_kernel->get_lhs(), features);
+	for (index_t i=0; i<features->get_num_vectors(); i++)
+	{
+		auto output=reduced->get_bias()+reduced->get_alpha(0)*
+			kernel->kernel(reduced->get_support_vector(0), i);
+		EXPECT_NEAR(reduced->apply_one(i), output, 1e-10);
+	}
+}
+
+TEST(KernelMachine, blocked_apply_matches_unblocked_apply)
+{
+	std::mt19937_64 prng(7);
+	auto train_data=DataGenerator::generate_gaussians(100, 2, 2, prng);
+	// several tiles of the block computation, the last one partial
+	auto test_data=DataGenerator::generate_gaussians(350, 2, 2, prng);
+	auto train_features=std::make_shared<DenseFeatures<float64_t>>(train_data);
+	auto test_features=std::make_shared<DenseFeatures<float64_t>>(test_data);
+
+	SGVector<float64_t> lab(train_data.num_cols);
+	for (index_t i=0; i<lab.vlen; i++)
+		lab[i]=i<lab.vlen/2 ? 1 : -1;
+
+	auto kernel=std::make_shared<GaussianKernel>(
+		train_features, train_features, 2.0);
+	auto svm=std::make_shared<LibSVM>(1, kernel, std::make_shared<BinaryLabels>(lab));
+	svm->train();
+
+	for (auto normalized : {false, true})
+	{
+		if (normalized)
+			kernel->set_normalizer(std::make_shared<SqrtDiagKernelNormalizer>());
+
+		svm->set_batch_computation_enabled(true);
+		auto blocked=svm->apply_binary(test_features);
+		ASSERT_TRUE(kernel->has_block_computation());
+
+		svm->set_batch_computation_enabled(false);
+		auto unblocked=svm->apply_binary(test_features);
+
+		ASSERT_EQ(blocked->get_num_labels(), test_data.num_cols);
+		for (index_t i=0; i<blocked->get_num_labels(); i++)
+			EXPECT_NEAR(blocked->get_value(i), unblocked->get_value(i), 1e-8);
+	}
+}
@@ -177,3 +177,34 @@ TEST_F(StochasticGBMachineTest, sinusoid_curve_fitting_subset_fraction)
 	EXPECT_NEAR(ret[8], -0.4408978052, epsilon);
 	EXPECT_NEAR(ret[9], 0.5380825978, epsilon);
 }
+
+TEST_F(StochasticGBMachineTest, histogram_trees_match_exact_trees)
+{
+	const int32_t seed = 2855;
+
+	// with fewer training vectors than bins, every value gets its own bin
+	SGVector<bool> ft(1);
+	ft[0] = false;
+	auto exact_tree = std::make_shared<CARTree>(ft);
+	exact_tree->set_max_depth(2);
+	auto binned_tree = std::make_shared<CARTree>(ft);
+	binned_tree->set_max_depth(2);
+	binned_tree->set_histogram_threshold(0);
+	ASSERT_EQ(binned_tree->get_num_bins(), 0);
+
+	auto sq = std::make_shared<SquaredLoss>();
+	auto exact = std::make_shared<StochasticGBMachine>(exact_tree, sq, 20, 0.1, 0.6);
+	exact->put("seed", seed);
+	exact->set_labels(train_labels);
+	exact->train(train_feats);
+
+	auto binned = std::make_shared<StochasticGBMachine>(binned_tree, sq, 20, 0.1, 0.6);
+	binned->put("seed", seed);
+	binned->set_labels(train_labels);
+	binned->train(train_feats);
+
+	auto expected = exact->apply_regression(test_feats)->get_labels();
+	auto result = binned->apply_regression(test_feats)->get_labels();
+	for (int32_t i = 0; i < num_test_samples; i++)
+		EXPECT_NEAR(result[i], expected[i], epsilon);
+}
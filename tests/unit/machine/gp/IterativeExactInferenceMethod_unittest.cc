@@ -0,0 +1,169 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/normalizer/SqrtDiagKernelNormalizer.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/machine/gp/ConstMean.h>
+#include <shogun/machine/gp/ExactInferenceMethod.h>
+#include <shogun/machine/gp/GaussianLikelihood.h>
+#include <shogun/machine/gp/IterativeExactInferenceMethod.h>
+
+#include <random>
+
+using namespace shogun;
+
+class IterativeExactInferenceMethodTest : public ::testing::Test
+{
+public:
+	virtual void SetUp()
+	{
+		const index_t n=80;
+		std::mt19937_64 prng(1);
+		std::normal_distribution<float64_t> normal;
+
+		SGMatrix<float64_t> X(1, n);
+		SGVector<float64_t> Y(n);
+		for (index_t i=0; i<n; i++)
+		{
+			X[i]=2*normal(prng);
+			Y[i]=std::sin(X[i])+0.3*normal(prng);
+		}
+		features=std::make_shared<DenseFeatures<float64_t>>(X);
+		labels=std::make_shared<RegressionLabels>(Y);
+
+		exact=std::make_shared<ExactInferenceMethod>(
+			std::make_shared<GaussianKernel>(10, 2.0), features,
+			std::make_shared<ConstMean>(0.1), labels,
+			std::make_shared<GaussianLikelihood>(0.3));
+		exact->set_scale(1.5);
+	}
+
+	std::shared_ptr<IterativeExactInferenceMethod> iterative(int32_t rank)
+	{
+		auto inf=std::make_shared<IterativeExactInferenceMethod>(
+			std::make_shared<GaussianKernel>(10, 2.0), features,
+			std::make_shared<ConstMean>(0.1), labels,
+			std::make_shared<GaussianLikelihood>(0.3));
+		inf->set_scale(1.5);
+		inf->set_preconditioner_rank(rank);
+		inf->set_num_probes(50);
+		inf->set_tolerance(1e-10);
+		inf->put(random::kSeed, 17);
+		return inf;
+	}
+
+	static std::map<std::string, SGVector<float64_t>>
+	gradient(const std::shared_ptr<Inference>& inf)
+	{
+		std::map<SGObject::Parameters::value_type, std::shared_ptr<SGObject>>
+			parameter_dictionary;
+		inf->build_gradient_parameter_dictionary(parameter_dictionary);
+		return inf->get_negative_log_marginal_likelihood_derivatives(
+			parameter_dictionary);
+	}
+
+	std::shared_ptr<DenseFeatures<float64_t>> features;
+	std::shared_ptr<RegressionLabels> labels;
+	std::shared_ptr<ExactInferenceMethod> exact;
+};
+
+TEST_F(IterativeExactInferenceMethodTest, exact_preconditioner)
+{
+	// a full rank preconditioner makes all estimates exact
+	auto inf=iterative(features->get_num_vectors());
+
+	EXPECT_NEAR(
+		inf->get_negative_log_marginal_likelihood(),
+		exact->get_negative_log_marginal_likelihood(), 1e-6);
+
+	auto alpha=inf->get_alpha();
+	auto exact_alpha=exact->get_alpha();
+	for (index_t i=0; i<alpha.vlen; i++)
+		EXPECT_NEAR(alpha[i], exact_alpha[i], 1e-6);
+
+	auto mu=inf->get_posterior_mean();
+	auto exact_mu=exact->get_posterior_mean();
+	for (index_t i=0; i<mu.vlen; i++)
+		EXPECT_NEAR(mu[i], exact_mu[i], 1e-6);
+
+	auto grad=gradient(inf);
+	auto exact_grad=gradient(exact);
+	for (auto name : {"log_width", "log_scale", "log_sigma", "mean"})
+		EXPECT_NEAR(grad[name][0], exact_grad[name][0], 1e-5);
+}
+
+TEST_F(IterativeExactInferenceMethodTest, low_rank_preconditioner)
+{
+	auto inf=iterative(15);
+
+	// the solve is exact up to the tolerance, the rest is estimated
+	auto alpha=inf->get_alpha();
+	auto exact_alpha=exact->get_alpha();
+	for (index_t i=0; i<alpha.vlen; i++)
+		EXPECT_NEAR(alpha[i], exact_alpha[i], 1e-6);
+
+	EXPECT_NEAR(
+		inf->get_negative_log_marginal_likelihood(),
+		exact->get_negative_log_marginal_likelihood(), 0.1);
+
+	auto grad=gradient(inf);
+	auto exact_grad=gradient(exact);
+	EXPECT_NEAR(grad["log_scale"][0], exact_grad["log_scale"][0], 0.1);
+	EXPECT_NEAR(grad["log_sigma"][0], exact_grad["log_sigma"][0], 0.1);
+	EXPECT_NEAR(grad["mean"][0], exact_grad["mean"][0], 1e-6);
+	EXPECT_NEAR(
+		grad["log_width"][0], exact_grad["log_width"][0],
+		0.05*std::abs(exact_grad["log_width"][0]));
+
+	// the probes are the same in every update
+	auto nlZ=inf->get_negative_log_marginal_likelihood();
+	inf->update();
+	EXPECT_EQ(inf->get_negative_log_marginal_likelihood(), nlZ);
+}
+
+TEST_F(IterativeExactInferenceMethodTest, no_kernel_matrix)
+{
+	auto inf=iterative(10);
+	inf->update();
+
+	// predictive means only need alpha
+	EXPECT_EQ(inf->get_alpha().vlen, features->get_num_vectors());
+	EXPECT_THROW(inf->get_cholesky(), ShogunException);
+	EXPECT_THROW(inf->get_posterior_covariance(), ShogunException);
+}
+
+TEST_F(IterativeExactInferenceMethodTest, multiple_kernel_blocks)
+{
+	auto inf=iterative(features->get_num_vectors());
+	// blocks of 7 rows, the last one holding only the remaining 3 rows
+	inf->set_block_size(7*features->get_num_vectors());
+
+	EXPECT_NEAR(
+		inf->get_negative_log_marginal_likelihood(),
+		exact->get_negative_log_marginal_likelihood(), 1e-6);
+
+	auto mu=inf->get_posterior_mean();
+	auto exact_mu=exact->get_posterior_mean();
+	for (index_t i=0; i<mu.vlen; i++)
+		EXPECT_NEAR(mu[i], exact_mu[i], 1e-6);
+
+	// the kernel derivatives use the diagonal of every block
+	auto grad=gradient(inf);
+	auto exact_grad=gradient(exact);
+	for (auto name : {"log_width", "log_scale", "log_sigma", "mean"})
+		EXPECT_NEAR(grad[name][0], exact_grad[name][0], 1e-5);
+}
+
+TEST_F(IterativeExactInferenceMethodTest, rejects_data_dependent_normalizer)
+{
+	auto kernel=std::make_shared<GaussianKernel>(10, 2.0);
+	kernel->set_normalizer(std::make_shared<SqrtDiagKernelNormalizer>());
+	auto inf=iterative(10);
+	inf->set_kernel(kernel);
+
+	EXPECT_THROW(inf->update(), ShogunException);
+}
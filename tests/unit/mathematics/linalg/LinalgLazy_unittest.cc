@@ -0,0 +1,76 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include <shogun/mathematics/linalg/LinalgLazy.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/mathematics/linalg/LinalgSpecialPurposes.h>
+
+#include <cmath>
+
+using namespace shogun;
+
+TEST(LinalgLazy, matches_eager_operations)
+{
+	// more than one evaluation block
+	SGMatrix<float64_t> a(100, 200), b(100, 200);
+	for (index_t i = 0; i < a.num_rows * a.num_cols; ++i)
+	{
+		a[i] = std::sin(i * 0.01);
+		b[i] = 1.5 + std::cos(i * 0.02);
+	}
+
+	SGMatrix<float64_t> result(a.num_rows, a.num_cols);
+	{
+		using namespace linalg::lazy;
+		eval(
+		    add(element_prod(logistic(ref(a)), ref(b)), exponent(ref(b)),
+		        2.0, -0.5),
+		    result);
+	}
+
+	SGMatrix<float64_t> sig(a.num_rows, a.num_cols);
+	linalg::logistic(a, sig);
+	auto ref_result = linalg::add(
+	    linalg::element_prod(sig, b), linalg::exponent(b), 2.0, -0.5);
+	for (index_t i = 0; i < a.num_rows * a.num_cols; ++i)
+		EXPECT_NEAR(result[i], ref_result[i], 1e-12);
+}
+
+TEST(LinalgLazy, operators_in_place)
+{
+	SGVector<float64_t> g(11), a(11);
+	for (index_t i = 0; i < g.vlen; ++i)
+	{
+		g[i] = i - 5.0;
+		a[i] = i / 10.0;
+	}
+	auto g0 = g.clone();
+
+	{
+		using namespace linalg::lazy;
+		eval(ref(g) * ref(a) * (1 - ref(a)) + rectified_linear(ref(g)), g);
+	}
+
+	for (index_t i = 0; i < g.vlen; ++i)
+	{
+		auto expected =
+		    g0[i] * a[i] * (1 - a[i]) + (g0[i] > 0 ? g0[i] : 0.0);
+		EXPECT_NEAR(g[i], expected, 1e-15);
+	}
+}
+
+TEST(LinalgLazy, dimension_mismatch)
+{
+	SGVector<float64_t> a(3), b(4), result(3);
+	SGMatrix<float64_t> m(3, 2);
+
+	using namespace linalg::lazy;
+	EXPECT_THROW(ref(a) + ref(b), ShogunException);
+	EXPECT_THROW(eval(ref(a) * 2.0, m), ShogunException);
+	EXPECT_THROW(eval(ref(m) - 1.0, result), ShogunException);
+}
@@ -2543,3 +2543,145 @@ TYPED_TEST(LinalgBackendEigenNonIntegerTypesTest, SGMatrix_squared_error)
 	auto result = linalg::squared_error(A, B);
 	EXPECT_NEAR(ref, result, get_epsilon<TypeParam>());
 }
+
+// 5x4 dense matrix with a few zeros per column and its sparse copy
+template <typename T>
+static SGMatrix<T> sparse_test_matrix()
+{
+	SGMatrix<T> A(5, 4);
+	for (index_t i = 0; i < A.num_cols; ++i)
+	{
+		for (index_t j = 0; j < A.num_rows; ++j)
+			A(j, i) = (i + j) % 3 ? 0 : T(i * A.num_rows + j + 1) / 10;
+	}
+	return A;
+}
+
+TYPED_TEST(LinalgBackendEigenRealTypesTest, SGSparseMatrix_SGVector_matrix_prod)
+{
+	auto A = sparse_test_matrix<TypeParam>();
+	SGSparseMatrix<TypeParam> S(A);
+
+	SGVector<TypeParam> b(A.num_cols);
+	SGVector<TypeParam> c(A.num_rows);
+	for (index_t i = 0; i < b.vlen; ++i)
+		b[i] = TypeParam(i) - 1;
+	for (index_t i = 0; i < c.vlen; ++i)
+		c[i] = TypeParam(i) / 2;
+
+	auto x = matrix_prod(S, b);
+	auto ref = matrix_prod(A, b);
+	ASSERT_EQ(x.vlen, ref.vlen);
+	for (index_t i = 0; i < ref.vlen; ++i)
+		EXPECT_NEAR(x[i], ref[i], get_epsilon<TypeParam>());
+
+	auto y = matrix_prod(S, c, true);
+	auto ref_t = matrix_prod(A, c, true);
+	ASSERT_EQ(y.vlen, ref_t.vlen);
+	for (index_t i = 0; i < ref_t.vlen; ++i)
+		EXPECT_NEAR(y[i], ref_t[i], get_epsilon<TypeParam>());
+
+	for (index_t i = 0; i < A.num_cols; ++i)
+		EXPECT_NEAR(dot(S[i], c), ref_t[i], get_epsilon<TypeParam>());
+
+	SGVector<TypeParam> wrong(A.num_rows + 1);
+	EXPECT_THROW(matrix_prod(S, b, wrong), ShogunException);
+
+	// column 0 has an entry in row 3
+	SGVector<TypeParam> too_short(1);
+	EXPECT_THROW(dot(S[0], too_short), ShogunException);
+}
+
+TYPED_TEST(
+    LinalgBackendEigenRealTypesTest, SGSparseMatrix_SGVector_matrix_prod_partials)
+{
+	// enough columns to be split into partial results, with integer values
+	// so that every summation order gives the exact result
+	SGMatrix<TypeParam> A(7, 3000);
+	for (index_t i = 0; i < A.num_cols; ++i)
+	{
+		for (index_t j = 0; j < A.num_rows; ++j)
+			A(j, i) = (i + 2 * j) % 5 ? 0 : TypeParam((i + j) % 4);
+	}
+	SGSparseMatrix<TypeParam> S(A);
+
+	SGVector<TypeParam> b(A.num_cols);
+	for (index_t i = 0; i < b.vlen; ++i)
+		b[i] = TypeParam(i % 5) - 2;
+
+	auto x = matrix_prod(S, b);
+	auto ref = matrix_prod(A, b);
+	ASSERT_EQ(x.vlen, ref.vlen);
+	for (index_t i = 0; i < ref.vlen; ++i)
+		EXPECT_EQ(x[i], ref[i]);
+}
+
+TYPED_TEST(LinalgBackendEigenRealTypesTest, SGSparseMatrix_SGMatrix_matrix_prod)
+{
+	auto A = sparse_test_matrix<TypeParam>();
+	SGSparseMatrix<TypeParam> S(A);
+
+	SGMatrix<TypeParam> B(A.num_cols, 3);
+	SGMatrix<TypeParam> C(A.num_rows, 3);
+	for (index_t i = 0; i < B.num_rows * B.num_cols; ++i)
+		B[i] = (i % 4) ? TypeParam(i) / 4 : 0;
+	for (index_t i = 0; i < C.num_rows * C.num_cols; ++i)
+		C[i] = TypeParam(i) / 8 - 1;
+
+	auto X = matrix_prod(S, B);
+	auto ref = matrix_prod(A, B);
+	ASSERT_EQ(X.num_rows, ref.num_rows);
+	ASSERT_EQ(X.num_cols, ref.num_cols);
+	for (index_t i = 0; i < ref.num_rows * ref.num_cols; ++i)
+		EXPECT_NEAR(X[i], ref[i], get_epsilon<TypeParam>());
+
+	auto Y = matrix_prod(S, C, true);
+	auto ref_t = matrix_prod(A, C, true);
+	ASSERT_EQ(Y.num_rows, ref_t.num_rows);
+	ASSERT_EQ(Y.num_cols, ref_t.num_cols);
+	for (index_t i = 0; i < ref_t.num_rows * ref_t.num_cols; ++i)
+		EXPECT_NEAR(Y[i], ref_t[i], get_epsilon<TypeParam>());
+
+	EXPECT_THROW(matrix_prod(S, C), ShogunException);
+}
+
+TYPED_TEST(LinalgBackendEigenRealTypesTest, SGSparseMatrix_add_scale_sum)
+{
+	auto A = sparse_test_matrix<TypeParam>();
+	SGSparseMatrix<TypeParam> S(A);
+
+	SGMatrix<TypeParam> B(A.num_rows, A.num_cols);
+	for (index_t i = 0; i < B.num_rows * B.num_cols; ++i)
+		B[i] = TypeParam(i) / 3;
+
+	const TypeParam alpha = 2, beta = -0.5;
+	auto sum = add(S, B, alpha, beta);
+	auto ref = add(A, B, alpha, beta);
+	for (index_t i = 0; i < ref.num_rows * ref.num_cols; ++i)
+		EXPECT_NEAR(sum[i], ref[i], get_epsilon<TypeParam>());
+
+	auto scaled = scale(S, alpha);
+	auto ref_scaled = scale(A, alpha);
+	for (index_t i = 0; i < A.num_cols; ++i)
+	{
+		EXPECT_EQ(scaled[i].num_feat_entries, S[i].num_feat_entries);
+		for (index_t j = 0; j < A.num_rows; ++j)
+			EXPECT_NEAR(
+			    scaled[i].get_feature(j), ref_scaled(j, i),
+			    get_epsilon<TypeParam>());
+	}
+	// the operand is left untouched
+	EXPECT_NEAR(S[1].get_feature(1), A(1, 1), get_epsilon<TypeParam>());
+
+	auto col_sum = colwise_sum(S);
+	auto ref_col_sum = colwise_sum(A);
+	ASSERT_EQ(col_sum.vlen, ref_col_sum.vlen);
+	for (index_t i = 0; i < ref_col_sum.vlen; ++i)
+		EXPECT_NEAR(col_sum[i], ref_col_sum[i], get_epsilon<TypeParam>());
+
+	auto row_sum = rowwise_sum(S);
+	auto ref_row_sum = rowwise_sum(A);
+	ASSERT_EQ(row_sum.vlen, ref_row_sum.vlen);
+	for (index_t i = 0; i < ref_row_sum.vlen; ++i)
+		EXPECT_NEAR(row_sum[i], ref_row_sum[i], get_epsilon<TypeParam>());
+}
@@ -0,0 +1,190 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/features/DataGenerator.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/machine/KernelMulticlassMachine.h>
+#include <shogun/machine/LinearMulticlassMachine.h>
+#include <shogun/multiclass/MulticlassOneVsOneStrategy.h>
+#include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
+
+#include <random>
+
+using namespace shogun;
+
+const index_t num_classes=4;
+const index_t num_per_class=20;
+
+static std::shared_ptr<DenseFeatures<float64_t>> blobs()
+{
+	std::mt19937_64 prng(11);
+	return std::make_shared<DenseFeatures<float64_t>>(
+		DataGenerator::generate_gaussians(num_per_class, num_classes, 2, prng));
+}
+
+static std::shared_ptr<MulticlassLabels> blob_labels()
+{
+	SGVector<float64_t> labels(num_per_class*num_classes);
+	for (index_t i=0; i<labels.vlen; i++)
+		labels[i]=i/num_per_class;
+	return std::make_shared<MulticlassLabels>(labels);
+}
+
+static std::shared_ptr<KernelMulticlassMachine> kernel_machine(
+	std::shared_ptr<MulticlassStrategy> strategy, bool parallel)
+{
+	auto features=blobs();
+	auto kernel=std::make_shared<GaussianKernel>(features, features, 2.0);
+	auto machine=std::make_shared<KernelMulticlassMachine>(
+		strategy, kernel, std::make_shared<LibSVM>(), blob_labels());
+	machine->set_parallel_training(parallel);
+	machine->train();
+	return machine;
+}
+
+TEST(MulticlassMachine, parallel_training_kernel_one_vs_rest)
+{
+	auto default_num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+	auto serial=kernel_machine(
+		std::make_shared<MulticlassOneVsRestStrategy>(), false);
+	auto parallel=kernel_machine(
+		std::make_shared<MulticlassOneVsRestStrategy>(), true);
+	env()->set_num_threads(default_num_threads);
+
+	auto serial_labels=serial->apply_multiclass();
+	auto parallel_labels=parallel->apply_multiclass();
+	for (index_t i=0; i<num_classes; i++)
+	{
+		auto serial_outputs=serial->get_submachine_outputs(i);
+		auto parallel_outputs=parallel->get_submachine_outputs(i);
+		for (index_t j=0; j<serial_outputs->get_num_labels(); j++)
+		{
+			EXPECT_NEAR(
+				serial_outputs->get_value(j), parallel_outputs->get_value(j),
+				1e-3);
+		}
+	}
+	for (index_t i=0; i<serial_labels->get_num_labels(); i++)
+		EXPECT_EQ(serial_labels->get_label(i), parallel_labels->get_label(i));
+}
+
+TEST(MulticlassMachine, parallel_training_kernel_one_vs_one)
+{
+	auto default_num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+	auto machine=kernel_machine(
+		std::make_shared<MulticlassOneVsOneStrategy>(), true);
+	env()->set_num_threads(default_num_threads);
+
+	EXPECT_EQ(
+		machine->get_num_machines(), num_classes*(num_classes-1)/2);
+
+	// support vectors index into all training vectors
+	auto labels=blob_labels();
+	for (index_t i=0; i<machine->get_num_machines(); i++)
+	{
+		auto submachine=machine->get_machine(i)->as<KernelMachine>();
+		for (index_t j=0; j<submachine->get_num_support_vectors(); j++)
+		{
+			auto sv=submachine->get_support_vector(j);
+			EXPECT_GE(sv, 0);
+			EXPECT_LT(sv, labels->get_num_labels());
+		}
+	}
+
+	auto predicted=machine->apply_multiclass();
+	for (index_t i=0; i<labels->get_num_labels(); i++)
+		EXPECT_EQ(predicted->get_label(i), labels->get_label(i));
+}
+
+TEST(MulticlassMachine, parallel_training_linear_one_vs_one)
+{
+	auto default_num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	std::shared_ptr<LinearMulticlassMachine> machines[2];
+	for (auto parallel : {false, true})
+	{
+		auto machine=std::make_shared<LinearMulticlassMachine>(
+			std::make_shared<MulticlassOneVsOneStrategy>(), blobs(),
+			std::make_shared<LibLinear>(L2R_LR), blob_labels());
+		machine->set_parallel_training(parallel);
+		machine->train();
+		machines[parallel]=machine;
+	}
+	env()->set_num_threads(default_num_threads);
+
+	ASSERT_EQ(machines[0]->get_num_machines(), machines[1]->get_num_machines());
+	for (index_t i=0; i<machines[0]->get_num_machines(); i++)
+	{
+		auto serial_w=machines[0]->get_machine(i)->as<LinearMachine>()->get_w();
+		auto parallel_w=
+			machines[1]->get_machine(i)->as<LinearMachine>()->get_w();
+		ASSERT_EQ(serial_w.vlen, parallel_w.vlen);
+		for (index_t j=0; j<serial_w.vlen; j++)
+			EXPECT_NEAR(serial_w[j], parallel_w[j], 1e-8);
+	}
+}
+
+TEST(MulticlassMachine, parallel_training_rethrows_errors)
+{
+	auto default_num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	auto features=blobs();
+	auto kernel=std::make_shared<GaussianKernel>(features, features, 2.0);
+	auto svm=std::make_shared<LibSVM>();
+	// libsvm rejects a non-positive C in every submachine
+	svm->set_C(-1.0, -1.0);
+	auto machine=std::make_shared<KernelMulticlassMachine>(
+		std::make_shared<MulticlassOneVsOneStrategy>(), kernel, svm,
+		blob_labels());
+	machine->set_parallel_training(true);
+	EXPECT_THROW(machine->train(), ShogunException);
+	// no untrained submachines are left behind for apply
+	EXPECT_EQ(machine->get_num_machines(), 0);
+
+	env()->set_num_threads(default_num_threads);
+}
+
+TEST(MulticlassMachine, parallel_training_restores_base_machine)
+{
+	auto default_num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	auto features=blobs();
+	auto kernel=std::make_shared<GaussianKernel>(features, features, 2.0);
+	auto svm=std::make_shared<LibSVM>();
+	auto svm_labels=std::make_shared<BinaryLabels>(num_per_class*num_classes);
+	svm->set_labels(svm_labels);
+	auto machine=std::make_shared<KernelMulticlassMachine>(
+		std::make_shared<MulticlassOneVsRestStrategy>(), kernel, svm,
+		blob_labels());
+	machine->set_parallel_training(true);
+	machine->train();
+
+	EXPECT_EQ(svm->get_labels(), svm_labels);
+	EXPECT_EQ(svm->get_kernel(), kernel);
+
+	auto linear=std::make_shared<LibLinear>(L2R_LR);
+	linear->set_labels(svm_labels);
+	auto linear_machine=std::make_shared<LinearMulticlassMachine>(
+		std::make_shared<MulticlassOneVsRestStrategy>(), features, linear,
+		blob_labels());
+	linear_machine->set_parallel_training(true);
+	linear_machine->train();
+
+	EXPECT_EQ(linear->get_labels(), svm_labels);
+	EXPECT_EQ(linear->get_features(), features);
+
+	env()->set_num_threads(default_num_threads);
+}
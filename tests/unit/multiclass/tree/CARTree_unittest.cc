@@ -29,6 +29,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
@@ -665,3 +666,244 @@ TEST(CARTree,cv_prune_simple)
 
 
 }
+
+TEST(CARTree, histogram_splits_match_exact_splits)
+{
+	// with fewer distinct values than bins, every value gets its own bin
+	const int32_t num_vecs=300;
+	std::mt19937_64 prng(17);
+	SGMatrix<float64_t> data(3, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		for (int32_t j=0;j<3;j++)
+			data(j,i)=prng()%10;
+
+		lab[i]=(data(0,i)+data(1,i)>8) + (data(2,i)>6);
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto labels=std::make_shared<MulticlassLabels>(lab);
+
+	auto exact=std::make_shared<CARTree>();
+	exact->set_num_bins(0);
+	exact->set_max_depth(6);
+	exact->set_labels(labels);
+	exact->train(feats);
+
+	auto binned=std::make_shared<CARTree>();
+	binned->set_num_bins(255);
+	binned->set_histogram_threshold(0);
+	binned->set_max_depth(6);
+	binned->set_labels(labels);
+	EXPECT_TRUE(binned->use_histograms(num_vecs));
+	binned->train(feats);
+
+	EXPECT_EQ(
+	    exact->get_root()->data.num_leaves,
+	    binned->get_root()->data.num_leaves);
+
+	auto exact_out=exact->apply_multiclass(feats)->get_labels();
+	auto binned_out=binned->apply_multiclass(feats)->get_labels();
+	for (int32_t i=0;i<num_vecs;i++)
+		EXPECT_EQ(exact_out[i], binned_out[i]);
+}
+
+TEST(CARTree, histogram_splits_on_nested_subsets)
+{
+	const int32_t num_vecs=400;
+	std::mt19937_64 prng(23);
+	SGMatrix<float64_t> data(3, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		for (int32_t j=0;j<3;j++)
+			data(j,i)=prng()%10;
+
+		lab[i]=(data(0,i)+data(1,i)>8) + (data(2,i)>6);
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+
+	auto binned=std::make_shared<CARTree>();
+	binned->set_num_bins(255);
+	binned->set_histogram_threshold(0);
+	binned->set_max_depth(6);
+	binned->set_binned_features(binned->bin_features(feats));
+
+	// every other vector, then the first half of those in reverse
+	SGVector<index_t> outer(num_vecs/2);
+	for (index_t i=0;i<outer.vlen;i++)
+		outer[i]=2*i;
+	SGVector<index_t> inner(outer.vlen/2);
+	for (index_t i=0;i<inner.vlen;i++)
+		inner[i]=inner.vlen-1-i;
+	feats->add_subset(outer);
+	feats->add_subset(inner);
+
+	SGVector<float64_t> sub_lab(inner.vlen);
+	for (index_t i=0;i<inner.vlen;i++)
+		sub_lab[i]=lab[outer[inner[i]]];
+	auto labels=std::make_shared<MulticlassLabels>(sub_lab);
+
+	auto exact=std::make_shared<CARTree>();
+	exact->set_num_bins(0);
+	exact->set_max_depth(6);
+	exact->set_labels(labels);
+	exact->train(feats);
+
+	binned->set_labels(labels);
+	binned->train(feats);
+
+	auto exact_out=exact->apply_multiclass(feats)->get_labels();
+	auto binned_out=binned->apply_multiclass(feats)->get_labels();
+	for (index_t i=0;i<inner.vlen;i++)
+		EXPECT_EQ(exact_out[i], binned_out[i]);
+}
+
+TEST(CARTree, histogram_splits_regression)
+{
+	const int32_t num_vecs=1000;
+	std::mt19937_64 prng(5);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+	SGMatrix<float64_t> data(2, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		data(0,i)=uniform(prng);
+		data(1,i)=uniform(prng);
+		lab[i]=std::sin(6*data(0,i))+(data(1,i)>0.5);
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto labels=std::make_shared<RegressionLabels>(lab);
+
+	auto c=std::make_shared<CARTree>();
+	c->set_num_bins(64);
+	c->set_histogram_threshold(0);
+	c->set_max_depth(8);
+	c->set_labels(labels);
+	c->train(feats);
+
+	auto result=c->apply_regression(feats)->get_labels();
+	float64_t mean=linalg::mean(lab);
+	float64_t sse=0, sst=0;
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		sse+=(result[i]-lab[i])*(result[i]-lab[i]);
+		sst+=(lab[i]-mean)*(lab[i]-mean);
+	}
+	EXPECT_LT(sse, 0.05*sst);
+}
+
+TEST(CARTree, histogram_splits_independent_of_label_offset)
+{
+	const int32_t num_vecs=1000;
+	const float64_t offset=1e8;
+	std::mt19937_64 prng(11);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+	SGMatrix<float64_t> data(2, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	SGVector<float64_t> lab_offset(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		data(0,i)=uniform(prng);
+		data(1,i)=uniform(prng);
+		lab[i]=std::sin(6*data(0,i))+(data(1,i)>0.5);
+		lab_offset[i]=lab[i]+offset;
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+
+	auto train=[&](const SGVector<float64_t>& y) {
+		auto c=std::make_shared<CARTree>();
+		c->set_num_bins(64);
+		c->set_histogram_threshold(0);
+		c->set_max_depth(8);
+		c->set_labels(std::make_shared<RegressionLabels>(y));
+		c->train(feats);
+		return c;
+	};
+	auto c=train(lab);
+	auto c_offset=train(lab_offset);
+
+	EXPECT_EQ(
+	    c->get_root()->data.num_leaves, c_offset->get_root()->data.num_leaves);
+	auto result=c->apply_regression(feats)->get_labels();
+	auto result_offset=c_offset->apply_regression(feats)->get_labels();
+	for (int32_t i=0;i<num_vecs;i++)
+		EXPECT_NEAR(result_offset[i]-offset, result[i], 1e-6);
+}
+
+TEST(CARTree, histogram_splits_quantile_binned)
+{
+	const int32_t num_vecs=2000;
+	std::mt19937_64 prng(3);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+	SGMatrix<float64_t> data(2, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		data(0,i)=uniform(prng);
+		data(1,i)=uniform(prng);
+		lab[i]=(data(0,i)>0.3) + (data(1,i)>0.7);
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto labels=std::make_shared<MulticlassLabels>(lab);
+
+	auto c=std::make_shared<CARTree>();
+	c->set_num_bins(32);
+	c->set_histogram_threshold(1000);
+	c->set_labels(labels);
+	EXPECT_TRUE(c->use_histograms(num_vecs));
+	c->train(feats);
+
+	auto result=c->apply_multiclass(feats)->get_labels();
+	int32_t correct=0;
+	for (int32_t i=0;i<num_vecs;i++)
+		correct+=(result[i]==lab[i]);
+
+	// thresholds can only be off by the width of a bin
+	EXPECT_GE(correct, 0.95*num_vecs);
+}
+
+TEST(CARTree, parallel_growth_matches_serial_growth)
+{
+	const int32_t num_vecs=3000;
+	std::mt19937_64 prng(7);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+	SGMatrix<float64_t> data(3, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		for (int32_t j=0;j<3;j++)
+			data(j,i)=uniform(prng);
+		lab[i]=std::sin(5*data(0,i))+data(1,i)*data(2,i);
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto labels=std::make_shared<RegressionLabels>(lab);
+
+	auto num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	// exact and histogram split finding
+	for (index_t threshold : {num_vecs+1, 0})
+	{
+		auto serial=std::make_shared<CARTree>();
+		serial->set_num_bins(255);
+		serial->set_histogram_threshold(threshold);
+		serial->set_parallel_node_size(0);
+		serial->set_labels(labels);
+		serial->train(feats);
+
+		auto parallel=std::make_shared<CARTree>();
+		parallel->set_num_bins(255);
+		parallel->set_histogram_threshold(threshold);
+		parallel->set_parallel_node_size(20);
+		parallel->set_labels(labels);
+		parallel->train(feats);
+
+		auto expected=serial->apply_regression(feats)->get_labels();
+		auto result=parallel->apply_regression(feats)->get_labels();
+		for (int32_t i=0;i<num_vecs;i++)
+			EXPECT_EQ(result[i], expected[i]);
+	}
+
+	env()->set_num_threads(num_threads);
+}
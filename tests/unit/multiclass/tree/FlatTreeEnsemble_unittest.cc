@@ -0,0 +1,67 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+using namespace shogun;
+
+typedef BinaryTreeMachineNode<CARTreeNodeData> bnode_t;
+
+static std::shared_ptr<bnode_t> leaf(float64_t label, SGVector<float64_t> transit)
+{
+	auto node=std::make_shared<bnode_t>();
+	node->data.node_label=label;
+	node->data.num_leaves=1;
+	node->data.transit_into_values=transit;
+	return node;
+}
+
+TEST(FlatTreeEnsemble, continuous_and_nominal_splits)
+{
+	// x0<=0.5 ? 1 : (x1 in {2, 3} ? 2 : 3)
+	auto nominal_split=leaf(0, SGVector<float64_t>({0.5}));
+	nominal_split->data.attribute_id=1;
+	nominal_split->data.num_leaves=2;
+	nominal_split->left(leaf(2, SGVector<float64_t>({2, 3})));
+	nominal_split->right(leaf(3, SGVector<float64_t>({1})));
+
+	auto root=leaf(0, SGVector<float64_t>());
+	root->data.attribute_id=0;
+	root->data.num_leaves=3;
+	root->left(leaf(1, SGVector<float64_t>({0.5})));
+	root->right(nominal_split);
+
+	SGVector<bool> nominal({false, true});
+	FlatTreeEnsemble flat;
+	flat.add_tree(root, nominal);
+	flat.add_tree(leaf(7, SGVector<float64_t>()), nominal);
+	EXPECT_EQ(flat.get_num_trees(), 2);
+	EXPECT_EQ(flat.get_num_nodes(), 6);
+
+	// enough vectors to fill more than one block
+	const index_t num_vecs=150;
+	SGMatrix<float64_t> data(2, num_vecs);
+	for (index_t i=0; i<num_vecs; i++)
+	{
+		data(0, i)=(i%3)*0.5;
+		data(1, i)=i%4;
+	}
+
+	auto outputs=flat.apply(data);
+	ASSERT_EQ(outputs.num_rows, num_vecs);
+	ASSERT_EQ(outputs.num_cols, 2);
+	for (index_t i=0; i<num_vecs; i++)
+	{
+		float64_t expected=1;
+		if (data(0, i)>0.5)
+			expected=(data(1, i)==2 || data(1, i)==3) ? 2 : 3;
+
+		EXPECT_EQ(outputs(i, 0), expected);
+		EXPECT_EQ(outputs(i, 1), 7);
+	}
+
+	// the trees split on the second attribute
+	EXPECT_THROW(flat.apply(SGMatrix<float64_t>(1, 3)), ShogunException);
+}
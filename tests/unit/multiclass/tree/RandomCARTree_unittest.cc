@@ -29,10 +29,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/RegressionLabels.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/multiclass/tree/RandomCARTree.h>
 
+#include <random>
+
 using namespace shogun;
 
 #define sunny 1.
@@ -198,4 +202,53 @@ TEST(RandomCARTree, classify_nominal)
 
 
 
+}
+
+TEST(RandomCARTree, parallel_growth_matches_serial_growth)
+{
+	const int32_t num_vecs=3000;
+	std::mt19937_64 prng(11);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+	SGMatrix<float64_t> data(6, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (int32_t i=0;i<num_vecs;i++)
+	{
+		for (int32_t j=0;j<6;j++)
+			data(j,i)=uniform(prng);
+		lab[i]=std::sin(5*data(0,i))+data(1,i)*data(2,i)-data(4,i);
+	}
+	auto feats=std::make_shared<DenseFeatures<float64_t>>(data);
+	auto labels=std::make_shared<RegressionLabels>(lab);
+
+	auto num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	// exact and histogram split finding
+	for (index_t threshold : {num_vecs+1, 0})
+	{
+		auto serial=std::make_shared<RandomCARTree>();
+		serial->set_feature_subset_size(2);
+		serial->set_num_bins(255);
+		serial->set_histogram_threshold(threshold);
+		serial->set_parallel_node_size(0);
+		serial->put("seed", 17);
+		serial->set_labels(labels);
+		serial->train(feats);
+
+		auto parallel=std::make_shared<RandomCARTree>();
+		parallel->set_feature_subset_size(2);
+		parallel->set_num_bins(255);
+		parallel->set_histogram_threshold(threshold);
+		parallel->set_parallel_node_size(20);
+		parallel->put("seed", 17);
+		parallel->set_labels(labels);
+		parallel->train(feats);
+
+		auto expected=serial->apply_regression(feats)->get_labels();
+		auto result=parallel->apply_regression(feats)->get_labels();
+		for (int32_t i=0;i<num_vecs;i++)
+			EXPECT_EQ(result[i], expected[i]);
+	}
+
+	env()->set_num_threads(num_threads);
 }
@@ -262,3 +262,41 @@ TEST_F(RandomForestTest, score_consistent_with_binary_trivial_data)
 	EXPECT_NEAR(1.0, values_vector[8], 1e-1);
 	EXPECT_NEAR(1.0, values_vector[9], 1e-1);
 }
+
+TEST_F(RandomForestTest, retrain_with_same_number_of_bags)
+{
+	int32_t seed = 2343;
+	env()->set_num_threads(1);
+
+	SGVector<float64_t> lab = weather_labels_train->get_labels();
+	SGVector<float64_t> flipped(lab.vlen);
+	for (index_t i = 0; i < lab.vlen; i++)
+		flipped[i] = 1 - lab[i];
+	auto flipped_labels = std::make_shared<MulticlassLabels>(flipped);
+
+	auto c = std::make_shared<RandomForest>(
+	    weather_features_train, weather_labels_train, 10, 2);
+	c->set_feature_types(weather_ft);
+	c->set_combination_rule(std::make_shared<MajorityVote>());
+	c->put("seed", seed);
+	c->train(weather_features_train);
+	c->apply(weather_features_test);
+
+	// the flattened trees of the first training must not be reused
+	c->set_labels(flipped_labels);
+	c->put("seed", seed);
+	c->train(weather_features_train);
+	auto result = c->apply(weather_features_test)->as<MulticlassLabels>();
+
+	auto expected = std::make_shared<RandomForest>(
+	    weather_features_train, flipped_labels, 10, 2);
+	expected->set_feature_types(weather_ft);
+	expected->set_combination_rule(std::make_shared<MajorityVote>());
+	expected->put("seed", seed);
+	expected->train(weather_features_train);
+	auto expected_result =
+	    expected->apply(weather_features_test)->as<MulticlassLabels>();
+
+	for (index_t i = 0; i < result->get_num_labels(); i++)
+		EXPECT_EQ(result->get_label(i), expected_result->get_label(i));
+}
@@ -31,6 +31,7 @@
  * Written (W) 2014 Khaled Nasr
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/neuralnets/ConvolutionalFeatureMap.h>
 #include <shogun/neuralnets/NeuralInputLayer.h>
 #include <shogun/neuralnets/NeuralLinearLayer.h>
@@ -786,3 +787,156 @@ TEST(ConvolutionalFeatureMap, pool_activations)
 	for (int32_t i=0; i<max_indices.num_rows*max_indices.num_cols; i++)
 		EXPECT_EQ(ref_max_indices[i], max_indices[i]);
 }
+
+TEST(ConvolutionalFeatureMap, compute_gradients_multiple_maps_with_stride)
+{
+	const int32_t seed = 100;
+	const int32_t w = 12;
+	const int32_t h = 10;
+	const int32_t rx = 1;
+	const int32_t ry = 2;
+	const int32_t stride_x = 3;
+	const int32_t stride_y = 2;
+	const int32_t b = 3;
+	const int32_t num_maps = 2;
+	const int32_t w_out = w/stride_x;
+	const int32_t h_out = h/stride_y;
+
+	std::mt19937_64 prng(seed);
+	UniformRealDistribution<float64_t> uniform_real_dist;
+
+	// two channels
+	auto input = std::make_shared<NeuralLinearLayer> (2*w*h);
+	input->set_batch_size(b);
+	for (int32_t i=0; i<input->get_num_neurons()*b; i++)
+		input->get_activations()[i] = uniform_real_dist(prng, {-10.0,10.0});
+
+	std::vector<std::shared_ptr<NeuralLayer>> layers;
+	layers.push_back(input);
+
+	SGVector<int32_t> input_indices(1);
+	input_indices[0] = 0;
+
+	const int32_t num_params_per_map = 1+(2*rx+1)*(2*ry+1)*2;
+	NormalDistribution<float64_t> normal_dist;
+	SGVector<float64_t> params(num_maps*num_params_per_map);
+	for (int32_t i=0; i<params.vlen; i++)
+		params[i] = normal_dist(prng, {0.0,0.01});
+
+	// both maps handled together give the same activations as one at a time
+	CConvolutionalFeatureMap maps(w,h,rx,ry,stride_x,stride_y,0,
+		CMAF_IDENTITY, NLAP_NONE, num_maps);
+	SGMatrix<float64_t> A(num_maps*w_out*h_out,b);
+	maps.compute_activations(params, layers, input_indices, A);
+
+	SGMatrix<float64_t> A_single(num_maps*w_out*h_out,b);
+	for (int32_t m=0; m<num_maps; m++)
+	{
+		CConvolutionalFeatureMap map(w,h,rx,ry,stride_x,stride_y,m);
+		SGVector<float64_t> map_params(params.vector+m*num_params_per_map,
+			num_params_per_map, false);
+		map.compute_activations(map_params, layers, input_indices, A_single);
+	}
+
+	for (int32_t i=0; i<A.num_rows*A.num_cols; i++)
+		EXPECT_NEAR(A_single[i], A[i], 1e-12);
+
+	// gradients with respect to 0.5*sum(A[i]^2)
+	SGMatrix<float64_t> AG(num_maps*w_out*h_out,b);
+	for (int32_t i=0; i<AG.num_rows*AG.num_cols; i++)
+		AG[i] = A[i];
+
+	input->get_activation_gradients().zero();
+	SGVector<float64_t> PG(params.vlen);
+	maps.compute_gradients(params, A, AG, layers, input_indices, PG);
+
+	auto error = [&]()
+	{
+		maps.compute_activations(params, layers, input_indices, A);
+		float64_t sum = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			sum += 0.5*A[k]*A[k];
+		return sum;
+	};
+
+	float64_t epsilon = 1e-6;
+	for (int32_t i=0; i<params.vlen; i++)
+	{
+		params[i] += epsilon;
+		float64_t error_plus = error();
+		params[i] -= 2*epsilon;
+		float64_t error_minus = error();
+		params[i] += epsilon;
+
+		EXPECT_NEAR((error_plus-error_minus)/(2*epsilon), PG[i], 1e-5);
+	}
+
+	SGMatrix<float64_t> X = input->get_activations();
+	SGMatrix<float64_t> IG = input->get_activation_gradients();
+	for (int32_t i=0; i<X.num_rows*X.num_cols; i++)
+	{
+		X[i] += epsilon;
+		float64_t error_plus = error();
+		X[i] -= 2*epsilon;
+		float64_t error_minus = error();
+		X[i] += epsilon;
+
+		EXPECT_NEAR((error_plus-error_minus)/(2*epsilon), IG[i], 1e-5);
+	}
+}
+
+/** tests that the parameter gradients of a batch do not depend on the number
+ * of threads
+ */
+TEST(ConvolutionalFeatureMap, compute_parameter_gradients_thread_independent)
+{
+	const int32_t seed = 100;
+	const int32_t w = 8;
+	const int32_t h = 6;
+	const int32_t rx = 1;
+	const int32_t ry = 1;
+	const int32_t b = 37;
+	const int32_t num_maps = 2;
+
+	std::mt19937_64 prng(seed);
+	UniformRealDistribution<float64_t> uniform_real_dist;
+
+	auto input = std::make_shared<NeuralLinearLayer> (w*h);
+	input->set_batch_size(b);
+	for (int32_t i=0; i<input->get_num_neurons()*b; i++)
+		input->get_activations()[i] = uniform_real_dist(prng, {-10.0,10.0});
+
+	std::vector<std::shared_ptr<NeuralLayer>> layers;
+	layers.push_back(input);
+
+	SGVector<int32_t> input_indices(1);
+	input_indices[0] = 0;
+
+	SGVector<float64_t> params(num_maps*(1+(2*rx+1)*(2*ry+1)));
+	for (int32_t i=0; i<params.vlen; i++)
+		params[i] = uniform_real_dist(prng, {-1.0,1.0});
+
+	CConvolutionalFeatureMap maps(w,h,rx,ry,1,1,0,
+		CMAF_IDENTITY, NLAP_NONE, num_maps);
+	SGMatrix<float64_t> A(num_maps*w*h,b);
+	maps.compute_activations(params, layers, input_indices, A);
+
+	auto gradients = [&](int32_t num_threads)
+	{
+		env()->set_num_threads(num_threads);
+		SGMatrix<float64_t> AG = A.clone();
+		SGVector<float64_t> PG(params.vlen);
+		maps.compute_gradients(params, A, AG, layers, input_indices, PG);
+		return PG;
+	};
+
+	auto default_num_threads = env()->get_num_threads();
+	auto expected = gradients(1);
+	for (auto num_threads : {2, 3, 4})
+	{
+		auto result = gradients(num_threads);
+		for (int32_t i=0; i<params.vlen; i++)
+			EXPECT_EQ(result[i], expected[i]);
+	}
+	env()->set_num_threads(default_num_threads);
+}
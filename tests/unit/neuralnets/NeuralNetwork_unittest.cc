@@ -32,9 +32,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/labels/MulticlassLabels.h>
@@ -46,6 +48,7 @@
 #include <shogun/neuralnets/NeuralConvolutionalLayer.h>
 #include <shogun/neuralnets/NeuralLayers.h>
 
+#include <cmath>
 #include <vector>
 
 using namespace shogun;
@@ -447,3 +450,137 @@ TEST(NeuralNetwork, gradient_descent)
 	for (int32_t i=0; i<4; i++)
 		EXPECT_EQ(predictions->get_label(i), labels->get_label(i));
 }
+
+/** tests that gradient descent on a sharded mini-batch gives the same
+ * network as on the whole mini-batch, independently of the number of threads
+ */
+TEST(NeuralNetwork, gradient_descent_sharded)
+{
+	int32_t seed = 100;
+
+	int32_t N = 50;
+	SGMatrix<float64_t> inputs_matrix(3,N);
+	SGVector<float64_t> targets_vector(N);
+
+	for (int32_t i=0; i<N; i++)
+	{
+		for (int32_t j=0; j<3; j++)
+			inputs_matrix(j,i) = std::sin(i*(j+1)*0.1);
+		targets_vector[i] = std::cos(i*0.2);
+	}
+
+	auto features =
+		std::make_shared<DenseFeatures<float64_t>>(inputs_matrix);
+
+	auto labels = std::make_shared<RegressionLabels>(targets_vector);
+
+	auto train = [&](int32_t num_shards, int32_t num_threads)
+	{
+		std::vector<std::shared_ptr<NeuralLayer>> layers;
+		layers.push_back(std::make_shared<NeuralInputLayer>(3));
+		layers.push_back(std::make_shared<NeuralLogisticLayer>(8));
+		layers.push_back(std::make_shared<NeuralLinearLayer>(1));
+
+		auto network = std::make_shared<NeuralNetwork>(layers);
+		network->put("seed", seed);
+		network->put("sigma", 0.1);
+
+		network->set_optimization_method(NNOM_GRADIENT_DESCENT);
+		network->set_gd_mini_batch_size(16);
+		network->set_gd_num_shards(num_shards);
+		network->set_l2_coefficient(0.01);
+		network->set_epsilon(0.0);
+		network->set_max_num_epochs(20);
+
+		env()->set_num_threads(num_threads);
+		network->set_labels(labels);
+		network->train(features);
+
+		return network->apply_regression(features)->get_labels();
+	};
+
+	auto default_num_threads = env()->get_num_threads();
+	auto whole = train(1, 1);
+	auto sharded = train(3, 1);
+	auto sharded_parallel = train(3, 4);
+	env()->set_num_threads(default_num_threads);
+
+	for (int32_t i=0; i<N; i++)
+	{
+		EXPECT_NEAR(sharded[i], whole[i], 1e-10);
+		EXPECT_EQ(sharded_parallel[i], sharded[i]);
+	}
+}
+
+/** tests that applying a network in chunks, to dense and streaming features,
+ * gives the same outputs as applying it to the whole set at once
+ */
+TEST(NeuralNetwork, apply_in_chunks)
+{
+	int32_t seed = 100;
+
+	int32_t N = 50;
+	SGMatrix<float64_t> inputs_matrix(3,N);
+	SGVector<float64_t> targets_vector(N);
+
+	for (int32_t i=0; i<N; i++)
+	{
+		for (int32_t j=0; j<3; j++)
+			inputs_matrix(j,i) = std::sin(i*(j+1)*0.1);
+		targets_vector[i] = i%3;
+	}
+
+	auto features =
+		std::make_shared<DenseFeatures<float64_t>>(inputs_matrix);
+
+	auto labels = std::make_shared<MulticlassLabels>(targets_vector);
+
+	std::vector<std::shared_ptr<NeuralLayer>> layers;
+	layers.push_back(std::make_shared<NeuralInputLayer>(3));
+	layers.push_back(std::make_shared<NeuralLogisticLayer>(8));
+	layers.push_back(std::make_shared<NeuralSoftmaxLayer>(3));
+
+	auto network = std::make_shared<NeuralNetwork>(layers);
+	network->put("seed", seed);
+	network->put("sigma", 0.1);
+
+	network->set_max_num_epochs(20);
+	network->set_labels(labels);
+	network->train(features);
+
+	auto whole = network->apply_multiclass(features);
+
+	auto default_num_threads = env()->get_num_threads();
+	for (auto num_threads : {1, 4})
+	{
+		env()->set_num_threads(num_threads);
+
+		// the chunk size does not divide the number of vectors
+		network->set_inference_chunk_size(7);
+		auto chunked = network->apply_multiclass(features);
+
+		auto stream =
+			std::make_shared<StreamingDenseFeatures<float64_t>>(features);
+		auto streamed = network->apply_multiclass(stream);
+
+		ASSERT_EQ(chunked->get_num_labels(), N);
+		ASSERT_EQ(streamed->get_num_labels(), N);
+		for (int32_t i=0; i<N; i++)
+		{
+			EXPECT_EQ(chunked->get_label(i), whole->get_label(i));
+			EXPECT_EQ(streamed->get_label(i), whole->get_label(i));
+
+			auto expected = whole->get_multiclass_confidences(i);
+			auto chunked_conf = chunked->get_multiclass_confidences(i);
+			auto streamed_conf = streamed->get_multiclass_confidences(i);
+			for (int32_t k=0; k<3; k++)
+			{
+				EXPECT_NEAR(chunked_conf[k], expected[k], 1e-12);
+				EXPECT_NEAR(streamed_conf[k], expected[k], 1e-12);
+			}
+		}
+
+		network->set_inference_chunk_size(0);
+	}
+	env()->set_num_threads(default_num_threads);
+}
@@ -0,0 +1,246 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGNDArray.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/structure/DynProg.h>
+#include <shogun/structure/PlifMatrix.h>
+
+#include <random>
+#include <vector>
+
+using namespace shogun;
+
+struct DecodedPaths
+{
+	SGVector<float64_t> scores;
+	SGMatrix<int32_t> states;
+	SGMatrix<int32_t> positions;
+};
+
+/** decodes a random model with three states, where every transition has a
+ * plif for segments of length 1 to 60 and some states cannot be observed at
+ * some positions
+ */
+static DecodedPaths decode(
+	int32_t num_pos, int16_t nbest, bool long_transitions,
+	int32_t checkpoint_interval)
+{
+	const int32_t num_states=3;
+	const int32_t num_limits=4;
+	const int32_t num_plifs=num_states*num_states;
+	std::mt19937_64 prng(17);
+	std::uniform_real_distribution<float64_t> uniform(-1.0, 1.0);
+
+	SGVector<int32_t> pos(num_pos);
+	pos[0]=0;
+	for (index_t i=1; i<num_pos; i++)
+		pos[i]=pos[i-1]+1+prng()%9;
+
+	SGVector<char> genestr(pos[num_pos-1]+1);
+	for (index_t i=0; i<genestr.vlen; i++)
+		genestr[i]="acgt"[prng()%4];
+
+	auto plifs=std::make_shared<PlifMatrix>();
+	plifs->create_plifs(num_plifs, num_limits);
+	SGVector<int32_t> ids(num_plifs);
+	SGVector<float64_t> min_values(num_plifs);
+	SGVector<float64_t> max_values(num_plifs);
+	SGMatrix<float64_t> limits(num_plifs, num_limits);
+	SGMatrix<float64_t> penalties(num_plifs, num_limits);
+	for (index_t i=0; i<num_plifs; i++)
+	{
+		ids[i]=i;
+		min_values[i]=1;
+		max_values[i]=60;
+		for (index_t k=0; k<num_limits; k++)
+		{
+			limits.matrix[i*num_limits+k]=1+20*k;
+			penalties.matrix[i*num_limits+k]=uniform(prng);
+		}
+	}
+	plifs->set_plif_ids(ids);
+	plifs->set_plif_min_values(min_values);
+	plifs->set_plif_max_values(max_values);
+	plifs->set_plif_limits(limits);
+	plifs->set_plif_penalties(penalties);
+
+	// plif ids are one based
+	SGNDArray<float64_t> plif_ids(SGVector<index_t>({num_states, num_states, 1}));
+	for (index_t i=0; i<num_plifs; i++)
+		plif_ids.array[i]=i+1;
+	EXPECT_TRUE(plifs->compute_plif_matrix(plif_ids));
+
+	SGMatrix<int32_t> state_signals(num_states, 1);
+	state_signals.zero();
+	EXPECT_TRUE(plifs->compute_signal_plifs(state_signals));
+
+	auto dyn=std::make_shared<DynProg>();
+	dyn->set_num_states(num_states);
+	dyn->set_pos(pos);
+	dyn->set_gene_string(genestr);
+	dyn->init_content_svm_value_array(dyn->get_num_svms());
+
+	SGMatrix<int32_t> orf_info(num_states, 2);
+	orf_info.set_const(-1);
+	dyn->set_orf_info(orf_info);
+
+	SGVector<float64_t> p(num_states);
+	SGVector<float64_t> q(num_states);
+	for (index_t i=0; i<num_states; i++)
+	{
+		p[i]=uniform(prng);
+		q[i]=uniform(prng);
+	}
+	dyn->set_p_vector(p);
+	dyn->set_q_vector(q);
+
+	// transitions from, to and score, ordered by the target state
+	SGMatrix<float64_t> a_trans(num_plifs, 3);
+	for (index_t to=0; to<num_states; to++)
+	{
+		for (index_t from=0; from<num_states; from++)
+		{
+			a_trans(from+to*num_states, 0)=from;
+			a_trans(from+to*num_states, 1)=to;
+			a_trans(from+to*num_states, 2)=uniform(prng);
+		}
+	}
+	dyn->set_a_trans_matrix(a_trans);
+	EXPECT_TRUE(dyn->check_svm_arrays());
+
+	// negative observations favour long segments, and thus long transitions
+	SGNDArray<float64_t> obs(SGVector<index_t>({num_states, num_pos, 1}));
+	for (index_t i=0; i<num_states*num_pos; i++)
+		obs.array[i]=prng()%5==0 ? -Math::INFTY : uniform(prng)-1.0;
+	dyn->set_observation_matrix(obs);
+	dyn->set_plif_matrices(plifs);
+
+	dyn->long_transition_settings(long_transitions, 20, 0);
+	dyn->set_checkpoint_interval(checkpoint_interval);
+	dyn->compute_nbest_paths(1, false, nbest, false, false);
+
+	return {dyn->get_scores(), dyn->get_states(), dyn->get_positions()};
+}
+
+static void expect_same_paths(const DecodedPaths& a, const DecodedPaths& b)
+{
+	ASSERT_EQ(a.scores.vlen, b.scores.vlen);
+	for (index_t k=0; k<a.scores.vlen; k++)
+		EXPECT_EQ(a.scores[k], b.scores[k]);
+
+	ASSERT_EQ(a.states.num_rows, b.states.num_rows);
+	ASSERT_EQ(a.states.num_cols, b.states.num_cols);
+	for (index_t i=0; i<a.states.num_rows*a.states.num_cols; i++)
+	{
+		EXPECT_EQ(a.states.matrix[i], b.states.matrix[i]);
+		EXPECT_EQ(a.positions.matrix[i], b.positions.matrix[i]);
+	}
+}
+
+/** compares the best path against one recorded from the decoder before
+ * checkpointing and the delta ring were introduced
+ */
+static void expect_recorded_path(
+	const DecodedPaths& d, float64_t score, const std::vector<int32_t>& states,
+	const std::vector<int32_t>& positions)
+{
+	ASSERT_EQ(d.scores.vlen, 1);
+	EXPECT_NEAR(d.scores[0], score, 1e-10);
+
+	ASSERT_EQ(states.size(), positions.size());
+	ASSERT_LE(index_t(states.size()), d.states.num_cols);
+	for (index_t i=0; i<index_t(states.size()); i++)
+	{
+		EXPECT_EQ(d.states(0, i), states[i]);
+		EXPECT_EQ(d.positions(0, i), positions[i]);
+	}
+	if (index_t(states.size())<d.states.num_cols)
+	{
+		EXPECT_EQ(d.states(0, states.size()), -1);
+	}
+}
+
+TEST(DynProg, default_path_matches_recorded)
+{
+	expect_recorded_path(
+		decode(100, 1, true, 0), 41.397550032758424,
+		{0, 2, 0, 0, 2, 0, 2, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 2, 0, 2, 0,
+		 0, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2,
+		 0, 2, 0, 2, 0, 0, 2, 2, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2},
+		{0,  1,  2,  3,  4,  5,  6,  8,  9,  10, 12, 13, 14, 15, 16, 17, 18,
+		 21, 22, 25, 28, 29, 30, 32, 33, 35, 36, 39, 40, 41, 42, 43, 44, 45,
+		 46, 50, 52, 54, 55, 56, 57, 58, 61, 62, 63, 64, 66, 67, 69, 74, 76,
+		 77, 78, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 97, 99});
+
+	expect_recorded_path(
+		decode(100, 1, false, 0), 41.595139064735527,
+		{0, 2, 0, 0, 2, 0, 2, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 2, 0, 2, 0,
+		 0, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 0, 2,
+		 0, 2, 0, 2, 0, 0, 0, 2, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2},
+		{0,  1,  2,  3,  4,  5,  6,  8,  9,  10, 12, 13, 14, 15, 16, 17, 18,
+		 21, 22, 25, 28, 29, 30, 32, 33, 35, 36, 39, 40, 41, 42, 43, 44, 45,
+		 46, 50, 52, 54, 55, 56, 57, 58, 61, 62, 63, 64, 66, 67, 69, 74, 76,
+		 77, 82, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 97, 99});
+}
+
+TEST(DynProg, checkpoints_long_transitions)
+{
+	auto full=decode(300, 1, true, 0);
+	EXPECT_GT(full.scores[0], -Math::INFTY);
+
+	for (auto interval : {2, 7, 64, 299})
+		expect_same_paths(full, decode(300, 1, true, interval));
+}
+
+TEST(DynProg, checkpoints_nbest)
+{
+	auto full=decode(300, 3, false, 0);
+	for (index_t k=0; k<3; k++)
+		EXPECT_GT(full.scores[k], -Math::INFTY);
+
+	for (auto interval : {2, 7, 64, 299})
+		expect_same_paths(full, decode(300, 3, false, interval));
+
+	// long transitions only support the best path
+	EXPECT_THROW(decode(300, 3, true, 0), ShogunException);
+}
+
+TEST(DynProg, nbest_paths)
+{
+	auto best=decode(300, 1, false, 0);
+	auto paths=decode(300, 3, false, 0);
+	ASSERT_EQ(paths.scores.vlen, 3);
+	ASSERT_EQ(paths.states.num_rows, 3);
+
+	// the first path is the best path, the others are distinct and worse
+	EXPECT_NEAR(paths.scores[0], best.scores[0], 1e-10);
+	for (index_t i=0; i<best.states.num_cols; i++)
+	{
+		EXPECT_EQ(paths.states(0, i), best.states(0, i));
+		EXPECT_EQ(paths.positions(0, i), best.positions(0, i));
+		if (best.states(0, i)==-1)
+			break;
+	}
+
+	for (index_t k=1; k<3; k++)
+	{
+		EXPECT_LE(paths.scores[k], paths.scores[k-1]);
+		for (index_t l=0; l<k; l++)
+		{
+			bool same=true;
+			for (index_t i=0; i<paths.states.num_cols && same; i++)
+			{
+				same=paths.states(k, i)==paths.states(l, i) &&
+					paths.positions(k, i)==paths.positions(l, i);
+				if (paths.states(k, i)==-1)
+					break;
+			}
+			EXPECT_FALSE(same);
+		}
+	}
+}